@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "DelimiterClassifier.hpp"
+
+// Classifies the same way as DelimiterClassifier{ L"" }: Whitespace and
+// control characters are ControlChar and everything else is a RegularChar.
+DelimiterClassifier::DelimiterClassifier() noexcept
+{
+    for (size_t i = 0; i < _ascii.size(); ++i)
+    {
+        til::at(_ascii, i) = i <= L' ' ? DelimiterClass::ControlChar : DelimiterClass::RegularChar;
+    }
+}
+
+DelimiterClassifier::DelimiterClassifier(const std::wstring_view wordDelimiters) :
+    DelimiterClassifier{}
+{
+    std::vector<wchar_t> nonAscii;
+
+    for (const auto wch : wordDelimiters)
+    {
+        // Whitespace and control characters are always ControlChar, even if they're delimiters.
+        if (wch <= L' ')
+        {
+            continue;
+        }
+        if (wch < _ascii.size())
+        {
+            til::at(_ascii, wch) = DelimiterClass::DelimiterChar;
+        }
+        else
+        {
+            nonAscii.emplace_back(wch);
+        }
+    }
+
+    std::sort(nonAscii.begin(), nonAscii.end());
+
+    // Join consecutive characters into ranges, which also takes care of duplicates.
+    for (const auto wch : nonAscii)
+    {
+        if (!_ranges.empty() && wch <= _ranges.back().second + 1)
+        {
+            _ranges.back().second = wch;
+        }
+        else
+        {
+            _ranges.emplace_back(wch, wch);
+        }
+    }
+}
+
+DelimiterClass DelimiterClassifier::_classifyNonAscii(const wchar_t wch) const noexcept
+{
+    // Find the first range that ends at or after wch. wch is a delimiter if that range starts at or before it.
+    const auto it = std::lower_bound(_ranges.begin(), _ranges.end(), wch, [](const auto& range, const wchar_t value) noexcept {
+        return range.second < value;
+    });
+    return it != _ranges.end() && it->first <= wch ? DelimiterClass::DelimiterChar : DelimiterClass::RegularChar;
+}
@@ -0,0 +1,46 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- DelimiterClassifier.hpp
+
+Abstract:
+- Sorts characters into the classes used for word navigation (double click
+  selection, UIA word movement, ...), based on the user's word delimiters.
+- It's built once from the delimiter setting. ASCII characters are looked up
+  in a table, all others via binary search in a sorted list of ranges.
+  This replaces a linear search through the delimiter string for every cell.
+--*/
+
+#pragma once
+
+enum class DelimiterClass : uint8_t
+{
+    ControlChar,
+    DelimiterChar,
+    RegularChar
+};
+
+class DelimiterClassifier
+{
+public:
+    DelimiterClassifier() noexcept;
+    explicit DelimiterClassifier(std::wstring_view wordDelimiters);
+
+    DelimiterClass Classify(wchar_t wch) const noexcept
+    {
+        if (wch < _ascii.size())
+        {
+            return til::at(_ascii, wch);
+        }
+        return _classifyNonAscii(wch);
+    }
+
+private:
+    DelimiterClass _classifyNonAscii(wchar_t wch) const noexcept;
+
+    std::array<DelimiterClass, 128> _ascii{};
+    // Inclusive, sorted and non-overlapping ranges of non-ASCII delimiters.
+    std::vector<std::pair<wchar_t, wchar_t>> _ranges;
+};
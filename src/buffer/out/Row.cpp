@@ -4,6 +4,7 @@
 #include "precomp.h"
 #include "Row.hpp"
 
+#include <til/scan.h>
 #include <til/unicode.h>
 
 #include "textBuffer.hpp"
@@ -68,6 +69,76 @@ constexpr OutIt copy_n_small(InIt first, Diff count, OutIt dest)
     return dest;
 }
 
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+
+// Returns the number of leading characters in [beg, beg + len) that are ASCII (< 0x80).
+// ASCII is always 1 column wide and 1 wchar_t long, which allows ROW::WriteHelper::ReplaceText()
+// to skip the code point iteration and width lookup for the most common kind of output.
+static size_t countAsciiPrefix(const wchar_t* beg, const size_t len) noexcept
+{
+    auto it = beg;
+    const auto end = beg + len;
+
+#if defined(_M_X64) || defined(_M_IX86)
+    // SSE2 lacks unsigned 16-bit comparisons, but (ch & 0xff80) == 0 is equivalent to ch < 0x80.
+    const auto nonAscii = _mm_set1_epi16(static_cast<short>(0xff80));
+    const auto zero = _mm_setzero_si128();
+    for (; end - it >= 8; it += 8)
+    {
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, nonAscii), zero)) != 0xffff)
+        {
+            break;
+        }
+    }
+#elif defined(_M_ARM64)
+    for (; end - it >= 8; it += 8)
+    {
+        const auto v = vld1q_u16(reinterpret_cast<const uint16_t*>(it));
+        if (vmaxvq_u16(v) >= 0x80)
+        {
+            break;
+        }
+    }
+#endif
+
+    // The remainder, as well as the block with the first non-ASCII character in it.
+    for (; it != end && *it < 0x80; ++it)
+    {
+    }
+
+    return gsl::narrow_cast<size_t>(it - beg);
+}
+
+// Fills dest[0..count) with val, val + 1, ..., just like iota_n(), but 8 values at a time.
+static void iota_n_u16(uint16_t* dest, size_t count, uint16_t val) noexcept
+{
+#if defined(_M_X64) || defined(_M_IX86)
+    auto v = _mm_add_epi16(_mm_set1_epi16(static_cast<short>(val)), _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7));
+    const auto step = _mm_set1_epi16(8);
+    for (; count >= 8; count -= 8, dest += 8, val += 8)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), v);
+        v = _mm_add_epi16(v, step);
+    }
+#elif defined(_M_ARM64)
+    static constexpr uint16_t increments[8]{ 0, 1, 2, 3, 4, 5, 6, 7 };
+    auto v = vaddq_u16(vdupq_n_u16(val), vld1q_u16(&increments[0]));
+    const auto step = vdupq_n_u16(8);
+    for (; count >= 8; count -= 8, dest += 8, val += 8)
+    {
+        vst1q_u16(dest, v);
+        v = vaddq_u16(v, step);
+    }
+#endif
+
+    iota_n(dest, count, val);
+}
+
+#pragma warning(pop)
+
 // Routine Description:
 // - constructor
 // Arguments:
@@ -80,7 +151,8 @@ ROW::ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, c
     _chars{ charsBuffer, rowWidth },
     _charOffsets{ charOffsetsBuffer, ::base::strict_cast<size_t>(rowWidth) + 1u },
     _attr{ rowWidth, fillAttribute },
-    _columnCount{ rowWidth }
+    _columnCount{ rowWidth },
+    _blinking{ fillAttribute.IsBlinking() }
 {
     if (_chars.data())
     {
@@ -132,6 +204,7 @@ void ROW::Reset(const TextAttribute& attr)
     _lineRendition = LineRendition::SingleWidth;
     _wrapForced = false;
     _doubleBytePadded = false;
+    _blinking = attr.IsBlinking();
     _init();
 }
 
@@ -141,10 +214,32 @@ void ROW::_init() noexcept
     std::iota(_charOffsets.begin(), _charOffsets.end(), uint16_t{ 0 });
 }
 
+// Keeps _blinking up to date after attr was written into some of the cells.
+// Writing a blinking attribute can only add blinking cells, but anything
+// else may have overwritten the last of them, so we need to look again.
+void ROW::_attributesWritten(const TextAttribute& attr) noexcept
+{
+    if (attr.IsBlinking())
+    {
+        _blinking = true;
+    }
+    else if (_blinking)
+    {
+        _blinking = _hasBlinkingRun();
+    }
+}
+
+bool ROW::_hasBlinkingRun() const noexcept
+{
+    const auto& runs = _attr.runs();
+    return std::any_of(runs.begin(), runs.end(), [](const auto& run) noexcept { return run.value.IsBlinking(); });
+}
+
 void ROW::TransferAttributes(const til::small_rle<TextAttribute, uint16_t, 1>& attr, til::CoordType newWidth)
 {
     _attr = attr;
     _attr.resize_trailing_extent(gsl::narrow<uint16_t>(newWidth));
+    _blinking = _hasBlinkingRun();
 }
 
 // Returns the previous possible cursor position, preceding the given column.
@@ -231,6 +326,7 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
                 // Otherwise, commit this color into the run and save off the new one.
                 // Now commit the new color runs into the attr row.
                 _attr.replace(colorStarts, currentIndex, currentColor);
+                _attributesWritten(currentColor);
                 currentColor = it->TextAttr();
                 colorUses = 1;
                 colorStarts = currentIndex;
@@ -311,6 +407,7 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
     if (colorUses)
     {
         _attr.replace(colorStarts, currentIndex, currentColor);
+        _attributesWritten(currentColor);
     }
 
     return it;
@@ -319,12 +416,14 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
 bool ROW::SetAttrToEnd(const til::CoordType columnBegin, const TextAttribute attr)
 {
     _attr.replace(_clampedColumnInclusive(columnBegin), _attr.size(), attr);
+    _attributesWritten(attr);
     return true;
 }
 
 void ROW::ReplaceAttributes(const til::CoordType beginIndex, const til::CoordType endIndex, const TextAttribute& newAttr)
 {
     _attr.replace(_clampedColumnInclusive(beginIndex), _clampedColumnInclusive(endIndex), newAttr);
+    _attributesWritten(newAttr);
 }
 
 [[msvc::forceinline]] ROW::WriteHelper::WriteHelper(ROW& row, til::CoordType columnBegin, til::CoordType columnLimit, const std::wstring_view& chars) noexcept :
@@ -422,7 +521,28 @@ catch (...)
 {
     size_t ch = chBeg;
 
-    for (const auto& s : til::utf16_iterator{ chars })
+    // Fast path: Most text is ASCII. Each character is exactly 1 column wide and so its
+    // char offset is simply the one of the previous character + 1. Any wide glyph we might
+    // overwrite at the edges of the written range is handled by the constructor and Finish().
+    {
+        const auto ascii = countAsciiPrefix(chars.data(), std::min<size_t>(chars.size(), colLimit - colEnd));
+        if (ascii)
+        {
+            iota_n_u16(&til::at(row._charOffsets, colEnd), ascii, chBeg);
+            colEnd = gsl::narrow_cast<uint16_t>(colEnd + ascii);
+            colEndDirty = colEnd;
+            ch += ascii;
+
+            if (ascii == chars.size())
+            {
+                charsConsumed = ascii;
+                return;
+            }
+        }
+    }
+
+    // Slow path: Everything after the first non-ASCII character (if it still fits).
+    for (const auto& s : til::utf16_iterator{ chars.substr(ch - chBeg) })
     {
         const auto wide = til::at(s, 0) < 0x80 ? false : IsGlyphFullWidth(s);
         const auto colEndNew = gsl::narrow_cast<uint16_t>(colEnd + 1u + wide);
@@ -634,6 +754,38 @@ std::vector<uint16_t> ROW::GetHyperlinks() const
     return ids;
 }
 
+bool ROW::ContainsBlinkingCells() const noexcept
+{
+    return _blinking;
+}
+
+// Returns the [begin, end) range of columns that spans all cells with the blink attribute.
+// The range is empty if there aren't any.
+std::pair<til::CoordType, til::CoordType> ROW::GetBlinkingColumns() const noexcept
+{
+    til::CoordType begin = 0;
+    til::CoordType end = 0;
+
+    if (_blinking)
+    {
+        til::CoordType column = 0;
+        auto found = false;
+        for (const auto& run : _attr.runs())
+        {
+            const auto next = column + run.length;
+            if (run.value.IsBlinking())
+            {
+                begin = found ? begin : column;
+                end = next;
+                found = true;
+            }
+            column = next;
+        }
+    }
+
+    return { begin, end };
+}
+
 uint16_t ROW::size() const noexcept
 {
     return _columnCount;
@@ -648,43 +800,23 @@ til::CoordType ROW::LineRenditionColumns() const noexcept
 til::CoordType ROW::MeasureLeft() const noexcept
 {
     const auto text = GetText();
-    const auto beg = text.begin();
-    const auto end = text.end();
-    auto it = beg;
-
-    for (; it != end; ++it)
-    {
-        if (*it != L' ')
-        {
-            break;
-        }
-    }
-
-    return gsl::narrow_cast<til::CoordType>(it - beg);
+    const auto offset = til::scan::find_first_not_of(text, L' ');
+    return gsl::narrow_cast<til::CoordType>(offset == til::scan::npos ? text.size() : offset);
 }
 
 til::CoordType ROW::MeasureRight() const noexcept
 {
     const auto text = GetText();
-    const auto beg = text.begin();
-    const auto end = text.end();
-    auto it = end;
-
-    for (; it != beg; --it)
-    {
-        // it[-1] is safe as `it` is always greater than `beg` (loop invariant).
-        if (til::at(it, -1) != L' ')
-        {
-            break;
-        }
-    }
+    const auto last = til::scan::find_last_not_of(text, L' ');
+    // The number of trailing spaces. (npos + 1 wraps around to 0.)
+    const auto trailing = text.size() - (last + 1);
 
     // We're supposed to return the measurement in cells and not characters
-    // and therefore simply calculating `it - beg` would be wrong.
+    // and therefore simply returning `last + 1` would be wrong.
     //
-    // An example: The row is 10 cells wide and `it` points to the second character.
-    // `it - beg` would return 1, but it's possible it's actually 1 wide glyph and 8 whitespace.
-    return gsl::narrow_cast<til::CoordType>(_columnCount - (end - it));
+    // An example: The row is 10 cells wide and `last` is 0.
+    // `last + 1` would return 1, but it's possible it's actually 1 wide glyph and 8 whitespace.
+    return gsl::narrow_cast<til::CoordType>(_columnCount - trailing);
 }
 
 bool ROW::ContainsText() const noexcept
@@ -746,23 +878,75 @@ std::wstring_view ROW::GetText() const noexcept
     return { _chars.data(), _charSize() };
 }
 
-DelimiterClass ROW::DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept
+// Routine Description:
+// - Returns the text of the glyphs that begin in the range [columnBegin, columnEnd).
+//   The trailing half of a wide glyph contributes nothing, while a wide glyph whose
+//   leading half is the last column of the range is included in its entirety.
+// Arguments:
+// - columnBegin, columnEnd - the range of columns. They're clamped to the row.
+// Return Value:
+// - A view into the row's text without any copies.
+std::wstring_view ROW::GetText(til::CoordType columnBegin, til::CoordType columnEnd) const noexcept
 {
-    const auto col = _clampedColumn(column);
-    // Safety: col is [0, _columnCount).
-    const auto glyph = _uncheckedChar(_uncheckedCharOffset(col));
+    const auto colBeg = _adjustForward(_clampedColumnInclusive(columnBegin));
+    const auto colEnd = std::max(colBeg, _adjustForward(_clampedColumnInclusive(columnEnd)));
+    // Safety: colBeg and colEnd are [0, _columnCount].
+    const auto chBeg = _uncheckedCharOffset(colBeg);
+    const auto chEnd = _uncheckedCharOffset(colEnd);
+    return { _chars.begin() + chBeg, _chars.begin() + chEnd };
+}
+
+RowMemoryUsage ROW::GetMemoryUsage() const noexcept
+{
+    RowMemoryUsage usage;
 
-    if (glyph <= L' ')
+    if (_charsHeap)
     {
-        return DelimiterClass::ControlChar;
+        // _chars.size() is the capacity of _charsHeap. See the comment on _chars.
+        usage.charsHeapUsed = _charSize() * sizeof(wchar_t);
+        usage.charsHeapCapacity = _chars.size() * sizeof(wchar_t);
     }
-    else if (wordDelimiters.find(glyph) != std::wstring_view::npos)
+
+    // small_vector only allocates once its capacity exceeds the inline capacity.
+    const auto& runs = _attr.runs();
+    if (runs.capacity() > 1)
     {
-        return DelimiterClass::DelimiterChar;
+        using Run = std::remove_cvref_t<decltype(runs)>::value_type;
+        usage.attributesUsed = runs.size() * sizeof(Run);
+        usage.attributesCapacity = runs.capacity() * sizeof(Run);
     }
-    else
+
+    return usage;
+}
+
+DelimiterClass ROW::DelimiterClassAt(til::CoordType column, const DelimiterClassifier& classifier) const noexcept
+{
+    const auto col = _clampedColumn(column);
+    // Safety: col is [0, _columnCount).
+    return classifier.Classify(_uncheckedChar(_uncheckedCharOffset(col)));
+}
+
+// Routine Description:
+// - Classifies the cells in the range [columnBegin, columnEnd) in a single pass.
+//   Word navigation uses this to find the boundaries of runs of the same class
+//   without looking up every cell individually.
+// Arguments:
+// - columnBegin, columnEnd - the range of columns. They're clamped to the row.
+// - classifier - built from the user's word delimiters
+// - classes - receives one DelimiterClass per column, starting at columnBegin
+void ROW::ClassifyDelimiters(til::CoordType columnBegin, til::CoordType columnEnd, const DelimiterClassifier& classifier, std::vector<DelimiterClass>& classes) const
+{
+    const auto colBeg = _clampedColumnInclusive(columnBegin);
+    const auto colEnd = std::max(colBeg, _clampedColumnInclusive(columnEnd));
+
+    classes.resize(colEnd - colBeg);
+    auto out = classes.data();
+
+    // The trailing half of a wide glyph refers to the same char offset as its leading half
+    // (minus the CharOffsetsTrailer flag), so both halves get the class of the glyph.
+    for (auto col = colBeg; col < colEnd; ++col)
     {
-        return DelimiterClass::RegularChar;
+        *out++ = classifier.Classify(_uncheckedChar(_uncheckedCharOffset(col)));
     }
 }
 
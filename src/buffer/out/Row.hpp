@@ -22,19 +22,13 @@ Revision History:
 
 #include <til/rle.h>
 
+#include "DelimiterClassifier.hpp"
 #include "LineRendition.hpp"
 #include "OutputCell.hpp"
 #include "OutputCellIterator.hpp"
 
 class TextBuffer;
 
-enum class DelimiterClass
-{
-    ControlChar,
-    DelimiterChar,
-    RegularChar
-};
-
 struct RowWriteState
 {
     // The text you want to write into the given ROW. When ReplaceText() returns,
@@ -57,6 +51,18 @@ struct RowWriteState
     til::CoordType columnEndDirty = 0; // OUT
 };
 
+// The heap memory a ROW owns in addition to the storage its TextBuffer provides for it.
+// Inline storage, like the first attribute run, is part of sizeof(ROW) and not counted here.
+struct RowMemoryUsage
+{
+    // ROW::_charsHeap, which is allocated when the text doesn't fit into the TextBuffer's storage anymore.
+    size_t charsHeapUsed = 0;
+    size_t charsHeapCapacity = 0;
+    // The attribute runs that don't fit into ROW::_attr inline.
+    size_t attributesUsed = 0;
+    size_t attributesCapacity = 0;
+};
+
 class ROW final
 {
 public:
@@ -94,6 +100,9 @@ public:
     const til::small_rle<TextAttribute, uint16_t, 1>& Attributes() const noexcept;
     TextAttribute GetAttrByColumn(til::CoordType column) const;
     std::vector<uint16_t> GetHyperlinks() const;
+    RowMemoryUsage GetMemoryUsage() const noexcept;
+    bool ContainsBlinkingCells() const noexcept;
+    std::pair<til::CoordType, til::CoordType> GetBlinkingColumns() const noexcept;
     uint16_t size() const noexcept;
     til::CoordType LineRenditionColumns() const noexcept;
     til::CoordType MeasureLeft() const noexcept;
@@ -102,7 +111,9 @@ public:
     std::wstring_view GlyphAt(til::CoordType column) const noexcept;
     DbcsAttribute DbcsAttrAt(til::CoordType column) const noexcept;
     std::wstring_view GetText() const noexcept;
-    DelimiterClass DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept;
+    std::wstring_view GetText(til::CoordType columnBegin, til::CoordType columnEnd) const noexcept;
+    DelimiterClass DelimiterClassAt(til::CoordType column, const DelimiterClassifier& classifier) const noexcept;
+    void ClassifyDelimiters(til::CoordType columnBegin, til::CoordType columnEnd, const DelimiterClassifier& classifier, std::vector<DelimiterClass>& classes) const;
 
     auto AttrBegin() const noexcept { return _attr.begin(); }
     auto AttrEnd() const noexcept { return _attr.end(); }
@@ -179,6 +190,8 @@ private:
     bool _uncheckedIsTrailer(size_t col) const noexcept;
 
     void _init() noexcept;
+    void _attributesWritten(const TextAttribute& attr) noexcept;
+    bool _hasBlinkingRun() const noexcept;
     void _resizeChars(uint16_t colEndDirty, uint16_t chBegDirty, size_t chEndDirty, uint16_t chEndDirtyOld);
 
     // These fields are a bit "wasteful", but it makes all this a bit more robust against
@@ -232,6 +245,9 @@ private:
     bool _wrapForced = false;
     // Occurs when the user runs out of text to support a double byte character and we're forced to the next line
     bool _doubleBytePadded = false;
+    // Whether any of the _attr runs has the blink attribute. Kept up to date whenever _attr
+    // is written, so that the blink timer only needs to redraw the rows that actually blink.
+    bool _blinking = false;
 };
 
 #ifdef UNIT_TESTING
@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "ScrollbackSpill.hpp"
+
+std::unique_ptr<ScrollbackSpill> ScrollbackSpill::TryCreate(size_t rowStride, size_t rowCount) noexcept
+{
+    if constexpr (!Feature_ScrollbackSpill::IsEnabled())
+    {
+        return nullptr;
+    }
+
+    if (rowCount < MinimumRows)
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        return std::make_unique<ScrollbackSpill>(rowStride, rowCount, DefaultResidentPages);
+    }
+    CATCH_LOG();
+    return nullptr;
+}
+
+ScrollbackSpill::ScrollbackSpill(size_t rowStride, size_t rowCount, size_t residentPages) :
+    _size{ gsl::narrow<size_t>(::base::strict_cast<uint64_t>(rowStride) * ::base::strict_cast<uint64_t>(rowCount)) },
+    _rowStride{ rowStride },
+    _residentBudget{ std::max<size_t>(residentPages, 1) }
+{
+    wchar_t directory[MAX_PATH + 1];
+    THROW_LAST_ERROR_IF(GetTempPathW(ARRAYSIZE(directory), &directory[0]) == 0);
+    wchar_t path[MAX_PATH + 1];
+    THROW_LAST_ERROR_IF(GetTempFileNameW(&directory[0], L"wts", 0, &path[0]) == 0);
+
+    // FILE_ATTRIBUTE_TEMPORARY keeps the file in the cache manager for as long as there's
+    // enough memory and FILE_FLAG_DELETE_ON_CLOSE ensures it's gone once we are.
+    _file.reset(CreateFileW(&path[0], GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr));
+    THROW_LAST_ERROR_IF(!_file);
+
+    // The mapping extends the file to _size bytes, which are guaranteed to be zero,
+    // just like the VirtualAlloc() memory TextBuffer uses otherwise.
+    const auto size = ::base::strict_cast<uint64_t>(_size);
+    _mapping.reset(CreateFileMappingW(_file.get(), nullptr, PAGE_READWRITE, gsl::narrow_cast<DWORD>(size >> 32), gsl::narrow_cast<DWORD>(size), nullptr));
+    THROW_LAST_ERROR_IF(!_mapping);
+
+    _view.reset(static_cast<std::byte*>(MapViewOfFile(_mapping.get(), FILE_MAP_WRITE, 0, 0, _size)));
+    THROW_LAST_ERROR_IF(!_view);
+
+    _pages.resize((_size + PageSize - 1) / PageSize);
+}
+
+std::byte* ScrollbackSpill::Data() const noexcept
+{
+    return _view.get();
+}
+
+size_t ScrollbackSpill::Size() const noexcept
+{
+    return _size;
+}
+
+size_t ScrollbackSpill::PageCount() const noexcept
+{
+    return _pages.size();
+}
+
+size_t ScrollbackSpill::ResidentPageCount() const noexcept
+{
+    return _residentCount;
+}
+
+bool ScrollbackSpill::IsPageResident(size_t page) const noexcept
+{
+    return page < _pages.size() && til::at(_pages, page).resident;
+}
+
+void ScrollbackSpill::Touch(size_t rowBegin, size_t rowEnd) noexcept
+{
+    if (rowBegin >= rowEnd || _pages.empty())
+    {
+        return;
+    }
+
+    const auto beg = rowBegin * _rowStride / PageSize;
+    const auto end = std::min((rowEnd * _rowStride - 1) / PageSize + 1, _pages.size());
+
+    // Touching the most recently used page again is by far the most common case (new lines are
+    // written one after another), so it's handled without touching the list at all.
+    if (end - beg == 1 && _head == beg)
+    {
+        return;
+    }
+
+    for (auto page = beg; page < end; ++page)
+    {
+        _touchPage(gsl::narrow_cast<uint32_t>(page));
+    }
+
+    while (_residentCount > _residentBudget)
+    {
+        _evictLeastRecentlyUsed();
+    }
+}
+
+void ScrollbackSpill::Trim() noexcept
+{
+    for (auto& p : _pages)
+    {
+        p = {};
+    }
+    _head = npos;
+    _tail = npos;
+    _residentCount = 0;
+
+    // See _evictLeastRecentlyUsed().
+    VirtualUnlock(_view.get(), _size);
+}
+
+void ScrollbackSpill::_touchPage(uint32_t page) noexcept
+{
+    auto& p = til::at(_pages, page);
+
+    if (p.resident)
+    {
+        if (_head == page)
+        {
+            return;
+        }
+        _unlink(page);
+    }
+    else
+    {
+        p.resident = true;
+        _residentCount++;
+    }
+
+    p.prev = npos;
+    p.next = _head;
+    if (_head != npos)
+    {
+        til::at(_pages, _head).prev = page;
+    }
+    _head = page;
+    if (_tail == npos)
+    {
+        _tail = page;
+    }
+}
+
+void ScrollbackSpill::_unlink(uint32_t page) noexcept
+{
+    auto& p = til::at(_pages, page);
+
+    if (p.prev != npos)
+    {
+        til::at(_pages, p.prev).next = p.next;
+    }
+    else
+    {
+        _head = p.next;
+    }
+
+    if (p.next != npos)
+    {
+        til::at(_pages, p.next).prev = p.prev;
+    }
+    else
+    {
+        _tail = p.prev;
+    }
+
+    p.prev = npos;
+    p.next = npos;
+}
+
+void ScrollbackSpill::_evictLeastRecentlyUsed() noexcept
+{
+    const auto page = _tail;
+    if (page == npos)
+    {
+        return;
+    }
+
+    _unlink(page);
+    til::at(_pages, page).resident = false;
+    _residentCount--;
+
+    // Calling VirtualUnlock() on memory that isn't locked removes it from the working set.
+    // It fails with ERROR_NOT_LOCKED in that case, which is expected. Since the memory is
+    // backed by our file (and not the pagefile), dirty pages are written back to it.
+    const auto offset = static_cast<size_t>(page) * PageSize;
+    const auto length = std::min(PageSize, _size - offset);
+    VirtualUnlock(_view.get() + offset, length);
+}
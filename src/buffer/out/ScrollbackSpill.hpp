@@ -0,0 +1,86 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ScrollbackSpill.hpp
+
+Abstract:
+- A cold tier for the character storage of very large text buffers.
+- Instead of committing pagefile backed memory via VirtualAlloc, the ROW
+  character and offset arrays are placed in a mapping of a temporary file.
+  The buffer is split into fixed size pages, which are tracked in a page
+  table with an LRU list. Once more than the budgeted number of pages were
+  touched recently, the least recently used ones are trimmed from our working
+  set. Their contents are written back to the file by the memory manager and
+  faulted back in transparently whenever a ROW is read again (search,
+  selection, scrolling into the history, ...). This way ROW pointers
+  stay valid and no code path needs to know whether a row is resident.
+- Only the character storage is spilled. ROW attributes are run-length
+  encoded and usually tiny, so they stay on the heap.
+--*/
+
+#pragma once
+
+class ScrollbackSpill final
+{
+public:
+    // Buffers with fewer rows than this always use regular memory.
+    static constexpr size_t MinimumRows = 8192;
+    // The unit of eviction. It's the allocation granularity on all
+    // current architectures and so the smallest unit that's worth tracking.
+    static constexpr size_t PageSize = 64 * 1024;
+    // How many pages may stay resident: 4 MiB worth of rows.
+    static constexpr size_t DefaultResidentPages = 64;
+
+    // Returns a spill for a buffer of the given geometry, or nullptr if the buffer
+    // is too small to benefit from it, the feature is disabled, or creating the
+    // backing file failed. In the latter case the caller should use regular memory.
+    static std::unique_ptr<ScrollbackSpill> TryCreate(size_t rowStride, size_t rowCount) noexcept;
+
+    ScrollbackSpill(size_t rowStride, size_t rowCount, size_t residentPages);
+
+    ScrollbackSpill(const ScrollbackSpill&) = delete;
+    ScrollbackSpill& operator=(const ScrollbackSpill&) = delete;
+
+    std::byte* Data() const noexcept;
+    size_t Size() const noexcept;
+
+    // Marks the rows [rowBegin, rowEnd) (indices into the TextBuffer storage,
+    // not logical rows) as recently used and evicts pages beyond the budget.
+    void Touch(size_t rowBegin, size_t rowEnd) noexcept;
+    // Evicts all pages, for instance after the entire buffer was rewritten during a resize.
+    void Trim() noexcept;
+
+    size_t PageCount() const noexcept;
+    size_t ResidentPageCount() const noexcept;
+    bool IsPageResident(size_t page) const noexcept;
+
+private:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    struct Page
+    {
+        uint32_t prev = npos;
+        uint32_t next = npos;
+        bool resident = false;
+    };
+
+    void _touchPage(uint32_t page) noexcept;
+    void _unlink(uint32_t page) noexcept;
+    void _evictLeastRecentlyUsed() noexcept;
+
+    wil::unique_hfile _file;
+    wil::unique_handle _mapping;
+    wil::unique_mapview_ptr<std::byte> _view;
+    size_t _size = 0;
+    size_t _rowStride = 0;
+    size_t _residentBudget = 0;
+
+    // The page table. _pages[i] describes the bytes [i * PageSize, (i + 1) * PageSize).
+    // Resident pages form a doubly linked list from most (_head) to least (_tail) recently used.
+    std::vector<Page> _pages;
+    uint32_t _head = npos;
+    uint32_t _tail = npos;
+    size_t _residentCount = 0;
+};
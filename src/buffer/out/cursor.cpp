@@ -286,6 +286,32 @@ void Cursor::CopyProperties(const Cursor& OtherCursor) noexcept
     _cursorType = OtherCursor._cursorType;
 }
 
+// Routine Description:
+// - Returns all properties to the values a newly constructed cursor has.
+// - This is used when a text buffer is reused instead of being created anew.
+// Arguments:
+// - ulSize - The height of the cursor within this buffer
+// Return Value:
+// - <none>
+void Cursor::Reset(const ULONG ulSize) noexcept
+{
+    _cPosition = {};
+    _fHasMoved = false;
+    _fIsVisible = true;
+    _fIsOn = true;
+    _fIsDouble = false;
+    _fBlinkingAllowed = true;
+    _fDelay = false;
+    _fIsConversionArea = false;
+    _fIsPopupShown = false;
+    _fDelayedEolWrap = false;
+    _coordDelayedAt = {};
+    _fDeferCursorRedraw = false;
+    _fHaveDeferredCursorRedraw = false;
+    _ulSize = ulSize;
+    _cursorType = CursorType::Legacy;
+}
+
 void Cursor::DelayEOLWrap() noexcept
 {
     _coordDelayedAt = _cPosition;
@@ -75,6 +75,7 @@ public:
     void DecrementYPosition(const til::CoordType DeltaY) noexcept;
 
     void CopyProperties(const Cursor& OtherCursor) noexcept;
+    void Reset(const ULONG ulSize) noexcept;
 
     void DelayEOLWrap() noexcept;
     void ResetDelayEOLWrap() noexcept;
@@ -88,7 +89,7 @@ private:
 
     //TODO: separate the rendering and text placement
 
-    // NOTE: If you are adding a property here, go add it to CopyProperties.
+    // NOTE: If you are adding a property here, go add it to CopyProperties and Reset.
 
     til::point _cPosition; // current position on screen (in screen buffer coords).
 
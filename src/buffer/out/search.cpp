@@ -5,6 +5,7 @@
 
 #include "search.h"
 
+#include <til/scan.h>
 #include <til/unicode.h>
 
 #include "textBuffer.hpp"
@@ -79,6 +80,8 @@ bool Search::FindNext()
     {
         if (_FindNeedleInHaystackAt(_coordNext, _coordSelStart, _coordSelEnd))
         {
+            // The match is about to be selected and scrolled into view.
+            _renderData.GetTextBuffer().TouchRows(_coordSelStart.y, _coordSelEnd.y);
             _UpdateNextPosition();
             _reachedEnd = _coordNext == _coordAnchor;
             return true;
@@ -227,40 +230,12 @@ bool Search::_FindNeedleInHaystackAt(const til::point pos, til::point& start, ti
 // Return Value:
 // - True if they are the same. False otherwise.
 bool Search::_CompareChars(const std::wstring_view one, const std::wstring_view two) const noexcept
-{
-    if (one.size() != two.size())
-    {
-        return false;
-    }
-
-    for (size_t i = 0; i < one.size(); i++)
-    {
-        if (_ApplySensitivity(one.at(i)) != _ApplySensitivity(two.at(i)))
-        {
-            return false;
-        }
-    }
-
-    return true;
-}
-
-// Routine Description:
-// - Provides an abstraction for conditionally applying case sensitivity
-//   based on object construction
-// Arguments:
-// - wch - Character to adjust if necessary
-// Return Value:
-// - Adjusted value (or not).
-wchar_t Search::_ApplySensitivity(const wchar_t wch) const noexcept
 {
     if (_sensitivity == Sensitivity::CaseInsensitive)
     {
-        return ::towlower(wch);
-    }
-    else
-    {
-        return wch;
+        return til::scan::equals_ignore_case(one, two);
     }
+    return one == two;
 }
 
 // Routine Description:
@@ -57,7 +57,6 @@ public:
     std::pair<til::point, til::point> GetFoundLocation() const noexcept;
 
 private:
-    wchar_t _ApplySensitivity(const wchar_t wch) const noexcept;
     bool _FindNeedleInHaystackAt(const til::point pos, til::point& start, til::point& end) const;
     bool _CompareChars(const std::wstring_view one, const std::wstring_view two) const noexcept;
     void _UpdateNextPosition();
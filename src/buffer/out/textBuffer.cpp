@@ -42,7 +42,7 @@ TextBuffer::TextBuffer(til::size screenBufferSize,
     // Guard against resizing the text buffer to 0 columns/rows, which would break being able to insert text.
     screenBufferSize.width = std::max(screenBufferSize.width, 1);
     screenBufferSize.height = std::max(screenBufferSize.height, 1);
-    _charBuffer = _allocateBuffer(screenBufferSize, _currentAttributes, _storage);
+    _charBuffer = _allocateBuffer(screenBufferSize, _currentAttributes, _storage, _spill);
     _UpdateSize();
 }
 
@@ -69,6 +69,137 @@ til::CoordType TextBuffer::TotalRowCount() const noexcept
     return gsl::narrow_cast<til::CoordType>(_storage.size());
 }
 
+// Routine Description:
+// - Informs the buffer that the given rows are about to be accessed, for instance
+//   because the user scrolled into them or they're being searched or copied.
+// - This only matters for buffers with a ScrollbackSpill, which uses it to decide
+//   which parts of the history may be evicted from memory. Rows are always readable,
+//   even if they weren't touched beforehand. It's const, because it only updates
+//   the bookkeeping of the spill and not the contents of the buffer.
+// Arguments:
+// - firstRow - The first row (inclusive), relative to the top of the buffer.
+// - lastRow - The last row (inclusive), relative to the top of the buffer.
+void TextBuffer::TouchRows(const til::CoordType firstRow, const til::CoordType lastRow) const noexcept
+{
+    if (!_spill)
+    {
+        return;
+    }
+
+    const auto height = _storage.size();
+    const auto first = gsl::narrow_cast<size_t>(std::clamp(firstRow, 0, TotalRowCount() - 1));
+    const auto last = gsl::narrow_cast<size_t>(std::clamp(lastRow, 0, TotalRowCount() - 1));
+    if (first > last)
+    {
+        return;
+    }
+
+    // The logical range may wrap around the end of the circular storage.
+    const auto beg = (gsl::narrow_cast<size_t>(_firstRow) + first) % height;
+    const auto count = last - first + 1;
+    const auto end = beg + count;
+    if (end <= height)
+    {
+        _spill->Touch(beg, end);
+    }
+    else
+    {
+        _spill->Touch(beg, height);
+        _spill->Touch(0, end - height);
+    }
+}
+
+const ScrollbackSpill* TextBuffer::GetScrollbackSpill() const noexcept
+{
+    return _spill.get();
+}
+
+// The STL allocates a node for every element of an unordered_map, which holds the key-value pair
+// and the pointers of the list it's linked into. The bucket array stores 2 pointers per bucket.
+template<typename Map>
+static void _addMapUsage(TextBuffer::MemoryUsage& usage, const Map& map) noexcept
+{
+    usage.used += map.size() * sizeof(typename Map::value_type);
+    usage.capacity += map.size() * (sizeof(typename Map::value_type) + 2 * sizeof(void*));
+    usage.capacity += map.bucket_count() * 2 * sizeof(void*);
+}
+
+// Strings only allocate if they're too long for the small string optimization.
+static void _addStringUsage(TextBuffer::MemoryUsage& usage, const std::wstring& str) noexcept
+{
+    static const auto inlineCapacity = std::wstring{}.capacity();
+    usage.used += str.size() * sizeof(wchar_t);
+    if (str.capacity() > inlineCapacity)
+    {
+        usage.capacity += (str.capacity() + 1) * sizeof(wchar_t);
+    }
+}
+
+size_t TextBuffer::MemoryReport::Total() const noexcept
+{
+    return charBufferResident + charsHeap.capacity + rows.capacity + attributes.capacity + hyperlinks.capacity + patterns.capacity + cursor;
+}
+
+// Routine Description:
+// - Reports how much memory this buffer uses, and for what. The rows are visited once,
+//   but their text isn't read, so this is cheap enough to be polled for diagnostics
+//   and doesn't fault in rows that spilled into a file.
+// Return Value:
+// - The memory report. See MemoryReport.
+TextBuffer::MemoryReport TextBuffer::GetMemoryReport() const noexcept
+{
+    MemoryReport report;
+
+    const auto rowCount = _storage.size();
+    const auto rowStride = rowCount ? _getRowStride(_storage.front().size()) : 0;
+    const auto rowsInUse = std::min(rowCount, gsl::narrow_cast<size_t>(std::max(0, _cursor.GetPosition().y + 1)));
+
+    report.charBuffer.capacity = rowCount * rowStride;
+    report.charBuffer.used = rowsInUse * rowStride;
+    report.charBufferResident = report.charBuffer.capacity;
+    if (_spill)
+    {
+        report.charBufferResident = std::min(report.charBufferResident, _spill->ResidentPageCount() * ScrollbackSpill::PageSize);
+    }
+
+    report.rows.used = rowCount * sizeof(ROW);
+    report.rows.capacity = _storage.capacity() * sizeof(ROW);
+
+    for (const auto& row : _storage)
+    {
+        const auto usage = row.GetMemoryUsage();
+        report.charsHeap.used += usage.charsHeapUsed;
+        report.charsHeap.capacity += usage.charsHeapCapacity;
+        if (usage.charsHeapCapacity)
+        {
+            report.rowsWithCharsHeap++;
+        }
+        report.attributes.used += usage.attributesUsed;
+        report.attributes.capacity += usage.attributesCapacity;
+    }
+
+    _addMapUsage(report.hyperlinks, _hyperlinkMap);
+    for (const auto& [id, uri] : _hyperlinkMap)
+    {
+        _addStringUsage(report.hyperlinks, uri);
+    }
+    _addMapUsage(report.hyperlinks, _hyperlinkCustomIdMap);
+    for (const auto& [customId, id] : _hyperlinkCustomIdMap)
+    {
+        _addStringUsage(report.hyperlinks, customId);
+    }
+
+    _addMapUsage(report.patterns, _idsAndPatterns);
+    for (const auto& [id, pattern] : _idsAndPatterns)
+    {
+        _addStringUsage(report.patterns, pattern);
+    }
+
+    report.cursor = sizeof(Cursor);
+
+    return report;
+}
+
 // Routine Description:
 // - Retrieves a row from the buffer by its offset from the first row of the text buffer (what corresponds to
 // the top row of the screen buffer)
@@ -175,6 +306,31 @@ TextBufferCellIterator TextBuffer::GetCellDataAt(const til::point at, const View
     return TextBufferCellIterator(*this, at, limit);
 }
 
+// Routine Description:
+// - Retrieves a read-only iterator over the spans of text with the same attributes,
+//   starting at the given buffer location until the end of the buffer.
+// Arguments:
+// - at - X,Y position in buffer for iterator start position
+// Return Value:
+// - Read-only iterator of row spans.
+TextBufferRowSpanIterator TextBuffer::GetRowSpansAt(const til::point at) const
+{
+    return TextBufferRowSpanIterator(*this, at);
+}
+
+// Routine Description:
+// - Retrieves a read-only iterator over the spans of text with the same attributes,
+//   starting at the given buffer location but restricted to the given viewport.
+// Arguments:
+// - at - X,Y position in buffer for iterator start position
+// - limit - boundaries for the iterator to operate within
+// Return Value:
+// - Read-only iterator of row spans.
+TextBufferRowSpanIterator TextBuffer::GetRowSpansAt(const til::point at, const Viewport limit) const
+{
+    return TextBufferRowSpanIterator(*this, at, limit);
+}
+
 //Routine Description:
 // - Corrects and enforces consistent double byte character state (KAttrs line) within a row of the text buffer.
 // - This will take the given double byte information and check that it will be consistent when inserted into the buffer
@@ -573,14 +729,24 @@ bool TextBuffer::NewlineCursor()
 //Return Value:
 // - true if we successfully incremented the buffer.
 bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
+{
+    TriggerCircling();
+    IncrementCircularBufferWithoutFlush(inVtMode);
+    return true;
+}
+
+//Routine Description:
+// - Increments the circular buffer by one, without flushing the renderer first.
+//   This allows the adapter to rotate the buffer many times in a row and to
+//   notify the renderer only once, via TriggerCircling() and TriggerScroll().
+//Arguments:
+// - inVtMode - set to true in VT mode, so standard erase attributes are used for the new row.
+//Return Value:
+// - <none>
+void TextBuffer::IncrementCircularBufferWithoutFlush(const bool inVtMode)
 {
     // FirstRow is at any given point in time the array index in the circular buffer that corresponds
     // to the logical position 0 in the window (cursor coordinates and all other coordinates).
-    if (_isActiveBuffer)
-    {
-        _renderer.TriggerFlush(true);
-    }
-
     // Prune hyperlinks to delete obsolete references
     _PruneHyperlinks();
 
@@ -593,6 +759,10 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
         fillAttributes.SetStandardErase();
     }
     GetRowByOffset(0).Reset(fillAttributes);
+    if (_spill)
+    {
+        _spill->Touch(gsl::narrow_cast<size_t>(_firstRow), gsl::narrow_cast<size_t>(_firstRow) + 1);
+    }
     {
         // Now proceed to increment.
         // Incrementing it will cause the next line down to become the new "top" of the window (the new "0" in logical coordinates)
@@ -604,7 +774,6 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
             _firstRow = 0;
         }
     }
-    return true;
 }
 
 //Routine Description:
@@ -693,24 +862,48 @@ const Viewport TextBuffer::GetSize() const noexcept
     return _size;
 }
 
-wil::unique_virtualalloc_ptr<std::byte> TextBuffer::_allocateBuffer(til::size sz, const TextAttribute& attributes, std::vector<ROW>& rows)
+// Routine Description:
+// - Returns the number of bytes of character storage each row of the given width needs.
+size_t TextBuffer::_getRowStride(const uint16_t width) noexcept
+{
+    const auto charsBytes = width * sizeof(wchar_t);
+    // The ROW::_indices array stores 1 more item than the buffer is wide.
+    // That extra column stores the past-the-end _chars pointer.
+    const auto indicesBytes = width * sizeof(uint16_t) + sizeof(uint16_t);
+    return charsBytes + indicesBytes;
+}
+
+// Routine Description:
+// - Allocates the character storage for a buffer of the given size and initializes the given rows.
+// - Very large buffers are backed by a ScrollbackSpill (returned via `spill`) and nullptr
+//   is returned. Otherwise the storage is committed memory and `spill` is reset.
+wil::unique_virtualalloc_ptr<std::byte> TextBuffer::_allocateBuffer(til::size sz, const TextAttribute& attributes, std::vector<ROW>& rows, std::unique_ptr<ScrollbackSpill>& spill)
 {
     const auto w = gsl::narrow<uint16_t>(sz.width);
     const auto h = gsl::narrow<uint16_t>(sz.height);
 
     const auto charsBytes = w * sizeof(wchar_t);
-    // The ROW::_indices array stores 1 more item than the buffer is wide.
-    // That extra column stores the past-the-end _chars pointer.
-    const auto indicesBytes = w * sizeof(uint16_t) + sizeof(uint16_t);
-    const auto rowStride = charsBytes + indicesBytes;
+    const auto rowStride = _getRowStride(w);
     // 65535*65535 cells would result in a charsAreaSize of 8GiB.
     // --> Use uint64_t so that we can safely do our calculations even on x86.
     const auto allocSize = gsl::narrow<size_t>(::base::strict_cast<uint64_t>(rowStride) * ::base::strict_cast<uint64_t>(h));
 
-    auto buffer = wil::unique_virtualalloc_ptr<std::byte>{ static_cast<std::byte*>(VirtualAlloc(nullptr, allocSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE)) };
-    THROW_IF_NULL_ALLOC(buffer);
+    wil::unique_virtualalloc_ptr<std::byte> buffer;
+    std::byte* base = nullptr;
 
-    auto data = std::span{ buffer.get(), allocSize }.begin();
+    spill = ScrollbackSpill::TryCreate(rowStride, h);
+    if (spill)
+    {
+        base = spill->Data();
+    }
+    else
+    {
+        buffer.reset(static_cast<std::byte*>(VirtualAlloc(nullptr, allocSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE)));
+        THROW_IF_NULL_ALLOC(buffer);
+        base = buffer.get();
+    }
+
+    auto data = std::span{ base, allocSize }.begin();
 
     rows.resize(h);
     for (auto& row : rows)
@@ -721,6 +914,12 @@ wil::unique_virtualalloc_ptr<std::byte> TextBuffer::_allocateBuffer(til::size sz
         data += rowStride;
     }
 
+    // Initializing the rows touched every page. None of them are in use yet.
+    if (spill)
+    {
+        spill->Trim();
+    }
+
     return buffer;
 }
 
@@ -936,6 +1135,30 @@ void TextBuffer::Reset()
     }
 }
 
+// Routine Description:
+// - Returns the buffer to the state a newly constructed one with the same size is in,
+//   but keeps the existing row storage. This is much cheaper than constructing a new
+//   buffer and is used for the alternate screen buffer, which applications like pagers
+//   and editors enter and leave over and over.
+// Arguments:
+// - defaultAttributes - The attributes the buffer is filled with.
+// - cursorSize - The height of the cursor.
+void TextBuffer::ResetToDefaults(const TextAttribute defaultAttributes, const UINT cursorSize)
+{
+    _currentAttributes = defaultAttributes;
+    _cursor.Reset(cursorSize);
+    _firstRow = 0;
+
+    _hyperlinkMap.clear();
+    _hyperlinkCustomIdMap.clear();
+    _currentHyperlinkId = 1;
+
+    _idsAndPatterns.clear();
+    _currentPatternId = 0;
+
+    Reset();
+}
+
 // Routine Description:
 // - This is the legacy screen resize with minimal changes
 // Arguments:
@@ -958,7 +1181,8 @@ void TextBuffer::Reset()
         const auto TopRowIndex = gsl::narrow_cast<size_t>(_firstRow + TopRow) % _storage.size();
 
         std::vector<ROW> newStorage;
-        auto newBuffer = _allocateBuffer(newSize, _currentAttributes, newStorage);
+        std::unique_ptr<ScrollbackSpill> newSpill;
+        auto newBuffer = _allocateBuffer(newSize, _currentAttributes, newStorage, newSpill);
 
         // This basically imitates a std::rotate_copy(first, mid, last), but uses ROW::CopyRangeFrom() to do the copying.
         {
@@ -995,8 +1219,14 @@ void TextBuffer::Reset()
         }
 
         _charBuffer = std::move(newBuffer);
+        _spill = std::move(newSpill);
         _storage = std::move(newStorage);
 
+        if (_spill)
+        {
+            _spill->Trim();
+        }
+
         _SetFirstRowIndex(0);
         _UpdateSize();
     }
@@ -1060,6 +1290,15 @@ void TextBuffer::TriggerScroll(const til::point delta)
     }
 }
 
+// Gives the renderer a chance to paint the rows that are about to be rotated out of the buffer.
+void TextBuffer::TriggerCircling()
+{
+    if (_isActiveBuffer)
+    {
+        _renderer.TriggerFlush(true);
+    }
+}
+
 void TextBuffer::TriggerNewTextNotification(const std::wstring_view newText)
 {
     if (_isActiveBuffer)
@@ -1080,30 +1319,108 @@ ROW& TextBuffer::_GetFirstRow() noexcept
 }
 
 // Method Description:
-// - get delimiter class for buffer cell position
+// - Moves pos backwards, across rows, while the class of the cell it's on is
+//   (or isn't) a RegularChar. Each row is classified once and searched for the
+//   end of the run, instead of looking up every cell individually.
 // - used for double click selection and uia word navigation
 // Arguments:
-// - pos: the buffer cell under observation
-// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// - pos - the buffer cell to start at. Receives the first cell that doesn't match.
+// - classifier - built from the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// - regular - whether to move across RegularChar cells or across all others
+// Return Value:
+// - false if the buffer origin was reached before a cell that doesn't match.
+//   pos is the origin in that case.
+bool TextBuffer::_MoveBackwardWhileRegular(til::point& pos, const DelimiterClassifier& classifier, const bool regular) const
+{
+    const auto bufferSize = GetSize();
+    std::vector<DelimiterClass> classes;
+
+    for (;;)
+    {
+        GetRowByOffset(pos.y).ClassifyDelimiters(bufferSize.Left(), pos.x + 1, classifier, classes);
+        const auto it = std::find_if(classes.rbegin(), classes.rend(), [&](const auto c) noexcept {
+            return (c == DelimiterClass::RegularChar) != regular;
+        });
+        if (it != classes.rend())
+        {
+            pos.x = bufferSize.Left() + gsl::narrow_cast<til::CoordType>(classes.rend() - it) - 1;
+            return true;
+        }
+
+        if (pos.y <= bufferSize.Top())
+        {
+            pos.x = bufferSize.Left();
+            return false;
+        }
+
+        pos.y--;
+        pos.x = bufferSize.RightInclusive();
+    }
+}
+
+// Method Description:
+// - Moves pos forwards, across rows, while the class of the cell it's on is
+//   (or isn't) a RegularChar and it hasn't reached the limit.
+// Arguments:
+// - pos - the buffer cell to start at. Receives the first cell that doesn't match, or the limit.
+// - classifier - built from the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// - regular - whether to move across RegularChar cells or across all others
+// - limit - the position at which to stop
 // Return Value:
-// - the delimiter class for the given char
-DelimiterClass TextBuffer::_GetDelimiterClassAt(const til::point pos, const std::wstring_view wordDelimiters) const noexcept
+// - false if pos moved past the end of the buffer. pos is EndExclusive() in that case.
+bool TextBuffer::_MoveForwardWhileRegular(til::point& pos, const DelimiterClassifier& classifier, const bool regular, const til::point limit) const
 {
-    return GetRowByOffset(pos.y).DelimiterClassAt(pos.x, wordDelimiters);
+    const auto bufferSize = GetSize();
+    std::vector<DelimiterClass> classes;
+
+    for (;;)
+    {
+        if (pos == limit)
+        {
+            return true;
+        }
+
+        // Don't classify any cells beyond the limit.
+        const auto end = pos.y == limit.y && limit.x > pos.x ? limit.x : bufferSize.RightExclusive();
+        GetRowByOffset(pos.y).ClassifyDelimiters(pos.x, end, classifier, classes);
+        const auto it = std::find_if(classes.begin(), classes.end(), [&](const auto c) noexcept {
+            return (c == DelimiterClass::RegularChar) != regular;
+        });
+        if (it != classes.end())
+        {
+            pos.x += gsl::narrow_cast<til::CoordType>(it - classes.begin());
+            return true;
+        }
+
+        if (end != bufferSize.RightExclusive())
+        {
+            pos.x = end;
+            return true;
+        }
+
+        if (pos.y >= bufferSize.BottomInclusive())
+        {
+            pos = bufferSize.EndExclusive();
+            return false;
+        }
+
+        pos.y++;
+        pos.x = bufferSize.Left();
+    }
 }
 
 // Method Description:
 // - Get the til::point for the beginning of the word you are on
 // Arguments:
 // - target - a til::point on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // - accessibilityMode - when enabled, we continue expanding left until we are at the beginning of a readable word.
 //                        Otherwise, expand left until a character of a new delimiter class is found
 //                        (or a row boundary is encountered)
 // - limitOptional - (optional) the last possible position in the buffer that can be explored. This can be used to improve performance.
 // Return Value:
 // - The til::point for the first character on the "word" (inclusive)
-til::point TextBuffer::GetWordStart(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode, std::optional<til::point> limitOptional) const
+til::point TextBuffer::GetWordStart(const til::point target, const DelimiterClassifier& classifier, bool accessibilityMode, std::optional<til::point> limitOptional) const
 {
     // Consider a buffer with this text in it:
     // "  word   other  "
@@ -1138,54 +1455,43 @@ til::point TextBuffer::GetWordStart(const til::point target, const std::wstring_
 
     if (accessibilityMode)
     {
-        return _GetWordStartForAccessibility(copy, wordDelimiters);
+        return _GetWordStartForAccessibility(copy, classifier);
     }
     else
     {
-        return _GetWordStartForSelection(copy, wordDelimiters);
+        return _GetWordStartForSelection(copy, classifier);
     }
 }
 
+til::point TextBuffer::GetWordStart(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode, std::optional<til::point> limitOptional) const
+{
+    return GetWordStart(target, DelimiterClassifier{ wordDelimiters }, accessibilityMode, limitOptional);
+}
+
 // Method Description:
 // - Helper method for GetWordStart(). Get the til::point for the beginning of the word (accessibility definition) you are on
 // Arguments:
 // - target - a til::point on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // Return Value:
 // - The til::point for the first character on the current/previous READABLE "word" (inclusive)
-til::point TextBuffer::_GetWordStartForAccessibility(const til::point target, const std::wstring_view wordDelimiters) const noexcept
+til::point TextBuffer::_GetWordStartForAccessibility(const til::point target, const DelimiterClassifier& classifier) const
 {
     auto result = target;
-    const auto bufferSize = GetSize();
-    auto stayAtOrigin = false;
 
     // ignore left boundary. Continue until readable text found
-    while (_GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
+    if (!_MoveBackwardWhileRegular(result, classifier, false))
     {
-        if (!bufferSize.DecrementInBounds(result))
-        {
-            // first char in buffer is a DelimiterChar or ControlChar
-            // we can't move any further back
-            stayAtOrigin = true;
-            break;
-        }
+        // first char in buffer is a DelimiterChar or ControlChar
+        // we can't move any further back
+        return result;
     }
 
     // make sure we expand to the left boundary or the beginning of the word
-    while (_GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
+    if (_MoveBackwardWhileRegular(result, classifier, true))
     {
-        if (!bufferSize.DecrementInBounds(result))
-        {
-            // first char in buffer is a RegularChar
-            // we can't move any further back
-            break;
-        }
-    }
-
-    // move off of delimiter and onto word start
-    if (!stayAtOrigin && _GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
-    {
-        bufferSize.IncrementInBounds(result);
+        // move off of delimiter and onto word start
+        GetSize().IncrementInBounds(result);
     }
 
     return result;
@@ -1195,43 +1501,35 @@ til::point TextBuffer::_GetWordStartForAccessibility(const til::point target, co
 // - Helper method for GetWordStart(). Get the til::point for the beginning of the word (selection definition) you are on
 // Arguments:
 // - target - a til::point on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // Return Value:
 // - The til::point for the first character on the current word or delimiter run (stopped by the left margin)
-til::point TextBuffer::_GetWordStartForSelection(const til::point target, const std::wstring_view wordDelimiters) const noexcept
+til::point TextBuffer::_GetWordStartForSelection(const til::point target, const DelimiterClassifier& classifier) const
 {
-    auto result = target;
     const auto bufferSize = GetSize();
-
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
+    std::vector<DelimiterClass> classes;
+    GetRowByOffset(target.y).ClassifyDelimiters(bufferSize.Left(), target.x + 1, classifier, classes);
 
     // expand left until we hit the left boundary or a different delimiter class
-    while (result.x > bufferSize.Left() && (_GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter))
-    {
-        bufferSize.DecrementInBounds(result);
-    }
+    const auto initialDelimiter = classes.back();
+    const auto it = std::find_if(classes.rbegin(), classes.rend(), [&](const auto c) noexcept { return c != initialDelimiter; });
 
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
-    {
-        // move off of delimiter
-        bufferSize.IncrementInBounds(result);
-    }
-
-    return result;
+    // it points at the last cell of the previous run, if there's any
+    return { bufferSize.Left() + gsl::narrow_cast<til::CoordType>(classes.rend() - it), target.y };
 }
 
 // Method Description:
 // - Get the til::point for the beginning of the NEXT word
 // Arguments:
 // - target - a til::point on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // - accessibilityMode - when enabled, we continue expanding right until we are at the beginning of the next READABLE word
 //                        Otherwise, expand right until a character of a new delimiter class is found
 //                        (or a row boundary is encountered)
 // - limitOptional - (optional) the last possible position in the buffer that can be explored. This can be used to improve performance.
 // Return Value:
 // - The til::point for the last character on the "word" (inclusive)
-til::point TextBuffer::GetWordEnd(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode, std::optional<til::point> limitOptional) const
+til::point TextBuffer::GetWordEnd(const til::point target, const DelimiterClassifier& classifier, bool accessibilityMode, std::optional<til::point> limitOptional) const
 {
     // Consider a buffer with this text in it:
     // "  word   other  "
@@ -1253,23 +1551,28 @@ til::point TextBuffer::GetWordEnd(const til::point target, const std::wstring_vi
 
     if (accessibilityMode)
     {
-        return _GetWordEndForAccessibility(target, wordDelimiters, limit);
+        return _GetWordEndForAccessibility(target, classifier, limit);
     }
     else
     {
-        return _GetWordEndForSelection(target, wordDelimiters);
+        return _GetWordEndForSelection(target, classifier);
     }
 }
 
+til::point TextBuffer::GetWordEnd(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode, std::optional<til::point> limitOptional) const
+{
+    return GetWordEnd(target, DelimiterClassifier{ wordDelimiters }, accessibilityMode, limitOptional);
+}
+
 // Method Description:
 // - Helper method for GetWordEnd(). Get the til::point for the beginning of the next READABLE word
 // Arguments:
 // - target - a til::point on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // - limit - the last "valid" position in the text buffer (to improve performance)
 // Return Value:
 // - The til::point for the first character of the next readable "word". If no next word, return one past the end of the buffer
-til::point TextBuffer::_GetWordEndForAccessibility(const til::point target, const std::wstring_view wordDelimiters, const til::point limit) const
+til::point TextBuffer::_GetWordEndForAccessibility(const til::point target, const DelimiterClassifier& classifier, const til::point limit) const
 {
     const auto bufferSize{ GetSize() };
     auto result{ target };
@@ -1285,27 +1588,11 @@ til::point TextBuffer::_GetWordEndForAccessibility(const til::point target, cons
     }
     else
     {
-        auto iter{ GetCellDataAt(result, bufferSize) };
-        while (iter && iter.Pos() != limit && _GetDelimiterClassAt(iter.Pos(), wordDelimiters) == DelimiterClass::RegularChar)
-        {
-            // Iterate through readable text
-            ++iter;
-        }
-
-        while (iter && iter.Pos() != limit && _GetDelimiterClassAt(iter.Pos(), wordDelimiters) != DelimiterClass::RegularChar)
-        {
-            // expand to the beginning of the NEXT word
-            ++iter;
-        }
-
-        result = iter.Pos();
-
-        // Special case: we tried to move one past the end of the buffer,
-        // but iter prevented that (because that pos doesn't exist).
-        // Manually increment onto the EndExclusive point.
-        if (!iter)
+        // Iterate through readable text and then
+        // expand to the beginning of the NEXT word
+        if (_MoveForwardWhileRegular(result, classifier, true, limit))
         {
-            bufferSize.IncrementInBounds(result, true);
+            _MoveForwardWhileRegular(result, classifier, false, limit);
         }
     }
 
@@ -1316,10 +1603,10 @@ til::point TextBuffer::_GetWordEndForAccessibility(const til::point target, cons
 // - Helper method for GetWordEnd(). Get the til::point for the beginning of the NEXT word
 // Arguments:
 // - target - a til::point on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // Return Value:
 // - The til::point for the last character of the current word or delimiter run (stopped by right margin)
-til::point TextBuffer::_GetWordEndForSelection(const til::point target, const std::wstring_view wordDelimiters) const noexcept
+til::point TextBuffer::_GetWordEndForSelection(const til::point target, const DelimiterClassifier& classifier) const
 {
     const auto bufferSize = GetSize();
 
@@ -1329,22 +1616,15 @@ til::point TextBuffer::_GetWordEndForSelection(const til::point target, const st
         return target;
     }
 
-    auto result = target;
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
+    std::vector<DelimiterClass> classes;
+    GetRowByOffset(target.y).ClassifyDelimiters(target.x, bufferSize.RightExclusive(), classifier, classes);
 
     // expand right until we hit the right boundary or a different delimiter class
-    while (result.x < bufferSize.RightInclusive() && (_GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter))
-    {
-        bufferSize.IncrementInBounds(result);
-    }
+    const auto initialDelimiter = classes.front();
+    const auto it = std::find_if(classes.begin(), classes.end(), [&](const auto c) noexcept { return c != initialDelimiter; });
 
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
-    {
-        // move off of delimiter
-        bufferSize.DecrementInBounds(result);
-    }
-
-    return result;
+    // it points at the first cell of the next run, if there's any
+    return { target.x + gsl::narrow_cast<til::CoordType>(it - classes.begin()) - 1, target.y };
 }
 
 void TextBuffer::_PruneHyperlinks()
@@ -1397,19 +1677,19 @@ void TextBuffer::_PruneHyperlinks()
 // - Update pos to be the position of the first character of the next word. This is used for accessibility
 // Arguments:
 // - pos - a til::point on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // - limitOptional - (optional) the last possible position in the buffer that can be explored. This can be used to improve performance.
 // Return Value:
 // - true, if successfully updated pos. False, if we are unable to move (usually due to a buffer boundary)
 // - pos - The til::point for the first character on the "word" (inclusive)
-bool TextBuffer::MoveToNextWord(til::point& pos, const std::wstring_view wordDelimiters, std::optional<til::point> limitOptional) const
+bool TextBuffer::MoveToNextWord(til::point& pos, const DelimiterClassifier& classifier, std::optional<til::point> limitOptional) const
 {
     // move to the beginning of the next word
     // NOTE: _GetWordEnd...() returns the exclusive position of the "end of the word"
     //       This is also the inclusive start of the next word.
     const auto bufferSize{ GetSize() };
     const auto limit{ limitOptional.value_or(bufferSize.EndExclusive()) };
-    const auto copy{ _GetWordEndForAccessibility(pos, wordDelimiters, limit) };
+    const auto copy{ _GetWordEndForAccessibility(pos, classifier, limit) };
 
     if (bufferSize.CompareInBounds(copy, limit, true) >= 0)
     {
@@ -1420,18 +1700,23 @@ bool TextBuffer::MoveToNextWord(til::point& pos, const std::wstring_view wordDel
     return true;
 }
 
+bool TextBuffer::MoveToNextWord(til::point& pos, const std::wstring_view wordDelimiters, std::optional<til::point> limitOptional) const
+{
+    return MoveToNextWord(pos, DelimiterClassifier{ wordDelimiters }, limitOptional);
+}
+
 // Method Description:
 // - Update pos to be the position of the first character of the previous word. This is used for accessibility
 // Arguments:
 // - pos - a til::point on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // Return Value:
 // - true, if successfully updated pos. False, if we are unable to move (usually due to a buffer boundary)
 // - pos - The til::point for the first character on the "word" (inclusive)
-bool TextBuffer::MoveToPreviousWord(til::point& pos, std::wstring_view wordDelimiters) const
+bool TextBuffer::MoveToPreviousWord(til::point& pos, const DelimiterClassifier& classifier) const
 {
     // move to the beginning of the current word
-    auto copy{ GetWordStart(pos, wordDelimiters, true) };
+    auto copy{ GetWordStart(pos, classifier, true) };
 
     if (!GetSize().DecrementInBounds(copy, true))
     {
@@ -1440,10 +1725,15 @@ bool TextBuffer::MoveToPreviousWord(til::point& pos, std::wstring_view wordDelim
     }
 
     // move to the beginning of the previous word
-    pos = GetWordStart(copy, wordDelimiters, true);
+    pos = GetWordStart(copy, classifier, true);
     return true;
 }
 
+bool TextBuffer::MoveToPreviousWord(til::point& pos, const std::wstring_view wordDelimiters) const
+{
+    return MoveToPreviousWord(pos, DelimiterClassifier{ wordDelimiters });
+}
+
 // Method Description:
 // - Update pos to be the beginning of the current glyph/character. This is used for accessibility
 // Arguments:
@@ -1783,7 +2073,7 @@ const TextBuffer::TextAndColor TextBuffer::GetText(const bool includeCRLF,
         const auto highlight = Viewport::FromInclusive(selectionRects.at(i));
 
         // retrieve the data from the screen buffer
-        auto it = GetCellDataAt(highlight.Origin(), highlight);
+        auto it = GetRowSpansAt(highlight.Origin(), highlight);
 
         // allocate a string buffer
         std::wstring selectionText;
@@ -1798,29 +2088,19 @@ const TextBuffer::TextAndColor TextBuffer::GetText(const bool includeCRLF,
             selectionBkAttr.reserve(gsl::narrow<size_t>(highlight.Width()) + 2);
         }
 
-        // copy char data into the string buffer, skipping trailing bytes
-        while (it)
+        // copy char data into the string buffer, one span of equal attributes at a time.
+        // The span's text already skips the trailing halves of wide glyphs.
+        for (; it; ++it)
         {
-            const auto& cell = *it;
+            const auto chars = it->Text();
+            selectionText.append(chars);
 
-            if (cell.DbcsAttr() != DbcsAttribute::Trailing)
+            if (copyTextColor)
             {
-                const auto chars = cell.Chars();
-                selectionText.append(chars);
-
-                if (copyTextColor)
-                {
-                    const auto cellData = cell.TextAttr();
-                    const auto [CellFgAttr, CellBkAttr] = GetAttributeColors(cellData);
-                    for (size_t j = 0; j < chars.size(); ++j)
-                    {
-                        selectionFgAttr.push_back(CellFgAttr);
-                        selectionBkAttr.push_back(CellBkAttr);
-                    }
-                }
+                const auto [CellFgAttr, CellBkAttr] = GetAttributeColors(it->attr);
+                selectionFgAttr.insert(selectionFgAttr.end(), chars.size(), CellFgAttr);
+                selectionBkAttr.insert(selectionBkAttr.end(), chars.size(), CellBkAttr);
             }
-
-            ++it;
         }
 
         // We apply formatting to rows if the row was NOT wrapped or formatting of wrapped rows is allowed
@@ -1898,16 +2178,19 @@ std::wstring TextBuffer::GetPlainText(const til::point& start, const til::point&
     auto spanLength = SpanLength(start, end);
     text.reserve(spanLength);
 
-    auto it = GetCellDataAt(start);
-
-    for (; it && spanLength > 0; ++it, --spanLength)
+    for (auto it = GetRowSpansAt(start); it && it->y <= end.y; ++it)
     {
-        const auto& cell = *it;
-        if (cell.DbcsAttr() != DbcsAttribute::Trailing)
+        auto columnEnd = it->columnEnd;
+        if (it->y == end.y)
         {
-            const auto chars = cell.Chars();
-            text.append(chars);
+            // end is inclusive.
+            if (it->columnBegin > end.x)
+            {
+                break;
+            }
+            columnEnd = std::min(columnEnd, end.x + 1);
         }
+        text.append(it->row->GetText(it->columnBegin, columnEnd));
     }
 
     return text;
@@ -2628,6 +2911,12 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
 
         // Set size back to real size as it will be taking over the rendering duties.
         newCursor.SetSize(ulSize);
+
+        // Reflowing wrote to every row of the new buffer. Only keep what's actually in use.
+        if (newBuffer._spill)
+        {
+            newBuffer._spill->Trim();
+        }
     }
 
     return hr;
@@ -2780,8 +3069,6 @@ void TextBuffer::CopyPatterns(const TextBuffer& OtherBuffer)
 // - An interval tree containing the patterns found
 PointTree TextBuffer::GetPatterns(const til::CoordType firstRow, const til::CoordType lastRow) const
 {
-    PointTree::interval_vector intervals;
-
     std::wstring concatAll;
     const auto rowSize = GetRowByOffset(0).size();
     concatAll.reserve(gsl::narrow_cast<size_t>(rowSize) * gsl::narrow_cast<size_t>(lastRow - firstRow + 1));
@@ -2794,14 +3081,38 @@ PointTree TextBuffer::GetPatterns(const til::CoordType firstRow, const til::Coor
         concatAll += row.GetText();
     }
 
+    return FindPatterns(_idsAndPatterns, concatAll, rowSize);
+}
+
+// Method Description:
+// - Returns the regex patterns registered via AddPatternRecognizer, by their ID.
+const std::unordered_map<size_t, std::wstring>& TextBuffer::GetPatternRecognizers() const noexcept
+{
+    return _idsAndPatterns;
+}
+
+// Method Description:
+// - Finds patterns in the given text, which consists of rows of rowSize columns
+//   each, as concatenated by GetPatterns. This doesn't access the buffer at all,
+//   which allows callers to run the (expensive) matching without holding a lock.
+// Arguments:
+// - patterns - the regex patterns by their ID
+// - text - the concatenated text of the rows to search
+// - rowSize - the width of each row in columns
+// Return value:
+// - An interval tree containing the patterns found, relative to the first row
+PointTree TextBuffer::FindPatterns(const std::unordered_map<size_t, std::wstring>& patterns, const std::wstring_view text, const til::CoordType rowSize)
+{
+    PointTree::interval_vector intervals;
+
     // for each pattern we know of, iterate through the string
-    for (const auto& idAndPattern : _idsAndPatterns)
+    for (const auto& idAndPattern : patterns)
     {
         std::wregex regexObj{ idAndPattern.second };
 
         // search through the run with our regex object
-        auto words_begin = std::wsregex_iterator(concatAll.begin(), concatAll.end(), regexObj);
-        auto words_end = std::wsregex_iterator();
+        auto words_begin = std::wcregex_iterator(text.data(), text.data() + text.size(), regexObj);
+        auto words_end = std::wcregex_iterator();
 
         til::CoordType lenUpToThis = 0;
         for (auto i = words_begin; i != words_end; ++i)
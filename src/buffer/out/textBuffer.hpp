@@ -53,10 +53,12 @@ filling in the last row, and updating the screen.
 
 #include "cursor.h"
 #include "Row.hpp"
+#include "ScrollbackSpill.hpp"
 #include "TextAttribute.hpp"
 #include "../types/inc/Viewport.hpp"
 
 #include "../buffer/out/textBufferCellIterator.hpp"
+#include "../buffer/out/textBufferRowSpanIterator.hpp"
 #include "../buffer/out/textBufferTextIterator.hpp"
 
 namespace Microsoft::Console::Render
@@ -87,6 +89,8 @@ public:
     TextBufferTextIterator GetTextDataAt(const til::point at) const;
     TextBufferTextIterator GetTextLineDataAt(const til::point at) const;
     TextBufferTextIterator GetTextDataAt(const til::point at, const Microsoft::Console::Types::Viewport limit) const;
+    TextBufferRowSpanIterator GetRowSpansAt(const til::point at) const;
+    TextBufferRowSpanIterator GetRowSpansAt(const til::point at, const Microsoft::Console::Types::Viewport limit) const;
 
     // Text insertion functions
     static void ConsumeGrapheme(std::wstring_view& chars) noexcept;
@@ -110,6 +114,9 @@ public:
 
     // Scroll needs access to this to quickly rotate around the buffer.
     bool IncrementCircularBuffer(const bool inVtMode = false);
+    // Same as IncrementCircularBuffer(), but the caller is responsible for calling
+    // TriggerCircling() before it notifies anyone about the rotation.
+    void IncrementCircularBufferWithoutFlush(const bool inVtMode);
 
     til::point GetLastNonSpaceCharacter(std::optional<const Microsoft::Console::Types::Viewport> viewOptional = std::nullopt) const;
 
@@ -123,6 +130,39 @@ public:
     void ScrollRows(const til::CoordType firstRow, const til::CoordType size, const til::CoordType delta);
 
     til::CoordType TotalRowCount() const noexcept;
+    void TouchRows(const til::CoordType firstRow, const til::CoordType lastRow) const noexcept;
+    const ScrollbackSpill* GetScrollbackSpill() const noexcept;
+
+    struct MemoryUsage
+    {
+        size_t used = 0;
+        size_t capacity = 0;
+    };
+
+    // A breakdown of the memory used by a TextBuffer. All values are in bytes.
+    struct MemoryReport
+    {
+        // The block of memory holding ROW::_chars and ROW::_charOffsets of all rows.
+        // Rows below the cursor haven't been written to yet and are counted as unused.
+        MemoryUsage charBuffer;
+        // The part of charBuffer that's actually in memory. It's less than
+        // its capacity if the buffer spilled into a file (see ScrollbackSpill).
+        size_t charBufferResident = 0;
+        // The heap allocations of rows whose text didn't fit into charBuffer.
+        MemoryUsage charsHeap;
+        size_t rowsWithCharsHeap = 0;
+        // The ROW objects and the attribute runs that don't fit into them.
+        MemoryUsage rows;
+        MemoryUsage attributes;
+        // These are estimates, because the node layout of std::unordered_map is implementation defined.
+        MemoryUsage hyperlinks;
+        MemoryUsage patterns;
+        size_t cursor = 0;
+
+        size_t Total() const noexcept;
+    };
+
+    MemoryReport GetMemoryReport() const noexcept;
 
     [[nodiscard]] TextAttribute GetCurrentAttributes() const noexcept;
 
@@ -139,6 +179,7 @@ public:
     til::point BufferToScreenPosition(const til::point position) const noexcept;
 
     void Reset();
+    void ResetToDefaults(const TextAttribute defaultAttributes, const UINT cursorSize);
 
     [[nodiscard]] HRESULT ResizeTraditional(const til::size newSize) noexcept;
 
@@ -152,8 +193,15 @@ public:
     void TriggerRedrawAll();
     void TriggerScroll();
     void TriggerScroll(const til::point delta);
+    void TriggerCircling();
     void TriggerNewTextNotification(const std::wstring_view newText);
 
+    til::point GetWordStart(const til::point target, const DelimiterClassifier& classifier, bool accessibilityMode = false, std::optional<til::point> limitOptional = std::nullopt) const;
+    til::point GetWordEnd(const til::point target, const DelimiterClassifier& classifier, bool accessibilityMode = false, std::optional<til::point> limitOptional = std::nullopt) const;
+    bool MoveToNextWord(til::point& pos, const DelimiterClassifier& classifier, std::optional<til::point> limitOptional = std::nullopt) const;
+    bool MoveToPreviousWord(til::point& pos, const DelimiterClassifier& classifier) const;
+
+    // Convenience overloads for callers that don't keep a DelimiterClassifier around.
     til::point GetWordStart(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode = false, std::optional<til::point> limitOptional = std::nullopt) const;
     til::point GetWordEnd(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode = false, std::optional<til::point> limitOptional = std::nullopt) const;
     bool MoveToNextWord(til::point& pos, const std::wstring_view wordDelimiters, std::optional<til::point> limitOptional = std::nullopt) const;
@@ -217,9 +265,12 @@ public:
     void ClearPatternRecognizers() noexcept;
     void CopyPatterns(const TextBuffer& OtherBuffer);
     interval_tree::IntervalTree<til::point, size_t> GetPatterns(const til::CoordType firstRow, const til::CoordType lastRow) const;
+    const std::unordered_map<size_t, std::wstring>& GetPatternRecognizers() const noexcept;
+    static interval_tree::IntervalTree<til::point, size_t> FindPatterns(const std::unordered_map<size_t, std::wstring>& patterns, const std::wstring_view text, const til::CoordType rowSize);
 
 private:
-    static wil::unique_virtualalloc_ptr<std::byte> _allocateBuffer(til::size sz, const TextAttribute& attributes, std::vector<ROW>& rows);
+    static size_t _getRowStride(uint16_t width) noexcept;
+    static wil::unique_virtualalloc_ptr<std::byte> _allocateBuffer(til::size sz, const TextAttribute& attributes, std::vector<ROW>& rows, std::unique_ptr<ScrollbackSpill>& spill);
 
     void _UpdateSize();
     void _SetFirstRowIndex(const til::CoordType FirstRowIndex) noexcept;
@@ -231,11 +282,12 @@ private:
     bool _AssertValidDoubleByteSequence(const DbcsAttribute dbcsAttribute);
     ROW& _GetFirstRow() noexcept;
     void _ExpandTextRow(til::inclusive_rect& selectionRow) const;
-    DelimiterClass _GetDelimiterClassAt(const til::point pos, const std::wstring_view wordDelimiters) const noexcept;
-    til::point _GetWordStartForAccessibility(const til::point target, const std::wstring_view wordDelimiters) const noexcept;
-    til::point _GetWordStartForSelection(const til::point target, const std::wstring_view wordDelimiters) const noexcept;
-    til::point _GetWordEndForAccessibility(const til::point target, const std::wstring_view wordDelimiters, const til::point limit) const;
-    til::point _GetWordEndForSelection(const til::point target, const std::wstring_view wordDelimiters) const noexcept;
+    bool _MoveBackwardWhileRegular(til::point& pos, const DelimiterClassifier& classifier, const bool regular) const;
+    bool _MoveForwardWhileRegular(til::point& pos, const DelimiterClassifier& classifier, const bool regular, const til::point limit) const;
+    til::point _GetWordStartForAccessibility(const til::point target, const DelimiterClassifier& classifier) const;
+    til::point _GetWordStartForSelection(const til::point target, const DelimiterClassifier& classifier) const;
+    til::point _GetWordEndForAccessibility(const til::point target, const DelimiterClassifier& classifier, const til::point limit) const;
+    til::point _GetWordEndForSelection(const til::point target, const DelimiterClassifier& classifier) const;
     void _PruneHyperlinks();
 
     static void _AppendRTFText(std::ostringstream& contentBuilder, const std::wstring_view& text);
@@ -249,7 +301,9 @@ private:
     std::unordered_map<size_t, std::wstring> _idsAndPatterns;
     size_t _currentPatternId = 0;
 
+    // The ROW character storage lives in either of these two: _spill is used for very large buffers.
     wil::unique_virtualalloc_ptr<std::byte> _charBuffer;
+    std::unique_ptr<ScrollbackSpill> _spill;
     std::vector<ROW> _storage;
     TextAttribute _currentAttributes;
     til::CoordType _firstRow = 0; // indexes top row (not necessarily 0)
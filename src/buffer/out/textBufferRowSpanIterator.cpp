@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "textBufferRowSpanIterator.hpp"
+
+#include "textBuffer.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Types;
+
+// Routine Description:
+// - Creates a new read-only iterator that yields the spans from the given position until the end of the buffer.
+//   Every row after the first one starts at column 0.
+// Arguments:
+// - buffer - Text buffer to seek through
+// - pos - Starting position to retrieve spans from (within screen buffer bounds)
+TextBufferRowSpanIterator::TextBufferRowSpanIterator(const TextBuffer& buffer, til::point pos) :
+    TextBufferRowSpanIterator(buffer, pos, buffer.GetSize())
+{
+}
+
+// Routine Description:
+// - Creates a new read-only iterator that yields the spans from the given position until the end of the limits.
+//   Every row after the first one starts at the left edge of the limits, just like with TextBufferCellIterator.
+// Arguments:
+// - buffer - Text buffer to seek through
+// - pos - Starting position to retrieve spans from (within the limits)
+// - limits - Viewport limits to restrict the iterator within the buffer bounds (smaller than the buffer itself)
+TextBufferRowSpanIterator::TextBufferRowSpanIterator(const TextBuffer& buffer, til::point pos, const Viewport limits) :
+    _buffer{ buffer },
+    _left{ limits.Left() },
+    _right{ limits.RightExclusive() },
+    _bottom{ limits.BottomExclusive() }
+{
+    // Throw if the bounds rectangle is not limited to the inside of the given buffer.
+    THROW_HR_IF(E_INVALIDARG, !buffer.GetSize().IsInBounds(limits));
+
+    // Throw if the coordinate is not limited to the inside of the given buffer.
+    THROW_HR_IF(E_INVALIDARG, !limits.IsInBounds(pos));
+
+    _span.y = pos.y;
+    _LoadRow(pos.x);
+}
+
+// Routine Description:
+// - Tells if the iterator is still valid (hasn't exceeded the limits it was created with)
+// Return Value:
+// - True if this iterator can still be dereferenced for data. False if we've passed the end and are out of data.
+TextBufferRowSpanIterator::operator bool() const noexcept
+{
+    return _span.y < _bottom;
+}
+
+// Routine Description:
+// - Advances to the next attribute run within the current row, or to the first span of the next row.
+// Return Value:
+// - Reference to self after movement.
+TextBufferRowSpanIterator& TextBufferRowSpanIterator::operator++() noexcept
+{
+    if (_span.columnEnd < _right)
+    {
+        ++_run;
+        _runEnd += _run->length;
+        _span.columnBegin = _span.columnEnd;
+        _LoadRun();
+    }
+    else if (++_span.y < _bottom)
+    {
+        _LoadRow(_left);
+    }
+    return *this;
+}
+
+const TextBufferRowSpan& TextBufferRowSpanIterator::operator*() const noexcept
+{
+    return _span;
+}
+
+const TextBufferRowSpan* TextBufferRowSpanIterator::operator->() const noexcept
+{
+    return &_span;
+}
+
+// Routine Description:
+// - Seeks to the attribute run containing the given column in the row at _span.y.
+void TextBufferRowSpanIterator::_LoadRow(const til::CoordType column) noexcept
+{
+    _span.row = &_buffer.GetRowByOffset(_span.y);
+    _span.columnBegin = column;
+
+    const auto& runs = _span.row->Attributes().runs();
+    _run = runs.begin();
+    _runsEnd = runs.end();
+    _runEnd = _run->length;
+
+    // The attributes of a row always cover all of its columns,
+    // so this can't run past the last run as long as column < _right.
+    while (_runEnd <= column && std::next(_run) != _runsEnd)
+    {
+        ++_run;
+        _runEnd += _run->length;
+    }
+
+    _LoadRun();
+}
+
+void TextBufferRowSpanIterator::_LoadRun() noexcept
+{
+    _span.columnEnd = std::min(_runEnd, _right);
+    _span.attr = _run->value;
+}
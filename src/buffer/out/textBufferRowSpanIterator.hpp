@@ -0,0 +1,76 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- textBufferRowSpanIterator.hpp
+
+Abstract:
+- Walks through the text buffer one span at a time instead of one cell at a time.
+  A span is a contiguous range of columns within a row that share the same attributes.
+- Each span is read straight out of the ROW's text, char offsets and attribute runs,
+  which avoids constructing an OutputCellView and re-resolving the row and the
+  attribute run for every cell like TextBufferCellIterator does.
+- It is intended for read-only operations.
+--*/
+
+#pragma once
+
+#include "Row.hpp"
+#include "../../types/inc/viewport.hpp"
+
+class TextBuffer;
+
+struct TextBufferRowSpan
+{
+    const ROW* row = nullptr;
+    til::CoordType y = 0;
+    // The range of columns [columnBegin, columnEnd) covered by this span.
+    // A span may begin or end in the middle of a wide glyph if the limits of the iterator do.
+    til::CoordType columnBegin = 0;
+    til::CoordType columnEnd = 0;
+    TextAttribute attr;
+
+    til::CoordType Columns() const noexcept
+    {
+        return columnEnd - columnBegin;
+    }
+
+    // The text of the glyphs that begin within this span. See ROW::GetText().
+    std::wstring_view Text() const noexcept
+    {
+        return row->GetText(columnBegin, columnEnd);
+    }
+};
+
+class TextBufferRowSpanIterator
+{
+public:
+    TextBufferRowSpanIterator(const TextBuffer& buffer, til::point pos);
+    TextBufferRowSpanIterator(const TextBuffer& buffer, til::point pos, const Microsoft::Console::Types::Viewport limits);
+
+    explicit operator bool() const noexcept;
+
+    TextBufferRowSpanIterator& operator++() noexcept;
+
+    const TextBufferRowSpan& operator*() const noexcept;
+    const TextBufferRowSpan* operator->() const noexcept;
+
+private:
+    using AttrRuns = til::small_rle<TextAttribute, uint16_t, 1>::container;
+
+    void _LoadRow(til::CoordType column) noexcept;
+    void _LoadRun() noexcept;
+
+    const TextBuffer& _buffer;
+    til::CoordType _left;
+    til::CoordType _right;
+    til::CoordType _bottom;
+
+    AttrRuns::const_iterator _run;
+    AttrRuns::const_iterator _runsEnd;
+    // The column at which _run ends (exclusive).
+    til::CoordType _runEnd = 0;
+
+    TextBufferRowSpan _span;
+};
@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../Row.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace
+{
+    // A ROW together with the storage TextBuffer would normally provide for it.
+    struct TestRow
+    {
+        explicit TestRow(uint16_t width) :
+            chars(width),
+            offsets(width + 1u),
+            row{ chars.data(), offsets.data(), width, TextAttribute{} }
+        {
+        }
+
+        std::vector<wchar_t> chars;
+        std::vector<uint16_t> offsets;
+        ROW row;
+    };
+
+    RowWriteState write(ROW& row, til::CoordType column, std::wstring_view text)
+    {
+        RowWriteState state{
+            .text = text,
+            .columnBegin = column,
+            .columnLimit = row.size(),
+        };
+        row.ReplaceText(state);
+        return state;
+    }
+}
+
+class RowTests
+{
+    TEST_CLASS(RowTests);
+
+    TEST_METHOD(ReplaceTextAscii)
+    {
+        TestRow r{ 10 };
+        const auto state = write(r.row, 2, L"hello");
+
+        VERIFY_ARE_EQUAL(7, state.columnEnd);
+        VERIFY_ARE_EQUAL(2, state.columnBeginDirty);
+        VERIFY_ARE_EQUAL(7, state.columnEndDirty);
+        VERIFY_IS_TRUE(state.text.empty());
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"  hello   " }, r.row.GetText());
+        for (uint16_t i = 0; i <= 10; ++i)
+        {
+            VERIFY_ARE_EQUAL(i, r.row._charOffsets[i]);
+        }
+    }
+
+    TEST_METHOD(ReplaceTextAsciiAcrossVectorBlocks)
+    {
+        // The first non-ASCII character is in the middle of the second block of 8 characters.
+        // U+00E9 is narrow, so every character below occupies exactly 1 column.
+        TestRow r{ 20 };
+        const auto state = write(r.row, 0, L"abcdefghijklm\u00e9nopqrs");
+
+        VERIFY_ARE_EQUAL(20, state.columnEnd);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"abcdefghijklm\u00e9nopqrs" }, r.row.GetText());
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\u00e9" }, r.row.GlyphAt(13));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"n" }, r.row.GlyphAt(14));
+    }
+
+    TEST_METHOD(ReplaceTextAsciiThenWide)
+    {
+        TestRow r{ 10 };
+        const auto state = write(r.row, 0, L"ab\u732Bc");
+
+        VERIFY_ARE_EQUAL(5, state.columnEnd);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"ab\u732Bc     " }, r.row.GetText());
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\u732B" }, r.row.GlyphAt(2));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\u732B" }, r.row.GlyphAt(3));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"c" }, r.row.GlyphAt(4));
+    }
+
+    TEST_METHOD(ReplaceTextAsciiOverWideGlyphs)
+    {
+        TestRow r{ 10 };
+        write(r.row, 0, L"\u732B\u732B\u732B");
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\u732B\u732B\u732B    " }, r.row.GetText());
+
+        // Starts on the trailing half of the first glyph and ends on the trailing half of the second.
+        auto state = write(r.row, 1, L"abc");
+        VERIFY_ARE_EQUAL(0, state.columnBeginDirty);
+        VERIFY_ARE_EQUAL(4, state.columnEndDirty);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L" abc\u732B    " }, r.row.GetText());
+
+        // Ends on the leading half of the third glyph.
+        state = write(r.row, 4, L"d");
+        VERIFY_ARE_EQUAL(4, state.columnBeginDirty);
+        VERIFY_ARE_EQUAL(6, state.columnEndDirty);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L" abcd     " }, r.row.GetText());
+    }
+
+    TEST_METHOD(ReplaceTextAsciiStopsAtLimit)
+    {
+        TestRow r{ 10 };
+        const auto state = write(r.row, 0, L"abcdefghijkl");
+
+        VERIFY_ARE_EQUAL(10, state.columnEnd);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"kl" }, state.text);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"abcdefghij" }, r.row.GetText());
+    }
+
+    TEST_METHOD(TracksBlinkingCells)
+    {
+        TextAttribute blinking;
+        blinking.SetBlinking(true);
+
+        TestRow r{ 20 };
+        VERIFY_IS_FALSE(r.row.ContainsBlinkingCells());
+
+        r.row.ReplaceAttributes(3, 5, blinking);
+        r.row.ReplaceAttributes(12, 14, blinking);
+        VERIFY_IS_TRUE(r.row.ContainsBlinkingCells());
+        VERIFY_ARE_EQUAL((std::pair<til::CoordType, til::CoordType>{ 3, 14 }), r.row.GetBlinkingColumns());
+
+        Log::Comment(L"Overwriting some of the blinking cells keeps the others.");
+        r.row.ReplaceAttributes(0, 6, TextAttribute{});
+        VERIFY_IS_TRUE(r.row.ContainsBlinkingCells());
+        VERIFY_ARE_EQUAL((std::pair<til::CoordType, til::CoordType>{ 12, 14 }), r.row.GetBlinkingColumns());
+
+        Log::Comment(L"Overwriting the last of them clears the flag.");
+        r.row.SetAttrToEnd(10, TextAttribute{});
+        VERIFY_IS_FALSE(r.row.ContainsBlinkingCells());
+        VERIFY_ARE_EQUAL((std::pair<til::CoordType, til::CoordType>{ 0, 0 }), r.row.GetBlinkingColumns());
+
+        r.row.Reset(blinking);
+        VERIFY_IS_TRUE(r.row.ContainsBlinkingCells());
+        VERIFY_ARE_EQUAL((std::pair<til::CoordType, til::CoordType>{ 0, 20 }), r.row.GetBlinkingColumns());
+
+        r.row.Reset(TextAttribute{});
+        VERIFY_IS_FALSE(r.row.ContainsBlinkingCells());
+    }
+
+    TEST_METHOD(ClassifiesDelimiters)
+    {
+        // Includes a range of consecutive non-ASCII delimiters, a duplicate and whitespace.
+        static constexpr std::wstring_view delimiters{ L"/\\()\"'-:,.;<>~!@#$%^&*|+=[]{}~?\u2502\u2503\u2504\u2502 \t" };
+        const DelimiterClassifier classifier{ delimiters };
+
+        // The classification that ROW::DelimiterClassAt() used to do for every cell.
+        const auto expected = [&](const wchar_t wch) {
+            if (wch <= L' ')
+            {
+                return DelimiterClass::ControlChar;
+            }
+            return delimiters.find(wch) != std::wstring_view::npos ? DelimiterClass::DelimiterChar : DelimiterClass::RegularChar;
+        };
+
+        auto mismatches = 0;
+        for (wchar_t wch = 0; wch < 0x3000; ++wch)
+        {
+            mismatches += expected(wch) != classifier.Classify(wch);
+        }
+        VERIFY_ARE_EQUAL(0, mismatches);
+        VERIFY_IS_TRUE(DelimiterClass::RegularChar == classifier.Classify(L'\uffff'));
+
+        TestRow r{ 20 };
+        write(r.row, 0, L"ls -la \u732B\u2503x/y");
+
+        std::vector<DelimiterClass> classes;
+        r.row.ClassifyDelimiters(0, 20, classifier, classes);
+        VERIFY_ARE_EQUAL(size_t{ 20 }, classes.size());
+        for (til::CoordType col = 0; col < 20; ++col)
+        {
+            VERIFY_IS_TRUE(r.row.DelimiterClassAt(col, classifier) == classes[col]);
+        }
+
+        // Both halves of the wide glyph at column 7 are regular characters.
+        VERIFY_IS_TRUE(DelimiterClass::RegularChar == classes[7]);
+        VERIFY_IS_TRUE(DelimiterClass::RegularChar == classes[8]);
+        VERIFY_IS_TRUE(DelimiterClass::DelimiterChar == classes[9]);
+
+        Log::Comment(L"Segments are clamped to the row.");
+        r.row.ClassifyDelimiters(3, 6, classifier, classes);
+        VERIFY_ARE_EQUAL(size_t{ 3 }, classes.size());
+        VERIFY_IS_TRUE(DelimiterClass::DelimiterChar == classes[0]);
+        r.row.ClassifyDelimiters(15, 100, classifier, classes);
+        VERIFY_ARE_EQUAL(size_t{ 5 }, classes.size());
+        r.row.ClassifyDelimiters(10, 5, classifier, classes);
+        VERIFY_IS_TRUE(classes.empty());
+    }
+};
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../ScrollbackSpill.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class ScrollbackSpillTests
+{
+    TEST_CLASS(ScrollbackSpillTests);
+
+    // 1 KiB rows make the page math easy: 64 rows per page.
+    static constexpr size_t rowStride = 1024;
+    static constexpr size_t rowsPerPage = ScrollbackSpill::PageSize / rowStride;
+
+    TEST_METHOD(StartsZeroed)
+    {
+        ScrollbackSpill spill{ rowStride, 1000, 4 };
+        VERIFY_ARE_EQUAL(rowStride * 1000, spill.Size());
+        VERIFY_ARE_EQUAL(16u, spill.PageCount());
+        VERIFY_ARE_EQUAL(0u, spill.ResidentPageCount());
+
+        const std::span data{ spill.Data(), spill.Size() };
+        VERIFY_IS_TRUE(std::all_of(data.begin(), data.end(), [](auto b) { return b == std::byte{}; }));
+    }
+
+    TEST_METHOD(EvictsLeastRecentlyUsed)
+    {
+        ScrollbackSpill spill{ rowStride, 16 * rowsPerPage, 4 };
+
+        // Touch pages 0-3. They all fit into the budget.
+        for (size_t page = 0; page < 4; ++page)
+        {
+            spill.Touch(page * rowsPerPage, page * rowsPerPage + 1);
+        }
+        VERIFY_ARE_EQUAL(4u, spill.ResidentPageCount());
+
+        // Page 0 is used again, which makes page 1 the least recently used one...
+        spill.Touch(0, 1);
+        // ...and so it's the one that gets evicted for page 4.
+        spill.Touch(4 * rowsPerPage, 4 * rowsPerPage + 1);
+
+        VERIFY_ARE_EQUAL(4u, spill.ResidentPageCount());
+        VERIFY_IS_TRUE(spill.IsPageResident(0));
+        VERIFY_IS_FALSE(spill.IsPageResident(1));
+        VERIFY_IS_TRUE(spill.IsPageResident(2));
+        VERIFY_IS_TRUE(spill.IsPageResident(3));
+        VERIFY_IS_TRUE(spill.IsPageResident(4));
+    }
+
+    TEST_METHOD(TouchSpanningPages)
+    {
+        ScrollbackSpill spill{ rowStride, 16 * rowsPerPage, 8 };
+
+        // The last row of page 2 up to and including the first row of page 5.
+        spill.Touch(3 * rowsPerPage - 1, 5 * rowsPerPage + 1);
+
+        VERIFY_ARE_EQUAL(4u, spill.ResidentPageCount());
+        VERIFY_IS_FALSE(spill.IsPageResident(1));
+        VERIFY_IS_TRUE(spill.IsPageResident(2));
+        VERIFY_IS_TRUE(spill.IsPageResident(5));
+        VERIFY_IS_FALSE(spill.IsPageResident(6));
+
+        spill.Trim();
+        VERIFY_ARE_EQUAL(0u, spill.ResidentPageCount());
+        VERIFY_IS_FALSE(spill.IsPageResident(2));
+    }
+
+    TEST_METHOD(EvictedPagesKeepTheirContents)
+    {
+        static constexpr size_t rows = 32 * rowsPerPage;
+        ScrollbackSpill spill{ rowStride, rows, 2 };
+
+        // Write a unique pattern into every row, while only ever keeping 2 pages resident.
+        for (size_t row = 0; row < rows; ++row)
+        {
+            spill.Touch(row, row + 1);
+            memset(spill.Data() + row * rowStride, static_cast<int>(row % 251), rowStride);
+        }
+        VERIFY_ARE_EQUAL(2u, spill.ResidentPageCount());
+
+        // Rows are faulted back in from the file when accessed, whether they were touched or not.
+        for (size_t row = 0; row < rows; ++row)
+        {
+            const auto expected = static_cast<std::byte>(row % 251);
+            const std::span data{ spill.Data() + row * rowStride, rowStride };
+            VERIFY_IS_TRUE(std::all_of(data.begin(), data.end(), [=](auto b) { return b == expected; }));
+        }
+    }
+};
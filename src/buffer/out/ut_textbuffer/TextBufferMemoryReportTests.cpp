@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class TextBufferMemoryReportTests
+{
+    TEST_CLASS(TextBufferMemoryReportTests);
+
+    static DummyRenderer renderer;
+
+    static constexpr til::size bufferSize{ 80, 30 };
+    // Every row stores 80 chars and 81 char offsets in the buffer's storage.
+    static constexpr size_t rowStride = 80 * sizeof(wchar_t) + 81 * sizeof(uint16_t);
+
+    static std::unique_ptr<TextBuffer> _makeBuffer()
+    {
+        return std::make_unique<TextBuffer>(bufferSize, TextAttribute{ 0x7 }, 0, false, renderer);
+    }
+
+    static void _verifyTotal(const TextBuffer::MemoryReport& report)
+    {
+        const auto total = report.charBufferResident + report.charsHeap.capacity + report.rows.capacity +
+                           report.attributes.capacity + report.hyperlinks.capacity + report.patterns.capacity + report.cursor;
+        VERIFY_ARE_EQUAL(total, report.Total());
+    }
+
+    TEST_METHOD(EmptyBuffer)
+    {
+        const auto buffer = _makeBuffer();
+        const auto report = buffer->GetMemoryReport();
+
+        VERIFY_ARE_EQUAL(30 * rowStride, report.charBuffer.capacity);
+        // Only the row with the cursor is in use.
+        VERIFY_ARE_EQUAL(rowStride, report.charBuffer.used);
+        VERIFY_ARE_EQUAL(report.charBuffer.capacity, report.charBufferResident);
+
+        VERIFY_ARE_EQUAL(30 * sizeof(ROW), report.rows.used);
+        VERIFY_IS_TRUE(report.rows.capacity >= report.rows.used);
+
+        VERIFY_ARE_EQUAL(size_t{ 0 }, report.charsHeap.capacity);
+        VERIFY_ARE_EQUAL(size_t{ 0 }, report.rowsWithCharsHeap);
+        VERIFY_ARE_EQUAL(size_t{ 0 }, report.attributes.capacity);
+        VERIFY_ARE_EQUAL(size_t{ 0 }, report.hyperlinks.used);
+        VERIFY_ARE_EQUAL(size_t{ 0 }, report.patterns.used);
+        VERIFY_ARE_EQUAL(sizeof(Cursor), report.cursor);
+
+        _verifyTotal(report);
+    }
+
+    TEST_METHOD(RowsAboveCursorAreUsed)
+    {
+        const auto buffer = _makeBuffer();
+
+        buffer->GetCursor().SetPosition({ 5, 9 });
+        VERIFY_ARE_EQUAL(10 * rowStride, buffer->GetMemoryReport().charBuffer.used);
+
+        buffer->GetCursor().SetPosition({ 0, 29 });
+        VERIFY_ARE_EQUAL(30 * rowStride, buffer->GetMemoryReport().charBuffer.used);
+    }
+
+    TEST_METHOD(CharsHeap)
+    {
+        const auto buffer = _makeBuffer();
+
+        // 2 chars per column don't fit into the buffer's storage for the row.
+        auto& row = buffer->GetRowByOffset(3);
+        for (til::CoordType x = 0; x < bufferSize.width; ++x)
+        {
+            row.ReplaceCharacters(x, 1, L"e\u0301");
+        }
+
+        const auto report = buffer->GetMemoryReport();
+        VERIFY_ARE_EQUAL(size_t{ 1 }, report.rowsWithCharsHeap);
+        VERIFY_ARE_EQUAL(160 * sizeof(wchar_t), report.charsHeap.used);
+        VERIFY_IS_TRUE(report.charsHeap.capacity >= report.charsHeap.used);
+        _verifyTotal(report);
+    }
+
+    TEST_METHOD(Attributes)
+    {
+        using Run = til::rle_pair<TextAttribute, uint16_t>;
+        const auto buffer = _makeBuffer();
+
+        // A single run per row is stored inline and doesn't count.
+        buffer->GetRowByOffset(0).ReplaceAttributes(0, bufferSize.width, TextAttribute{ 0x1f });
+        VERIFY_ARE_EQUAL(size_t{ 0 }, buffer->GetMemoryReport().attributes.capacity);
+
+        // Alternating attributes result in 1 run per column.
+        auto& row = buffer->GetRowByOffset(1);
+        for (til::CoordType x = 0; x < bufferSize.width; x += 2)
+        {
+            row.ReplaceAttributes(x, x + 1, TextAttribute{ 0x4f });
+        }
+
+        const auto report = buffer->GetMemoryReport();
+        VERIFY_ARE_EQUAL(80 * sizeof(Run), report.attributes.used);
+        VERIFY_IS_TRUE(report.attributes.capacity >= report.attributes.used);
+        _verifyTotal(report);
+    }
+
+    TEST_METHOD(HyperlinksAndPatterns)
+    {
+        const auto buffer = _makeBuffer();
+        const auto before = buffer->GetMemoryReport();
+
+        // Long enough to not fit into the small string optimization.
+        const std::wstring uri(100, L'x');
+        const auto id = buffer->GetHyperlinkId(uri, L"custom");
+        buffer->AddHyperlinkToMap(uri, id);
+        buffer->AddPatternRecognizer(LR"(\b(https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])");
+
+        const auto after = buffer->GetMemoryReport();
+        VERIFY_IS_TRUE(after.hyperlinks.used >= before.hyperlinks.used + uri.size() * sizeof(wchar_t));
+        VERIFY_IS_TRUE(after.hyperlinks.capacity >= after.hyperlinks.used);
+        VERIFY_IS_TRUE(after.patterns.used > before.patterns.used);
+        VERIFY_IS_TRUE(after.patterns.capacity >= after.patterns.used);
+        VERIFY_IS_TRUE(after.Total() > before.Total());
+        _verifyTotal(after);
+    }
+};
+
+DummyRenderer TextBufferMemoryReportTests::renderer{};
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console::Types;
+
+class TextBufferRowSpanIteratorTests
+{
+    TEST_CLASS(TextBufferRowSpanIteratorTests);
+
+    static DummyRenderer renderer;
+
+    // Writes text into the given row. Glyphs in wide are written 2 columns wide.
+    static void _write(TextBuffer& buffer, til::CoordType y, std::wstring_view text, std::wstring_view wide = {})
+    {
+        auto& row = buffer.GetRowByOffset(y);
+        til::CoordType x = 0;
+        for (const auto& ch : text)
+        {
+            const til::CoordType width = wide.find(ch) != std::wstring_view::npos ? 2 : 1;
+            row.ReplaceCharacters(x, width, { &ch, 1 });
+            x += width;
+        }
+    }
+
+    // Fills the buffer with text and changes the attributes every few columns,
+    // which is a bit more colorful than the average shell prompt.
+    static std::unique_ptr<TextBuffer> _makeColorfulBuffer(const til::size size)
+    {
+        auto buffer = std::make_unique<TextBuffer>(size, TextAttribute{ 0x7 }, 0, false, renderer);
+        for (til::CoordType y = 0; y < size.height; ++y)
+        {
+            auto& row = buffer->GetRowByOffset(y);
+            for (til::CoordType x = 0; x < size.width; ++x)
+            {
+                const auto ch = static_cast<wchar_t>(L'!' + (x + y) % 94);
+                row.ReplaceCharacters(x, 1, { &ch, 1 });
+            }
+            for (til::CoordType x = 0; x < size.width; x += 8)
+            {
+                row.ReplaceAttributes(x, std::min(x + 8, size.width), TextAttribute{ gsl::narrow_cast<WORD>(x / 8 % 16) });
+            }
+        }
+        return buffer;
+    }
+
+    TEST_METHOD(RowGetTextRange)
+    {
+        auto buffer = std::make_unique<TextBuffer>(til::size{ 8, 1 }, TextAttribute{ 0x7 }, 0, false, renderer);
+        _write(*buffer, 0, L"a\u3042b", L"\u3042");
+        const auto& row = buffer->GetRowByOffset(0);
+
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"a\u3042b" }, row.GetText(0, 4));
+        // A range ending on the leading half contains the entire glyph...
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"a\u3042" }, row.GetText(0, 2));
+        // ...and one beginning on the trailing half contains nothing of it.
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"b" }, row.GetText(2, 4));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"" }, row.GetText(2, 3));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"" }, row.GetText(3, 3));
+        // The range is clamped to the row.
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"b    " }, row.GetText(3, 100));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"" }, row.GetText(-5, 0));
+    }
+
+    TEST_METHOD(YieldsOneSpanPerAttributeRun)
+    {
+        const TextAttribute red{ FOREGROUND_RED };
+        const TextAttribute blue{ FOREGROUND_BLUE };
+
+        auto buffer = std::make_unique<TextBuffer>(til::size{ 10, 3 }, TextAttribute{ 0x7 }, 0, false, renderer);
+        _write(*buffer, 0, L"ab\u3042cdefg", L"\u3042");
+        _write(*buffer, 1, L"0123456789");
+        buffer->GetRowByOffset(0).ReplaceAttributes(2, 4, red);
+        buffer->GetRowByOffset(1).ReplaceAttributes(0, 5, blue);
+
+        // Limited to the columns [1, 9) of the first 2 rows.
+        auto it = buffer->GetRowSpansAt({ 1, 0 }, Viewport::FromExclusive({ 1, 0, 9, 2 }));
+
+        VERIFY_IS_TRUE(static_cast<bool>(it));
+        VERIFY_ARE_EQUAL(0, it->y);
+        VERIFY_ARE_EQUAL(1, it->columnBegin);
+        VERIFY_ARE_EQUAL(2, it->columnEnd);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"b" }, it->Text());
+        VERIFY_IS_TRUE(TextAttribute{ 0x7 } == it->attr);
+
+        ++it;
+        VERIFY_ARE_EQUAL(2, it->columnBegin);
+        VERIFY_ARE_EQUAL(4, it->columnEnd);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\u3042" }, it->Text());
+        VERIFY_IS_TRUE(red == it->attr);
+
+        ++it;
+        VERIFY_ARE_EQUAL(4, it->columnBegin);
+        VERIFY_ARE_EQUAL(9, it->columnEnd);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"cdefg" }, it->Text());
+
+        // The next row starts at the left edge of the limits again.
+        ++it;
+        VERIFY_ARE_EQUAL(1, it->y);
+        VERIFY_ARE_EQUAL(1, it->columnBegin);
+        VERIFY_ARE_EQUAL(5, it->columnEnd);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"1234" }, it->Text());
+        VERIFY_IS_TRUE(blue == it->attr);
+
+        ++it;
+        VERIFY_ARE_EQUAL(5, it->columnBegin);
+        VERIFY_ARE_EQUAL(9, it->columnEnd);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"5678" }, it->Text());
+
+        ++it;
+        VERIFY_IS_FALSE(static_cast<bool>(it));
+
+        // Without limits the iterator continues at column 0 until the end of the buffer.
+        size_t spans = 0;
+        til::CoordType columns = 0;
+        for (auto stream = buffer->GetRowSpansAt({ 8, 1 }); stream; ++stream)
+        {
+            spans++;
+            columns += stream->Columns();
+        }
+        VERIFY_ARE_EQUAL(size_t{ 2 }, spans);
+        VERIFY_ARE_EQUAL(12, columns);
+    }
+
+    // The spans must describe exactly the same text and attributes as the cells.
+    TEST_METHOD(MatchesCellIterator)
+    {
+        auto buffer = _makeColorfulBuffer({ 30, 4 });
+        _write(*buffer, 2, L"\u3042\u3044x\u3046", L"\u3042\u3044\u3046");
+        buffer->GetRowByOffset(2).ReplaceAttributes(1, 3, TextAttribute{ 0x4f });
+
+        const auto limits = Viewport::FromExclusive({ 3, 1, 27, 4 });
+        const til::point start{ 5, 1 };
+
+        std::wstring cellText;
+        std::vector<TextAttribute> cellAttrs;
+        for (auto it = buffer->GetCellDataAt(start, limits); it; ++it)
+        {
+            if (it->DbcsAttr() != DbcsAttribute::Trailing)
+            {
+                cellText.append(it->Chars());
+            }
+            cellAttrs.emplace_back(it->TextAttr());
+        }
+
+        std::wstring spanText;
+        std::vector<TextAttribute> spanAttrs;
+        for (auto it = buffer->GetRowSpansAt(start, limits); it; ++it)
+        {
+            spanText.append(it->Text());
+            spanAttrs.insert(spanAttrs.end(), gsl::narrow_cast<size_t>(it->Columns()), it->attr);
+        }
+
+        VERIFY_ARE_EQUAL(cellText, spanText);
+        VERIFY_ARE_EQUAL(cellAttrs.size(), spanAttrs.size());
+        VERIFY_IS_TRUE(cellAttrs == spanAttrs);
+    }
+};
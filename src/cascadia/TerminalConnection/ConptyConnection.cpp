@@ -393,6 +393,24 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         _startTime = std::chrono::high_resolution_clock::now();
 
+        // The output thread appends to the recording, so it must exist before the
+        // thread starts. Otherwise we'd race with it and miss the first chunks of output.
+        _startRecording();
+
+        // The output thread may write replies to the input pipe right away (for instance
+        // the cursor position report conpty requests with PSEUDOCONSOLE_INHERIT_CURSOR).
+        // The writer must be ready before then, or those replies are lost and conpty hangs.
+        // When the connection is restarted, the writer is restarted instead of replaced,
+        // because the paste thread may still be waiting on it in WaitForPendingInputBelow().
+        if (_inputWriter)
+        {
+            _inputWriter->Restart(_inPipe.get());
+        }
+        else
+        {
+            _inputWriter = std::make_unique<ConptyInputWriter>(_inPipe.get());
+        }
+
         // Create our own output handling thread
         // This must be done after the pipes are populated.
         // Each connection needs to make sure to drain the output from its backing host.
@@ -478,6 +496,31 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     }
     CATCH_LOG()
 
+    // Method Description:
+    // - Starts recording the session to disk if the WT_VT_RECORDING_DIR environment
+    //   variable is set. The file is created in that directory and named after the session GUID.
+    // - Recordings can be replayed with VtBench or the VtReplayTests. A failure
+    //   to record is logged but never prevents the connection from starting.
+    void ConptyConnection::_startRecording() noexcept
+    try
+    {
+        if (_recording)
+        {
+            return;
+        }
+
+        const auto directory = wil::TryGetEnvironmentVariableW<std::wstring>(L"WT_VT_RECORDING_DIR");
+        if (directory.empty())
+        {
+            return;
+        }
+
+        const auto path = std::filesystem::path{ directory } / (Utils::GuidToString(_guid) + L".vtrec");
+        _recording = std::make_unique<Utils::VtRecordingWriter>(path);
+        _recording->WriteResize(gsl::narrow_cast<uint32_t>(_cols), gsl::narrow_cast<uint32_t>(_rows));
+    }
+    CATCH_LOG()
+
     void ConptyConnection::WriteInput(const hstring& data)
     {
         if (!_isConnected())
@@ -485,10 +528,47 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
             return;
         }
 
-        // convert from UTF-16LE to UTF-8 as ConPty expects UTF-8
-        // TODO GH#3378 reconcile and unify UTF-8 converters
-        auto str = winrt::to_string(data);
-        LOG_IF_WIN32_BOOL_FALSE(WriteFile(_inPipe.get(), str.c_str(), (DWORD)str.length(), nullptr, nullptr));
+        if (_recording)
+        {
+            LOG_IF_FAILED(wil::ResultFromException([&]() { _recording->WriteInput(data); }));
+        }
+
+        // The writer converts the input to UTF-8 and writes it on its own thread,
+        // because WriteFile() blocks if the client doesn't read its input.
+        if (_inputWriter)
+        {
+            _inputWriter->Write(data);
+        }
+    }
+
+    // Function Description:
+    // - Blocks the calling thread until fewer than `limit` UTF-16 code units of input
+    //   are waiting to be written. Used to feed large pastes to the client no faster
+    //   than it reads them. Must not be called on the UI thread.
+    // Return Value:
+    // - false if the connection is closed and no more input will be written.
+    bool ConptyConnection::WaitForPendingInputBelow(const uint64_t limit)
+    {
+        if (!_isConnected() || !_inputWriter)
+        {
+            return false;
+        }
+        return _inputWriter->WaitForPendingBelow(gsl::narrow_cast<size_t>(std::min<uint64_t>(limit, SIZE_MAX)));
+    }
+
+    // Function Description:
+    // - Discards all input that hasn't been written to the client yet.
+    void ConptyConnection::CancelPendingInput() noexcept
+    {
+        if (_inputWriter)
+        {
+            _inputWriter->CancelPending();
+        }
+    }
+
+    uint64_t ConptyConnection::PendingInput() const noexcept
+    {
+        return _inputWriter ? _inputWriter->Pending() : 0;
     }
 
     void ConptyConnection::Resize(uint32_t rows, uint32_t columns)
@@ -497,6 +577,11 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         _rows = rows;
         _cols = columns;
 
+        if (_recording)
+        {
+            _recording->WriteResize(columns, rows);
+        }
+
         if (_isConnected())
         {
             THROW_IF_FAILED(ConptyResizePseudoConsole(_hPC.get(), { Utils::ClampToShortMax(columns, 1), Utils::ClampToShortMax(rows, 1) }));
@@ -550,7 +635,13 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         // .reset()ing either of these two will signal ConPTY to send out a CTRL_CLOSE_EVENT to all attached clients.
         // FYI: The other members of this class are concurrently read by the _hOutputThread
         // thread running in the background and so they're not safe to be .reset().
+        // The input writer however must be stopped before _inPipe is closed, since it writes into it.
+        // It's only shut down and not destroyed, because a paste may be waiting on it concurrently.
         _hPC.reset();
+        if (_inputWriter)
+        {
+            _inputWriter->Shutdown();
+        }
         _inPipe.reset();
 
         if (_hOutputThread)
@@ -584,6 +675,11 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         _hOutputThread.reset();
         _piClient.reset();
 
+        if (_recording)
+        {
+            _recording->Flush();
+        }
+
         _transitionToState(ConnectionState::Closed);
     }
     CATCH_LOG()
@@ -656,6 +752,11 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 }
             }
 
+            if (_recording)
+            {
+                LOG_IF_FAILED(wil::ResultFromException([&]() { _recording->WriteOutput({ _buffer.data(), read }); }));
+            }
+
             const auto result{ til::u8u16(std::string_view{ _buffer.data(), read }, _u16Str, _u8State) };
             if (FAILED(result))
             {
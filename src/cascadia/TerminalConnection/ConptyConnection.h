@@ -5,8 +5,10 @@
 
 #include "ConptyConnection.g.h"
 #include "ConnectionStateHolder.h"
+#include "ConptyInputWriter.h"
 
 #include "ITerminalHandoff.h"
+#include "../../types/inc/VtRecording.hpp"
 
 namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 {
@@ -31,6 +33,10 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         void Close() noexcept;
         void ClearBuffer();
 
+        bool WaitForPendingInputBelow(const uint64_t limit);
+        void CancelPendingInput() noexcept;
+        uint64_t PendingInput() const noexcept;
+
         void ShowHide(const bool show);
 
         void ReparentWindow(const uint64_t newParent);
@@ -65,6 +71,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         HRESULT _LaunchAttachedClient() noexcept;
         void _indicateExitWithStatus(unsigned int status) noexcept;
         void _LastConPtyClientDisconnected() noexcept;
+        void _startRecording() noexcept;
 
         til::CoordType _rows{};
         til::CoordType _cols{};
@@ -83,6 +90,9 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         wil::unique_hfile _inPipe; // The pipe for writing input to
         wil::unique_hfile _outPipe; // The pipe for reading output from
         wil::unique_handle _hOutputThread;
+        // Writes into _inPipe, so that WriteInput() never blocks on a client that doesn't read its input.
+        // It lives as long as the connection and is only ever shut down and restarted.
+        std::unique_ptr<ConptyInputWriter> _inputWriter;
         wil::unique_process_information _piClient;
         wil::unique_any<HPCON, decltype(closePseudoConsoleAsync), closePseudoConsoleAsync> _hPC;
 
@@ -92,6 +102,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         bool _passthroughMode{};
         bool _reloadEnvironmentVariables{};
         guid _profileGuid{};
+        // Non-null while the session is being recorded for later replay. See VtRecording.hpp.
+        std::unique_ptr<::Microsoft::Console::Utils::VtRecordingWriter> _recording;
 
         struct StartupInfoFromDefTerm
         {
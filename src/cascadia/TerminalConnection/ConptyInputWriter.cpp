@@ -0,0 +1,224 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "ConptyInputWriter.h"
+
+namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
+{
+    // Starts the writer thread. The pipe isn't owned and must outlive this instance.
+    ConptyInputWriter::ConptyInputWriter(HANDLE pipe) :
+        _pipe{ pipe }
+    {
+        const std::lock_guard lock{ _mutex };
+        _startThread();
+    }
+
+    ConptyInputWriter::~ConptyInputWriter()
+    {
+        Shutdown();
+    }
+
+    // Stops the writer thread. Input that wasn't written yet is discarded, and
+    // all further calls to Write() and WaitForPendingBelow() return immediately until Restart().
+    // It's safe to call this while another thread is in WaitForPendingBelow().
+    void ConptyInputWriter::Shutdown() noexcept
+    {
+        if (!_thread)
+        {
+            return;
+        }
+
+        {
+            const std::lock_guard lock{ _mutex };
+            _shutdown = true;
+            _generation++;
+            _session++;
+        }
+        _pending.notify_one();
+        // Unblock anyone waiting in WaitForPendingBelow().
+        _written.notify_all();
+
+        // The writer thread may be stuck in WriteFile() if the client doesn't read its input.
+        // Loop around CancelSynchronousIo() in case we called it while it wasn't blocked yet.
+        for (;;)
+        {
+            CancelSynchronousIo(_thread.get());
+            if (WaitForSingleObject(_thread.get(), 1000) == WAIT_OBJECT_0)
+            {
+                break;
+            }
+        }
+
+        _thread.reset();
+    }
+
+    // Shuts the writer down if it's still running and starts it again with a new pipe.
+    // Threads that were waiting in WaitForPendingBelow() for the previous pipe return false.
+    // The writer is restarted instead of being replaced, because a paste may still be
+    // waiting on it, and there's no telling when it'll wake up and return.
+    void ConptyInputWriter::Restart(HANDLE pipe)
+    {
+        Shutdown();
+
+        // The writer thread isn't running, so everything it owns can be reset without the lock.
+        _writing.clear();
+        _utf8.clear();
+        _u16State.reset();
+
+        // The thread is started under the lock, so that CancelPending() never sees
+        // _shutdown being false without a thread to cancel.
+        const std::lock_guard lock{ _mutex };
+        _pipe = pipe;
+        _queued.clear();
+        _inFlight = 0;
+        _failed = false;
+        _shutdown = false;
+        _startThread();
+    }
+
+    // INVARIANT: _mutex must be held, and the previous thread must have exited.
+    void ConptyInputWriter::_startThread()
+    {
+        _thread.reset(CreateThread(nullptr, 0, s_WriterThread, this, 0, nullptr));
+        THROW_LAST_ERROR_IF(!_thread);
+        LOG_IF_FAILED(SetThreadDescription(_thread.get(), L"ConptyConnection Input Thread"));
+    }
+
+    // Queues the text for writing and returns immediately.
+    void ConptyInputWriter::Write(const std::wstring_view text)
+    {
+        if (text.empty())
+        {
+            return;
+        }
+
+        {
+            const std::lock_guard lock{ _mutex };
+            if (_failed || _shutdown)
+            {
+                return;
+            }
+            _queued.append(text);
+        }
+        _pending.notify_one();
+    }
+
+    // Blocks until fewer than `limit` code units are waiting to be written.
+    // This allows a producer of large amounts of input (like a paste) to
+    // stay only a little ahead of the application that consumes it.
+    // Returns false if the pipe broke or the writer was shut down in the meantime,
+    // in which case no further input will ever be written into the pipe.
+    bool ConptyInputWriter::WaitForPendingBelow(const size_t limit)
+    {
+        std::unique_lock lock{ _mutex };
+        const auto session = _session;
+        _written.wait(lock, [&]() noexcept { return _queued.size() + _inFlight < limit || _failed || _shutdown || _session != session; });
+        return !_failed && !_shutdown && _session == session;
+    }
+
+    // Discards all input that wasn't written yet, including the remainder of
+    // the buffer that the writer thread is currently working on.
+    void ConptyInputWriter::CancelPending() noexcept
+    {
+        const std::lock_guard lock{ _mutex };
+        _queued.clear();
+        _generation++;
+        // Abort a WriteFile() that's stuck waiting for the client to read.
+        // This happens under the lock, so that it can't race with Shutdown().
+        if (!_shutdown)
+        {
+            CancelSynchronousIo(_thread.get());
+        }
+    }
+
+    // Returns the number of UTF-16 code units that are waiting to be written.
+    size_t ConptyInputWriter::Pending() const noexcept
+    {
+        const std::lock_guard lock{ _mutex };
+        return _queued.size() + _inFlight;
+    }
+
+    DWORD WINAPI ConptyInputWriter::s_WriterThread(LPVOID parameter) noexcept
+    {
+        static_cast<ConptyInputWriter*>(parameter)->_WriterThread();
+        return 0;
+    }
+
+    void ConptyInputWriter::_WriterThread() noexcept
+    {
+        std::unique_lock lock{ _mutex };
+
+        for (;;)
+        {
+            _pending.wait(lock, [&]() noexcept { return !_queued.empty() || _shutdown; });
+            if (_shutdown)
+            {
+                break;
+            }
+
+            // Swap the buffers, so that Write() can continue to append to the (now empty) queue while we write.
+            _writing.swap(_queued);
+            _inFlight = _writing.size();
+            const auto generation = _generation;
+            lock.unlock();
+
+            // Transcoding and writing the input in slices allows CancelPending() to take effect quickly and
+            // WaitForPendingBelow() to make progress without waiting for the entire buffer to be written.
+            std::wstring_view remaining{ _writing };
+            auto cancelled = false;
+            auto failed = false;
+            while (!remaining.empty())
+            {
+                const auto slice = remaining.substr(0, SliceSize);
+                remaining = remaining.substr(slice.size());
+
+                // The u16state carries a high surrogate split across slices over to the next one.
+                // ConPTY expects UTF-8. TODO GH#3378 reconcile and unify UTF-8 converters
+                if (FAILED(til::u16u8(slice, _utf8, _u16State)))
+                {
+                    failed = true;
+                    break;
+                }
+
+                if (!_utf8.empty() && !WriteFile(_pipe, _utf8.data(), gsl::narrow_cast<DWORD>(_utf8.size()), nullptr, nullptr))
+                {
+                    // CancelSynchronousIo() makes WriteFile() fail with ERROR_OPERATION_ABORTED.
+                    // Only a broken pipe is a reason to stop accepting input for good.
+                    failed = GetLastError() != ERROR_OPERATION_ABORTED;
+                    cancelled = !failed;
+                    LOG_LAST_ERROR_IF(failed);
+                    break;
+                }
+
+                lock.lock();
+                _inFlight -= slice.size();
+                cancelled = generation != _generation;
+                lock.unlock();
+                _written.notify_all();
+
+                if (cancelled)
+                {
+                    break;
+                }
+            }
+
+            lock.lock();
+            _inFlight = 0;
+            _writing.clear();
+            if (cancelled)
+            {
+                _u16State.reset();
+            }
+            if (failed)
+            {
+                // There's no point in writing anything else. Write() is a no-op from now on.
+                _failed = true;
+                _queued.clear();
+                _written.notify_all();
+                break;
+            }
+            _written.notify_all();
+        }
+    }
+}
@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <condition_variable>
+
+namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
+{
+    // Writes input into the ConPTY input pipe on a dedicated thread. WriteFile() blocks as
+    // soon as the pipe is full, which happens whenever the client application doesn't read
+    // its input (for instance because it's busy printing the previous chunk of a large paste).
+    // Without this, the UI thread would hang until the application caught up.
+    class ConptyInputWriter
+    {
+    public:
+        // The number of UTF-16 code units transcoded and written per WriteFile() call.
+        static constexpr size_t SliceSize = 16 * 1024;
+
+        explicit ConptyInputWriter(HANDLE pipe);
+        ~ConptyInputWriter();
+
+        ConptyInputWriter(const ConptyInputWriter&) = delete;
+        ConptyInputWriter& operator=(const ConptyInputWriter&) = delete;
+
+        void Shutdown() noexcept;
+        void Restart(HANDLE pipe);
+        void Write(std::wstring_view text);
+        bool WaitForPendingBelow(size_t limit);
+        void CancelPending() noexcept;
+        size_t Pending() const noexcept;
+
+    private:
+        void _startThread();
+        static DWORD WINAPI s_WriterThread(LPVOID parameter) noexcept;
+        void _WriterThread() noexcept;
+
+        HANDLE _pipe;
+        wil::unique_handle _thread;
+
+        mutable std::mutex _mutex;
+        // Signaled by Write() when _queued isn't empty anymore and by the destructor.
+        std::condition_variable _pending;
+        // Signaled by the writer thread whenever it finished writing a slice.
+        std::condition_variable _written;
+
+        // Protected by _mutex.
+        std::wstring _queued;
+        size_t _inFlight = 0;
+        // Incremented by CancelPending(). The writer thread stops writing
+        // the current buffer as soon as it notices that it changed.
+        uint64_t _generation = 0;
+        // Incremented by Shutdown(). WaitForPendingBelow() returns false once it changed,
+        // even if the writer was restarted before the waiting thread woke up.
+        uint64_t _session = 0;
+        bool _failed = false;
+        bool _shutdown = false;
+
+        // Only accessed by the writer thread.
+        std::wstring _writing;
+        std::string _utf8;
+        til::u16state _u16State;
+    };
+}
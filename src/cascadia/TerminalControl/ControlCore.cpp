@@ -39,6 +39,12 @@ constexpr const auto TsfRedrawInterval = std::chrono::milliseconds(100);
 // The minimum delay between updating the locations of regex patterns
 constexpr const auto UpdatePatternLocationsInterval = std::chrono::milliseconds(500);
 
+// Pastes larger than this many characters are written in chunks of this size on a background thread.
+constexpr const size_t PasteChunkSize = 64 * 1024;
+
+// The number of characters a paste may be ahead of the application reading it.
+constexpr const uint64_t PasteBacklogLimit = 2 * PasteChunkSize;
+
 namespace winrt::Microsoft::Terminal::Control::implementation
 {
     static winrt::Microsoft::Terminal::Core::OptionalColor OptionalFromColor(const til::color& c)
@@ -198,13 +204,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         // NOTE: Calling UpdatePatternLocations from a background
         // thread is a workaround for us to hit GH#12607 less often.
+        // The scan only holds the terminal lock for short slices of time,
+        // so that it doesn't delay output or the echo of keystrokes.
         _updatePatternLocations = std::make_unique<til::throttled_func_trailing<>>(
             UpdatePatternLocationsInterval,
             [weakTerminal = std::weak_ptr{ _terminal }]() {
                 if (const auto t = weakTerminal.lock())
                 {
-                    auto lock = t->LockForWriting();
-                    t->UpdatePatternsUnderLock();
+                    t->UpdatePatternsIncrementally();
                 }
             });
 
@@ -1072,6 +1079,40 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return info;
     }
 
+    // Method Description:
+    // - Reports the memory used by the main or the alt buffer, for diagnostics.
+    //   This is cheap enough to be polled about once per second.
+    // Arguments:
+    // - altBuffer: whether to report the alt buffer instead of the main buffer.
+    //   The report is empty if there's no alt buffer.
+    Control::BufferMemoryReport ControlCore::GetBufferMemoryReport(bool altBuffer) const
+    {
+        TextBuffer::MemoryReport report;
+        {
+            auto lock = _terminal->LockForReading();
+            report = _terminal->GetBufferMemoryReport(altBuffer);
+        }
+
+        Control::BufferMemoryReport info;
+        info.CharBufferUsed = report.charBuffer.used;
+        info.CharBufferCapacity = report.charBuffer.capacity;
+        info.CharBufferResident = report.charBufferResident;
+        info.CharsHeapUsed = report.charsHeap.used;
+        info.CharsHeapCapacity = report.charsHeap.capacity;
+        info.RowsWithCharsHeap = report.rowsWithCharsHeap;
+        info.RowsUsed = report.rows.used;
+        info.RowsCapacity = report.rows.capacity;
+        info.AttributesUsed = report.attributes.used;
+        info.AttributesCapacity = report.attributes.capacity;
+        info.HyperlinksUsed = report.hyperlinks.used;
+        info.HyperlinksCapacity = report.hyperlinks.capacity;
+        info.PatternsUsed = report.patterns.used;
+        info.PatternsCapacity = report.patterns.capacity;
+        info.Cursor = report.cursor;
+        info.Total = report.Total();
+        return info;
+    }
+
     // Method Description:
     // - Sets selection's end position to match supplied cursor position, e.g. while mouse dragging.
     // Arguments:
@@ -1225,16 +1266,219 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     }
 
     // Method Description:
-    // - Pre-process text pasted (presumably from the clipboard)
-    //   before sending it over the terminal's connection.
+    // - Pastes the given text into the connection. Small pastes are written right away.
+    //   Large ones are filtered and written in chunks on a background thread, no faster
+    //   than the application reads them, so that the UI doesn't hang until it caught up.
+    // - Pastes are written in the order they were made. While a paste is in progress,
+    //   even small ones are queued behind it, so that they can't interleave.
+    // Arguments:
+    // - hstr: the text to paste.
     void ControlCore::PasteText(const winrt::hstring& hstr)
     {
-        _terminal->WritePastedText(hstr);
+        auto queued = false;
+        auto startPaste = false;
+        if (!_isReadOnly)
+        {
+            const std::lock_guard lock{ _pasteMutex };
+            if (_paste.running || hstr.size() > PasteChunkSize)
+            {
+                _paste.queue.push_back({ hstr, _terminal->IsXtermBracketedPasteModeEnabled() });
+                queued = true;
+                if (!_paste.running)
+                {
+                    _paste.running = true;
+                    _paste.connection = _connection;
+                    startPaste = true;
+                }
+            }
+        }
+
+        if (startPaste)
+        {
+            _pasteInBackground();
+        }
+        else if (!queued)
+        {
+            // This also takes care of warning the user about read-only mode.
+            _terminal->WritePastedText(hstr);
+        }
+
         _terminal->ClearSelection();
         _updateSelectionUI();
         _terminal->TrySnapOnInput();
     }
 
+    // Method Description:
+    // - Stops the paste that's in progress and discards all queued ones.
+    //   Input that was handed to a ConPTY connection but not read by the
+    //   application yet is discarded as well.
+    void ControlCore::CancelPaste()
+    {
+        const std::lock_guard lock{ _pasteMutex };
+        if (!_paste.running)
+        {
+            return;
+        }
+
+        _paste.queue.clear();
+        _paste.cancelled = true;
+
+        // This happens under the lock, because _writeNextPasteChunk() writes under the lock as well.
+        // This way, it can't discard the end of the bracketed paste, which is written after this.
+        if (const auto conpty{ _paste.connection.try_as<TerminalConnection::ConptyConnection>() })
+        {
+            conpty.CancelPendingInput();
+        }
+    }
+
+    bool ControlCore::IsPasting() const
+    {
+        const std::lock_guard lock{ _pasteMutex };
+        return _paste.running;
+    }
+
+    // Method Description:
+    // - Returns how much of the paste that's in progress was written, from 0 to 1.
+    double ControlCore::PasteProgress() const
+    {
+        const std::lock_guard lock{ _pasteMutex };
+        if (!_paste.filter || _paste.current.text.empty())
+        {
+            return 0.0;
+        }
+        return static_cast<double>(_paste.written) / static_cast<double>(_paste.current.text.size());
+    }
+
+    // Method Description:
+    // - Writes the queued pastes to the connection, one chunk after another.
+    //   For ConPTY connections it waits for the application to read most of the previous
+    //   chunks before writing the next one. This keeps the memory usage bounded and
+    //   allows CancelPaste() to take effect quickly even for pastes of many megabytes.
+    winrt::fire_and_forget ControlCore::_pasteInBackground()
+    {
+        const auto weakThis{ get_weak() };
+        TerminalConnection::ConptyConnection conpty{ nullptr };
+        {
+            const std::lock_guard lock{ _pasteMutex };
+            conpty = _paste.connection.try_as<TerminalConnection::ConptyConnection>();
+        }
+
+        co_await winrt::resume_background();
+
+        for (;;)
+        {
+            if (conpty && !conpty.WaitForPendingInputBelow(PasteBacklogLimit))
+            {
+                // The connection was closed. Nothing we write would arrive anymore.
+                if (const auto core{ weakThis.get() })
+                {
+                    core->_abandonPaste();
+                }
+                co_return;
+            }
+
+            const auto core{ weakThis.get() };
+            if (!core || !core->_writeNextPasteChunk())
+            {
+                co_return;
+            }
+        }
+    }
+
+    // Method Description:
+    // - Filters the next chunk of the current paste and writes it to the connection.
+    //   Called on the background thread started by PasteText().
+    // Return Value:
+    // - false if there's nothing left to paste.
+    bool ControlCore::_writeNextPasteChunk()
+    {
+        {
+            const std::lock_guard lock{ _pasteMutex };
+            auto& paste = _paste;
+            std::wstring chunk;
+
+            if (paste.cancelled)
+            {
+                // Leave bracketed paste mode, or the application will consider the following keystrokes as pasted.
+                if (paste.filter && paste.current.bracketed)
+                {
+                    chunk.append(L"\x1b[201~");
+                }
+                paste.current = {};
+                paste.filter.reset();
+                paste.cancelled = false;
+            }
+            else
+            {
+                if (!paste.filter)
+                {
+                    if (paste.queue.empty())
+                    {
+                        paste.running = false;
+                        paste.connection = nullptr;
+                        return false;
+                    }
+
+                    paste.current = std::move(paste.queue.front());
+                    paste.queue.pop_front();
+                    paste.written = 0;
+                    paste.filter.emplace(::Microsoft::Terminal::Core::Terminal::CreatePasteFilter());
+                    if (paste.current.bracketed)
+                    {
+                        chunk.append(L"\x1b[200~");
+                    }
+                }
+
+                const std::wstring_view text{ paste.current.text };
+                auto count = std::min(PasteChunkSize, text.size() - paste.written);
+                // Connections transcode every write separately, so surrogate pairs must not be split.
+                if (paste.written + count < text.size() && til::is_leading_surrogate(text[paste.written + count - 1]))
+                {
+                    count--;
+                }
+
+                paste.filter->Filter(text.substr(paste.written, count), chunk);
+                paste.written += count;
+
+                if (paste.written == text.size())
+                {
+                    if (paste.current.bracketed)
+                    {
+                        chunk.append(L"\x1b[201~");
+                    }
+                    paste.current = {};
+                    paste.filter.reset();
+                }
+            }
+
+            // Written under the lock, so that it's ordered with CancelPaste().
+            // ConptyConnection::WriteInput() doesn't block, it only queues the input.
+            if (!chunk.empty())
+            {
+                paste.connection.WriteInput(chunk);
+            }
+        }
+
+        _PasteProgressChangedHandlers(*this, nullptr);
+        return true;
+    }
+
+    // Method Description:
+    // - Discards all pastes after the connection was closed.
+    void ControlCore::_abandonPaste()
+    {
+        {
+            const std::lock_guard lock{ _pasteMutex };
+            _paste.queue.clear();
+            _paste.current = {};
+            _paste.filter.reset();
+            _paste.connection = nullptr;
+            _paste.running = false;
+            _paste.cancelled = false;
+        }
+        _PasteProgressChangedHandlers(*this, nullptr);
+    }
+
     FontInfo ControlCore::GetFont() const
     {
         return _actualFont;
@@ -1540,6 +1784,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // Ensure Close() doesn't hang, waiting for MidiAudio to finish playing an hour long song.
             _midiAudio.BeginSkip();
 
+            // Don't write any more pasted text into a connection that's going away.
+            CancelPaste();
+
             // Stop accepting new output and state changes before we disconnect everything.
             _connection.TerminalOutput(_connectionOutputEventToken);
             _connectionStateChangedRevoker.revoke();
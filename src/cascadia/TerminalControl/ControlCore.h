@@ -101,6 +101,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void SendInput(const winrt::hstring& wstr);
         void PasteText(const winrt::hstring& hstr);
+        void CancelPaste();
+        bool IsPasting() const;
+        double PasteProgress() const;
         bool CopySelectionToClipboard(bool singleLine, const Windows::Foundation::IReference<CopyFormat>& formats);
         void SelectAll();
         void ClearSelection();
@@ -188,6 +191,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         bool CopyOnSelect() const;
         Windows::Foundation::Collections::IVector<winrt::hstring> SelectedText(bool trimTrailingWhitespace) const;
         Control::SelectionData SelectionInfo() const;
+        Control::BufferMemoryReport GetBufferMemoryReport(bool altBuffer) const;
         void SetSelectionAnchor(const til::point position);
         void SetEndSelectionPoint(const til::point position);
 
@@ -250,6 +254,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         TYPED_EVENT(CloseTerminalRequested,    IInspectable, IInspectable);
 
         TYPED_EVENT(Attached,                  IInspectable, IInspectable);
+        // Raised on the background paste thread. See _pasteInBackground().
+        TYPED_EVENT(PasteProgressChanged,      IInspectable, IInspectable);
         // clang-format on
 
     private:
@@ -289,6 +295,27 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         bool _isReadOnly{ false };
 
+        // Large pastes are written in chunks on a background thread, see PasteText().
+        struct PendingPaste
+        {
+            winrt::hstring text;
+            bool bracketed{ false };
+        };
+        struct PasteState
+        {
+            std::deque<PendingPaste> queue;
+            // The paste that's being written and how many of its characters were written so far.
+            // The filter is only set while a paste is in progress.
+            PendingPaste current;
+            size_t written{ 0 };
+            std::optional<::Microsoft::Console::Utils::PasteFilter> filter;
+            TerminalConnection::ITerminalConnection connection{ nullptr };
+            bool running{ false };
+            bool cancelled{ false };
+        };
+        mutable std::mutex _pasteMutex;
+        PasteState _paste;
+
         std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> _lastHoveredInterval{ std::nullopt };
 
         // These members represent the size of the surface that we should be
@@ -315,6 +342,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void _handleControlC();
         void _sendInputToConnection(std::wstring_view wstr);
 
+        winrt::fire_and_forget _pasteInBackground();
+        bool _writeNextPasteChunk();
+        void _abandonPaste();
+
 #pragma region TerminalCoreCallbacks
         void _terminalCopyToClipboard(std::wstring_view wstr);
         void _terminalWarningBell();
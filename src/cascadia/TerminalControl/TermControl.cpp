@@ -104,6 +104,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _revokers.ConnectionStateChanged = _core.ConnectionStateChanged(winrt::auto_revoke, { get_weak(), &TermControl::_bubbleConnectionStateChanged });
         _revokers.ShowWindowChanged = _core.ShowWindowChanged(winrt::auto_revoke, { get_weak(), &TermControl::_bubbleShowWindowChanged });
         _revokers.CloseTerminalRequested = _core.CloseTerminalRequested(winrt::auto_revoke, { get_weak(), &TermControl::_bubbleCloseTerminalRequested });
+        _revokers.PasteProgressChanged = _core.PasteProgressChanged(winrt::auto_revoke, { get_weak(), &TermControl::_corePasteProgressChanged });
 
         _revokers.PasteFromClipboard = _interactivity.PasteFromClipboard(winrt::auto_revoke, { get_weak(), &TermControl::_bubblePasteFromClipboard });
 
@@ -1212,6 +1213,15 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return;
         }
 
+        // Escape cancels a large paste that's still being written, instead of
+        // being queued behind it. See ControlCore::PasteText().
+        if (keyDown && vkey == VK_ESCAPE && _pasting && _core.IsPasting())
+        {
+            _core.CancelPaste();
+            e.Handled(true);
+            return;
+        }
+
         // GH#2235: Terminal::Settings hasn't been modified to differentiate
         // between AltGr and Ctrl+Alt yet.
         // -> Don't check for key bindings if this is an AltGr key combination.
@@ -2888,7 +2898,13 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - The taskbar state of this control
     const uint64_t TermControl::TaskbarState() const noexcept
     {
-        return _core.TaskbarState();
+        const auto state = _core.TaskbarState();
+        // A large paste shows its progress, unless the application reports its own.
+        if (state == 0 && _pasting)
+        {
+            return 1;
+        }
+        return state;
     }
 
     // Method Description:
@@ -2897,6 +2913,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - The taskbar progress of this control
     const uint64_t TermControl::TaskbarProgress() const noexcept
     {
+        if (_core.TaskbarState() == 0 && _pasting)
+        {
+            return _pasteProgress;
+        }
         return _core.TaskbarProgress();
     }
 
@@ -3006,6 +3026,36 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _core.ClearHoveredCell();
     }
 
+    // Method Description:
+    // - Shows the progress of a large paste in the tab and the taskbar, like the
+    //   progress an application reports with OSC 9;4.
+    // - The core raises this on its background paste thread, so we need to
+    //   switch to the UI thread before touching our state.
+    winrt::fire_and_forget TermControl::_corePasteProgressChanged(IInspectable /*sender*/,
+                                                                  IInspectable /*args*/)
+    {
+        auto weakThis{ get_weak() };
+        co_await wil::resume_foreground(Dispatcher());
+        if (auto self{ weakThis.get() })
+        {
+            if (_IsClosing())
+            {
+                co_return;
+            }
+
+            const auto pasting = _core.IsPasting();
+            const auto progress = pasting ? static_cast<uint64_t>(std::clamp(_core.PasteProgress(), 0.0, 1.0) * 100.0) : 0;
+            if (pasting == _pasting && progress == _pasteProgress)
+            {
+                co_return;
+            }
+
+            _pasting = pasting;
+            _pasteProgress = progress;
+            _SetTaskbarProgressHandlers(*this, nullptr);
+        }
+    }
+
     winrt::fire_and_forget TermControl::_hoveredHyperlinkChanged(IInspectable /*sender*/,
                                                                  IInspectable /*args*/)
     {
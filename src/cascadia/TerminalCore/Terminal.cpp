@@ -105,7 +105,7 @@ void Terminal::UpdateSettings(ICoreSettings settings)
 
     _snapOnInput = settings.SnapOnInput();
     _altGrAliasing = settings.AltGrAliasing();
-    _wordDelimiters = settings.WordDelimiters();
+    _wordDelimiters = DelimiterClassifier{ settings.WordDelimiters() };
     _suppressApplicationTitle = settings.SuppressApplicationTitle();
     _startingTitle = settings.StartingTitle();
     _trimBlockSelection = settings.TrimBlockSelection();
@@ -497,12 +497,12 @@ void Terminal::Write(std::wstring_view stringView)
     }
 }
 
+static constexpr auto PasteFilterOption = ::Microsoft::Console::Utils::FilterOption::CarriageReturnNewline |
+                                          ::Microsoft::Console::Utils::FilterOption::ControlCodes;
+
 void Terminal::WritePastedText(std::wstring_view stringView)
 {
-    const auto option = ::Microsoft::Console::Utils::FilterOption::CarriageReturnNewline |
-                        ::Microsoft::Console::Utils::FilterOption::ControlCodes;
-
-    auto filtered = ::Microsoft::Console::Utils::FilterStringForPaste(stringView, option);
+    auto filtered = ::Microsoft::Console::Utils::FilterStringForPaste(stringView, PasteFilterOption);
     if (IsXtermBracketedPasteModeEnabled())
     {
         filtered.insert(0, L"\x1b[200~");
@@ -515,6 +515,15 @@ void Terminal::WritePastedText(std::wstring_view stringView)
     }
 }
 
+// Method Description:
+// - Returns a filter that processes a paste written in several chunks
+//   the same way WritePastedText() processes it all at once.
+//   The caller is responsible for the bracketed paste markers.
+::Microsoft::Console::Utils::PasteFilter Terminal::CreatePasteFilter() noexcept
+{
+    return ::Microsoft::Console::Utils::PasteFilter{ PasteFilterOption };
+}
+
 // Method Description:
 // - Attempts to snap to the bottom of the buffer, if SnapOnInput is true. Does
 //   nothing if SnapOnInput is set to false, or we're already at the bottom of
@@ -1033,6 +1042,19 @@ til::CoordType Terminal::GetBufferHeight() const noexcept
     return _GetMutableViewport().BottomExclusive();
 }
 
+// Method Description:
+// - Reports the memory used by the main or the alt buffer. The alt buffer
+//   is reported even while it's only retained for reuse after leaving it.
+// Arguments:
+// - altBuffer - Whether to report the alt buffer instead of the main buffer.
+// Return Value:
+// - The buffer's memory report, or an empty one if there's no alt buffer.
+TextBuffer::MemoryReport Terminal::GetBufferMemoryReport(const bool altBuffer) const noexcept
+{
+    const auto buffer = altBuffer ? (_altBuffer ? _altBuffer.get() : _retainedAltBuffer.get()) : _mainBuffer.get();
+    return buffer ? buffer->GetMemoryReport() : TextBuffer::MemoryReport{};
+}
+
 // ViewStartIndex is also the length of the scrollback
 int Terminal::ViewStartIndex() const noexcept
 {
@@ -1099,6 +1121,10 @@ void Terminal::UserScrollViewport(const int viewTop)
 
     _scrollOffset = std::max(0, newDelta);
 
+    // Scrolling into the history may bring rows back that were spilled to disk.
+    const auto visible = _GetVisibleViewport();
+    _activeBuffer().TouchRows(visible.Top(), visible.BottomInclusive());
+
     // We can use the void variant of TriggerScroll here because
     // we adjusted the viewport so it can detect the difference
     // from the previous frame drawn.
@@ -1223,10 +1249,103 @@ void Terminal::UpdatePatternsUnderLock()
 {
     auto oldTree = _patternIntervalTree;
     _patternIntervalTree = _activeBuffer().GetPatterns(_VisibleStartIndex(), _VisibleEndIndex());
+    _patternTreeGeneration++;
     _InvalidatePatternTree(oldTree);
     _InvalidatePatternTree(_patternIntervalTree);
 }
 
+// Method Description:
+// - The same as UpdatePatternsUnderLock, but without holding the lock for long:
+//   * The visible rows are copied in batches, each within a single lock acquisition
+//     that ends once lockBudget has been exceeded. The scan resumes where it left off.
+//   * The regex matching, which is the expensive part, runs without the lock.
+//   * The results are published under the lock all at once.
+// - The scan is cancelled if the viewport moves or the pattern tree is changed
+//   otherwise in the meantime. Whoever did that is responsible for scheduling a new update.
+// - Rows that change while the scan is running may be matched in their old state.
+//   This is fine, since new output schedules another update anyways.
+// - INVARIANT: the caller must not hold the lock on the terminal
+// Arguments:
+// - lockBudget - the time after which the lock is released while copying rows
+// Return Value:
+// - Statistics about the lock acquisitions
+Terminal::PatternScanStats Terminal::UpdatePatternsIncrementally(const std::chrono::microseconds lockBudget)
+{
+    PatternScanStats stats;
+    PatternScan scan;
+
+    for (;;)
+    {
+        const auto lock = LockForWriting();
+        const auto beg = std::chrono::steady_clock::now();
+        stats.lockAcquisitions++;
+
+        if (!scan.buffer)
+        {
+            const auto& buffer = _activeBuffer();
+            scan.buffer = &buffer;
+            scan.generation = _patternTreeGeneration;
+            scan.firstRow = _VisibleStartIndex();
+            scan.lastRow = _VisibleEndIndex();
+            scan.nextRow = scan.firstRow;
+            scan.rowSize = buffer.GetSize().Width();
+            scan.patterns = buffer.GetPatternRecognizers();
+            scan.text.reserve(gsl::narrow_cast<size_t>(scan.rowSize) * gsl::narrow_cast<size_t>(scan.lastRow - scan.firstRow + 1));
+        }
+        else if (!_isPatternScanCurrent(scan))
+        {
+            stats.cancelled = true;
+            return stats;
+        }
+
+        // Querying the clock for every row would be wasteful, so we do it every couple rows.
+        while (scan.nextRow <= scan.lastRow)
+        {
+            scan.text += scan.buffer->GetRowByOffset(scan.nextRow).GetText();
+            scan.nextRow++;
+
+            if ((scan.nextRow - scan.firstRow) % 8 == 0 && std::chrono::steady_clock::now() - beg >= lockBudget)
+            {
+                break;
+            }
+        }
+
+        if (scan.nextRow > scan.lastRow)
+        {
+            break;
+        }
+    }
+
+    auto tree = TextBuffer::FindPatterns(scan.patterns, scan.text, scan.rowSize);
+
+    const auto lock = LockForWriting();
+    stats.lockAcquisitions++;
+
+    if (_isPatternScanCurrent(scan))
+    {
+        auto oldTree = std::move(_patternIntervalTree);
+        _patternIntervalTree = std::move(tree);
+        _patternTreeGeneration++;
+        _InvalidatePatternTree(oldTree);
+        _InvalidatePatternTree(_patternIntervalTree);
+    }
+    else
+    {
+        stats.cancelled = true;
+    }
+
+    return stats;
+}
+
+bool Terminal::_isPatternScanCurrent(const PatternScan& scan) const noexcept
+{
+    return scan.generation == _patternTreeGeneration &&
+           scan.buffer == &_activeBuffer() &&
+           scan.firstRow == _VisibleStartIndex() &&
+           scan.lastRow == _VisibleEndIndex() &&
+           scan.rowSize == _activeBuffer().GetSize().Width();
+}
+
 // Method Description:
 // - Clears and invalidates the interval pattern tree
 // - This is called to prevent the renderer from rendering patterns while the
@@ -1235,6 +1354,7 @@ void Terminal::ClearPatternTree()
 {
     auto oldTree = _patternIntervalTree;
     _patternIntervalTree = {};
+    _patternTreeGeneration++;
     _InvalidatePatternTree(oldTree);
 }
 
@@ -13,6 +13,7 @@
 #include "../../terminal/input/terminalInput.hpp"
 #include "../../types/inc/Viewport.hpp"
 #include "../../types/inc/GlyphWidth.hpp"
+#include "../../types/inc/utils.hpp"
 #include "../../cascadia/terminalcore/ITerminalInput.hpp"
 
 #include <til/ticket_lock.h>
@@ -84,12 +85,14 @@ public:
 
     // WritePastedText comes from our input and goes back to the PTY's input channel
     void WritePastedText(std::wstring_view stringView);
+    static ::Microsoft::Console::Utils::PasteFilter CreatePasteFilter() noexcept;
 
     [[nodiscard]] std::unique_lock<til::recursive_ticket_lock> LockForReading();
     [[nodiscard]] std::unique_lock<til::recursive_ticket_lock> LockForWriting();
     til::recursive_ticket_lock_suspension SuspendLock() noexcept;
 
     til::CoordType GetBufferHeight() const noexcept;
+    TextBuffer::MemoryReport GetBufferMemoryReport(const bool altBuffer) const noexcept;
 
     int ViewStartIndex() const noexcept;
     int ViewEndIndex() const noexcept;
@@ -188,7 +191,7 @@ public:
     const bool IsGridLineDrawingAllowed() noexcept override;
     const std::wstring GetHyperlinkUri(uint16_t id) const override;
     const std::wstring GetHyperlinkCustomId(uint16_t id) const override;
-    const std::vector<size_t> GetPatternId(const til::point location) const override;
+    void GetPatternsInRow(const til::point begin, const til::CoordType endX, std::vector<Microsoft::Console::Render::PatternInterval>& patterns) const override;
 
     std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept override;
     std::vector<Microsoft::Console::Types::Viewport> GetSelectionRects() noexcept override;
@@ -216,7 +219,17 @@ public:
     void SetCursorOn(const bool isOn);
     bool IsCursorBlinkingAllowed() const noexcept;
 
+    // How long UpdatePatternsIncrementally() holds the lock at most, give or take a few rows.
+    static constexpr std::chrono::microseconds PatternScanLockBudget{ 1000 };
+
+    struct PatternScanStats
+    {
+        size_t lockAcquisitions = 0;
+        bool cancelled = false;
+    };
+
     void UpdatePatternsUnderLock();
+    PatternScanStats UpdatePatternsIncrementally(const std::chrono::microseconds lockBudget = PatternScanLockBudget);
     void ClearPatternTree();
 
     const std::optional<til::color> GetTabColor() const;
@@ -350,7 +363,8 @@ private:
     };
     std::optional<SelectionAnchors> _selection;
     bool _blockSelection = false;
-    std::wstring _wordDelimiters;
+    // Built from the WordDelimiters setting, so that selecting words doesn't search the setting for every cell.
+    DelimiterClassifier _wordDelimiters;
     SelectionExpansion _multiClickSelectionMode = SelectionExpansion::Char;
     SelectionInteractionMode _selectionMode = SelectionInteractionMode::None;
     bool _selectionIsTargetingUrl = false;
@@ -360,6 +374,9 @@ private:
 
     std::unique_ptr<TextBuffer> _mainBuffer;
     std::unique_ptr<TextBuffer> _altBuffer;
+    // The alt buffer is kept around after leaving it, so that it can be
+    // reused when an application enters it again with the same size.
+    std::unique_ptr<TextBuffer> _retainedAltBuffer;
     Microsoft::Console::Types::Viewport _mutableViewport;
     til::CoordType _scrollbackLines = 0;
     bool _detectURLs = false;
@@ -384,6 +401,22 @@ private:
     //      Either way, we should make this behavior controlled by a setting.
 
     interval_tree::IntervalTree<til::point, size_t> _patternIntervalTree;
+    // Incremented whenever _patternIntervalTree changes, which cancels incremental scans in flight.
+    uint64_t _patternTreeGeneration = 0;
+
+    // The state of UpdatePatternsIncrementally() between lock acquisitions.
+    struct PatternScan
+    {
+        const TextBuffer* buffer = nullptr;
+        uint64_t generation = 0;
+        til::CoordType firstRow = 0;
+        til::CoordType lastRow = 0;
+        til::CoordType nextRow = 0;
+        til::CoordType rowSize = 0;
+        std::unordered_map<size_t, std::wstring> patterns;
+        std::wstring text;
+    };
+    bool _isPatternScanCurrent(const PatternScan& scan) const noexcept;
     void _InvalidatePatternTree(const interval_tree::IntervalTree<til::point, size_t>& tree);
     void _InvalidateFromCoords(const til::point start, const til::point end);
 
@@ -212,12 +212,24 @@ void Terminal::UseAlternateScreenBuffer()
     ClearSelection();
     _mainBuffer->ClearPatternRecognizers();
 
-    // Create a new alt buffer
-    _altBuffer = std::make_unique<TextBuffer>(_altBufferSize,
-                                              TextAttribute{},
-                                              cursorSize,
-                                              true,
-                                              _mainBuffer->GetRenderer());
+    // Reuse the previous alt buffer if it has the right size. Applications like
+    // pagers and editors toggle the alt buffer a lot and this saves us from
+    // allocating and constructing all of its rows every time.
+    if (_retainedAltBuffer && _retainedAltBuffer->GetSize().Dimensions() == _altBufferSize)
+    {
+        _altBuffer = std::move(_retainedAltBuffer);
+        _altBuffer->ResetToDefaults(TextAttribute{}, cursorSize);
+        _altBuffer->SetAsActiveBuffer(true);
+    }
+    else
+    {
+        _retainedAltBuffer = nullptr;
+        _altBuffer = std::make_unique<TextBuffer>(_altBufferSize,
+                                                  TextAttribute{},
+                                                  cursorSize,
+                                                  true,
+                                                  _mainBuffer->GetRenderer());
+    }
     _mainBuffer->SetAsActiveBuffer(false);
 
     // Copy our cursor state to the new buffer's cursor
@@ -279,8 +291,9 @@ void Terminal::UseMainScreenBuffer()
     }
 
     _mainBuffer->SetAsActiveBuffer(true);
-    // destroy the alt buffer
-    _altBuffer = nullptr;
+    // Keep the alt buffer for the next time an application switches to it.
+    _altBuffer->SetAsActiveBuffer(false);
+    _retainedAltBuffer = std::move(_altBuffer);
 
     if (_deferredResize.has_value())
     {
@@ -474,6 +487,7 @@ void Terminal::NotifyBufferRotation(const int delta)
 
     // manually erase our pattern intervals since the locations have changed now
     _patternIntervalTree = {};
+    _patternTreeGeneration++;
 
     const auto hasScrollMarks = _scrollMarks.size() > 0;
     if (hasScrollMarks)
@@ -98,29 +98,17 @@ const std::wstring Microsoft::Terminal::Core::Terminal::GetHyperlinkCustomId(uin
 }
 
 // Method Description:
-// - Gets the regex pattern ids of a location
+// - Gets the regex pattern matches that overlap a part of a row
 // Arguments:
-// - The location
-// Return value:
-// - The pattern IDs of the location
-const std::vector<size_t> Terminal::GetPatternId(const til::point location) const
-{
-    // Look through our interval tree for this location
-    const auto intervals = _patternIntervalTree.findOverlapping({ location.x + 1, location.y }, location);
-    if (intervals.size() == 0)
-    {
-        return {};
-    }
-    else
-    {
-        std::vector<size_t> result{};
-        for (const auto& interval : intervals)
-        {
-            result.emplace_back(interval.value);
-        }
-        return result;
-    }
-    return {};
+// - begin - The first cell
+// - endX - The column past the last cell
+// - patterns - The matches are appended to this vector
+void Terminal::GetPatternsInRow(const til::point begin, const til::CoordType endX, std::vector<PatternInterval>& patterns) const
+{
+    // The stop of a match is exclusive: it covers a cell if it starts at or before it and stops after it.
+    _patternIntervalTree.visit_overlapping({ begin.x + 1, begin.y }, { endX - 1, begin.y }, [&](const auto& interval) {
+        patterns.emplace_back(interval);
+    });
 }
 
 std::pair<COLORREF, COLORREF> Terminal::GetAttributeColors(const TextAttribute& attr) const noexcept
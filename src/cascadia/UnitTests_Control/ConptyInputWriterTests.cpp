@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "../TerminalConnection/ConptyInputWriter.h"
+
+#include <future>
+
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace WEX::Common;
+
+using winrt::Microsoft::Terminal::TerminalConnection::implementation::ConptyInputWriter;
+
+namespace ControlUnitTests
+{
+    class ConptyInputWriterTests
+    {
+        BEGIN_TEST_CLASS(ConptyInputWriterTests)
+            TEST_CLASS_PROPERTY(L"TestTimeout", L"0:0:30") // 30s timeout
+        END_TEST_CLASS()
+
+        TEST_METHOD(RestartDuringChunkedPaste);
+
+        struct Pipe
+        {
+            wil::unique_hfile read;
+            wil::unique_hfile write;
+        };
+
+        static Pipe _createPipe()
+        {
+            Pipe pipe;
+            // A small buffer, so that the writer blocks soon if nobody reads.
+            VERIFY_WIN32_BOOL_SUCCEEDED(CreatePipe(pipe.read.put(), pipe.write.put(), nullptr, 4096));
+            return pipe;
+        }
+    };
+
+    // A restart of the connection shuts the input writer down and restarts it with the
+    // new pipe, while the paste thread may still be waiting for the previous pipe to drain.
+    // The writer must outlive that wait, and the wait must end without writing anything else.
+    void ConptyInputWriterTests::RestartDuringChunkedPaste()
+    {
+        const auto first = _createPipe();
+        ConptyInputWriter writer{ first.write.get() };
+
+        Log::Comment(L"Write a chunk that the client never reads, like an application that's busy.");
+        writer.Write(std::wstring(64 * 1024, L'a'));
+
+        Log::Comment(L"Wait for the backlog to drain on another thread, like ControlCore's paste thread.");
+        std::promise<bool> waited;
+        auto waitResult = waited.get_future();
+        std::thread pasteThread{ [&]() {
+            waited.set_value(writer.WaitForPendingBelow(1));
+        } };
+        const auto joinPasteThread = wil::scope_exit([&]() { pasteThread.join(); });
+
+        VERIFY_ARE_EQUAL(std::future_status::timeout, waitResult.wait_for(std::chrono::milliseconds{ 100 }));
+
+        Log::Comment(L"Restart the writer with a new pipe, like ConptyConnection::Close() followed by Start().");
+        const auto second = _createPipe();
+        writer.Restart(second.write.get());
+
+        VERIFY_ARE_EQUAL(std::future_status::ready, waitResult.wait_for(std::chrono::seconds{ 10 }));
+        VERIFY_IS_FALSE(waitResult.get(), L"The paste must end, since its pipe is gone");
+
+        Log::Comment(L"The restarted writer writes into the new pipe, without leftovers of the old one.");
+        writer.Write(L"hello");
+        VERIFY_IS_TRUE(writer.WaitForPendingBelow(1));
+
+        char buffer[16]{};
+        DWORD read = 0;
+        VERIFY_WIN32_BOOL_SUCCEEDED(ReadFile(second.read.get(), &buffer[0], sizeof(buffer), &read, nullptr));
+        VERIFY_ARE_EQUAL(std::string_view{ "hello" }, (std::string_view{ &buffer[0], read }));
+    }
+}
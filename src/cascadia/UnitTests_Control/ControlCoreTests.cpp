@@ -41,6 +41,9 @@ namespace ControlUnitTests
         TEST_METHOD(TestSelectCommandSimple);
         TEST_METHOD(TestSelectOutputSimple);
 
+        TEST_METHOD(TestChunkedPaste);
+        TEST_METHOD(TestBufferMemoryReport);
+
         TEST_CLASS_SETUP(ModuleSetup)
         {
             winrt::init_apartment(winrt::apartment_type::single_threaded);
@@ -499,4 +502,85 @@ namespace ControlUnitTests
             VERIFY_ARE_EQUAL(expectedEnd, end);
         }
     }
+
+    void ControlCoreTests::TestChunkedPaste()
+    {
+        auto [settings, conn] = _createSettingsAndConnection();
+        Log::Comment(L"Create ControlCore object");
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        // The mock connection echoes the input back to us. It's called on the paste's background thread.
+        std::mutex mutex;
+        std::wstring received;
+        conn->TerminalOutput([&](const winrt::hstring& hstr) {
+            const std::lock_guard lock{ mutex };
+            received.append(hstr);
+        });
+        std::atomic<int> progressEvents{ 0 };
+        core->PasteProgressChanged([&](auto&&, auto&&) {
+            progressEvents++;
+        });
+
+        Log::Comment(L"Paste a few chunks worth of text, with line endings and surrogate pairs that straddle the chunk boundaries");
+        std::wstring text;
+        while (text.size() < 300 * 1024)
+        {
+            text.append(L"The quick brown fox\r\njumps over \U0001F98A the lazy dog\n");
+        }
+        const auto expected = Utils::FilterStringForPaste(text, Utils::FilterOption::CarriageReturnNewline | Utils::FilterOption::ControlCodes);
+
+        core->PasteText(winrt::hstring{ text });
+        VERIFY_IS_TRUE(core->IsPasting());
+
+        Log::Comment(L"A small paste made while the large one is in progress must be written after it");
+        core->PasteText(L"end");
+
+        // The paste runs on a background thread. A hung paste must fail the test instead of hanging it.
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 30 };
+        while (core->IsPasting() && std::chrono::steady_clock::now() < deadline)
+        {
+            Sleep(1);
+        }
+        VERIFY_IS_FALSE(core->IsPasting(), L"The paste should finish within 30 seconds");
+
+        const std::lock_guard lock{ mutex };
+        VERIFY_ARE_EQUAL(expected.size() + 3, received.size());
+        VERIFY_IS_TRUE(received == expected + L"end");
+        VERIFY_IS_TRUE(progressEvents >= 5);
+        VERIFY_ARE_EQUAL(0.0, core->PasteProgress());
+    }
+
+    void ControlCoreTests::TestBufferMemoryReport()
+    {
+        auto [settings, conn] = _createSettingsAndConnection();
+        Log::Comment(L"Create ControlCore object");
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        const auto main = core->GetBufferMemoryReport(false);
+        VERIFY_IS_TRUE(main.CharBufferCapacity > 0);
+        VERIFY_IS_TRUE(main.CharBufferUsed <= main.CharBufferCapacity);
+        VERIFY_IS_TRUE(main.Total >= main.CharBufferResident + main.RowsCapacity + main.Cursor);
+
+        Log::Comment(L"There's no alt buffer yet");
+        VERIFY_ARE_EQUAL(0ull, core->GetBufferMemoryReport(true).Total);
+
+        Log::Comment(L"Print 10 rows, which are now in use");
+        for (auto i = 0; i < 10; ++i)
+        {
+            conn->WriteInput(L"Foo\r\n");
+        }
+        const auto written = core->GetBufferMemoryReport(false);
+        VERIFY_IS_TRUE(written.CharBufferUsed > main.CharBufferUsed);
+
+        Log::Comment(L"The alt buffer is reported while in use and after leaving it");
+        conn->WriteInput(L"\x1b[?1049h");
+        const auto alt = core->GetBufferMemoryReport(true);
+        VERIFY_IS_TRUE(alt.CharBufferCapacity > 0);
+        conn->WriteInput(L"\x1b[?1049l");
+        VERIFY_ARE_EQUAL(alt.CharBufferCapacity, core->GetBufferMemoryReport(true).CharBufferCapacity);
+    }
 }
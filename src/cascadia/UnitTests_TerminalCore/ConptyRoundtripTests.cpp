@@ -137,6 +137,7 @@ class TerminalCoreUnitTests::ConptyRoundtripTests final
         expectedOutput.clear();
         _checkConptyOutput = true;
         _logConpty = false;
+        _writesOutsideConsoleLock = 0;
 
         VERIFY_ARE_EQUAL(gci.GetActiveOutputBuffer().GetViewport().Dimensions(),
                          gci.GetActiveOutputBuffer().GetBufferSize().Dimensions(),
@@ -234,6 +235,8 @@ class TerminalCoreUnitTests::ConptyRoundtripTests final
     TEST_METHOD(TestNoExtendedAttrsOptimization);
     TEST_METHOD(TestNoBackgroundAttrsOptimization);
 
+    TEST_METHOD(VtEnginePaintsUnderConsoleLock);
+
 private:
     bool _writeCallback(const char* const pch, const size_t cch);
     void _flushFirstFrame();
@@ -250,6 +253,7 @@ private:
     // Tests can set these variables how they link to configure the behavior of the test harness.
     bool _checkConptyOutput{ true }; // If true, the test class will check that the output from conpty was expected
     bool _logConpty{ false }; // If true, the test class will log all the output from conpty. Helpful for debugging.
+    size_t _writesOutsideConsoleLock{ 0 }; // The number of times conpty wrote its output without holding the console lock.
 
     std::unique_ptr<DummyRenderer> emptyRenderer;
     std::unique_ptr<Terminal> term;
@@ -261,6 +265,11 @@ bool ConptyRoundtripTests::_writeCallback(const char* const pch, const size_t cc
 {
     auto actualString = std::string(pch, cch);
 
+    if (!ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked())
+    {
+        _writesOutsideConsoleLock++;
+    }
+
     if (_checkConptyOutput)
     {
         VERIFY_IS_GREATER_THAN(expectedOutput.size(),
@@ -4334,3 +4343,38 @@ void ConptyRoundtripTests::TestNoBackgroundAttrsOptimization()
     Log::Comment(L"========== Check terminal buffer ==========");
     verifyBuffer(*termTb);
 }
+
+void ConptyRoundtripTests::VtEnginePaintsUnderConsoleLock()
+{
+    Log::Comment(L"The renderer usually paints outside of the console lock, but the VT engine "
+                 L"opts out of that, because its output must not interleave with the output "
+                 L"thread's passthrough. Check that it writes its entire frame under the lock.");
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& renderer = *g.pRender;
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& hostSm = si.GetStateMachine();
+    auto& termTb = *term->_mainBuffer;
+
+    for (const auto engine : renderer._engines)
+    {
+        if (engine)
+        {
+            VERIFY_IS_TRUE(engine->RequiresRenderDataWhilePainting());
+        }
+    }
+
+    _flushFirstFrame();
+
+    expectedOutput.push_back("Hello World");
+    hostSm.ProcessString(L"Hello World");
+
+    _writesOutsideConsoleLock = 0;
+    VERIFY_IS_FALSE(gci.IsConsoleLocked());
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_IS_FALSE(gci.IsConsoleLocked());
+
+    VERIFY_ARE_EQUAL(0u, _writesOutsideConsoleLock);
+    TestUtils::VerifyExpectedString(termTb, L"Hello World ", { 0, 0 });
+}
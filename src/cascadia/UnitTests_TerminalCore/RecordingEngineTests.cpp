@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include <WexTestClass.h>
+
+#include "../renderer/inc/DummyRenderer.hpp"
+#include "../renderer/inc/RecordingEngine.hpp"
+
+#include "../cascadia/TerminalCore/Terminal.hpp"
+
+using namespace Microsoft::Terminal::Core;
+using namespace Microsoft::Console::Render;
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace TerminalCoreUnitTests
+{
+    class RecordingEngineTests;
+};
+using namespace TerminalCoreUnitTests;
+
+class TerminalCoreUnitTests::RecordingEngineTests final
+{
+    static constexpr til::size ViewportSize{ 80, 24 };
+
+    TEST_CLASS(RecordingEngineTests);
+
+    TEST_METHOD(RecordsPaintedText)
+    {
+        Terminal term;
+        DummyRenderer renderer{ &term };
+        RecordingEngine engine{ RecordingEngine::Mode::Record };
+        renderer.AddRenderEngine(&engine);
+        term.Create(ViewportSize, 0, renderer);
+
+        _Write(term, L"\x1b[1;1Hhello\x1b[3;5H\x1b[4mworld\x1b[m");
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        VERIFY_ARE_EQUAL(1ull, engine.GetFrameCount());
+        VERIFY_ARE_EQUAL(1ull, engine.GetCallCount(RecordingEngine::Call::StartPaint));
+        VERIFY_ARE_EQUAL(1ull, engine.GetCallCount(RecordingEngine::Call::EndPaint));
+        VERIFY_ARE_EQUAL(0ull, engine.GetDroppedRecordCount());
+
+        const auto records = engine.GetRecords();
+        VERIFY_ARE_EQUAL(engine.GetTotalCallCount(), uint64_t{ records.size() });
+
+        std::wstring row0;
+        std::wstring row2;
+        auto underlined = false;
+        for (const auto& record : records)
+        {
+            if (record.call == RecordingEngine::Call::PaintBufferLine)
+            {
+                if (record.rect.top == 0)
+                {
+                    row0.append(engine.GetText(record));
+                }
+                else if (record.rect.top == 2)
+                {
+                    row2.append(engine.GetText(record));
+                }
+            }
+            else if (record.call == RecordingEngine::Call::PaintBufferGridLines && record.rect.top == 2)
+            {
+                VERIFY_ARE_EQUAL(4, record.rect.left);
+                VERIFY_ARE_EQUAL(5, record.rect.width());
+                VERIFY_IS_TRUE((record.detail & GridLineSet{ GridLines::Underline }.bits()) != 0);
+                underlined = true;
+            }
+        }
+
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"hello" }, std::wstring_view{ row0 }.substr(0, 5));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"world" }, std::wstring_view{ row2 }.substr(4, 5));
+        VERIFY_IS_TRUE(underlined);
+    }
+
+    TEST_METHOD(SkipsFramesWithoutInvalidation)
+    {
+        Terminal term;
+        DummyRenderer renderer{ &term };
+        RecordingEngine engine;
+        renderer.AddRenderEngine(&engine);
+        term.Create(ViewportSize, 0, renderer);
+
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+        VERIFY_ARE_EQUAL(1ull, engine.GetFrameCount());
+
+        // A single changed cell only repaints that one row.
+        engine.Reset();
+        const til::point coord{ 3, 7 };
+        renderer.TriggerRedraw(&coord);
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+        VERIFY_ARE_EQUAL(1ull, engine.GetFrameCount());
+        VERIFY_ARE_EQUAL(1ull, engine.GetCallCount(RecordingEngine::Call::PaintBufferLine));
+    }
+
+    // The Count mode must not record anything, not even into its (nonexistent) arena.
+    TEST_METHOD(CountsWithoutRecording)
+    {
+        Terminal term;
+        DummyRenderer renderer{ &term };
+        RecordingEngine engine{ RecordingEngine::Mode::Count };
+        renderer.AddRenderEngine(&engine);
+        term.Create(ViewportSize, 0, renderer);
+
+        _Write(term, L"hello");
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        VERIFY_ARE_EQUAL(1ull, engine.GetFrameCount());
+        VERIFY_IS_TRUE(engine.GetCallCount(RecordingEngine::Call::PaintBufferLine) > 0);
+        VERIFY_ARE_EQUAL(size_t{ 0 }, engine.GetRecords().size());
+        VERIFY_ARE_EQUAL(0ull, engine.GetDroppedRecordCount());
+    }
+
+    // Once the arena is full, records are dropped instead of allocating more memory.
+    TEST_METHOD(DropsRecordsWhenFull)
+    {
+        Terminal term;
+        DummyRenderer renderer{ &term };
+        RecordingEngine engine{ RecordingEngine::Mode::Record, 8, 16 };
+        renderer.AddRenderEngine(&engine);
+        term.Create(ViewportSize, 0, renderer);
+
+        _Write(term, L"hello");
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        VERIFY_ARE_EQUAL(size_t{ 8 }, engine.GetRecords().size());
+        VERIFY_ARE_EQUAL(engine.GetTotalCallCount() - 8, engine.GetDroppedRecordCount());
+        for (const auto& record : engine.GetRecords())
+        {
+            VERIFY_IS_TRUE(engine.GetText(record).size() <= 16);
+        }
+    }
+
+private:
+    static void _Write(Terminal& term, const std::wstring_view text)
+    {
+        const auto lock = term.LockForWriting();
+        term.Write(text);
+    }
+};
@@ -0,0 +1,219 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include <WexTestClass.h>
+
+#include "../renderer/inc/DummyRenderer.hpp"
+#include "../renderer/base/Renderer.hpp"
+
+#include "../cascadia/TerminalCore/Terminal.hpp"
+
+using namespace Microsoft::Terminal::Core;
+using namespace Microsoft::Console::Render;
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace
+{
+    // Records the text the renderer paints into a grid, so that we can compare what several engines got.
+    // The dirty area is controlled by the test: InvalidateAll() marks the whole viewport dirty.
+    class GridRenderEngine final : public RenderEngineBase
+    {
+    public:
+        std::vector<til::rect> dirty;
+        std::vector<std::wstring> rows;
+        size_t paintBufferLineCalls = 0;
+        size_t brushUpdates = 0;
+
+        HRESULT StartPaint() noexcept { return dirty.empty() ? S_FALSE : S_OK; }
+        HRESULT EndPaint() noexcept
+        {
+            dirty.clear();
+            return S_OK;
+        }
+        HRESULT Present() noexcept { return S_OK; }
+        HRESULT PrepareForTeardown(_Out_ bool* pForcePaint) noexcept
+        {
+            *pForcePaint = false;
+            return S_OK;
+        }
+        HRESULT ScrollFrame() noexcept { return S_OK; }
+        HRESULT Invalidate(const til::rect* psrRegion) noexcept
+        {
+            dirty.emplace_back(*psrRegion);
+            return S_OK;
+        }
+        HRESULT InvalidateCursor(const til::rect* /*psrRegion*/) noexcept { return S_OK; }
+        HRESULT InvalidateSystem(const til::rect* /*prcDirtyClient*/) noexcept { return S_OK; }
+        HRESULT InvalidateSelection(const std::vector<til::rect>& /*rectangles*/) noexcept { return S_OK; }
+        HRESULT InvalidateScroll(const til::point* /*pcoordDelta*/) noexcept { return S_OK; }
+        HRESULT InvalidateAll() noexcept
+        {
+            dirty.assign(1, til::rect{ _size });
+            return S_OK;
+        }
+        HRESULT PaintBackground() noexcept { return S_OK; }
+        HRESULT PaintBufferLine(std::span<const Cluster> clusters, til::point coord, bool /*fTrimLeft*/, bool /*lineWrapped*/) noexcept
+        {
+            paintBufferLineCalls++;
+            auto& row = rows.at(coord.y);
+            for (const auto& cluster : clusters)
+            {
+                const auto text = cluster.GetText();
+                row.replace(coord.x, text.size(), text);
+                coord.x += cluster.GetColumns();
+            }
+            return S_OK;
+        }
+        HRESULT PaintBufferGridLines(GridLineSet /*lines*/, COLORREF /*color*/, size_t /*cchLine*/, til::point /*coordTarget*/) noexcept { return S_OK; }
+        HRESULT PaintSelection(const til::rect& /*rect*/) noexcept { return S_OK; }
+        HRESULT PaintCursor(const CursorOptions& /*options*/) noexcept { return S_OK; }
+        HRESULT UpdateDrawingBrushes(const TextAttribute& /*textAttributes*/, const RenderSettings& /*renderSettings*/, gsl::not_null<IRenderData*> /*pData*/, bool /*usingSoftFont*/, bool /*isSettingDefaultBrushes*/) noexcept
+        {
+            brushUpdates++;
+            return S_OK;
+        }
+        HRESULT UpdateFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/) noexcept { return S_OK; }
+        HRESULT UpdateDpi(int /*iDpi*/) noexcept { return S_OK; }
+        HRESULT UpdateViewport(const til::inclusive_rect& srNewViewport) noexcept
+        {
+            _size = { srNewViewport.right - srNewViewport.left + 1, srNewViewport.bottom - srNewViewport.top + 1 };
+            rows.assign(gsl::narrow_cast<size_t>(_size.height), std::wstring(gsl::narrow_cast<size_t>(_size.width), L'.'));
+            return S_OK;
+        }
+        HRESULT GetProposedFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/, int /*iDpi*/) noexcept { return S_OK; }
+        HRESULT GetDirtyArea(std::span<const til::rect>& area) noexcept
+        {
+            area = dirty;
+            return S_OK;
+        }
+        HRESULT GetFontSize(_Out_ til::size* pFontSize) noexcept
+        {
+            *pFontSize = { 1, 1 };
+            return S_OK;
+        }
+        HRESULT IsGlyphWideByFont(std::wstring_view /*glyph*/, _Out_ bool* pResult) noexcept
+        {
+            *pResult = false;
+            return S_OK;
+        }
+
+    protected:
+        HRESULT _DoUpdateTitle(const std::wstring_view /*newTitle*/) noexcept { return S_OK; }
+
+    private:
+        til::size _size;
+    };
+}
+
+namespace TerminalCoreUnitTests
+{
+    class RenderFanOutTests;
+};
+using namespace TerminalCoreUnitTests;
+
+// The Renderer captures each frame once for the union of all engines' dirty areas
+// and replays it to every engine. These tests check that each engine still gets
+// exactly what it asked for, and measure how the frame time scales with the number of engines.
+class TerminalCoreUnitTests::RenderFanOutTests final
+{
+    static constexpr til::size ViewportSize{ 80, 24 };
+
+    TEST_CLASS(RenderFanOutTests);
+
+    TEST_METHOD(AllEnginesPaintTheSameFrame)
+    {
+        Terminal term;
+        DummyRenderer renderer{ &term };
+        std::array<GridRenderEngine, 3> engines;
+        for (auto& engine : engines)
+        {
+            renderer.AddRenderEngine(&engine);
+        }
+        term.Create(ViewportSize, 0, renderer);
+
+        _WriteColorfulScreen(term);
+
+        // The first frame picks up the viewport. Everything is dirty in the second one.
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+        renderer.TriggerRedrawAll();
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        const auto& expected = engines[0].rows;
+        VERIFY_ARE_EQUAL(std::wstring{ L"row 0: word word " }, expected[0].substr(0, 17));
+        VERIFY_ARE_NOT_EQUAL(0u, engines[0].paintBufferLineCalls);
+
+        for (auto& engine : engines)
+        {
+            VERIFY_ARE_EQUAL(engines[0].paintBufferLineCalls, engine.paintBufferLineCalls);
+            VERIFY_ARE_EQUAL(engines[0].brushUpdates, engine.brushUpdates);
+            for (size_t y = 0; y < expected.size(); ++y)
+            {
+                VERIFY_ARE_EQUAL(expected[y], engine.rows[y]);
+            }
+        }
+    }
+
+    TEST_METHOD(EngineSpecificDirtyAreas)
+    {
+        Terminal term;
+        DummyRenderer renderer{ &term };
+        GridRenderEngine full;
+        GridRenderEngine partial;
+        renderer.AddRenderEngine(&full);
+        renderer.AddRenderEngine(&partial);
+        term.Create(ViewportSize, 0, renderer);
+
+        _WriteColorfulScreen(term);
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        // Only the full engine gets the rows outside of the partial one's dirty area.
+        for (auto& row : partial.rows)
+        {
+            row.assign(row.size(), L'.');
+        }
+        full.InvalidateAll();
+        partial.dirty = { til::rect{ 10, 2, 20, 4 }, til::rect{ 0, 6, 5, 7 } };
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        for (til::CoordType y = 0; y < ViewportSize.height; ++y)
+        {
+            const auto& fullRow = full.rows[y];
+            const auto& partialRow = partial.rows[y];
+
+            std::wstring expected(ViewportSize.width, L'.');
+            if (y >= 2 && y < 4)
+            {
+                expected.replace(10, 10, fullRow.substr(10, 10));
+            }
+            else if (y == 6)
+            {
+                expected.replace(0, 5, fullRow.substr(0, 5));
+            }
+
+            VERIFY_ARE_EQUAL(expected, partialRow, NoThrowString().Format(L"row %d", y));
+        }
+    }
+
+private:
+    // Fills the viewport with rows of text that change their color every few cells.
+    static void _WriteColorfulScreen(Terminal& term)
+    {
+        std::wstring text;
+        for (til::CoordType y = 0; y < ViewportSize.height; ++y)
+        {
+            text.append(fmt::format(L"\x1b[{};1Hrow {}: ", y + 1, y));
+            for (auto x = 0; x < 12; ++x)
+            {
+                text.append(fmt::format(L"\x1b[3{}mword ", x % 8));
+            }
+        }
+        text.append(L"\x1b[m");
+
+        const auto lock = term.LockForWriting();
+        term.Write(text);
+    }
+};
@@ -0,0 +1,260 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include <WexTestClass.h>
+
+#include <future>
+#include <thread>
+
+#include "../renderer/inc/DummyRenderer.hpp"
+#include "../renderer/base/Renderer.hpp"
+
+#include "../cascadia/TerminalCore/Terminal.hpp"
+
+using namespace Microsoft::Terminal::Core;
+using namespace Microsoft::Console::Render;
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace
+{
+    // Records the text the renderer paints into a grid and calls back into
+    // the test while it paints, so that the test can run code mid-frame.
+    class PaintHookEngine final : public RenderEngineBase
+    {
+    public:
+        std::vector<til::rect> dirty;
+        std::vector<std::wstring> rows;
+        // Called for the first PaintBufferLine() of every frame.
+        std::function<void()> onPaint;
+        bool requiresRenderData = false;
+
+        HRESULT StartPaint() noexcept
+        {
+            _painted = false;
+            return dirty.empty() ? S_FALSE : S_OK;
+        }
+        HRESULT EndPaint() noexcept
+        {
+            dirty.clear();
+            return S_OK;
+        }
+        HRESULT Present() noexcept { return S_OK; }
+        HRESULT PrepareForTeardown(_Out_ bool* pForcePaint) noexcept
+        {
+            *pForcePaint = false;
+            return S_OK;
+        }
+        HRESULT ScrollFrame() noexcept { return S_OK; }
+        HRESULT Invalidate(const til::rect* psrRegion) noexcept
+        {
+            dirty.emplace_back(*psrRegion);
+            return S_OK;
+        }
+        HRESULT InvalidateCursor(const til::rect* /*psrRegion*/) noexcept { return S_OK; }
+        HRESULT InvalidateSystem(const til::rect* /*prcDirtyClient*/) noexcept { return S_OK; }
+        HRESULT InvalidateSelection(const std::vector<til::rect>& /*rectangles*/) noexcept { return S_OK; }
+        HRESULT InvalidateScroll(const til::point* /*pcoordDelta*/) noexcept { return S_OK; }
+        HRESULT InvalidateAll() noexcept
+        {
+            dirty.assign(1, til::rect{ _size });
+            return S_OK;
+        }
+        HRESULT PaintBackground() noexcept { return S_OK; }
+        HRESULT PaintBufferLine(std::span<const Cluster> clusters, til::point coord, bool /*fTrimLeft*/, bool /*lineWrapped*/) noexcept
+        try
+        {
+            if (!_painted)
+            {
+                _painted = true;
+                if (onPaint)
+                {
+                    onPaint();
+                }
+            }
+
+            auto& row = rows.at(coord.y);
+            for (const auto& cluster : clusters)
+            {
+                const auto text = cluster.GetText();
+                row.replace(coord.x, text.size(), text);
+                coord.x += cluster.GetColumns();
+            }
+            return S_OK;
+        }
+        CATCH_RETURN()
+        HRESULT PaintBufferGridLines(GridLineSet /*lines*/, COLORREF /*color*/, size_t /*cchLine*/, til::point /*coordTarget*/) noexcept { return S_OK; }
+        HRESULT PaintSelection(const til::rect& /*rect*/) noexcept { return S_OK; }
+        HRESULT PaintCursor(const CursorOptions& /*options*/) noexcept { return S_OK; }
+        HRESULT UpdateDrawingBrushes(const TextAttribute& /*textAttributes*/, const RenderSettings& /*renderSettings*/, gsl::not_null<IRenderData*> /*pData*/, bool /*usingSoftFont*/, bool /*isSettingDefaultBrushes*/) noexcept { return S_OK; }
+        HRESULT UpdateFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/) noexcept { return S_OK; }
+        HRESULT UpdateDpi(int /*iDpi*/) noexcept { return S_OK; }
+        HRESULT UpdateViewport(const til::inclusive_rect& srNewViewport) noexcept
+        {
+            _size = { srNewViewport.right - srNewViewport.left + 1, srNewViewport.bottom - srNewViewport.top + 1 };
+            rows.assign(gsl::narrow_cast<size_t>(_size.height), std::wstring(gsl::narrow_cast<size_t>(_size.width), L'.'));
+            return S_OK;
+        }
+        HRESULT GetProposedFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/, int /*iDpi*/) noexcept { return S_OK; }
+        HRESULT GetDirtyArea(std::span<const til::rect>& area) noexcept
+        {
+            area = dirty;
+            return S_OK;
+        }
+        HRESULT GetFontSize(_Out_ til::size* pFontSize) noexcept
+        {
+            *pFontSize = { 1, 1 };
+            return S_OK;
+        }
+        HRESULT IsGlyphWideByFont(std::wstring_view /*glyph*/, _Out_ bool* pResult) noexcept
+        {
+            *pResult = false;
+            return S_OK;
+        }
+        [[nodiscard]] bool RequiresRenderDataWhilePainting() const noexcept
+        {
+            return requiresRenderData;
+        }
+
+    protected:
+        HRESULT _DoUpdateTitle(const std::wstring_view /*newTitle*/) noexcept { return S_OK; }
+
+    private:
+        til::size _size;
+        bool _painted = false;
+    };
+
+    // Writes text into the terminal on another thread, the same way the connection's output thread does.
+    class BackgroundWriter
+    {
+    public:
+        BackgroundWriter(Terminal& term, std::wstring text) :
+            _thread{ [&term, text = std::move(text), this]() {
+                const auto lock = term.LockForWriting();
+                term.Write(text);
+                _written.set_value();
+            } }
+        {
+        }
+
+        ~BackgroundWriter()
+        {
+            _thread.join();
+        }
+
+        // Returns true if the text was written within the given time.
+        bool WaitForWrite(const std::chrono::milliseconds timeout)
+        {
+            return _future.wait_for(timeout) == std::future_status::ready;
+        }
+
+    private:
+        std::promise<void> _written;
+        std::future<void> _future{ _written.get_future() };
+        std::thread _thread;
+    };
+}
+
+namespace TerminalCoreUnitTests
+{
+    class RendererThreadingTests;
+};
+using namespace TerminalCoreUnitTests;
+
+// The Renderer captures each frame under the console lock and, unless an engine asks
+// otherwise, paints it after releasing the lock. Invalidations that arrive while the
+// engines are busy are queued and applied at the start of the next frame.
+class TerminalCoreUnitTests::RendererThreadingTests final
+{
+    static constexpr til::size ViewportSize{ 80, 24 };
+    // Long enough to not fail on a busy machine. Only reached if the test is about to fail.
+    static constexpr std::chrono::seconds WriteTimeout{ 10 };
+
+    TEST_CLASS(RendererThreadingTests);
+
+    TEST_METHOD(ConsoleLockIsReleasedWhilePainting)
+    {
+        Terminal term;
+        DummyRenderer renderer{ &term };
+        PaintHookEngine engine;
+        renderer.AddRenderEngine(&engine);
+        term.Create(ViewportSize, 0, renderer);
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        std::optional<BackgroundWriter> writer;
+        auto written = false;
+        engine.onPaint = [&]() {
+            writer.emplace(term, L"\x1b[11;1Hwritten while painting");
+            written = writer->WaitForWrite(WriteTimeout);
+        };
+
+        renderer.TriggerRedrawAll();
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+        writer.reset();
+
+        VERIFY_IS_TRUE(written, L"The terminal should be writable while the engine paints");
+    }
+
+    TEST_METHOD(ConsoleLockIsHeldForEnginesThatRequireRenderData)
+    {
+        Terminal term;
+        DummyRenderer renderer{ &term };
+        PaintHookEngine engine;
+        engine.requiresRenderData = true;
+        renderer.AddRenderEngine(&engine);
+        term.Create(ViewportSize, 0, renderer);
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        std::optional<BackgroundWriter> writer;
+        auto writtenWhilePainting = true;
+        engine.onPaint = [&]() {
+            writer.emplace(term, L"\x1b[11;1Hwritten after painting");
+            writtenWhilePainting = writer->WaitForWrite(std::chrono::milliseconds{ 100 });
+        };
+
+        renderer.TriggerRedrawAll();
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        VERIFY_IS_FALSE(writtenWhilePainting, L"The terminal shouldn't be writable while the engine paints");
+        VERIFY_IS_TRUE(writer->WaitForWrite(WriteTimeout), L"The write should go through once the frame is done");
+        writer.reset();
+    }
+
+    TEST_METHOD(InvalidationDuringPaintIsAppliedToNextFrame)
+    {
+        Terminal term;
+        DummyRenderer renderer{ &term };
+        PaintHookEngine engine;
+        renderer.AddRenderEngine(&engine);
+        term.Create(ViewportSize, 0, renderer);
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        // Only the first row is painted in this frame. The text written
+        // meanwhile lands in row 10, which isn't part of the frame.
+        std::optional<BackgroundWriter> writer;
+        auto written = false;
+        engine.onPaint = [&]() {
+            if (writer)
+            {
+                return;
+            }
+            writer.emplace(term, L"\x1b[11;1Hqueued");
+            written = writer->WaitForWrite(WriteTimeout);
+        };
+
+        engine.dirty = { til::rect{ 0, 0, ViewportSize.width, 1 } };
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+        VERIFY_IS_TRUE(written);
+        VERIFY_ARE_NOT_EQUAL(std::wstring{ L"queued" }, engine.rows[10].substr(0, 6));
+        VERIFY_IS_TRUE(engine.dirty.empty());
+
+        Log::Comment(L"The write's invalidation was queued during the frame and must be applied now.");
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+        writer.reset();
+        VERIFY_ARE_EQUAL(std::wstring{ L"queued" }, engine.rows[10].substr(0, 6));
+    }
+};
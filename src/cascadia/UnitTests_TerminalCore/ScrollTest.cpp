@@ -34,9 +34,15 @@ namespace
             return _triggerScrollDelta;
         }
 
+        size_t TriggerScrollCount() const
+        {
+            return _triggerScrollCount;
+        }
+
         void Reset()
         {
             _triggerScrollDelta.reset();
+            _triggerScrollCount = 0;
         }
 
         HRESULT StartPaint() noexcept { return S_OK; }
@@ -51,6 +57,7 @@ namespace
         HRESULT InvalidateScroll(const til::point* pcoordDelta) noexcept
         {
             _triggerScrollDelta = *pcoordDelta;
+            _triggerScrollCount++;
             return S_OK;
         }
         HRESULT InvalidateAll() noexcept { return S_OK; }
@@ -74,6 +81,7 @@ namespace
 
     private:
         std::optional<til::point> _triggerScrollDelta;
+        size_t _triggerScrollCount = 0;
     };
 
     struct ScrollBarNotification
@@ -104,6 +112,7 @@ class TerminalCoreUnitTests::ScrollTest final
     TEST_CLASS(ScrollTest);
 
     TEST_METHOD(TestNotifyScrolling);
+    TEST_METHOD(TestCoalescedLineFeeds);
 
     TEST_METHOD_SETUP(MethodSetup)
     {
@@ -235,3 +244,51 @@ void ScrollTest::TestNotifyScrolling()
         }
     }
 }
+
+void ScrollTest::TestCoalescedLineFeeds()
+{
+    Log::Comment(L"A run of line feeds at the bottom of a full buffer should scroll the renderer only once per write.");
+
+    auto& termTb = *_term->_mainBuffer;
+    auto& termSm = *_term->_stateMachine;
+
+    // Fill the entire buffer, so that further line feeds cycle it.
+    const auto totalBufferSize = termTb.GetSize().Height();
+    std::wstring fill;
+    for (auto i = 0; i < totalBufferSize; ++i)
+    {
+        fill.append(L"X\r\n");
+    }
+    termSm.ProcessString(fill);
+
+    std::wstring lines;
+    for (auto i = 1; i <= 100; ++i)
+    {
+        lines.append(fmt::format(L"{}\r\n", i));
+    }
+
+    _renderEngine->Reset();
+    termSm.ProcessString(lines);
+
+    VERIFY_ARE_EQUAL(1u, _renderEngine->TriggerScrollCount());
+    VERIFY_ARE_EQUAL((til::point{ 0, -100 }), _renderEngine->TriggerScrollDelta().value());
+
+    // The text written in between the line feeds ended up in the right rows.
+    const auto cursorRow = termTb.GetCursor().GetPosition().y;
+    VERIFY_ARE_EQUAL(totalBufferSize - 1, cursorRow);
+    for (auto i = 1; i <= TerminalViewHeight - 1; ++i)
+    {
+        const auto expected = std::to_wstring(101 - i);
+        const auto text = termTb.GetRowByOffset(cursorRow - i).GetText();
+        VERIFY_ARE_EQUAL(expected, std::wstring{ text.substr(0, expected.size()) });
+    }
+
+    Log::Comment(L"Sequences that depend on the buffer position end the run.");
+    _renderEngine->Reset();
+    termSm.ProcessString(L"a\r\nb\r\n\x1b[1;1Hc\r\n\x1b[99;1Hd\r\ne\r\n");
+
+    VERIFY_ARE_EQUAL(2u, _renderEngine->TriggerScrollCount());
+    VERIFY_ARE_EQUAL((til::point{ 0, -2 }), _renderEngine->TriggerScrollDelta().value());
+    VERIFY_ARE_EQUAL(L'e', termTb.GetRowByOffset(cursorRow - 1).GetText().front());
+    VERIFY_ARE_EQUAL(L'd', termTb.GetRowByOffset(cursorRow - 2).GetText().front());
+}
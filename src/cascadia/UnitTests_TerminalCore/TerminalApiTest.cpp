@@ -12,9 +12,12 @@
 using namespace winrt::Microsoft::Terminal::Core;
 using namespace Microsoft::Terminal::Core;
 
+using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
 
+using PointTree = interval_tree::IntervalTree<til::point, size_t>;
+
 namespace TerminalCoreUnitTests
 {
 #define WCS(x) WCSHELPER(x)
@@ -41,6 +44,13 @@ namespace TerminalCoreUnitTests
 
         TEST_METHOD(SetTaskbarProgress);
         TEST_METHOD(SetWorkingDirectory);
+
+        TEST_METHOD(UpdatePatternsIncrementally);
+        TEST_METHOD(PatternScanCancelledByViewportChange);
+
+        TEST_METHOD(AltBufferIsReused);
+
+        TEST_METHOD(BlinkRedrawsOnlyBlinkingCells);
     };
 };
 
@@ -476,3 +486,176 @@ void TerminalCoreUnitTests::TerminalApiTest::SetWorkingDirectory()
     stateMachine.ProcessString(L"\x1b]9;9;D:\\中文\x1b\\");
     VERIFY_ARE_EQUAL(term.GetWorkingDirectory(), L"D:\\中文");
 }
+
+static std::vector<PointTree::interval> collectIntervals(const PointTree& tree)
+{
+    std::vector<PointTree::interval> intervals;
+    tree.visit_all([&](const PointTree::interval& interval) { intervals.emplace_back(interval); });
+    std::sort(intervals.begin(), intervals.end(), [](const auto& a, const auto& b) { return a.start < b.start; });
+    return intervals;
+}
+
+void TerminalApiTest::UpdatePatternsIncrementally()
+{
+    // A wide viewport full of long wrapped lines with links is the worst case for the pattern scan.
+    static constexpr til::CoordType width = 300;
+    static constexpr til::CoordType height = 120;
+
+    Terminal term;
+    DummyRenderer renderer{ &term };
+    term.Create({ width, height }, 0, renderer);
+    term._activeBuffer().AddPatternRecognizer(linkPattern);
+
+    auto& stateMachine = *(term._stateMachine);
+    for (auto i = 0; i < height / 3; ++i)
+    {
+        std::wstring line;
+        while (line.size() < 2 * width)
+        {
+            line.append(fmt::format(FMT_COMPILE(L"see https://example.com/{}/{} for details, "), i, line.size()));
+        }
+        stateMachine.ProcessString(line);
+        stateMachine.ProcessString(L"\r\n");
+    }
+
+    {
+        const auto lock = term.LockForWriting();
+        term.UpdatePatternsUnderLock();
+    }
+    const auto expected = collectIntervals(term._patternIntervalTree);
+    VERIFY_IS_FALSE(expected.empty());
+
+    term.ClearPatternTree();
+    VERIFY_IS_TRUE(collectIntervals(term._patternIntervalTree).empty());
+
+    // With a budget of 0 the lock is released after every batch of 8 rows.
+    // The last acquisition publishes the results.
+    const auto stats = term.UpdatePatternsIncrementally(std::chrono::microseconds{ 0 });
+    VERIFY_IS_FALSE(stats.cancelled);
+    VERIFY_ARE_EQUAL(static_cast<size_t>((height + 7) / 8 + 1), stats.lockAcquisitions);
+
+    const auto actual = collectIntervals(term._patternIntervalTree);
+    VERIFY_ARE_EQUAL(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        VERIFY_IS_TRUE(expected[i] == actual[i]);
+    }
+
+    // The default budget can fit several batches into one acquisition, but never fewer than one.
+    const auto defaultStats = term.UpdatePatternsIncrementally();
+    VERIFY_IS_FALSE(defaultStats.cancelled);
+    VERIFY_IS_GREATER_THAN_OR_EQUAL(defaultStats.lockAcquisitions, size_t{ 2 });
+    VERIFY_IS_LESS_THAN_OR_EQUAL(defaultStats.lockAcquisitions, stats.lockAcquisitions);
+    VERIFY_ARE_EQUAL(expected.size(), collectIntervals(term._patternIntervalTree).size());
+}
+
+void TerminalApiTest::PatternScanCancelledByViewportChange()
+{
+    Terminal term;
+    DummyRenderer renderer{ &term };
+    term.Create({ 100, 20 }, 100, renderer);
+    term._activeBuffer().AddPatternRecognizer(linkPattern);
+
+    auto& stateMachine = *(term._stateMachine);
+    for (auto i = 0; i < 50; ++i)
+    {
+        stateMachine.ProcessString(L"https://example.com\r\n");
+    }
+
+    Terminal::PatternScan scan;
+    scan.buffer = &term._activeBuffer();
+    scan.generation = term._patternTreeGeneration;
+    scan.firstRow = term._VisibleStartIndex();
+    scan.lastRow = term._VisibleEndIndex();
+    scan.rowSize = term._activeBuffer().GetSize().Width();
+    VERIFY_IS_TRUE(term._isPatternScanCurrent(scan));
+
+    // Scrolling the viewport invalidates the scan...
+    term.UserScrollViewport(scan.firstRow - 5);
+    VERIFY_IS_FALSE(term._isPatternScanCurrent(scan));
+    term.UserScrollViewport(scan.firstRow);
+    VERIFY_IS_TRUE(term._isPatternScanCurrent(scan));
+
+    // ...as does any other change to the pattern tree.
+    term.ClearPatternTree();
+    VERIFY_IS_FALSE(term._isPatternScanCurrent(scan));
+}
+
+void TerminalApiTest::AltBufferIsReused()
+{
+    Terminal term;
+    DummyRenderer renderer{ &term };
+    term.Create({ 80, 30 }, 100, renderer);
+    auto& stateMachine = *(term._stateMachine);
+
+    Log::Comment(L"Enter the alt buffer, write some text and leave it again.");
+    stateMachine.ProcessString(L"\x1b[?1049h\x1b[5;5H\x1b[7mhello\x1b]8;;https://example.com\x1b\\link\x1b]8;;\x1b\\");
+    const auto firstAltBuffer = term._altBuffer.get();
+    VERIFY_IS_NOT_NULL(firstAltBuffer);
+    stateMachine.ProcessString(L"\x1b[?1049l");
+    VERIFY_IS_FALSE(term._inAltBuffer());
+    VERIFY_IS_FALSE(firstAltBuffer->IsActiveBuffer());
+    VERIFY_IS_TRUE(term._mainBuffer->IsActiveBuffer());
+
+    Log::Comment(L"Entering it again reuses the buffer, which looks as if it was new.");
+    stateMachine.ProcessString(L"\x1b[?1049h");
+    VERIFY_ARE_EQUAL(firstAltBuffer, term._altBuffer.get());
+    auto& altBuffer = *term._altBuffer;
+    VERIFY_IS_TRUE(altBuffer.IsActiveBuffer());
+    VERIFY_IS_FALSE(term._mainBuffer->IsActiveBuffer());
+    VERIFY_ARE_EQUAL(std::wstring(80, L' '), altBuffer.GetRowByOffset(4).GetText());
+    VERIFY_ARE_EQUAL(TextAttribute{}, altBuffer.GetRowByOffset(4).GetAttrByColumn(4));
+    VERIFY_THROWS(altBuffer.GetHyperlinkUriFromId(1), std::out_of_range);
+    VERIFY_ARE_EQUAL(term._mainBuffer->GetCursor().GetPosition(), altBuffer.GetCursor().GetPosition());
+    stateMachine.ProcessString(L"\x1b[?1049l");
+
+    Log::Comment(L"Pagers like less toggle all the time. The buffer is never recreated.");
+    auto reused = true;
+    for (auto i = 0; i < 100; ++i)
+    {
+        stateMachine.ProcessString(L"\x1b[?1049h\x1b[Hpager\x1b[?1049l");
+        reused = reused && term._altBuffer.get() == firstAltBuffer;
+    }
+    VERIFY_IS_TRUE(reused);
+    VERIFY_IS_FALSE(term._inAltBuffer());
+
+    Log::Comment(L"After a resize, a new buffer of the right size is created.");
+    VERIFY_SUCCEEDED(term.UserResize({ 100, 30 }));
+    stateMachine.ProcessString(L"\x1b[?1049h");
+    VERIFY_ARE_EQUAL(100, term._altBuffer->GetSize().Width());
+    stateMachine.ProcessString(L"\x1b[?1049l");
+}
+
+void TerminalApiTest::BlinkRedrawsOnlyBlinkingCells()
+{
+    Terminal term;
+    DummyRenderer renderer{ &term };
+    term.Create({ 80, 30 }, 100, renderer);
+    renderer.EnablePainting();
+    auto& stateMachine = *(term._stateMachine);
+    auto& renderSettings = term.GetRenderSettings();
+    renderSettings.SetRenderMode(Microsoft::Console::Render::RenderSettings::Mode::BlinkAllowed, true);
+
+    Log::Comment(L"A few blinking cells on two rows, with plain text around them.");
+    stateMachine.ProcessString(L"plain text \x1b[5mblink\x1b[m plain\r\n");
+    stateMachine.ProcessString(L"\x1b[10;20H\x1b[5mX\x1b[mY\x1b[10;40H\x1b[5mZ\x1b[m");
+
+    // A full blink cycle consists of two toggles. The renderer usually tells the
+    // settings that blinking cells are in use when it paints them.
+    const auto blink = [&]() {
+        renderSettings.MarkBlinkInUse();
+        renderSettings.ToggleBlinkRendition(renderer);
+        renderSettings.ToggleBlinkRendition(renderer);
+    };
+
+    blink();
+    const auto cells = renderer.GetBlinkRedrawCellCount();
+    Log::Comment(NoThrowString().Format(L"%zu cells invalidated per blink cycle, instead of %d", cells, 80 * 30));
+    // "blink" on the first row and the span from X to Z on the second.
+    VERIFY_ARE_EQUAL(5u + 21u, cells);
+
+    Log::Comment(L"Once the blinking cells are overwritten, nothing needs to be redrawn.");
+    stateMachine.ProcessString(L"\x1b[1;1H\x1b[2K\x1b[10;1H\x1b[2K");
+    blink();
+    VERIFY_ARE_EQUAL(0u, renderer.GetBlinkRedrawCellCount());
+}
@@ -0,0 +1,239 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include <WexTestClass.h>
+
+#include "../renderer/inc/DummyRenderer.hpp"
+#include "../renderer/base/Renderer.hpp"
+
+#include "../cascadia/TerminalCore/Terminal.hpp"
+#include "../../types/inc/VtRecording.hpp"
+
+using namespace Microsoft::Terminal::Core;
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Utils;
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace
+{
+    // Counts how often the terminal asks the renderer to repaint something.
+    // This is what a replay measures besides time: a change that makes the
+    // terminal invalidate more than it needs to is a performance regression too.
+    class CountingRenderEngine final : public RenderEngineBase
+    {
+    public:
+        struct Counters
+        {
+            size_t invalidate = 0;
+            size_t invalidateCursor = 0;
+            size_t invalidateScroll = 0;
+            size_t invalidateAll = 0;
+            size_t invalidateSelection = 0;
+        };
+
+        Counters counters;
+
+        HRESULT StartPaint() noexcept { return S_OK; }
+        HRESULT EndPaint() noexcept { return S_OK; }
+        HRESULT Present() noexcept { return S_OK; }
+        HRESULT PrepareForTeardown(_Out_ bool* pForcePaint) noexcept
+        {
+            *pForcePaint = false;
+            return S_OK;
+        }
+        HRESULT ScrollFrame() noexcept { return S_OK; }
+        HRESULT Invalidate(const til::rect* /*psrRegion*/) noexcept
+        {
+            counters.invalidate++;
+            return S_OK;
+        }
+        HRESULT InvalidateCursor(const til::rect* /*psrRegion*/) noexcept
+        {
+            counters.invalidateCursor++;
+            return S_OK;
+        }
+        HRESULT InvalidateSystem(const til::rect* /*prcDirtyClient*/) noexcept { return S_OK; }
+        HRESULT InvalidateSelection(const std::vector<til::rect>& /*rectangles*/) noexcept
+        {
+            counters.invalidateSelection++;
+            return S_OK;
+        }
+        HRESULT InvalidateScroll(const til::point* /*pcoordDelta*/) noexcept
+        {
+            counters.invalidateScroll++;
+            return S_OK;
+        }
+        HRESULT InvalidateAll() noexcept
+        {
+            counters.invalidateAll++;
+            return S_OK;
+        }
+        HRESULT InvalidateCircling(_Out_ bool* pForcePaint) noexcept
+        {
+            *pForcePaint = false;
+            return S_OK;
+        }
+        HRESULT PaintBackground() noexcept { return S_OK; }
+        HRESULT PaintBufferLine(std::span<const Cluster> /*clusters*/, til::point /*coord*/, bool /*fTrimLeft*/, bool /*lineWrapped*/) noexcept { return S_OK; }
+        HRESULT PaintBufferGridLines(GridLineSet /*lines*/, COLORREF /*color*/, size_t /*cchLine*/, til::point /*coordTarget*/) noexcept { return S_OK; }
+        HRESULT PaintSelection(const til::rect& /*rect*/) noexcept { return S_OK; }
+        HRESULT PaintCursor(const CursorOptions& /*options*/) noexcept { return S_OK; }
+        HRESULT UpdateDrawingBrushes(const TextAttribute& /*textAttributes*/, const RenderSettings& /*renderSettings*/, gsl::not_null<IRenderData*> /*pData*/, bool /*usingSoftFont*/, bool /*isSettingDefaultBrushes*/) noexcept { return S_OK; }
+        HRESULT UpdateFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/) noexcept { return S_OK; }
+        HRESULT UpdateDpi(int /*iDpi*/) noexcept { return S_OK; }
+        HRESULT UpdateViewport(const til::inclusive_rect& /*srNewViewport*/) noexcept { return S_OK; }
+        HRESULT GetProposedFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/, int /*iDpi*/) noexcept { return S_OK; }
+        HRESULT GetDirtyArea(std::span<const til::rect>& area) noexcept
+        {
+            area = {};
+            return S_OK;
+        }
+        HRESULT GetFontSize(_Out_ til::size* pFontSize) noexcept
+        {
+            *pFontSize = { 1, 1 };
+            return S_OK;
+        }
+        HRESULT IsGlyphWideByFont(std::wstring_view /*glyph*/, _Out_ bool* pResult) noexcept
+        {
+            *pResult = false;
+            return S_OK;
+        }
+
+    protected:
+        HRESULT _DoUpdateTitle(const std::wstring_view /*newTitle*/) noexcept { return S_OK; }
+    };
+}
+
+namespace TerminalCoreUnitTests
+{
+    class VtReplayTests;
+};
+using namespace TerminalCoreUnitTests;
+
+// Replays a recording made with WT_VT_RECORDING_DIR (see VtRecording.hpp) through a real
+// Terminal, exactly like ControlCore would: every output frame is written under the write lock.
+//
+// This test is skipped unless a recording is passed in:
+//   te.exe UnitTests_TerminalCore.dll /name:*VtReplayTests* /p:VtRecording=C:\path\to\session.vtrec
+// Optional parameters:
+//   /p:RealTime=true      Sleep between frames to reproduce the original timing.
+//   /p:Scrollback=<n>     Size of the scrollback (default: 9001).
+class TerminalCoreUnitTests::VtReplayTests final
+{
+    TEST_CLASS(VtReplayTests);
+
+    TEST_METHOD(Replay)
+    {
+        String path;
+        if (FAILED(RuntimeParameters::TryGetValue(L"VtRecording", path)) || path.IsEmpty())
+        {
+            Log::Comment(L"No recording given. Pass /p:VtRecording=<path> to replay one.");
+            Log::Result(TestResults::Skipped);
+            return;
+        }
+
+        auto realTime = false;
+        RuntimeParameters::TryGetValue(L"RealTime", realTime);
+        int scrollback = 9001;
+        RuntimeParameters::TryGetValue(L"Scrollback", scrollback);
+
+        VtRecordingReader reader{ std::filesystem::path{ static_cast<const wchar_t*>(path) } };
+
+        // The recording starts with the initial size of the connection.
+        // 120x30 is only used for recordings that somehow lack it.
+        til::size size{ 120, 30 };
+        if (const auto first = reader.Next(); first && first->type == VtRecordingFrameType::Resize && first->payload.size() == sizeof(VtRecordingResize))
+        {
+            VtRecordingResize resize{};
+            memcpy(&resize, first->payload.data(), sizeof(resize));
+            size = { gsl::narrow<til::CoordType>(resize.columns), gsl::narrow<til::CoordType>(resize.rows) };
+        }
+        reader.Rewind();
+
+        Terminal term;
+        CountingRenderEngine engine;
+        DummyRenderer renderer{ &term };
+        renderer.AddRenderEngine(&engine);
+        term.Create(size, scrollback, renderer);
+
+        using clock = std::chrono::steady_clock;
+        clock::duration writeTime{};
+        clock::duration lockTime{};
+        clock::duration slowestFrame{};
+        size_t outputFrames = 0;
+        size_t inputFrames = 0;
+        size_t resizeFrames = 0;
+        size_t bytes = 0;
+
+        til::u8state u8State;
+        std::wstring u16Str;
+        const auto start = clock::now();
+
+        while (const auto frame = reader.Next())
+        {
+            if (realTime)
+            {
+                std::this_thread::sleep_until(start + frame->timestamp);
+            }
+
+            switch (frame->type)
+            {
+            case VtRecordingFrameType::Output:
+            {
+                outputFrames++;
+                bytes += frame->payload.size();
+                THROW_IF_FAILED(til::u8u16(frame->payload, u16Str, u8State));
+
+                const auto beforeLock = clock::now();
+                const auto lock = term.LockForWriting();
+                const auto beforeWrite = clock::now();
+                term.Write(u16Str);
+                const auto afterWrite = clock::now();
+
+                lockTime += beforeWrite - beforeLock;
+                writeTime += afterWrite - beforeWrite;
+                slowestFrame = std::max(slowestFrame, afterWrite - beforeWrite);
+                break;
+            }
+            case VtRecordingFrameType::Resize:
+            {
+                resizeFrames++;
+                VtRecordingResize resize{};
+                if (frame->payload.size() == sizeof(resize))
+                {
+                    memcpy(&resize, frame->payload.data(), sizeof(resize));
+                    const auto lock = term.LockForWriting();
+                    LOG_IF_FAILED(term.UserResize({ gsl::narrow<til::CoordType>(resize.columns), gsl::narrow<til::CoordType>(resize.rows) }));
+                }
+                break;
+            }
+            default:
+                // Input went to the application, not the terminal. The output frames
+                // already contain the application's reaction to it.
+                inputFrames++;
+                break;
+            }
+        }
+
+        const auto totalTime = clock::now() - start;
+        const auto toMs = [](clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+        const auto& c = engine.counters;
+
+        Log::Comment(NoThrowString().Format(L"Frames: %zu output, %zu input, %zu resize; %zu bytes", outputFrames, inputFrames, resizeFrames, bytes));
+        Log::Comment(NoThrowString().Format(L"Total: %.3fms, Write: %.3fms, Lock wait: %.3fms, Slowest frame: %.3fms", toMs(totalTime), toMs(writeTime), toMs(lockTime), toMs(slowestFrame)));
+        if (writeTime.count() > 0)
+        {
+            Log::Comment(NoThrowString().Format(L"Throughput: %.2f MB/s", bytes / 1e6 / std::chrono::duration<double>(writeTime).count()));
+        }
+        Log::Comment(NoThrowString().Format(L"Render triggers: %zu invalidate, %zu cursor, %zu scroll, %zu all, %zu selection",
+                                            c.invalidate,
+                                            c.invalidateCursor,
+                                            c.invalidateScroll,
+                                            c.invalidateAll,
+                                            c.invalidateSelection));
+    }
+};
@@ -21,6 +21,8 @@
 
 #include "../interactivity/inc/ServiceLocator.hpp"
 
+#include <til/scan.h>
+
 #pragma hdrstop
 using namespace Microsoft::Console::Types;
 using Microsoft::Console::Interactivity::ServiceLocator;
@@ -198,6 +200,32 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
             // WCL-NOTE: to be identical to lpString. They are incremented in lockstep, never separately, and lpString
             // WCL-NOTE: is initialized from pwchRealUnicode.
             const auto RealUnicodeChar = *pwchRealUnicode;
+
+            // Runs of printable ASCII are by far the most common input. They're always narrow
+            // glyphs and can be copied in one go, instead of measuring them one by one.
+            if (Char >= L' ' && Char < 0x7F)
+            {
+                static constexpr til::scan::char_class nonPrintableAscii{ { L'\x00', L'\x1f' }, { L'\x7f', L'\xffff' } };
+                const auto limit = std::min({
+                    // Rounded up, because the per-character loop below consumes a trailing odd byte as a whole character, too.
+                    (BufferSize - *pcb + 1) / sizeof(WCHAR),
+                    static_cast<size_t>(LOCAL_BUFFER_SIZE - i),
+                    static_cast<size_t>(coordScreenBufferSize.width - XPosition),
+                });
+                const auto end = til::scan::find_first_of({ lpString, limit }, nonPrintableAscii);
+                const auto count = end == til::scan::npos ? limit : end;
+                const auto countCoord = gsl::narrow_cast<til::CoordType>(count);
+
+                LocalBufPtr = std::copy_n(lpString, count, LocalBufPtr);
+                XPosition += countCoord;
+                i += countCoord;
+                pwchBuffer += count;
+                lpString += count;
+                pwchRealUnicode += count;
+                *pcb += count * sizeof(WCHAR);
+                continue;
+            }
+
             if (IS_GLYPH_CHAR(RealUnicodeChar) || fUnprocessed)
             {
                 // WCL-NOTE: This operates on a single code unit instead of a whole codepoint. It will mis-measure surrogate pairs.
@@ -674,7 +674,6 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 {
     try
     {
-        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
         const auto& storageBuffer = context.GetActiveBuffer().GetTextBuffer();
         const auto storageSize = storageBuffer.GetSize().Dimensions();
 
@@ -712,40 +711,33 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
         // We will start reading the buffer at the point of the top left corner (origin) of the (potentially adjusted) request
         const auto sourcePoint = clippedRequestRectangle.Origin();
 
-        // Get an iterator to the beginning of the return buffer
-        // We might have to seek this forward or skip around if we clipped the request.
-        auto targetIter = targetBuffer.begin();
-        til::point targetPos;
-        const auto targetLimit = Viewport::FromDimensions(targetPoint, clippedRequestRectangle.Dimensions());
-
-        // Get an iterator to the beginning of the request inside the screen buffer
+        // Walk through the request inside the screen buffer one span of equal attributes at a time.
         // This should walk exactly along every cell of the clipped request.
-        auto sourceIter = storageBuffer.GetCellDataAt(sourcePoint, clippedRequestRectangle);
-
-        // Walk through every cell of the target, advancing the buffer.
-        // Validate that we always still have a valid iterator to the backing store,
-        // that we always are writing inside the user's buffer (before the end)
-        // and we're always targeting the user's buffer inside its original bounds.
-        while (sourceIter && targetIter < targetBuffer.end())
+        for (auto it = storageBuffer.GetRowSpansAt(sourcePoint, clippedRequestRectangle); it; ++it)
         {
-            // If the point we're trying to write is inside the limited buffer write zone...
-            if (targetLimit.IsInBounds(targetPos))
-            {
-                // Copy the data into position...
-                *targetIter = gci.AsCharInfo(*sourceIter);
-                // ... and advance the read iterator.
-                ++sourceIter;
-            }
+            const auto& span = *it;
 
-            // Always advance the write iterator, we might have skipped it due to clipping.
-            ++targetIter;
+            // If the current text attributes aren't legacy attributes, then this maps
+            // the RGB values to the nearest table value. We only need to do that once per span.
+            const auto legacyAttributes = span.attr.GetLegacyAttributes();
 
-            // Increment the target
-            targetPos.x++;
-            if (targetPos.x >= targetSize.width)
+            // The cells of the span are written into the row of the user's buffer that corresponds
+            // to the source row, offset by targetPoint in case we clipped the request.
+            const auto targetRow = targetPoint.y + span.y - sourcePoint.y;
+            const auto targetOffset = targetPoint.x - sourcePoint.x;
+
+            for (auto col = span.columnBegin; col < span.columnEnd; ++col)
             {
-                targetPos.x = 0;
-                targetPos.y++;
+                const auto targetIndex = gsl::narrow_cast<size_t>(targetRow * targetSize.width + targetOffset + col);
+                // Validate that we're always writing inside the user's buffer.
+                if (targetIndex >= targetBuffer.size())
+                {
+                    break;
+                }
+
+                auto& ci = til::at(targetBuffer, targetIndex);
+                ci.Char.UnicodeChar = Utf16ToUcs2(span.row->GlyphAt(col));
+                ci.Attributes = legacyAttributes | GeneratePublicApiAttributeFormat(span.row->DbcsAttrAt(col));
             }
         }
 
@@ -92,27 +92,37 @@ static void _CopyRectangle(SCREEN_INFORMATION& screenInfo,
         }
     }
 
-    // 2. We can move any other scenario in-place without copying. We just have to carefully
-    //    choose which direction we walk through filling up the target so it doesn't accidentally
-    //    erase the source material before it can be copied/moved to the new location.
+    // 2. We can move any other scenario one row at a time. Each source row is read in its entirety
+    //    before the target row is written, so we only have to carefully choose which direction we walk
+    //    through the rows so it doesn't accidentally erase the source material before it can be
+    //    copied/moved to the new location. Reading the whole row first also ensures that
+    //    a two-cell DBCS character can't accidentally delete itself when moving horizontally.
     {
+        auto& buffer = screenInfo.GetTextBuffer();
         const auto target = Viewport::FromDimensions(targetOrigin, source.Dimensions());
         const auto walkDirection = Viewport::DetermineWalkDirection(source, target);
+        const auto height = source.Height();
 
-        auto sourcePos = source.GetWalkOrigin(walkDirection);
-        auto targetPos = target.GetWalkOrigin(walkDirection);
+        std::vector<OutputCell> cells;
+        cells.reserve(gsl::narrow_cast<size_t>(source.Width()));
 
-        // Note that we read two cells from the source before we start writing
-        // to the target, so a two-cell DBCS character can't accidentally delete
-        // itself when moving one cell horizontally.
-        auto next = OutputCell(*screenInfo.GetCellDataAt(sourcePos));
-        do
+        for (til::CoordType i = 0; i < height; ++i)
         {
-            const auto current = next;
-            source.WalkInBounds(sourcePos, walkDirection);
-            next = OutputCell(*screenInfo.GetCellDataAt(sourcePos));
-            screenInfo.GetTextBuffer().WriteLine(OutputCellIterator({ &current, 1 }), targetPos);
-        } while (target.WalkInBounds(targetPos, walkDirection));
+            const auto offset = walkDirection.y == Viewport::YWalk::BottomToTop ? height - 1 - i : i;
+            const til::point sourcePos{ source.Left(), source.Top() + offset };
+            const auto sourceLine = Viewport::FromDimensions(sourcePos, { source.Width(), 1 });
+
+            cells.clear();
+            for (auto it = buffer.GetRowSpansAt(sourcePos, sourceLine); it; ++it)
+            {
+                for (auto col = it->columnBegin; col < it->columnEnd; ++col)
+                {
+                    cells.emplace_back(it->row->GlyphAt(col), it->row->DbcsAttrAt(col), it->attr);
+                }
+            }
+
+            buffer.WriteLine(OutputCellIterator(cells), { target.Left(), target.Top() + offset }, std::nullopt, target.RightInclusive());
+        }
     }
 }
 
@@ -141,33 +151,36 @@ std::vector<WORD> ReadOutputAttributes(const SCREEN_INFORMATION& screenInfo,
     }
 
     // Get iterator to the position we should start reading at.
-    auto it = screenInfo.GetCellDataAt(coordRead);
+    auto it = screenInfo.GetTextBuffer().GetRowSpansAt(coordRead);
     // Count up the number of cells we've attempted to read.
-    ULONG amountRead = 0;
+    size_t amountRead = 0;
     // Prepare the return value string.
     std::vector<WORD> retVal;
     // Reserve the number of cells. If we have >U+FFFF, it will auto-grow later and that's OK.
     retVal.reserve(amountToRead);
 
     // While we haven't read enough cells yet and the iterator is still valid (hasn't reached end of buffer)
-    while (amountRead < amountToRead && it)
+    for (; amountRead < amountToRead && it; ++it)
     {
-        const auto legacyAttributes = it->TextAttr().GetLegacyAttributes();
+        // All cells of a span share their attributes, so we only need to convert them once.
+        const auto legacyAttributes = it->attr.GetLegacyAttributes();
 
-        // If the first thing we read is trailing, pad with a space.
-        // OR If the last thing we read is leading, pad with a space.
-        if ((amountRead == 0 && it->DbcsAttr() == DbcsAttribute::Trailing) ||
-            (amountRead == (amountToRead - 1) && it->DbcsAttr() == DbcsAttribute::Leading))
+        for (auto col = it->columnBegin; col < it->columnEnd && amountRead < amountToRead; ++col, ++amountRead)
         {
-            retVal.push_back(legacyAttributes);
-        }
-        else
-        {
-            retVal.push_back(legacyAttributes | GeneratePublicApiAttributeFormat(it->DbcsAttr()));
-        }
+            const auto dbcsAttr = it->row->DbcsAttrAt(col);
 
-        amountRead++;
-        it++;
+            // If the first thing we read is trailing, pad with a space.
+            // OR If the last thing we read is leading, pad with a space.
+            if ((amountRead == 0 && dbcsAttr == DbcsAttribute::Trailing) ||
+                (amountRead == (amountToRead - 1) && dbcsAttr == DbcsAttribute::Leading))
+            {
+                retVal.push_back(legacyAttributes);
+            }
+            else
+            {
+                retVal.push_back(legacyAttributes | GeneratePublicApiAttributeFormat(dbcsAttr));
+            }
+        }
     }
 
     return retVal;
@@ -198,36 +211,47 @@ std::wstring ReadOutputStringW(const SCREEN_INFORMATION& screenInfo,
     }
 
     // Get iterator to the position we should start reading at.
-    auto it = screenInfo.GetCellDataAt(coordRead);
+    auto it = screenInfo.GetTextBuffer().GetRowSpansAt(coordRead);
 
     // Count up the number of cells we've attempted to read.
-    ULONG amountRead = 0;
+    size_t amountRead = 0;
 
     // Prepare the return value string.
     std::wstring retVal;
     retVal.reserve(amountToRead); // Reserve the number of cells. If we have >U+FFFF, it will auto-grow later and that's OK.
 
     // While we haven't read enough cells yet and the iterator is still valid (hasn't reached end of buffer)
-    while (amountRead < amountToRead && it)
+    for (; amountRead < amountToRead && it; ++it)
     {
+        const auto& row = *it->row;
+        const auto columns = gsl::narrow_cast<til::CoordType>(std::min<size_t>(it->Columns(), amountToRead - amountRead));
+        auto textBegin = it->columnBegin;
+        auto textEnd = it->columnBegin + columns;
+        auto padEnd = false;
+
         // If the first thing we read is trailing, pad with a space.
-        // OR If the last thing we read is leading, pad with a space.
-        if ((amountRead == 0 && it->DbcsAttr() == DbcsAttribute::Trailing) ||
-            (amountRead == (amountToRead - 1) && it->DbcsAttr() == DbcsAttribute::Leading))
+        if (amountRead == 0 && row.DbcsAttrAt(textBegin) == DbcsAttribute::Trailing)
         {
             retVal += UNICODE_SPACE;
+            textBegin++;
         }
-        else
+
+        amountRead += columns;
+
+        // If the last thing we read is leading, pad with a space.
+        if (amountRead == amountToRead && textBegin < textEnd && row.DbcsAttrAt(textEnd - 1) == DbcsAttribute::Leading)
         {
-            // Otherwise, add anything that isn't a trailing cell. (Trailings are duplicate copies of the leading.)
-            if (it->DbcsAttr() != DbcsAttribute::Trailing)
-            {
-                retVal += it->Chars();
-            }
+            padEnd = true;
+            textEnd--;
         }
 
-        amountRead++;
-        it++;
+        // Otherwise, add anything that isn't a trailing cell. (Trailings are duplicate copies of the leading.)
+        retVal += row.GetText(textBegin, textEnd);
+
+        if (padEnd)
+        {
+            retVal += UNICODE_SPACE;
+        }
     }
 
     return retVal;
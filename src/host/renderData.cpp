@@ -313,9 +313,8 @@ const std::wstring RenderData::GetHyperlinkCustomId(uint16_t id) const
 }
 
 // For now, we ignore regex patterns in conhost
-const std::vector<size_t> RenderData::GetPatternId(const til::point /*location*/) const
+void RenderData::GetPatternsInRow(const til::point /*begin*/, const til::CoordType /*endX*/, std::vector<Microsoft::Console::Render::PatternInterval>& /*patterns*/) const
 {
-    return {};
 }
 
 // Routine Description:
@@ -94,6 +94,23 @@ SCREEN_INFORMATION::~SCREEN_INFORMATION()
                                                           const TextAttribute popupAttributes,
                                                           const UINT uiCursorSize,
                                                           _Outptr_ SCREEN_INFORMATION** const ppScreen)
+{
+    return _CreateInstance(coordWindowSize, fontInfo, coordScreenBufferSize, defaultAttributes, popupAttributes, uiCursorSize, nullptr, ppScreen);
+}
+
+// Routine Description:
+// - Same as CreateInstance, but the screen buffer can be given an existing text buffer
+//   of the right size, which will be reset instead of allocating a new one.
+// Arguments:
+// - textBuffer - optionally, the text buffer to reuse.
+[[nodiscard]] NTSTATUS SCREEN_INFORMATION::_CreateInstance(_In_ til::size coordWindowSize,
+                                                           const FontInfo fontInfo,
+                                                           _In_ til::size coordScreenBufferSize,
+                                                           const TextAttribute defaultAttributes,
+                                                           const TextAttribute popupAttributes,
+                                                           const UINT uiCursorSize,
+                                                           std::unique_ptr<TextBuffer> textBuffer,
+                                                           _Outptr_ SCREEN_INFORMATION** const ppScreen)
 {
     *ppScreen = nullptr;
 
@@ -114,11 +131,20 @@ SCREEN_INFORMATION::~SCREEN_INFORMATION()
         pScreen->UpdateBottom();
 
         // Set up text buffer
-        pScreen->_textBuffer = std::make_unique<TextBuffer>(coordScreenBufferSize,
-                                                            defaultAttributes,
-                                                            uiCursorSize,
-                                                            pScreen->IsActiveScreenBuffer(),
-                                                            *ServiceLocator::LocateGlobals().pRender);
+        if (textBuffer)
+        {
+            textBuffer->ResetToDefaults(defaultAttributes, uiCursorSize);
+            textBuffer->SetAsActiveBuffer(pScreen->IsActiveScreenBuffer());
+            pScreen->_textBuffer = std::move(textBuffer);
+        }
+        else
+        {
+            pScreen->_textBuffer = std::make_unique<TextBuffer>(coordScreenBufferSize,
+                                                                defaultAttributes,
+                                                                uiCursorSize,
+                                                                pScreen->IsActiveScreenBuffer(),
+                                                                *ServiceLocator::LocateGlobals().pRender);
+        }
 
         const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
         pScreen->_textBuffer->GetCursor().SetType(gci.GetCursorType());
@@ -1862,13 +1888,23 @@ const SCREEN_INFORMATION& SCREEN_INFORMATION::GetMainBuffer() const
     auto initAttributes = GetAttributes();
     initAttributes.SetStandardErase();
 
-    auto Status = SCREEN_INFORMATION::CreateInstance(WindowSize,
-                                                     existingFont,
-                                                     WindowSize,
-                                                     initAttributes,
-                                                     GetPopupAttributes(),
-                                                     Cursor::CURSOR_SMALL_SIZE,
-                                                     ppsiNewScreenBuffer);
+    // Applications like pagers and editors switch to the alt buffer and back
+    // a lot. If the size didn't change, we reuse the text buffer of the last
+    // one instead of allocating and constructing all of its rows again.
+    auto& retainedTextBuffer = GetMainBuffer()._retainedAltTextBuffer;
+    if (retainedTextBuffer && retainedTextBuffer->GetSize().Dimensions() != WindowSize)
+    {
+        retainedTextBuffer.reset();
+    }
+
+    auto Status = SCREEN_INFORMATION::_CreateInstance(WindowSize,
+                                                      existingFont,
+                                                      WindowSize,
+                                                      initAttributes,
+                                                      GetPopupAttributes(),
+                                                      Cursor::CURSOR_SMALL_SIZE,
+                                                      std::move(retainedTextBuffer),
+                                                      ppsiNewScreenBuffer);
     if (SUCCEEDED_NTSTATUS(Status))
     {
         // Update the alt buffer's cursor style, visibility, and position to match our own.
@@ -2052,6 +2088,11 @@ void SCREEN_INFORMATION::UseMainScreenBuffer()
         // Copy the alt buffer's output mode back to the main buffer.
         psiMain->OutputMode = psiAlt->OutputMode;
 
+        // Keep the alt buffer's text buffer for the next call to UseAlternateScreenBuffer.
+        // It's hidden until then and must not send any invalidations to the renderer.
+        psiMain->_retainedAltTextBuffer = std::move(psiAlt->_textBuffer);
+        psiMain->_retainedAltTextBuffer->SetAsActiveBuffer(false);
+
         s_RemoveScreenBuffer(psiAlt); // this will also delete the alt buffer
         // deleting the alt buffer will give the GetSet back to its main
 
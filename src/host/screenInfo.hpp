@@ -254,6 +254,14 @@ private:
     [[nodiscard]] NTSTATUS _InitializeOutputStateMachine();
     void _FreeOutputStateMachine();
 
+    [[nodiscard]] static NTSTATUS _CreateInstance(_In_ til::size coordWindowSize,
+                                                  const FontInfo fontInfo,
+                                                  _In_ til::size coordScreenBufferSize,
+                                                  const TextAttribute defaultAttributes,
+                                                  const TextAttribute popupAttributes,
+                                                  const UINT uiCursorSize,
+                                                  std::unique_ptr<TextBuffer> textBuffer,
+                                                  _Outptr_ SCREEN_INFORMATION** const ppScreen);
     [[nodiscard]] NTSTATUS _CreateAltBuffer(_Out_ SCREEN_INFORMATION** const ppsiNewScreenBuffer);
 
     bool _IsAltBuffer() const;
@@ -270,6 +278,7 @@ private:
 
     SCREEN_INFORMATION* _psiAlternateBuffer; // The VT "Alternate" screen buffer.
     SCREEN_INFORMATION* _psiMainBuffer; // A pointer to the main buffer, if this is the alternate buffer.
+    std::unique_ptr<TextBuffer> _retainedAltTextBuffer; // The text buffer of the last alternate buffer, for reuse by the next one.
 
     til::rect _rcAltSavedClientNew;
     til::rect _rcAltSavedClientOld;
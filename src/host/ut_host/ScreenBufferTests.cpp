@@ -102,6 +102,8 @@ class ScreenBufferTests
 
     TEST_METHOD(AlternateBufferCursorInheritanceTest);
 
+    TEST_METHOD(AlternateBufferTextBufferReuseTest);
+
     TEST_METHOD(TestReverseLineFeed);
 
     TEST_METHOD(TestResetClearTabStops);
@@ -442,6 +444,47 @@ void ScreenBufferTests::AlternateBufferCursorInheritanceTest()
     VERIFY_ARE_EQUAL(altCursorBlinking, mainCursor.IsBlinkingAllowed());
 }
 
+void ScreenBufferTests::AlternateBufferTextBufferReuseTest()
+{
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    gci.LockConsole(); // Lock must be taken to manipulate buffer.
+    auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+    auto& mainBuffer = gci.GetActiveOutputBuffer();
+    auto& stateMachine = mainBuffer.GetStateMachine();
+
+    Log::Comment(L"Switch to the alternate buffer and write some text.");
+    VERIFY_SUCCEEDED(mainBuffer.UseAlternateScreenBuffer());
+    const auto firstTextBuffer = &gci.GetActiveOutputBuffer().GetTextBuffer();
+    stateMachine.ProcessString(L"\x1b[31mfirst\x1b]8;;https://example.com\x1b\\link\x1b]8;;\x1b\\");
+    gci.GetActiveOutputBuffer().UseMainScreenBuffer();
+
+    Log::Comment(L"While it's retained, the text buffer is hidden and mustn't talk to the renderer.");
+    VERIFY_ARE_EQUAL(firstTextBuffer, mainBuffer._retainedAltTextBuffer.get());
+    VERIFY_IS_FALSE(firstTextBuffer->IsActiveBuffer());
+    VERIFY_IS_TRUE(mainBuffer.GetTextBuffer().IsActiveBuffer());
+
+    Log::Comment(L"Switch again. The text buffer is reused, but it's empty.");
+    VERIFY_SUCCEEDED(mainBuffer.UseAlternateScreenBuffer());
+    auto& altBuffer = gci.GetActiveOutputBuffer();
+    auto useMain = wil::scope_exit([&] { altBuffer.UseMainScreenBuffer(); });
+
+    auto& altTextBuffer = altBuffer.GetTextBuffer();
+    VERIFY_ARE_EQUAL(firstTextBuffer, &altTextBuffer);
+    VERIFY_IS_TRUE(altTextBuffer.IsActiveBuffer());
+    VERIFY_IS_FALSE(mainBuffer.GetTextBuffer().IsActiveBuffer());
+    VERIFY_ARE_EQUAL(mainBuffer.GetViewport().Dimensions(), altTextBuffer.GetSize().Dimensions());
+    VERIFY_ARE_EQUAL(std::wstring(altTextBuffer.GetSize().Width(), L' '), altTextBuffer.GetRowByOffset(0).GetText());
+    VERIFY_THROWS(altTextBuffer.GetHyperlinkUriFromId(1), std::out_of_range);
+
+    Log::Comment(L"The cursor is still inherited from the main buffer.");
+    const auto& mainCursor = mainBuffer.GetTextBuffer().GetCursor();
+    auto expectedPosition = mainCursor.GetPosition();
+    expectedPosition.y -= mainBuffer.GetVirtualViewport().Top();
+    VERIFY_ARE_EQUAL(expectedPosition, altTextBuffer.GetCursor().GetPosition());
+    VERIFY_ARE_EQUAL(mainCursor.GetSize(), altTextBuffer.GetCursor().GetSize());
+}
+
 void ScreenBufferTests::TestReverseLineFeed()
 {
     auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
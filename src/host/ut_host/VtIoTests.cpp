@@ -392,9 +392,8 @@ public:
         return {};
     }
 
-    const std::vector<size_t> GetPatternId(const til::point /*location*/) const
+    void GetPatternsInRow(const til::point /*begin*/, const til::CoordType /*endX*/, std::vector<PatternInterval>& /*patterns*/) const
     {
-        return {};
     }
 };
 
@@ -0,0 +1,213 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include <wextestclass.h>
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../../renderer/vt/VtPipeWriter.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console::Render;
+
+// Reads from a pipe on a background thread, like a terminal would. It can be
+// slowed down or held back entirely, to simulate a terminal that's busy.
+class SlowPipeReader
+{
+public:
+    SlowPipeReader(wil::unique_hfile pipe, const DWORD delayPerRead) :
+        _pipe{ std::move(pipe) },
+        _delayPerRead{ delayPerRead }
+    {
+        _thread = std::thread([this]() {
+            _released.wait();
+
+            char buffer[1024];
+            for (;;)
+            {
+                DWORD read = 0;
+                if (!ReadFile(_pipe.get(), &buffer[0], sizeof(buffer), &read, nullptr))
+                {
+                    break;
+                }
+                _received.append(&buffer[0], read);
+                Sleep(_delayPerRead);
+            }
+        });
+    }
+
+    ~SlowPipeReader()
+    {
+        Release();
+        if (_thread.joinable())
+        {
+            _thread.join();
+        }
+    }
+
+    void Release() noexcept
+    {
+        _released.SetEvent();
+    }
+
+    // Waits for the writer to close its end of the pipe and returns everything that was read.
+    const std::string& Join()
+    {
+        Release();
+        _thread.join();
+        return _received;
+    }
+
+private:
+    wil::unique_hfile _pipe;
+    DWORD _delayPerRead;
+    wil::slim_event_manual_reset _released;
+    std::string _received;
+    std::thread _thread;
+};
+
+class VtPipeWriterTests
+{
+    TEST_CLASS(VtPipeWriterTests);
+
+    TEST_METHOD(WritesArriveInOrder)
+    {
+        auto [reader, writer] = _CreatePipe();
+        SlowPipeReader slowReader{ std::move(reader), 1 };
+        slowReader.Release();
+
+        std::string expected;
+        {
+            VtPipeWriter pipeWriter{ std::move(writer), 16 * 1024 };
+
+            std::string buffer;
+            for (auto i = 0; i < 2000; ++i)
+            {
+                fmt::format_to(std::back_inserter(buffer), FMT_COMPILE("\x1b[{};1Hline {}\r\n"), i % 30 + 1, i);
+                expected.append(buffer);
+                VERIFY_SUCCEEDED(pipeWriter.Write(buffer));
+                // The buffer is handed over, not copied.
+                VERIFY_IS_TRUE(buffer.empty());
+            }
+
+            VERIFY_SUCCEEDED(pipeWriter.Drain());
+
+            const auto stats = pipeWriter.GetStats();
+            VERIFY_ARE_EQUAL(uint64_t{ expected.size() }, stats.bytesWritten);
+            VERIFY_IS_TRUE(stats.peakBytesQueued > 0);
+        }
+
+        VERIFY_ARE_EQUAL(expected, slowReader.Join());
+    }
+
+    // As long as the high-water mark isn't reached, writing must not block even if the terminal doesn't read anything.
+    TEST_METHOD(WriteDoesNotBlockOnPipe)
+    {
+        auto [reader, writer] = _CreatePipe();
+        SlowPipeReader slowReader{ std::move(reader), 0 };
+
+        uint64_t total = 0;
+        {
+            VtPipeWriter pipeWriter{ std::move(writer), 1024 * 1024 };
+
+            for (auto i = 0; i < 64; ++i)
+            {
+                std::string buffer(8 * 1024, static_cast<char>('a' + i % 26));
+                total += buffer.size();
+                VERIFY_SUCCEEDED(pipeWriter.Write(buffer));
+            }
+
+            auto stats = pipeWriter.GetStats();
+            VERIFY_ARE_EQUAL(0ull, stats.stalls);
+            VERIFY_ARE_EQUAL(total, stats.bytesQueued + stats.bytesWritten);
+
+            slowReader.Release();
+            VERIFY_SUCCEEDED(pipeWriter.Drain());
+
+            stats = pipeWriter.GetStats();
+            VERIFY_ARE_EQUAL(total, stats.bytesWritten);
+            VERIFY_ARE_EQUAL(0ull, stats.bytesQueued);
+        }
+
+        VERIFY_ARE_EQUAL(total, uint64_t{ slowReader.Join().size() });
+    }
+
+    // Once the high-water mark is exceeded, Write() waits for the terminal to catch up.
+    TEST_METHOD(StallsAtHighWaterMark)
+    {
+        auto [reader, writer] = _CreatePipe();
+        SlowPipeReader slowReader{ std::move(reader), 1 };
+
+        // The terminal starts reading after a while. Until then the writer thread is stuck
+        // in WriteFile(), the queue fills up and Write() has to wait for the terminal.
+        auto releaser = std::thread([&]() {
+            Sleep(100);
+            slowReader.Release();
+        });
+
+        uint64_t total = 0;
+        {
+            VtPipeWriter pipeWriter{ std::move(writer), 16 * 1024 };
+
+            for (auto i = 0; i < 32; ++i)
+            {
+                std::string buffer(16 * 1024, 'x');
+                total += buffer.size();
+                VERIFY_SUCCEEDED(pipeWriter.Write(buffer));
+            }
+            VERIFY_SUCCEEDED(pipeWriter.Drain());
+
+            const auto stats = pipeWriter.GetStats();
+            Log::Comment(NoThrowString().Format(L"%llu stalls, %lldus total", stats.stalls, std::chrono::duration_cast<std::chrono::microseconds>(stats.stallTime).count()));
+            VERIFY_IS_TRUE(stats.stalls > 0);
+            VERIFY_IS_TRUE(stats.stallTime.count() > 0);
+            VERIFY_IS_TRUE(stats.peakBytesQueued >= 16 * 1024);
+            VERIFY_ARE_EQUAL(total, stats.bytesWritten);
+        }
+
+        releaser.join();
+        VERIFY_ARE_EQUAL(total, uint64_t{ slowReader.Join().size() });
+    }
+
+    TEST_METHOD(ReportsBrokenPipe)
+    {
+        auto [reader, writer] = _CreatePipe();
+        VtPipeWriter pipeWriter{ std::move(writer), 1024 };
+
+        reader.reset();
+
+        std::string buffer{ "\x1b[H" };
+        // The first write may succeed, because the error is only noticed by the writer thread.
+        (void)pipeWriter.Write(buffer);
+        VERIFY_FAILED(pipeWriter.Drain());
+
+        buffer = "\x1b[H";
+        VERIFY_FAILED(pipeWriter.Write(buffer));
+    }
+
+    // A blocked terminal must not prevent the writer from shutting down.
+    TEST_METHOD(DestroyWhileBlocked)
+    {
+        auto [reader, writer] = _CreatePipe();
+        SlowPipeReader slowReader{ std::move(reader), 0 };
+
+        {
+            VtPipeWriter pipeWriter{ std::move(writer), 1024 * 1024 };
+            std::string buffer(256 * 1024, 'x');
+            VERIFY_SUCCEEDED(pipeWriter.Write(buffer));
+        }
+    }
+
+private:
+    static std::pair<wil::unique_hfile, wil::unique_hfile> _CreatePipe()
+    {
+        wil::unique_hfile reader;
+        wil::unique_hfile writer;
+        // A small pipe buffer makes WriteFile() block as soon as the reader falls behind.
+        THROW_IF_WIN32_BOOL_FALSE(CreatePipe(reader.addressof(), writer.addressof(), nullptr, 4096));
+        return { std::move(reader), std::move(writer) };
+    }
+};
@@ -141,7 +141,24 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             using const_iterator = details::_bitmap_const_iterator<allocator_type>;
 
         private:
+            // A cheap, incrementally maintained description of the set bits in a single row.
+            // As long as a row was only ever filled with overlapping or adjacent spans its bits
+            // are exactly [left, right) and runs() can emit it without looking at _bits at all.
+            // Otherwise the row is "fragmented" and [left, right) is merely its bounding range.
+            struct row_summary
+            {
+                til::CoordType left = 0;
+                til::CoordType right = 0;
+                bool contiguous = true;
+
+                constexpr bool empty() const noexcept
+                {
+                    return left >= right;
+                }
+            };
+
             using run_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<til::rect>;
+            using summary_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<row_summary>;
 
         public:
             explicit bitmap(const allocator_type& allocator) noexcept :
@@ -149,6 +166,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz{},
                 _rc{},
                 _bits{ _alloc },
+                _summary{ _alloc },
                 _runs{ _alloc }
             {
             }
@@ -173,6 +191,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz(sz),
                 _rc(sz),
                 _bits(_sz.area(), fill ? std::numeric_limits<unsigned long long>::max() : 0, _alloc),
+                _summary(static_cast<size_t>(std::max(0, _sz.height)), _full_row(fill), _alloc),
+                _fullRows{ fill ? static_cast<size_t>(std::max(0, _sz.height)) : 0 },
                 _runs{ _alloc }
             {
             }
@@ -187,6 +207,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz{ other._sz },
                 _rc{ other._rc },
                 _bits{ other._bits },
+                _summary{ other._summary },
+                _fullRows{ other._fullRows },
+                _fragmentedRows{ other._fragmentedRows },
                 _runs{ other._runs }
             {
                 // copy constructor is required to call select_on_container_copy
@@ -201,6 +224,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz = other._sz;
                 _rc = other._rc;
                 _bits = other._bits;
+                _summary = other._summary;
+                _fullRows = other._fullRows;
+                _fragmentedRows = other._fragmentedRows;
                 _runs = other._runs;
                 return *this;
             }
@@ -210,6 +236,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz{ std::move(other._sz) },
                 _rc{ std::move(other._rc) },
                 _bits{ std::move(other._bits) },
+                _summary{ std::move(other._summary) },
+                _fullRows{ std::exchange(other._fullRows, 0) },
+                _fragmentedRows{ std::exchange(other._fragmentedRows, 0) },
                 _runs{ std::move(other._runs) }
             {
             }
@@ -221,6 +250,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     _alloc = std::move(other._alloc);
                 }
                 _bits = std::move(other._bits);
+                _summary = std::move(other._summary);
+                _fullRows = std::exchange(other._fullRows, 0);
+                _fragmentedRows = std::exchange(other._fragmentedRows, 0);
                 _runs = std::move(other._runs);
                 _sz = std::move(other._sz);
                 _rc = std::move(other._rc);
@@ -236,6 +268,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     std::swap(_alloc, other._alloc);
                 }
                 std::swap(_bits, other._bits);
+                std::swap(_summary, other._summary);
+                std::swap(_fullRows, other._fullRows);
+                std::swap(_fragmentedRows, other._fragmentedRows);
                 std::swap(_runs, other._runs);
                 std::swap(_sz, other._sz);
                 std::swap(_rc, other._rc);
@@ -246,7 +281,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 return _sz == other._sz &&
                        _rc == other._rc &&
                        _bits == other._bits;
-                // _runs excluded because it's a cache of generated state.
+                // _summary and _runs excluded because they're caches of generated state.
             }
 
             constexpr bool operator!=(const bitmap& other) const noexcept
@@ -269,7 +304,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 // If we don't have cached runs, rebuild.
                 if (!_runs.has_value())
                 {
-                    _runs.emplace(begin(), end());
+                    _runs.emplace(_runs_allocator());
+                    _build_runs(*_runs);
                 }
 
                 // Return the runs.
@@ -355,6 +391,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _runs.reset(); // reset cached runs on any non-const method
 
                 _bits.set(_rc.index_of(pt));
+                _summarize(pt.y, pt.x, pt.x + 1);
             }
 
             void set(const til::rect& rc)
@@ -362,9 +399,27 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 THROW_HR_IF(E_INVALIDARG, !_rc.contains(rc));
                 _runs.reset(); // reset cached runs on any non-const method
 
+                if (rc.empty())
+                {
+                    return;
+                }
+
+                // Full-width rectangles are a single contiguous span of bits.
+                if (rc.left == 0 && rc.right == _sz.width)
+                {
+                    _bits.set(_rc.index_of(til::point{ 0, rc.top }), rc.size().area<size_t>(), true);
+                }
+                else
+                {
+                    for (auto row = rc.top; row < rc.bottom; ++row)
+                    {
+                        _bits.set(_rc.index_of(til::point{ rc.left, row }), rc.width(), true);
+                    }
+                }
+
                 for (auto row = rc.top; row < rc.bottom; ++row)
                 {
-                    _bits.set(_rc.index_of(til::point{ rc.left, row }), rc.width(), true);
+                    _summarize(row, rc.left, rc.right);
                 }
             }
 
@@ -372,12 +427,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             {
                 _runs.reset(); // reset cached runs on any non-const method
                 _bits.set();
+                _fill_summary(true);
             }
 
             void reset_all() noexcept
             {
                 _runs.reset(); // reset cached runs on any non-const method
                 _bits.reset();
+                _fill_summary(false);
             }
 
             // True if we resized. False if it was the same size as before.
@@ -450,6 +507,13 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             constexpr bool all() const noexcept
             {
+                // Contiguous rows know whether they're full, so unless
+                // a fragmented row could possibly be full, this is O(1).
+                const auto height = static_cast<size_t>(std::max(0, _sz.height));
+                if (_fragmentedRows == 0 || _fullRows + _fragmentedRows < height)
+                {
+                    return _fullRows == height;
+                }
                 return _bits.all();
             }
 
@@ -526,13 +590,133 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     }
                 }
 
+                // Shifting the bits by whole rows simply moves the row summaries along.
+                const auto rows = static_cast<size_t>(std::abs(delta_y));
+                const auto beg = _summary.begin();
+                const auto end = _summary.end();
+                if (isLeftShift)
+                {
+                    std::move_backward(beg, end - rows, end);
+                    std::fill(beg, beg + rows, _full_row(fill));
+                }
+                else
+                {
+                    std::move(beg + rows, end, beg);
+                    std::fill(end - rows, end, _full_row(fill));
+                }
+                _recount_summary();
+
                 _runs.reset(); // reset cached runs on any non-const method
             }
 
+            constexpr row_summary _full_row(bool fill) const noexcept
+            {
+                return fill ? row_summary{ 0, _sz.width, true } : row_summary{};
+            }
+
+            void _fill_summary(bool fill) noexcept
+            {
+                std::fill(_summary.begin(), _summary.end(), _full_row(fill));
+                _fullRows = fill ? _summary.size() : 0;
+                _fragmentedRows = 0;
+            }
+
+            void _recount_summary() noexcept
+            {
+                _fullRows = 0;
+                _fragmentedRows = 0;
+                for (const auto& s : _summary)
+                {
+                    _fullRows += s.contiguous && s.left == 0 && s.right == _sz.width;
+                    _fragmentedRows += !s.contiguous;
+                }
+            }
+
+            // Records that the bits [left, right) in the given row were set.
+            void _summarize(til::CoordType row, til::CoordType left, til::CoordType right) noexcept
+            {
+                auto& s = til::at(_summary, static_cast<size_t>(row));
+                const auto wasFull = s.contiguous && s.left == 0 && s.right == _sz.width;
+                const auto wasFragmented = !s.contiguous;
+
+                if (s.empty() || (left <= s.left && right >= s.right))
+                {
+                    // The new span covers everything that was previously set in this row.
+                    s = { left, right, true };
+                }
+                else
+                {
+                    // Overlapping or adjacent spans merge into a larger contiguous one.
+                    s.contiguous = s.contiguous && left <= s.right && right >= s.left;
+                    s.left = std::min(s.left, left);
+                    s.right = std::max(s.right, right);
+                }
+
+                const auto isFull = s.contiguous && s.left == 0 && s.right == _sz.width;
+                _fullRows += static_cast<size_t>(isFull) - static_cast<size_t>(wasFull);
+                _fragmentedRows += static_cast<size_t>(!s.contiguous) - static_cast<size_t>(wasFragmented);
+            }
+
+            run_allocator_type _runs_allocator() const noexcept
+            {
+                return run_allocator_type{ _alloc };
+            }
+
+            // Equivalent to std::vector(begin(), end()), but uses the row summaries to skip
+            // empty rows and to emit contiguous rows without touching _bits. Fragmented rows
+            // are scanned with find_next(), which skips over unset bits a word at a time.
+            void _build_runs(std::vector<til::rect, run_allocator_type>& runs) const
+            {
+                // Fully set maps are common (scrolling invalidates everything), so reserve
+                // exactly one run per row upfront. Sparse maps rarely need more than that.
+                runs.reserve(_summary.size());
+
+                til::CoordType y = 0;
+                for (const auto& s : _summary)
+                {
+                    if (!s.empty())
+                    {
+                        if (s.contiguous)
+                        {
+                            runs.emplace_back(s.left, y, s.right, y + 1);
+                        }
+                        else
+                        {
+                            const auto rowBeg = _rc.index_of<size_t>(til::point{ 0, y });
+                            const auto spanEnd = rowBeg + static_cast<size_t>(s.right);
+                            auto pos = rowBeg + static_cast<size_t>(s.left);
+
+                            // find_next(prev) searches _past_ prev, but the leftmost bit
+                            // in the bounding range is always set, so we can start there.
+                            while (pos < spanEnd)
+                            {
+                                auto end = pos + 1;
+                                while (end < spanEnd && _bits[end])
+                                {
+                                    ++end;
+                                }
+
+                                runs.emplace_back(
+                                    static_cast<til::CoordType>(pos - rowBeg),
+                                    y,
+                                    static_cast<til::CoordType>(end - rowBeg),
+                                    y + 1);
+
+                                pos = end < spanEnd ? _bits.find_next(end) : spanEnd;
+                            }
+                        }
+                    }
+                    ++y;
+                }
+            }
+
             allocator_type _alloc;
             til::size _sz;
             til::rect _rc;
             dynamic_bitset<unsigned long long, allocator_type> _bits;
+            std::vector<row_summary, summary_allocator_type> _summary;
+            size_t _fullRows = 0;
+            size_t _fragmentedRows = 0;
 
             mutable std::optional<std::vector<til::rect, run_allocator_type>> _runs;
 
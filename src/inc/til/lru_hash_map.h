@@ -0,0 +1,400 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "flat_set.h"
+
+#pragma warning(push)
+#pragma warning(disable : 26446) // Prefer to use gsl::at() instead of unchecked subscript operator (bounds.4).
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26495) // Variable '...' is uninitialized. Always initialize a member variable (type.6).
+
+namespace til
+{
+    // A hash map which keeps track of the order in which its entries were used,
+    // for implementing caches with a least-recently-used eviction policy.
+    //
+    // * The lookup table uses open addressing with linear probing. Each slot holds the
+    //   node pointer alongside the entry's hash, so that collisions rarely touch the node.
+    // * The nodes form an intrusive doubly-linked list, ordered from newest to oldest.
+    //   find() and make_newest() move an entry to the front, oldest() returns the back.
+    // * Nodes are allocated in chunks and recycled via a free list. Keys and values are
+    //   stored inline in the node and never move. Iterators thus remain valid until their
+    //   entry is erased, even if the map grows, which allows callers to hold onto them.
+    //
+    // Unlike std::unordered_map, insert() doesn't check whether the key exists already.
+    // Callers are expected to call find() first, which is what caches do anyways.
+    template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class lru_hash_map
+    {
+        struct node
+        {
+            // The anonymous union allows us to allocate nodes without constructing the entry.
+            node() noexcept {}
+            ~node() {}
+
+            node* newer = nullptr;
+            node* older = nullptr;
+            size_t hash = 0;
+            union
+            {
+                std::pair<K, V> entry;
+            };
+        };
+
+        struct slot
+        {
+            node* ptr = nullptr;
+            size_t hash = 0;
+        };
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+
+        class iterator
+        {
+        public:
+            constexpr iterator() noexcept = default;
+
+            value_type& operator*() const noexcept
+            {
+                return _node->entry;
+            }
+
+            value_type* operator->() const noexcept
+            {
+                return &_node->entry;
+            }
+
+            bool operator==(const iterator& rhs) const noexcept = default;
+
+        private:
+            friend class lru_hash_map;
+
+            explicit constexpr iterator(node* n) noexcept :
+                _node{ n }
+            {
+            }
+
+            node* _node = nullptr;
+        };
+
+        lru_hash_map() = default;
+
+        lru_hash_map(const lru_hash_map&) = delete;
+        lru_hash_map& operator=(const lru_hash_map&) = delete;
+
+        lru_hash_map(lru_hash_map&& other) noexcept :
+            _slots{ std::move(other._slots) },
+            _chunks{ std::move(other._chunks) },
+            _newest{ std::exchange(other._newest, nullptr) },
+            _oldest{ std::exchange(other._oldest, nullptr) },
+            _free{ std::exchange(other._free, nullptr) },
+            _size{ std::exchange(other._size, 0) },
+            _capacity{ std::exchange(other._capacity, 0) },
+            _shift{ std::exchange(other._shift, initialShift) },
+            _mask{ std::exchange(other._mask, 0) }
+        {
+        }
+
+        lru_hash_map& operator=(lru_hash_map&& other) noexcept
+        {
+            if (this != &other)
+            {
+                _destroyEntries();
+                _slots = std::move(other._slots);
+                _chunks = std::move(other._chunks);
+                _newest = std::exchange(other._newest, nullptr);
+                _oldest = std::exchange(other._oldest, nullptr);
+                _free = std::exchange(other._free, nullptr);
+                _size = std::exchange(other._size, 0);
+                _capacity = std::exchange(other._capacity, 0);
+                _shift = std::exchange(other._shift, initialShift);
+                _mask = std::exchange(other._mask, 0);
+            }
+            return *this;
+        }
+
+        ~lru_hash_map()
+        {
+            _destroyEntries();
+        }
+
+        bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        iterator end() const noexcept
+        {
+            return {};
+        }
+
+        // Returns the entry for the given key and marks it as the newest one.
+        iterator find(const K& key)
+        {
+            if (!_size)
+            {
+                return end();
+            }
+
+            const auto hash = Hash{}(key);
+
+            for (auto i = _home(hash);; ++i)
+            {
+                const auto& s = _slots[i & _mask];
+                if (!s.ptr)
+                {
+                    return end();
+                }
+                if (s.hash == hash && KeyEqual{}(s.ptr->entry.first, key))
+                {
+                    _makeNewest(s.ptr);
+                    return iterator{ s.ptr };
+                }
+            }
+        }
+
+        // Inserts a new entry as the newest one. The key must not exist in the map yet.
+        template<typename KK, typename VV>
+        iterator insert(KK&& key, VV&& value)
+        {
+            // Putting this into the insertion path is a little pessimistic, but it
+            // allows us to default-construct this hashmap without allocating anything.
+            // The table is kept at most half full, which keeps the probe sequences short.
+            if (_size >= _capacity / 2) [[unlikely]]
+            {
+                _bumpSize();
+            }
+
+            const auto n = _allocateNode();
+            try
+            {
+                std::construct_at(&n->entry, std::forward<KK>(key), std::forward<VV>(value));
+            }
+            catch (...)
+            {
+                n->older = _free;
+                _free = n;
+                throw;
+            }
+
+            n->hash = Hash{}(n->entry.first);
+            _insertSlot(n);
+            _linkNewest(n);
+            _size++;
+            return iterator{ n };
+        }
+
+        void make_newest(const iterator& it) noexcept
+        {
+            _makeNewest(it._node);
+        }
+
+        // Returns the least recently used entry or end() if the map is empty.
+        iterator oldest() const noexcept
+        {
+            return iterator{ _oldest };
+        }
+
+        void erase(const iterator& it) noexcept
+        {
+            const auto n = it._node;
+            _eraseSlot(n);
+            _unlink(n);
+            std::destroy_at(&n->entry);
+            n->older = _free;
+            _free = n;
+            _size--;
+        }
+
+        void pop_oldest() noexcept
+        {
+            erase(oldest());
+        }
+
+        // Removes all entries. The lookup table and the node chunks are kept for reuse.
+        void clear() noexcept
+        {
+            _destroyEntries();
+            std::fill_n(_slots.get(), _capacity, slot{});
+            _newest = nullptr;
+            _oldest = nullptr;
+            _size = 0;
+
+            _free = nullptr;
+            for (auto& chunk : _chunks)
+            {
+                const auto count = _chunkSize(&chunk - _chunks.data());
+                for (size_t i = 0; i < count; ++i)
+                {
+                    chunk[i].older = _free;
+                    _free = &chunk[i];
+                }
+            }
+        }
+
+    private:
+        static constexpr auto digits = std::numeric_limits<size_t>::digits;
+        // This results in an initial capacity of 16 slots, or 8 entries.
+        static constexpr size_t initialShift = digits - 4;
+        // Chunks double in size up to this many nodes.
+        static constexpr size_t maxChunkShift = 10;
+
+        static constexpr size_t _chunkSize(const ptrdiff_t index) noexcept
+        {
+            return size_t{ 16 } << std::min(static_cast<size_t>(index), maxChunkShift - 4);
+        }
+
+        size_t _home(const size_t hash) const noexcept
+        {
+            // See flat_set_hash_integer: the multiplication spreads the hash into the upper bits,
+            // which makes this robust against hash functions with weak lower bits.
+            return flat_set_hash_integer(hash) >> _shift;
+        }
+
+        node* _allocateNode()
+        {
+            if (!_free)
+            {
+                const auto count = _chunkSize(static_cast<ptrdiff_t>(_chunks.size()));
+                auto& chunk = _chunks.emplace_back(std::make_unique<node[]>(count));
+                for (size_t i = count; i-- > 0;)
+                {
+                    chunk[i].older = _free;
+                    _free = &chunk[i];
+                }
+            }
+
+            const auto n = _free;
+            _free = n->older;
+            return n;
+        }
+
+        void _insertSlot(node* n) noexcept
+        {
+            for (auto i = _home(n->hash);; ++i)
+            {
+                auto& s = _slots[i & _mask];
+                if (!s.ptr)
+                {
+                    s.ptr = n;
+                    s.hash = n->hash;
+                    return;
+                }
+            }
+        }
+
+        void _eraseSlot(const node* n) noexcept
+        {
+            auto i = _home(n->hash) & _mask;
+            while (_slots[i].ptr != n)
+            {
+                i = (i + 1) & _mask;
+            }
+
+            // Backward shift deletion: Instead of leaving a tombstone behind, we move
+            // all following entries of the cluster back, unless doing so would move
+            // them in front of their home slot. This keeps lookups free of tombstones.
+            for (auto j = (i + 1) & _mask;; j = (j + 1) & _mask)
+            {
+                const auto& s = _slots[j];
+                if (!s.ptr)
+                {
+                    break;
+                }
+
+                const auto home = _home(s.hash) & _mask;
+                if (((j - home) & _mask) >= ((j - i) & _mask))
+                {
+                    _slots[i] = s;
+                    i = j;
+                }
+            }
+
+            _slots[i] = {};
+        }
+
+        void _linkNewest(node* n) noexcept
+        {
+            n->newer = nullptr;
+            n->older = _newest;
+            if (_newest)
+            {
+                _newest->newer = n;
+            }
+            else
+            {
+                _oldest = n;
+            }
+            _newest = n;
+        }
+
+        void _unlink(node* n) noexcept
+        {
+            (n->newer ? n->newer->older : _newest) = n->older;
+            (n->older ? n->older->newer : _oldest) = n->newer;
+        }
+
+        void _makeNewest(node* n) noexcept
+        {
+            if (n != _newest)
+            {
+                _unlink(n);
+                _linkNewest(n);
+            }
+        }
+
+        void _destroyEntries() noexcept
+        {
+            for (auto n = _newest; n; n = n->older)
+            {
+                std::destroy_at(&n->entry);
+            }
+        }
+
+        __declspec(noinline) void _bumpSize()
+        {
+            // A _shift of 0 would result in a newShift of 0xfffff...
+            // A _shift of 1 would result in a newCapacity of 0
+            if (_shift < 2)
+            {
+                throw std::bad_array_new_length{};
+            }
+
+            const auto newShift = _capacity ? _shift - 1 : _shift;
+            const auto newCapacity = size_t{ 1 } << (digits - newShift);
+
+            _slots = std::make_unique<slot[]>(newCapacity);
+            _capacity = newCapacity;
+            _shift = newShift;
+            _mask = newCapacity - 1;
+
+            // The nodes don't move, so we only need to rebuild the lookup table.
+            for (auto n = _newest; n; n = n->older)
+            {
+                _insertSlot(n);
+            }
+        }
+
+        std::unique_ptr<slot[]> _slots;
+        std::vector<std::unique_ptr<node[]>> _chunks;
+        node* _newest = nullptr;
+        node* _oldest = nullptr;
+        node* _free = nullptr;
+        size_t _size = 0;
+        size_t _capacity = 0;
+        size_t _shift = initialShift;
+        size_t _mask = 0;
+    };
+}
+
+#pragma warning(pop)
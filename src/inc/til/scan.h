@@ -0,0 +1,387 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <bit>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#include <isa_availability.h>
+// Provided by the CRT, which initializes it before any of our code runs.
+extern "C" int __isa_available;
+#elif defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
+#pragma warning(push)
+#pragma warning(disable : 26446) // Prefer to use gsl::at() instead of unchecked subscript operator (bounds.4).
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+
+// Vectorized kernels for scanning UTF-16 text.
+//
+// Each kernel processes the text in blocks of 16 (AVX2) or 8 (SSE2, NEON) code units and finishes
+// the remainder with a scalar loop, which is also the implementation on all other architectures.
+// SSE2 and NEON are part of the x64 and ARM64 baselines. AVX2 is selected at runtime,
+// using the same CPU feature detection as the CRT's own vectorized routines.
+// The results are identical no matter which implementation runs.
+namespace til::scan
+{
+    inline constexpr auto npos = std::wstring_view::npos;
+
+    // A set of UTF-16 code units, given as up to 4 inclusive ranges. For instance:
+    //   static constexpr til::scan::char_class controls{ { L'\0', L'\x1f' }, { L'\x7f', L'\x9f' } };
+    struct char_class
+    {
+        struct range
+        {
+            wchar_t lo;
+            wchar_t hi;
+        };
+
+        constexpr char_class(const std::initializer_list<range> list) :
+            count{ list.size() }
+        {
+            if (list.size() < 1 || list.size() > ranges.size())
+            {
+                throw std::invalid_argument("char_class supports 1 to 4 ranges");
+            }
+            std::copy(list.begin(), list.end(), ranges.begin());
+        }
+
+        constexpr bool contains(const wchar_t ch) const noexcept
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                // Thanks to the unsigned wrap-around this is equivalent to lo <= ch && ch <= hi.
+                if (static_cast<wchar_t>(ch - ranges[i].lo) <= static_cast<wchar_t>(ranges[i].hi - ranges[i].lo))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::array<range, 4> ranges{};
+        size_t count = 0;
+    };
+
+    namespace details
+    {
+        // Each backend provides the same handful of operations on vectors of 16-bit lanes.
+        // mask() turns a comparison result into an integer with (1 << shift) bits per lane,
+        // which allows us to find the matching lane with a bit scan.
+#if defined(_M_X64) || defined(_M_IX86)
+        inline bool has_avx2() noexcept
+        {
+            return __isa_available >= __ISA_AVAILABLE_AVX2;
+        }
+
+        struct sse2
+        {
+            using vec = __m128i;
+            static constexpr size_t width = 8;
+            static constexpr int shift = 1;
+            static constexpr uint64_t full = 0xffff;
+
+            static vec load(const wchar_t* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+            static vec splat(const wchar_t ch) noexcept { return _mm_set1_epi16(static_cast<short>(ch)); }
+            static vec eq(const vec a, const vec b) noexcept { return _mm_cmpeq_epi16(a, b); }
+            static vec bit_or(const vec a, const vec b) noexcept { return _mm_or_si128(a, b); }
+            static vec bit_and(const vec a, const vec b) noexcept { return _mm_and_si128(a, b); }
+            static uint64_t mask(const vec v) noexcept { return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+
+            // Lanes for which lo <= v <= lo + span. There's no unsigned 16-bit comparison in SSE2,
+            // but a saturating subtraction results in 0 exactly if the lane is less or equal.
+            static vec in_range(const vec v, const wchar_t lo, const wchar_t span) noexcept
+            {
+                const auto offset = _mm_sub_epi16(v, splat(lo));
+                return _mm_cmpeq_epi16(_mm_subs_epu16(offset, splat(span)), _mm_setzero_si128());
+            }
+        };
+
+        struct avx2
+        {
+            using vec = __m256i;
+            static constexpr size_t width = 16;
+            static constexpr int shift = 1;
+            static constexpr uint64_t full = 0xffffffff;
+
+            static vec load(const wchar_t* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+            static vec splat(const wchar_t ch) noexcept { return _mm256_set1_epi16(static_cast<short>(ch)); }
+            static vec eq(const vec a, const vec b) noexcept { return _mm256_cmpeq_epi16(a, b); }
+            static vec bit_or(const vec a, const vec b) noexcept { return _mm256_or_si256(a, b); }
+            static vec bit_and(const vec a, const vec b) noexcept { return _mm256_and_si256(a, b); }
+            static uint64_t mask(const vec v) noexcept { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+
+            static vec in_range(const vec v, const wchar_t lo, const wchar_t span) noexcept
+            {
+                const auto offset = _mm256_sub_epi16(v, splat(lo));
+                return _mm256_cmpeq_epi16(_mm256_subs_epu16(offset, splat(span)), _mm256_setzero_si256());
+            }
+        };
+#elif defined(_M_ARM64)
+        struct neon
+        {
+            using vec = uint16x8_t;
+            static constexpr size_t width = 8;
+            static constexpr int shift = 3;
+            static constexpr uint64_t full = ~uint64_t{ 0 };
+
+            static vec load(const wchar_t* p) noexcept { return vld1q_u16(reinterpret_cast<const uint16_t*>(p)); }
+            static vec splat(const wchar_t ch) noexcept { return vdupq_n_u16(static_cast<uint16_t>(ch)); }
+            static vec eq(const vec a, const vec b) noexcept { return vceqq_u16(a, b); }
+            static vec bit_or(const vec a, const vec b) noexcept { return vorrq_u16(a, b); }
+            static vec bit_and(const vec a, const vec b) noexcept { return vandq_u16(a, b); }
+            // NEON has no movemask. Narrowing each 0xffff lane to 0xff results in a 64-bit mask with 8 bits per lane.
+            static uint64_t mask(const vec v) noexcept { return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(v, 4)), 0); }
+
+            static vec in_range(const vec v, const wchar_t lo, const wchar_t span) noexcept
+            {
+                return vcleq_u16(vsubq_u16(v, splat(lo)), splat(span));
+            }
+        };
+#endif
+
+        // Calls func with the best available backend and then with the baseline one,
+        // which processes whatever is left over after the wider vectors.
+        // func returns true if it's done and the scalar remainder must be skipped.
+        template<typename Func>
+        bool vectorized([[maybe_unused]] const size_t size, [[maybe_unused]] Func&& func) noexcept
+        {
+#if defined(_M_X64) || defined(_M_IX86)
+            if (size >= avx2::width && has_avx2() && func(avx2{}))
+            {
+                return true;
+            }
+            return size >= sse2::width && func(sse2{});
+#elif defined(_M_ARM64)
+            return size >= neon::width && func(neon{});
+#else
+            return false;
+#endif
+        }
+
+        // Finds the first code unit for which pred returns true.
+        // pred must be callable with a single code unit and with a backend and a vector, returning a lane mask.
+        template<typename Pred>
+        size_t find_first(const std::wstring_view text, const Pred& pred) noexcept
+        {
+            const auto data = text.data();
+            const auto size = text.size();
+            size_t i = 0;
+            size_t result = npos;
+
+            if (vectorized(size, [&](auto b) noexcept {
+                    using B = decltype(b);
+                    for (; i + B::width <= size; i += B::width)
+                    {
+                        if (const auto m = pred(b, B::load(data + i)))
+                        {
+                            result = i + (std::countr_zero(m) >> B::shift);
+                            return true;
+                        }
+                    }
+                    return false;
+                }))
+            {
+                return result;
+            }
+
+            for (; i < size; ++i)
+            {
+                if (pred(data[i]))
+                {
+                    return i;
+                }
+            }
+            return npos;
+        }
+
+        // Like find_first, but searches backwards from the end of the text.
+        template<typename Pred>
+        size_t find_last(const std::wstring_view text, const Pred& pred) noexcept
+        {
+            const auto data = text.data();
+            auto end = text.size();
+            size_t result = npos;
+
+            if (vectorized(end, [&](auto b) noexcept {
+                    using B = decltype(b);
+                    for (; end >= B::width; end -= B::width)
+                    {
+                        if (const auto m = pred(b, B::load(data + end - B::width)))
+                        {
+                            result = end - B::width + ((63 - std::countl_zero(m)) >> B::shift);
+                            return true;
+                        }
+                    }
+                    return false;
+                }))
+            {
+                return result;
+            }
+
+            while (end)
+            {
+                --end;
+                if (pred(data[end]))
+                {
+                    return end;
+                }
+            }
+            return npos;
+        }
+
+        struct in_class
+        {
+            const char_class& cls;
+
+            bool operator()(const wchar_t ch) const noexcept
+            {
+                return cls.contains(ch);
+            }
+
+            template<typename B>
+            uint64_t operator()(B, const typename B::vec v) const noexcept
+            {
+                auto m = B::in_range(v, cls.ranges[0].lo, static_cast<wchar_t>(cls.ranges[0].hi - cls.ranges[0].lo));
+                for (size_t r = 1; r < cls.count; ++r)
+                {
+                    m = B::bit_or(m, B::in_range(v, cls.ranges[r].lo, static_cast<wchar_t>(cls.ranges[r].hi - cls.ranges[r].lo)));
+                }
+                return B::mask(m);
+            }
+        };
+
+        struct not_equal
+        {
+            wchar_t ch;
+
+            bool operator()(const wchar_t c) const noexcept
+            {
+                return c != ch;
+            }
+
+            template<typename B>
+            uint64_t operator()(B, const typename B::vec v) const noexcept
+            {
+                return ~B::mask(B::eq(v, B::splat(ch))) & B::full;
+            }
+        };
+
+        inline constexpr char_class non_ascii{ { L'\x80', L'\xffff' } };
+    }
+
+    // Returns the offset of the first code unit in text that's part of cls, or npos.
+    inline size_t find_first_of(const std::wstring_view text, const char_class& cls) noexcept
+    {
+        return details::find_first(text, details::in_class{ cls });
+    }
+
+    // Returns the offset of the first code unit in text that isn't ch, or npos. Same as std::wstring_view::find_first_not_of.
+    inline size_t find_first_not_of(const std::wstring_view text, const wchar_t ch) noexcept
+    {
+        return details::find_first(text, details::not_equal{ ch });
+    }
+
+    // Returns the offset of the last code unit in text that isn't ch, or npos. Same as std::wstring_view::find_last_not_of.
+    inline size_t find_last_not_of(const std::wstring_view text, const wchar_t ch) noexcept
+    {
+        return details::find_last(text, details::not_equal{ ch });
+    }
+
+    // Returns true if all code units in text are <= U+007F.
+    inline bool is_ascii(const std::wstring_view text) noexcept
+    {
+        return details::find_first(text, details::in_class{ details::non_ascii }) == npos;
+    }
+
+    // Returns the number of occurrences of ch in text. Mostly useful for counting line feeds.
+    inline size_t count(const std::wstring_view text, const wchar_t ch) noexcept
+    {
+        const auto data = text.data();
+        const auto size = text.size();
+        size_t i = 0;
+        size_t n = 0;
+
+        details::vectorized(size, [&](auto b) noexcept {
+            using B = decltype(b);
+            const auto needle = B::splat(ch);
+            for (; i + B::width <= size; i += B::width)
+            {
+                n += static_cast<size_t>(std::popcount(B::mask(B::eq(B::load(data + i), needle)))) >> B::shift;
+            }
+            return false;
+        });
+
+        for (; i < size; ++i)
+        {
+            n += data[i] == ch;
+        }
+        return n;
+    }
+
+    // Returns true if both strings are equal after passing each code unit through towlower().
+    // Blocks of ASCII text are compared without calling towlower(), by folding A-Z to a-z.
+    inline bool equals_ignore_case(const std::wstring_view lhs, const std::wstring_view rhs) noexcept
+    {
+        if (lhs.size() != rhs.size())
+        {
+            return false;
+        }
+
+        const auto a = lhs.data();
+        const auto b = rhs.data();
+        const auto size = lhs.size();
+        size_t i = 0;
+        auto equal = true;
+
+        const auto scalar = [&](const size_t beg, const size_t end) noexcept {
+            for (auto j = beg; j < end; ++j)
+            {
+                if (a[j] != b[j] && ::towlower(a[j]) != ::towlower(b[j]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        if (details::vectorized(size, [&](auto tag) noexcept {
+                using B = decltype(tag);
+                const auto caseBit = B::splat(0x20);
+                const auto fold = [&](const typename B::vec v) noexcept {
+                    return B::bit_or(v, B::bit_and(B::in_range(v, L'A', static_cast<wchar_t>(L'Z' - L'A')), caseBit));
+                };
+
+                for (; i + B::width <= size; i += B::width)
+                {
+                    const auto va = B::load(a + i);
+                    const auto vb = B::load(b + i);
+
+                    if (B::mask(B::eq(va, vb)) == B::full)
+                    {
+                        continue;
+                    }
+
+                    // towlower() isn't limited to A-Z outside of ASCII and has no vectorized equivalent.
+                    const auto nonAscii = B::bit_or(B::in_range(va, L'\x80', L'\xff7f'), B::in_range(vb, L'\x80', L'\xff7f'));
+                    if (B::mask(nonAscii) ? !scalar(i, i + B::width) : B::mask(B::eq(fold(va), fold(vb))) != B::full)
+                    {
+                        equal = false;
+                        return true;
+                    }
+                }
+                return false;
+            }))
+        {
+            return equal;
+        }
+
+        return scalar(i, size);
+    }
+}
+
+#pragma warning(pop)
@@ -967,6 +967,8 @@ void AtlasEngine::_recreateSizeDependentResources()
         _r.cells = Buffer<Cell, 32>{ totalCellCount };
         _r.cellGlyphMapping = Buffer<TileHashMap::iterator>{ totalCellCount };
         _r.cellCount = _api.cellCount;
+        // _emplaceGlyph() drops clusters past the right edge, which is baked into the cached segmentation.
+        _api.shapingCache.Clear();
         _r.tileAllocator.setMaxArea(_api.sizeInPixel);
 
         // .clear() doesn't free the memory of these buffers.
@@ -1082,6 +1084,9 @@ void AtlasEngine::_recreateFontDependentResources()
         _r.glyphs = {};
         _r.glyphQueue = {};
         _r.glyphQueue.reserve(64);
+
+        // The cached segmentation depends on the font fallback results for the current font.
+        _api.shapingCache.Clear();
     }
     // D3D specifically for UpdateDpi()
     // This compensates for the built in scaling factor in a XAML SwapChainPanel (CompositionScaleX/Y).
@@ -1264,6 +1269,34 @@ void AtlasEngine::_flushBufferLine()
         _api.bufferLineColumn.emplace_back(lastColumn);
     }
 
+    // Scrolling repaints the same lines of text over and over again, just at a different position.
+    // Segmenting them is by far the most expensive part of this function, which is why
+    // the result is cached. The bold/italic state picks the text format and is thus part of the key.
+    const std::wstring_view bufferLineText{ _api.bufferLine.data(), _api.bufferLine.size() };
+    const auto shapingState = static_cast<u32>(_api.attributes.bold) | static_cast<u32>(_api.attributes.italic) << 1;
+
+    if (const auto cached = _api.shapingCache.Lookup(bufferLineText, _api.bufferLineColumn, shapingState))
+    {
+        for (const auto& segment : cached->segments)
+        {
+            _emplaceGlyph(cached->faces[segment.face].get(), segment.beg, segment.end);
+        }
+        return;
+    }
+
+    // This records all successful _emplaceGlyph() calls, which is all we need to replay this line later.
+    auto& shapingRecord = _api.shapingRecord;
+    shapingRecord.Clear();
+
+    const auto emplaceGlyph = [&](const wil::com_ptr<IDWriteFontFace>& fontFace, size_t bufferPos1, size_t bufferPos2) {
+        const auto emplaced = _emplaceGlyph(fontFace.get(), bufferPos1, bufferPos2);
+        if (emplaced)
+        {
+            shapingRecord.Append(fontFace, bufferPos1, bufferPos2);
+        }
+        return emplaced;
+    };
+
     // NOTE:
     // This entire function is one huge hack to see if it works.
 
@@ -1377,7 +1410,7 @@ void AtlasEngine::_flushBufferLine()
                 {
                     if (const auto col2 = _api.bufferLineColumn[pos2]; col1 != col2)
                     {
-                        _emplaceGlyph(nullptr, pos1, pos2);
+                        emplaceGlyph(nullptr, pos1, pos2);
                         pos1 = pos2;
                         col1 = col2;
                     }
@@ -1416,7 +1449,7 @@ void AtlasEngine::_flushBufferLine()
                 size_t beg = 0;
                 for (size_t i = 0; i < complexityLength; ++i)
                 {
-                    if (_emplaceGlyph(mappedFontFace.get(), idx + beg, idx + i + 1))
+                    if (emplaceGlyph(mappedFontFace, idx + beg, idx + i + 1))
                     {
                         beg = i + 1;
                     }
@@ -1534,7 +1567,7 @@ void AtlasEngine::_flushBufferLine()
                     {
                         if (_api.textProps[i].canBreakShapingAfter)
                         {
-                            if (_emplaceGlyph(mappedFontFace.get(), a.textPosition + beg, a.textPosition + i + 1))
+                            if (emplaceGlyph(mappedFontFace, a.textPosition + beg, a.textPosition + i + 1))
                             {
                                 beg = i + 1;
                             }
@@ -1544,6 +1577,8 @@ void AtlasEngine::_flushBufferLine()
             }
         }
     }
+
+    _api.shapingCache.Insert(bufferLineText, _api.bufferLineColumn, shapingState, shapingRecord);
 }
 // ^^^ Look at that amazing 8-fold nesting level. Lovely. <3
 
@@ -8,6 +8,7 @@
 #include <dwrite_3.h>
 
 #include "../../renderer/inc/IRenderEngine.hpp"
+#include "../../renderer/inc/ShapingCache.hpp"
 #include "DWriteTextAnalysis.h"
 
 namespace Microsoft::Console::Render
@@ -593,55 +594,27 @@ namespace Microsoft::Console::Render
 
         struct AtlasKeyHasher
         {
-            using is_transparent = int;
-
             size_t operator()(const AtlasKey& v) const noexcept
             {
                 return v.hash();
             }
-
-            size_t operator()(const std::list<std::pair<AtlasKey, AtlasValue>>::iterator& v) const noexcept
-            {
-                return operator()(v->first);
-            }
-        };
-
-        struct AtlasKeyEq
-        {
-            using is_transparent = int;
-
-            bool operator()(const AtlasKey& a, const std::list<std::pair<AtlasKey, AtlasValue>>::iterator& b) const noexcept
-            {
-                return a == b->first;
-            }
-
-            bool operator()(const std::list<std::pair<AtlasKey, AtlasValue>>::iterator& a, const std::list<std::pair<AtlasKey, AtlasValue>>::iterator& b) const noexcept
-            {
-                return operator()(a->first, b);
-            }
         };
 
         struct TileHashMap
         {
-            using iterator = std::list<std::pair<AtlasKey, AtlasValue>>::iterator;
+            using iterator = til::lru_hash_map<AtlasKey, AtlasValue, AtlasKeyHasher>::iterator;
 
             TileHashMap() noexcept = default;
 
             iterator end() noexcept
             {
-                return _lru.end();
+                return _map.end();
             }
 
             iterator find(const AtlasKey& key)
             {
-                const auto it = _map.find(key);
-                if (it != _map.end())
-                {
-                    // Move the key to the head of the LRU queue.
-                    makeNewest(*it);
-                    return *it;
-                }
-                return end();
+                // Moves the key to the head of the LRU queue if it exists.
+                return _map.find(key);
             }
 
             iterator insert(AtlasKey&& key, AtlasValue&& value)
@@ -650,21 +623,18 @@ namespace Microsoft::Console::Render
                 //
                 // && decays to & if the argument is named, because C++ is a simple language
                 // and so you have to std::move it again, because C++ is a simple language.
-                _lru.emplace_front(std::move(key), std::move(value));
-                auto it = _lru.begin();
-                _map.emplace(it);
-                return it;
+                return _map.insert(std::move(key), std::move(value));
             }
 
-            void makeNewest(const iterator& it)
+            void makeNewest(const iterator& it) noexcept
             {
-                _lru.splice(_lru.begin(), _lru, it);
+                _map.make_newest(it);
             }
 
             void popOldestTiles(std::vector<u16x2>& out) noexcept
             {
-                Expects(!_lru.empty());
-                const auto it = --_lru.end();
+                Expects(!_map.empty());
+                const auto it = _map.oldest();
 
                 const auto key = it->first.data();
                 const auto value = it->second.data();
@@ -676,15 +646,10 @@ namespace Microsoft::Console::Render
                 std::copy_n(beg, cellCount, out.begin() + offset);
 
                 _map.erase(it);
-                _lru.pop_back();
             }
 
         private:
-            // Please don't copy this code. It's a proof-of-concept.
-            // If you need a LRU hash-map, write a custom one with an intrusive
-            // prev/next linked list (it's easier than you might think!).
-            std::list<std::pair<AtlasKey, AtlasValue>> _lru;
-            std::unordered_set<iterator, AtlasKeyHasher, AtlasKeyEq> _map;
+            til::lru_hash_map<AtlasKey, AtlasValue, AtlasKeyHasher> _map;
         };
 
         // TileAllocator yields `tileSize`-sized tiles for our texture atlas.
@@ -1084,6 +1049,8 @@ namespace Microsoft::Console::Render
             std::vector<u16> bufferLineColumn;
             Buffer<BufferLineMetadata> bufferLineMetadata;
             std::vector<TextAnalysisSinkResult> analysisResults;
+            ShapingCache<wil::com_ptr<IDWriteFontFace>> shapingCache; // invalidated by ApiInvalidations::Font|Size
+            ShapingCache<wil::com_ptr<IDWriteFontFace>>::Entry shapingRecord;
             Buffer<u16> clusterMap;
             Buffer<DWRITE_SHAPING_TEXT_PROPERTIES> textProps;
             Buffer<u16> glyphIndices;
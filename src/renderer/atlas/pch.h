@@ -50,3 +50,4 @@
 
 #include <til.h>
 #include <til/bit.h>
+#include <til/lru_hash_map.h>
@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "FrameSnapshot.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+
+// Routine Description:
+// - Prepares the snapshot for capturing the next frame. The buffers keep their capacity.
+// Arguments:
+// - renderSettings - The colors and render modes to paint the frame with.
+void FrameSnapshot::Reset(const RenderSettings& renderSettings)
+{
+    lines.clear();
+    overlayLines.clear();
+    runs.clear();
+    clusters.clear();
+    selectionRects.clear();
+    cursor.reset();
+    title.clear();
+    settings = renderSettings;
+    viewportLeft = 0;
+    gridLinesAllowed = false;
+    hyperlinkHoveredId = 0;
+    hoveredInterval.reset();
+
+    _cells.clear();
+    _text.clear();
+    _blinking = false;
+
+    // The pattern sets are kept between frames, so that interning them doesn't allocate in steady state.
+    // They only depend on the registered patterns, so there are rarely more than a few of them.
+    if (_patternSets.size() > maxPatternSets)
+    {
+        _patternSets.clear();
+    }
+}
+
+// Routine Description:
+// - Copies the cells of a line of text into the snapshot.
+// Arguments:
+// - target - Either lines or overlayLines.
+// - it - An iterator limited to the cells that should be copied.
+// - data - Used to look up the patterns on the line.
+// - line - The line's position and attributes. The cell range is filled in by this function.
+void FrameSnapshot::AppendLine(std::vector<Line>& target, TextBufferRowSpanIterator it, const IRenderData& data, const Line& line)
+{
+    auto& l = target.emplace_back(line);
+    l.cellOffset = gsl::narrow<uint32_t>(_cells.size());
+
+    // The iterator yields runs of cells with the same attributes, but the snapshot stores one cell per column.
+    // The trailing half of a wide glyph is thus a cell of its own, which the renderer
+    // skips when assembling clusters but needs for drawing gridlines.
+    auto pos = line.target;
+    for (; it; ++it)
+    {
+        const auto& span = *it;
+        _blinking = _blinking || span.attr.IsBlinking();
+
+        for (auto col = span.columnBegin; col < span.columnEnd; ++col, ++pos.x)
+        {
+            const auto chars = span.row->GlyphAt(col);
+            const auto dbcs = span.row->DbcsAttrAt(col);
+            auto& cell = _cells.emplace_back();
+            cell.attr = span.attr;
+            cell.textOffset = gsl::narrow<uint32_t>(_text.size());
+            cell.textLength = gsl::narrow<uint16_t>(chars.size());
+            cell.columns = dbcs == DbcsAttribute::Leading ? 2 : 1;
+            cell.dbcs = dbcs;
+
+            _text.append(chars);
+        }
+    }
+
+    l.cellCount = gsl::narrow<uint32_t>(_cells.size() - l.cellOffset);
+
+    // Look up the patterns once for the whole line, instead of once per cell.
+    _patternIntervals.clear();
+    data.GetPatternsInRow(line.target, pos.x, _patternIntervals);
+    if (!_patternIntervals.empty())
+    {
+        _assignPatterns(l);
+    }
+}
+
+std::span<const FrameSnapshot::Cell> FrameSnapshot::GetCells(const Line& line) const noexcept
+{
+    return { _cells.data() + line.cellOffset, line.cellCount };
+}
+
+std::span<const FrameSnapshot::Run> FrameSnapshot::GetRuns(const Line& line) const noexcept
+{
+    return { runs.data() + line.runOffset, line.runCount };
+}
+
+std::wstring_view FrameSnapshot::GetText(const Cell& cell) const noexcept
+{
+    return { _text.data() + cell.textOffset, cell.textLength };
+}
+
+bool FrameSnapshot::HasPatterns(const Cell& cell) const noexcept
+{
+    return cell.patterns != 0;
+}
+
+// Routine Description:
+// - Returns true if any of the captured cells has the blink attribute.
+bool FrameSnapshot::IsBlinking() const noexcept
+{
+    return _blinking;
+}
+
+// Routine Description:
+// - Sets the pattern set of each cell of the line from the matches in _patternIntervals.
+void FrameSnapshot::_assignPatterns(const Line& line)
+{
+    auto cellBegin = line.target;
+    for (auto& cell : std::span{ _cells.data() + line.cellOffset, line.cellCount })
+    {
+        // A match covers the cell if it starts at or before it and stops after it. (The stop is exclusive.)
+        const til::point cellEnd{ cellBegin.x + 1, cellBegin.y };
+        _patternIds.clear();
+        for (const auto& interval : _patternIntervals)
+        {
+            if (interval.start <= cellBegin && interval.stop >= cellEnd)
+            {
+                _patternIds.emplace_back(interval.value);
+            }
+        }
+
+        // Sorted, so that the same set of patterns always interns to the same index.
+        std::sort(_patternIds.begin(), _patternIds.end());
+        cell.patterns = _internPatterns(_patternIds);
+        cellBegin = cellEnd;
+    }
+}
+
+uint16_t FrameSnapshot::_internPatterns(const std::vector<size_t>& patterns)
+{
+    if (patterns.empty())
+    {
+        return 0;
+    }
+
+    // There are rarely more than a handful of distinct pattern sets on the screen.
+    const auto it = std::find(_patternSets.begin(), _patternSets.end(), patterns);
+    if (it != _patternSets.end())
+    {
+        return gsl::narrow_cast<uint16_t>(it - _patternSets.begin() + 1);
+    }
+
+    _patternSets.emplace_back(patterns);
+    return gsl::narrow<uint16_t>(_patternSets.size());
+}
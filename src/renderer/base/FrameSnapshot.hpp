@@ -0,0 +1,117 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- FrameSnapshot.hpp
+
+Abstract:
+- A copy of everything the renderer needs to paint a frame: the dirty rows of the
+  text buffer, the overlays, the cursor, the selection, the title and the colors.
+- It's captured while the console lock is held. The renderer then releases the lock
+  and paints the frame from the snapshot, which allows the output thread to continue
+  writing into the buffer while the engines are busy.
+- A frame is captured once for the union of all engines' dirty areas. The lines are
+  then segmented into runs of clusters once and replayed to every engine.
+- The buffers are retained between frames. Once they have grown to the size
+  of the viewport, capturing a frame doesn't allocate anymore.
+--*/
+
+#pragma once
+
+#include "../inc/IRenderData.hpp"
+#include "../inc/IRenderEngine.hpp"
+#include "../inc/RenderSettings.hpp"
+
+#include "../../buffer/out/textBufferRowSpanIterator.hpp"
+
+namespace Microsoft::Console::Render
+{
+    class FrameSnapshot
+    {
+    public:
+        struct Cell
+        {
+            TextAttribute attr;
+            uint32_t textOffset = 0;
+            uint16_t textLength = 0;
+            uint16_t columns = 0;
+            // An index into the pattern sets. 0 means that the cell isn't part of any pattern.
+            uint16_t patterns = 0;
+            DbcsAttribute dbcs = DbcsAttribute::Single;
+        };
+
+        // A run of cells with the same attributes, which is painted with a single PaintBufferLine() call.
+        struct Run
+        {
+            TextAttribute attr;
+            til::point target;
+            uint32_t clusterOffset = 0;
+            uint32_t clusterCount = 0;
+            // Relative to the first of the cells the run was built from.
+            uint32_t cellOffset = 0;
+            uint32_t cellCount = 0;
+            til::CoordType columns = 0;
+            uint16_t patterns = 0;
+            bool usingSoftFont = false;
+            bool trimLeft = false;
+            bool containsWideCharacter = false;
+        };
+
+        struct Line
+        {
+            // The screen position of the first cell.
+            til::point target;
+            // The part of the row that was captured, in the coordinates of the engines' dirty areas.
+            til::rect screen;
+            LineRendition lineRendition = LineRendition::SingleWidth;
+            bool lineWrapped = false;
+            uint32_t cellOffset = 0;
+            uint32_t cellCount = 0;
+            uint32_t runOffset = 0;
+            uint32_t runCount = 0;
+        };
+
+        void Reset(const RenderSettings& renderSettings);
+        void AppendLine(std::vector<Line>& lines, TextBufferRowSpanIterator it, const IRenderData& data, const Line& line);
+
+        std::span<const Cell> GetCells(const Line& line) const noexcept;
+        std::span<const Run> GetRuns(const Line& line) const noexcept;
+        std::wstring_view GetText(const Cell& cell) const noexcept;
+        bool HasPatterns(const Cell& cell) const noexcept;
+        bool IsBlinking() const noexcept;
+
+        // The lines of the text buffer, in the order the engine's dirty areas list them.
+        std::vector<Line> lines;
+        // The lines of the overlays (IME composition), which are painted on top of the buffer.
+        std::vector<Line> overlayLines;
+        // The runs of all lines and the clusters they consist of. They're built once the console lock was released.
+        std::vector<Run> runs;
+        std::vector<Cluster> clusters;
+        // The selection, already converted to screen coordinates.
+        std::vector<til::rect> selectionRects;
+        std::optional<CursorOptions> cursor;
+        std::wstring title;
+        // A copy of the colors, so that the output thread may change them while the frame is painted.
+        RenderSettings settings;
+        til::CoordType viewportLeft = 0;
+        bool gridLinesAllowed = false;
+        uint16_t hyperlinkHoveredId = 0;
+        std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> hoveredInterval;
+
+    private:
+        static constexpr size_t maxPatternSets = 256;
+
+        void _assignPatterns(const Line& line);
+        uint16_t _internPatterns(const std::vector<size_t>& patterns);
+
+        std::vector<Cell> _cells;
+        std::wstring _text;
+        // Pattern sets are deduplicated, so that comparing the indices of two cells is equivalent to comparing their sets.
+        std::vector<std::vector<size_t>> _patternSets;
+        // Scratch buffers for AppendLine(): the pattern matches on the current line and the pattern IDs of a cell.
+        std::vector<PatternInterval> _patternIntervals;
+        std::vector<size_t> _patternIds;
+        bool _blinking = false;
+    };
+}
@@ -0,0 +1,522 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "../inc/RecordingEngine.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+
+static constexpr std::array<std::string_view, RecordingEngine::CallCount> s_callNames{
+    "StartPaint",
+    "EndPaint",
+    "RequiresContinuousRedraw",
+    "WaitUntilCanRender",
+    "Present",
+    "PrepareForTeardown",
+    "ScrollFrame",
+    "Invalidate",
+    "InvalidateCursor",
+    "InvalidateSystem",
+    "InvalidateSelection",
+    "InvalidateScroll",
+    "InvalidateAll",
+    "InvalidateFlush",
+    "InvalidateTitle",
+    "NotifyNewText",
+    "PrepareRenderInfo",
+    "ResetLineTransform",
+    "PrepareLineTransform",
+    "PaintBackground",
+    "PaintBufferLine",
+    "PaintBufferGridLines",
+    "PaintSelection",
+    "PaintCursor",
+    "UpdateDrawingBrushes",
+    "UpdateFont",
+    "UpdateSoftFont",
+    "UpdateDpi",
+    "UpdateViewport",
+    "GetProposedFont",
+    "GetDirtyArea",
+    "GetFontSize",
+    "IsGlyphWideByFont",
+    "UpdateTitle",
+};
+
+// Routine Description:
+// - Creates a new recording engine. The arenas are allocated here, so that painting never allocates.
+// - NOTE: Will throw if the arenas can't be allocated. Caller must catch.
+// Arguments:
+// - mode - Whether to record the calls or to only count them.
+// - recordCapacity - The maximum number of records. Unused in the Count mode.
+// - textCapacity - The maximum number of characters painted by PaintBufferLine. Unused in the Count mode.
+RecordingEngine::RecordingEngine(const Mode mode, const size_t recordCapacity, const size_t textCapacity) :
+    _mode{ mode }
+{
+    if (_mode == Mode::Record)
+    {
+        _records.reserve(recordCapacity);
+        _text.reserve(textCapacity);
+    }
+}
+
+// Routine Description:
+// - Starts a frame, unless nothing was invalidated since the last one.
+// Return Value:
+// - S_OK, or S_FALSE if there's nothing to paint.
+[[nodiscard]] HRESULT RecordingEngine::StartPaint() noexcept
+{
+    if (!_invalidMap.any() && !_titleChanged)
+    {
+        return S_FALSE;
+    }
+
+    _count(Call::StartPaint);
+    _frames++;
+    return S_OK;
+}
+
+// Routine Description:
+// - Ends the frame and forgets what was invalidated for it.
+[[nodiscard]] HRESULT RecordingEngine::EndPaint() noexcept
+{
+    _count(Call::EndPaint);
+    _invalidMap.reset_all();
+    return S_OK;
+}
+
+[[nodiscard]] bool RecordingEngine::RequiresContinuousRedraw() noexcept
+{
+    _count(Call::RequiresContinuousRedraw);
+    return false;
+}
+
+// Routine Description:
+// - Unlike the base class we don't throttle the render loop.
+//   Benchmarks want to paint as many frames as possible.
+void RecordingEngine::WaitUntilCanRender() noexcept
+{
+    _count(Call::WaitUntilCanRender);
+}
+
+[[nodiscard]] HRESULT RecordingEngine::Present() noexcept
+{
+    _count(Call::Present);
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, pForcePaint);
+    _count(Call::PrepareForTeardown);
+    *pForcePaint = false;
+    return S_OK;
+}
+
+// Routine Description:
+// - Records the accumulated scroll delta of the frame, if any.
+[[nodiscard]] HRESULT RecordingEngine::ScrollFrame() noexcept
+{
+    if (const auto record = _count(Call::ScrollFrame))
+    {
+        record->rect = { _scrollDelta.x, _scrollDelta.y, _scrollDelta.x, _scrollDelta.y };
+    }
+    _scrollDelta = {};
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::Invalidate(const til::rect* const psrRegion) noexcept
+try
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, psrRegion);
+    if (const auto record = _count(Call::Invalidate))
+    {
+        record->rect = *psrRegion;
+    }
+    _invalidMap.set(*psrRegion & til::rect{ _invalidMap.size() });
+    return S_OK;
+}
+CATCH_RETURN();
+
+[[nodiscard]] HRESULT RecordingEngine::InvalidateCursor(const til::rect* const psrRegion) noexcept
+try
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, psrRegion);
+    if (const auto record = _count(Call::InvalidateCursor))
+    {
+        record->rect = *psrRegion;
+    }
+    _invalidMap.set(*psrRegion & til::rect{ _invalidMap.size() });
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - The region is given in pixels. We don't have any, so there's nothing to invalidate.
+[[nodiscard]] HRESULT RecordingEngine::InvalidateSystem(const til::rect* const /*prcDirtyClient*/) noexcept
+{
+    _count(Call::InvalidateSystem);
+    return S_FALSE;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::InvalidateSelection(const std::vector<til::rect>& rectangles) noexcept
+try
+{
+    if (const auto record = _count(Call::InvalidateSelection))
+    {
+        record->value = gsl::narrow_cast<uint32_t>(rectangles.size());
+    }
+    for (const auto& rect : rectangles)
+    {
+        _invalidMap.set(rect & til::rect{ _invalidMap.size() });
+    }
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Moves what was invalidated so far by the given delta and invalidates the area that was scrolled into view.
+[[nodiscard]] HRESULT RecordingEngine::InvalidateScroll(const til::point* const pcoordDelta) noexcept
+try
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, pcoordDelta);
+    const auto delta = *pcoordDelta;
+    if (const auto record = _count(Call::InvalidateScroll))
+    {
+        record->rect = { delta.x, delta.y, delta.x, delta.y };
+    }
+    if (delta != til::point{})
+    {
+        _invalidMap.translate(delta, true);
+        _scrollDelta += delta;
+    }
+    return S_OK;
+}
+CATCH_RETURN();
+
+[[nodiscard]] HRESULT RecordingEngine::InvalidateAll() noexcept
+{
+    _count(Call::InvalidateAll);
+    _invalidMap.set_all();
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::InvalidateFlush(_In_ const bool circled, _Out_ bool* const pForcePaint) noexcept
+{
+    _count(Call::InvalidateFlush);
+    return RenderEngineBase::InvalidateFlush(circled, pForcePaint);
+}
+
+[[nodiscard]] HRESULT RecordingEngine::InvalidateTitle(const std::wstring_view proposedTitle) noexcept
+{
+    _count(Call::InvalidateTitle);
+    return RenderEngineBase::InvalidateTitle(proposedTitle);
+}
+
+[[nodiscard]] HRESULT RecordingEngine::NotifyNewText(const std::wstring_view newText) noexcept
+{
+    _count(Call::NotifyNewText);
+    return RenderEngineBase::NotifyNewText(newText);
+}
+
+[[nodiscard]] HRESULT RecordingEngine::PrepareRenderInfo(const RenderFrameInfo& info) noexcept
+{
+    _count(Call::PrepareRenderInfo);
+    return RenderEngineBase::PrepareRenderInfo(info);
+}
+
+[[nodiscard]] HRESULT RecordingEngine::ResetLineTransform() noexcept
+{
+    _count(Call::ResetLineTransform);
+    return RenderEngineBase::ResetLineTransform();
+}
+
+[[nodiscard]] HRESULT RecordingEngine::PrepareLineTransform(const LineRendition lineRendition,
+                                                            const til::CoordType targetRow,
+                                                            const til::CoordType viewportLeft) noexcept
+{
+    if (const auto record = _count(Call::PrepareLineTransform))
+    {
+        record->detail = static_cast<uint16_t>(lineRendition);
+        record->rect = { viewportLeft, targetRow, viewportLeft, targetRow + 1 };
+    }
+    return RenderEngineBase::PrepareLineTransform(lineRendition, targetRow, viewportLeft);
+}
+
+[[nodiscard]] HRESULT RecordingEngine::PaintBackground() noexcept
+{
+    _count(Call::PaintBackground);
+    return S_OK;
+}
+
+// Routine Description:
+// - Records the position of the line, the number of columns it covers and its text.
+// Arguments:
+// - clusters - Iterable collection of cluster information (text and columns it should consume)
+// - coord - Character coordinate position in the cell grid
+// - fTrimLeft - Whether or not to trim off the left half of a double wide character
+// - lineWrapped - Whether the line wraps into the next one
+// Return Value:
+// - S_OK
+[[nodiscard]] HRESULT RecordingEngine::PaintBufferLine(const std::span<const Cluster> clusters,
+                                                       const til::point coord,
+                                                       const bool fTrimLeft,
+                                                       const bool lineWrapped) noexcept
+{
+    if (const auto record = _count(Call::PaintBufferLine))
+    {
+        til::CoordType columns = 0;
+        for (const auto& cluster : clusters)
+        {
+            columns += cluster.GetColumns();
+        }
+
+        record->flags = gsl::narrow_cast<uint8_t>((fTrimLeft ? FlagTrimLeft : 0) | (lineWrapped ? FlagLineWrapped : 0));
+        record->rect = { coord.x, coord.y, coord.x + columns, coord.y + 1 };
+        _appendText(*record, clusters);
+    }
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::PaintBufferGridLines(const GridLineSet lines,
+                                                            const COLORREF color,
+                                                            const size_t cchLine,
+                                                            const til::point coordTarget) noexcept
+{
+    if (const auto record = _count(Call::PaintBufferGridLines))
+    {
+        record->detail = gsl::narrow_cast<uint16_t>(lines.bits());
+        record->value = color;
+        record->rect = { coordTarget.x, coordTarget.y, coordTarget.x + gsl::narrow_cast<til::CoordType>(cchLine), coordTarget.y + 1 };
+    }
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::PaintSelection(const til::rect& rect) noexcept
+{
+    if (const auto record = _count(Call::PaintSelection))
+    {
+        record->rect = rect;
+    }
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::PaintCursor(const CursorOptions& options) noexcept
+{
+    if (const auto record = _count(Call::PaintCursor))
+    {
+        record->flags = gsl::narrow_cast<uint8_t>((options.isOn ? FlagCursorOn : 0) | (options.fIsDoubleWidth ? FlagCursorDoubleWidth : 0));
+        record->detail = static_cast<uint16_t>(options.cursorType);
+        record->value = options.fUseColor ? options.cursorColor : 0;
+        const auto cursor = options.coordCursor;
+        record->rect = { cursor.x, cursor.y, cursor.x + (options.fIsDoubleWidth ? 2 : 1), cursor.y + 1 };
+    }
+    return S_OK;
+}
+
+// Routine Description:
+// - Records that the brushes changed. The colors aren't resolved, because that's
+//   the engine's work and we want to measure the renderer in isolation.
+[[nodiscard]] HRESULT RecordingEngine::UpdateDrawingBrushes(const TextAttribute& /*textAttributes*/,
+                                                            const RenderSettings& /*renderSettings*/,
+                                                            const gsl::not_null<IRenderData*> /*pData*/,
+                                                            const bool usingSoftFont,
+                                                            const bool isSettingDefaultBrushes) noexcept
+{
+    if (const auto record = _count(Call::UpdateDrawingBrushes))
+    {
+        record->flags = gsl::narrow_cast<uint8_t>((usingSoftFont ? FlagUsingSoftFont : 0) | (isSettingDefaultBrushes ? FlagDefaultBrushes : 0));
+    }
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::UpdateFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/) noexcept
+{
+    _count(Call::UpdateFont);
+    return S_FALSE;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::UpdateSoftFont(const std::span<const uint16_t> bitPattern,
+                                                      const til::size cellSize,
+                                                      const size_t centeringHint) noexcept
+{
+    _count(Call::UpdateSoftFont);
+    return RenderEngineBase::UpdateSoftFont(bitPattern, cellSize, centeringHint);
+}
+
+[[nodiscard]] HRESULT RecordingEngine::UpdateDpi(const int /*iDpi*/) noexcept
+{
+    _count(Call::UpdateDpi);
+    return S_FALSE;
+}
+
+// Routine Description:
+// - Resizes the invalidated area to the new viewport. A viewport of a new size is entirely invalid.
+[[nodiscard]] HRESULT RecordingEngine::UpdateViewport(const til::inclusive_rect& srNewViewport) noexcept
+try
+{
+    const auto viewport = til::rect{ srNewViewport };
+    if (const auto record = _count(Call::UpdateViewport))
+    {
+        record->rect = viewport;
+    }
+    if (_invalidMap.resize(viewport.size()))
+    {
+        _invalidMap.set_all();
+    }
+    return S_OK;
+}
+CATCH_RETURN();
+
+[[nodiscard]] HRESULT RecordingEngine::GetProposedFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/, const int /*iDpi*/) noexcept
+{
+    _count(Call::GetProposedFont);
+    return S_FALSE;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::GetDirtyArea(std::span<const til::rect>& area) noexcept
+try
+{
+    _count(Call::GetDirtyArea);
+    area = _invalidMap.runs();
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Every cell is 1x1 "pixels" large, which makes pixel and cell coordinates the same.
+[[nodiscard]] HRESULT RecordingEngine::GetFontSize(_Out_ til::size* const pFontSize) noexcept
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, pFontSize);
+    _count(Call::GetFontSize);
+    *pFontSize = { 1, 1 };
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::IsGlyphWideByFont(const std::wstring_view /*glyph*/, _Out_ bool* const pResult) noexcept
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, pResult);
+    _count(Call::IsGlyphWideByFont);
+    *pResult = false;
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT RecordingEngine::UpdateTitle(const std::wstring_view newTitle) noexcept
+{
+    _count(Call::UpdateTitle);
+    return RenderEngineBase::UpdateTitle(newTitle);
+}
+
+[[nodiscard]] HRESULT RecordingEngine::_DoUpdateTitle(const std::wstring_view /*newTitle*/) noexcept
+{
+    return S_OK;
+}
+
+std::string_view RecordingEngine::GetCallName(const Call call) noexcept
+{
+    const auto index = static_cast<size_t>(call);
+    return index < s_callNames.size() ? til::at(s_callNames, index) : std::string_view{};
+}
+
+RecordingEngine::Mode RecordingEngine::GetMode() const noexcept
+{
+    return _mode;
+}
+
+uint64_t RecordingEngine::GetCallCount(const Call call) const noexcept
+{
+    const auto index = static_cast<size_t>(call);
+    return index < _counts.size() ? til::at(_counts, index) : 0;
+}
+
+uint64_t RecordingEngine::GetTotalCallCount() const noexcept
+{
+    return std::accumulate(_counts.begin(), _counts.end(), uint64_t{ 0 });
+}
+
+uint64_t RecordingEngine::GetFrameCount() const noexcept
+{
+    return _frames;
+}
+
+std::span<const RecordingEngine::Record> RecordingEngine::GetRecords() const noexcept
+{
+    return _records;
+}
+
+// Routine Description:
+// - Returns the text that was painted by a PaintBufferLine record.
+//   It's empty for all other records and if the text arena was full.
+std::wstring_view RecordingEngine::GetText(const Record& record) const noexcept
+{
+    if (record.textOffset + size_t{ record.textLength } > _text.size())
+    {
+        return {};
+    }
+    return { _text.data() + record.textOffset, record.textLength };
+}
+
+uint64_t RecordingEngine::GetDroppedRecordCount() const noexcept
+{
+    return _droppedRecords;
+}
+
+void RecordingEngine::Reset() noexcept
+{
+    _counts = {};
+    _frames = 0;
+    _records.clear();
+    _text.clear();
+    _droppedRecords = 0;
+}
+
+// Routine Description:
+// - Counts the call and appends a record for it in the Record mode.
+// Arguments:
+// - call - The call to count.
+// Return Value:
+// - The new record for the caller to fill in, or nullptr if the call is only counted.
+RecordingEngine::Record* RecordingEngine::_count(const Call call) noexcept
+{
+    til::at(_counts, static_cast<size_t>(call))++;
+
+    if (_mode != Mode::Record)
+    {
+        return nullptr;
+    }
+
+    // The arena is never grown, as allocating would distort the measurements.
+    if (_records.size() == _records.capacity())
+    {
+        _droppedRecords++;
+        return nullptr;
+    }
+
+    return &_records.emplace_back(Record{ call });
+}
+
+// Routine Description:
+// - Copies the text of the clusters into the text arena, if there's enough room left.
+void RecordingEngine::_appendText(Record& record, const std::span<const Cluster> clusters) noexcept
+{
+    size_t length = 0;
+    for (const auto& cluster : clusters)
+    {
+        length += cluster.GetText().size();
+    }
+
+    if (length > _text.capacity() - _text.size())
+    {
+        return;
+    }
+
+    record.textOffset = gsl::narrow_cast<uint32_t>(_text.size());
+    record.textLength = gsl::narrow_cast<uint32_t>(length);
+    for (const auto& cluster : clusters)
+    {
+        const auto text = cluster.GetText();
+        _text.insert(_text.end(), text.begin(), text.end());
+    }
+}
@@ -289,6 +289,14 @@ std::pair<COLORREF, COLORREF> RenderSettings::GetAttributeColorsWithAlpha(const
     return { fg, bg };
 }
 
+// Routine Description:
+// - Records that blinking cells are in view. The renderer calls this when it
+//   captured a blinking cell, because it paints from a copy of these settings.
+void RenderSettings::MarkBlinkInUse() const noexcept
+{
+    _blinkIsInUse = true;
+}
+
 // Routine Description:
 // - Increments the position in the blink cycle, toggling the blink rendition
 //   state on every second call, potentially triggering a redraw of the given
@@ -312,8 +320,9 @@ try
         {
             // We reset the _blinkIsInUse flag before redrawing, so we can
             // get a fresh assessment of the current blink attribute usage.
+            // Only the blinking cells need to be redrawn, not the entire screen.
             _blinkIsInUse = false;
-            renderer.TriggerRedrawAll();
+            renderer.TriggerRedrawBlinkingCells();
         }
     }
 }
@@ -4,6 +4,8 @@
 #include "precomp.h"
 #include "renderer.hpp"
 
+#include <til/scan.h>
+
 #pragma hdrstop
 
 using namespace Microsoft::Console::Render;
@@ -57,59 +59,64 @@ Renderer::~Renderer()
 }
 
 // Routine Description:
-// - Walks through the console data structures to compose a new frame based on the data that has changed since last call and outputs it to the connected rendering engine.
+// - Walks through the console data structures to compose a new frame based on the data that has changed since last call and outputs it to the connected rendering engines.
+// - The buffer is walked only once per frame for the union of all engines' dirty areas.
 // Arguments:
 // - <none>
 // Return Value:
 // - HRESULT S_OK, GDI error, Safe Math error, or state/argument errors.
 [[nodiscard]] HRESULT Renderer::PaintFrame()
 {
-    FOREACH_ENGINE(pEngine)
+    auto tries = maxRetriesForRenderEngine;
+    while (tries > 0)
     {
-        auto tries = maxRetriesForRenderEngine;
-        while (tries > 0)
+        if (_destructing)
         {
-            if (_destructing)
-            {
-                return S_FALSE;
-            }
+            return S_FALSE;
+        }
 
-            const auto hr = _PaintFrameForEngine(pEngine);
-            if (SUCCEEDED(hr))
-            {
-                break;
-            }
+        // Engines that painted successfully before another one failed
+        // have nothing left to paint when we retry, so this is cheap.
+        const auto hr = _PaintFrameForEngines(_ActiveEngines());
+        if (SUCCEEDED(hr))
+        {
+            break;
+        }
 
-            LOG_HR_IF(hr, hr != E_PENDING);
+        LOG_HR_IF(hr, hr != E_PENDING);
 
-            if (--tries == 0)
+        if (--tries == 0)
+        {
+            // Stop trying.
+            _pThread->DisablePainting();
+            if (_pfnRendererEnteredErrorState)
             {
-                // Stop trying.
-                _pThread->DisablePainting();
-                if (_pfnRendererEnteredErrorState)
-                {
-                    _pfnRendererEnteredErrorState();
-                }
-                // If there's no callback, we still don't want to FAIL_FAST: the renderer going black
-                // isn't near as bad as the entire application aborting. We're a component. We shouldn't
-                // abort applications that host us.
-                return S_FALSE;
+                _pfnRendererEnteredErrorState();
             }
-
-            // Add a bit of backoff.
-            // Sleep 150ms, 300ms, 450ms before failing out and disabling the renderer.
-            Sleep(renderBackoffBaseTimeMilliseconds * (maxRetriesForRenderEngine - tries));
+            // If there's no callback, we still don't want to FAIL_FAST: the renderer going black
+            // isn't near as bad as the entire application aborting. We're a component. We shouldn't
+            // abort applications that host us.
+            return S_FALSE;
         }
+
+        // Add a bit of backoff.
+        // Sleep 150ms, 300ms, 450ms before failing out and disabling the renderer.
+        Sleep(renderBackoffBaseTimeMilliseconds * (maxRetriesForRenderEngine - tries));
     }
 
     return S_OK;
 }
 
 [[nodiscard]] HRESULT Renderer::_PaintFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept
-try
 {
     FAIL_FAST_IF_NULL(pEngine); // This is a programming error. Fail fast.
 
+    return _PaintFrameForEngines({ &pEngine, 1 });
+}
+
+[[nodiscard]] HRESULT Renderer::_PaintFrameForEngines(const std::span<IRenderEngine* const> engines) noexcept
+try
+{
     _pData->LockConsole();
     auto unlock = wil::scope_exit([&]() {
         _pData->UnlockConsole();
@@ -118,30 +125,105 @@ try
     // Last chance check if anything scrolled without an explicit invalidate notification since the last frame.
     _CheckViewportAndScroll();
 
-    // Try to start painting a frame
-    const auto hr = pEngine->StartPaint();
-    RETURN_IF_FAILED(hr);
+    // Invalidations that arrive while we paint the frame below are queued up
+    // and applied here, right before the engines figure out what's dirty.
+    auto engineLock = _engineLock.lock_exclusive();
+    _ApplyPendingInvalidations();
+
+    // The engines that have something to paint.
+    decltype(_engines) painting{};
+    size_t paintingCount = 0;
+    auto requiresRenderData = false;
+
+    auto endPaint = wil::scope_exit([&]() {
+        for (size_t i = 0; i < paintingCount; ++i)
+        {
+            const auto pEngine = til::at(painting, i);
+            LOG_IF_FAILED(pEngine->EndPaint());
+
+            // If the engine tells us it really wants to redraw immediately,
+            // tell the thread so it doesn't go to sleep and ticks again
+            // at the next opportunity.
+            if (pEngine->RequiresContinuousRedraw())
+            {
+                NotifyPaintFrame();
+            }
+        }
+    });
 
-    // Return early if there's nothing to paint.
-    // The renderer itself tracks if there's something to do with the title, the
-    //      engine won't know that.
-    if (S_FALSE == hr)
+    for (const auto pEngine : engines)
+    {
+        // Try to start painting a frame
+        const auto hr = pEngine->StartPaint();
+        RETURN_IF_FAILED(hr);
+
+        // Skip engines that have nothing to paint.
+        // The renderer itself tracks if there's something to do with the title, the
+        //      engine won't know that.
+        if (S_FALSE != hr)
+        {
+            til::at(painting, paintingCount++) = pEngine;
+            requiresRenderData = requiresRenderData || pEngine->RequiresRenderDataWhilePainting();
+        }
+    }
+
+    if (paintingCount == 0)
     {
         return S_OK;
     }
 
-    auto endPaint = wil::scope_exit([&]() {
-        LOG_IF_FAILED(pEngine->EndPaint());
+    // Copy everything we need for painting, so that the output thread
+    // can continue writing into the buffer while the engines are busy.
+    _CaptureFrame({ painting.data(), paintingCount });
+    if (!requiresRenderData)
+    {
+        unlock.reset();
+    }
+
+    // Segment the lines into runs once. They're replayed to every engine below.
+    _BuildFrameRuns();
 
-        // If the engine tells us it really wants to redraw immediately,
-        // tell the thread so it doesn't go to sleep and ticks again
-        // at the next opportunity.
-        if (pEngine->RequiresContinuousRedraw())
+    // A failing engine shouldn't prevent the others from painting their frame.
+    auto result = S_OK;
+    for (size_t i = 0; i < paintingCount; ++i)
+    {
+        const auto hr = _PaintFrameFromSnapshot(til::at(painting, i));
+        if (FAILED(hr) && SUCCEEDED(result))
         {
-            NotifyPaintFrame();
+            result = hr;
         }
-    });
+    }
+
+    // Force scope exit end paint to finish up collecting information and possibly painting
+    endPaint.reset();
+
+    // Force scope exit unlock to let go of the locks so other threads can run
+    engineLock.reset();
+    unlock.reset();
 
+    // Trigger out-of-lock presentation for renderers that can support it
+    for (size_t i = 0; i < paintingCount; ++i)
+    {
+        const auto hr = til::at(painting, i)->Present();
+        if (FAILED(hr) && SUCCEEDED(result))
+        {
+            result = hr;
+        }
+    }
+
+    return result;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Paints the captured frame with the given engine, which must have started painting.
+// Arguments:
+// - pEngine - The engine to paint the frame with.
+// Return Value:
+// - S_OK or the first error returned by the engine.
+[[nodiscard]] HRESULT Renderer::_PaintFrameFromSnapshot(_In_ IRenderEngine* const pEngine)
+try
+{
     // A. Prep Colors
     RETURN_IF_FAILED(_UpdateDrawingBrushes(pEngine, {}, false, true));
 
@@ -169,20 +251,19 @@ try
     // 6. Paint window title
     RETURN_IF_FAILED(_PaintTitle(pEngine));
 
-    // Force scope exit end paint to finish up collecting information and possibly painting
-    endPaint.reset();
-
-    // Force scope exit unlock to let go of global lock so other threads can run
-    unlock.reset();
-
-    // Trigger out-of-lock presentation for renderers that can support it
-    RETURN_IF_FAILED(pEngine->Present());
-
-    // As we leave the scope, EndPaint will be called (declared above)
     return S_OK;
 }
 CATCH_RETURN()
 
+// Routine Description:
+// - Returns the engines that are currently attached.
+std::span<IRenderEngine* const> Renderer::_ActiveEngines() const noexcept
+{
+    // Just like FOREACH_ENGINE we stop at the first empty slot.
+    const auto end = std::find(_engines.begin(), _engines.end(), nullptr);
+    return { _engines.data(), gsl::narrow_cast<size_t>(end - _engines.begin()) };
+}
+
 void Renderer::NotifyPaintFrame() noexcept
 {
     // If we're running in the unittests, we might not have a render thread.
@@ -193,6 +274,111 @@ void Renderer::NotifyPaintFrame() noexcept
     }
 }
 
+// Routine Description:
+// - Forwards an invalidation to all engines. If they're busy painting a frame,
+//   it's queued up instead and applied before the next frame is started.
+// Arguments:
+// - invalidation - The invalidation to apply.
+// Return Value:
+// - <none>
+void Renderer::_Invalidate(const PendingInvalidation& invalidation)
+{
+    if (const auto engineLock = _engineLock.try_lock_exclusive())
+    {
+        // Anything queued up earlier must be applied first, or the engines would see them out of order.
+        _ApplyPendingInvalidations();
+        _ApplyInvalidation(invalidation);
+    }
+    else
+    {
+        const auto pendingLock = _pendingLock.lock_exclusive();
+        _pendingInvalidations.emplace_back(invalidation);
+    }
+}
+
+// Routine Description:
+// - Forwards an invalidation to all engines. Must be called with the engine lock held.
+// Arguments:
+// - invalidation - The invalidation to apply.
+// Return Value:
+// - <none>
+void Renderer::_ApplyInvalidation(const PendingInvalidation& invalidation)
+{
+    using Kind = PendingInvalidation::Kind;
+
+    if (invalidation.kind == Kind::Selection)
+    {
+        _selectionScratch.clear();
+        _selectionScratch.emplace_back(invalidation.rect);
+    }
+
+    FOREACH_ENGINE(pEngine)
+    {
+        switch (invalidation.kind)
+        {
+        case Kind::Region:
+            LOG_IF_FAILED(pEngine->Invalidate(&invalidation.rect));
+            break;
+        case Kind::Cursor:
+            LOG_IF_FAILED(pEngine->InvalidateCursor(&invalidation.rect));
+            break;
+        case Kind::System:
+            LOG_IF_FAILED(pEngine->InvalidateSystem(&invalidation.rect));
+            break;
+        case Kind::Selection:
+            LOG_IF_FAILED(pEngine->InvalidateSelection(_selectionScratch));
+            break;
+        case Kind::Scroll:
+            LOG_IF_FAILED(pEngine->InvalidateScroll(&invalidation.delta));
+            break;
+        case Kind::All:
+            LOG_IF_FAILED(pEngine->InvalidateAll());
+            break;
+        case Kind::Viewport:
+            LOG_IF_FAILED(pEngine->UpdateViewport(invalidation.rect.to_inclusive_rect()));
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// Routine Description:
+// - Applies all invalidations that were queued up while the engines were busy.
+//   Must be called with the engine lock held.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_ApplyPendingInvalidations()
+{
+    const auto pendingLock = _pendingLock.lock_exclusive();
+
+    for (const auto& invalidation : _pendingInvalidations)
+    {
+        _ApplyInvalidation(invalidation);
+    }
+    _pendingInvalidations.clear();
+
+    if (_pendingTitle)
+    {
+        FOREACH_ENGINE(pEngine)
+        {
+            LOG_IF_FAILED(pEngine->InvalidateTitle(*_pendingTitle));
+        }
+        _pendingTitle.reset();
+    }
+
+    if (!_pendingNewText.empty())
+    {
+        FOREACH_ENGINE(pEngine)
+        {
+            LOG_IF_FAILED(pEngine->NotifyNewText(_pendingNewText));
+        }
+        _pendingNewText.clear();
+    }
+}
+
 // Routine Description:
 // - Called when the system has requested we redraw a portion of the console.
 // Arguments:
@@ -201,9 +387,9 @@ void Renderer::NotifyPaintFrame() noexcept
 // - <none>
 void Renderer::TriggerSystemRedraw(const til::rect* const prcDirtyClient)
 {
-    FOREACH_ENGINE(pEngine)
+    if (prcDirtyClient)
     {
-        LOG_IF_FAILED(pEngine->InvalidateSystem(prcDirtyClient));
+        _Invalidate({ PendingInvalidation::Kind::System, *prcDirtyClient });
     }
 
     NotifyPaintFrame();
@@ -235,10 +421,7 @@ void Renderer::TriggerRedraw(const Viewport& region)
     if (view.TrimToViewport(&srUpdateRegion))
     {
         view.ConvertToOrigin(&srUpdateRegion);
-        FOREACH_ENGINE(pEngine)
-        {
-            LOG_IF_FAILED(pEngine->Invalidate(&srUpdateRegion));
-        }
+        _Invalidate({ PendingInvalidation::Kind::Region, srUpdateRegion });
 
         NotifyPaintFrame();
     }
@@ -286,10 +469,7 @@ void Renderer::TriggerRedrawCursor(const til::point* const pcoord)
         if (view.TrimToViewport(&updateRect))
         {
             view.ConvertToOrigin(&updateRect);
-            FOREACH_ENGINE(pEngine)
-            {
-                LOG_IF_FAILED(pEngine->InvalidateCursor(&updateRect));
-            }
+            _Invalidate({ PendingInvalidation::Kind::Cursor, updateRect });
 
             NotifyPaintFrame();
         }
@@ -306,10 +486,7 @@ void Renderer::TriggerRedrawCursor(const til::point* const pcoord)
 // - <none>
 void Renderer::TriggerRedrawAll(const bool backgroundChanged, const bool frameChanged)
 {
-    FOREACH_ENGINE(pEngine)
-    {
-        LOG_IF_FAILED(pEngine->InvalidateAll());
-    }
+    _Invalidate({ PendingInvalidation::Kind::All });
 
     NotifyPaintFrame();
 
@@ -324,6 +501,47 @@ void Renderer::TriggerRedrawAll(const bool backgroundChanged, const bool frameCh
     }
 }
 
+// Routine Description:
+// - Called when the blink rendition changes. Only the cells with the blink attribute
+//   look any different, so we only invalidate the range of blinking cells of each row
+//   in the viewport, which the rows of the text buffer keep track of.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::TriggerRedrawBlinkingCells()
+{
+    const auto& buffer = _pData->GetTextBuffer();
+    const auto view = _viewport.ToExclusive();
+    const auto bufferHeight = buffer.GetSize().Height();
+
+    size_t cells = 0;
+    for (auto y = std::max(view.top, 0); y < std::min(view.bottom, bufferHeight); ++y)
+    {
+        const auto& row = buffer.GetRowByOffset(y);
+        if (!row.ContainsBlinkingCells())
+        {
+            continue;
+        }
+
+        const auto [left, right] = row.GetBlinkingColumns();
+        if (left < right)
+        {
+            TriggerRedraw(Viewport::FromExclusive({ left, y, right, y + 1 }));
+            cells += gsl::narrow_cast<size_t>(right - left);
+        }
+    }
+
+    _blinkRedrawCellCount = cells;
+}
+
+// Routine Description:
+// - Returns the number of cells the last call to TriggerRedrawBlinkingCells invalidated.
+size_t Renderer::GetBlinkRedrawCellCount() const noexcept
+{
+    return _blinkRedrawCellCount;
+}
+
 // Method Description:
 // - Called when the host is about to die, to give the renderer one last chance
 //      to paint before the host exits.
@@ -340,7 +558,11 @@ void Renderer::TriggerTeardown() noexcept
     FOREACH_ENGINE(pEngine)
     {
         auto fEngineRequestsRepaint = false;
-        auto hr = pEngine->PrepareForTeardown(&fEngineRequestsRepaint);
+        auto hr = S_OK;
+        {
+            const auto engineLock = _engineLock.lock_exclusive();
+            hr = pEngine->PrepareForTeardown(&fEngineRequestsRepaint);
+        }
         LOG_IF_FAILED(hr);
 
         if (SUCCEEDED(hr) && fEngineRequestsRepaint)
@@ -372,10 +594,13 @@ void Renderer::TriggerSelection()
             sr &= viewport;
         }
 
-        FOREACH_ENGINE(pEngine)
+        for (const auto& rect : _previousSelection)
         {
-            LOG_IF_FAILED(pEngine->InvalidateSelection(_previousSelection));
-            LOG_IF_FAILED(pEngine->InvalidateSelection(rects));
+            _Invalidate({ PendingInvalidation::Kind::Selection, rect });
+        }
+        for (const auto& rect : rects)
+        {
+            _Invalidate({ PendingInvalidation::Kind::Selection, rect });
         }
 
         _previousSelection = std::move(rects);
@@ -408,11 +633,8 @@ bool Renderer::_CheckViewportAndScroll()
     coordDelta.x = srOldViewport.left - srNewViewport.left;
     coordDelta.y = srOldViewport.top - srNewViewport.top;
 
-    FOREACH_ENGINE(engine)
-    {
-        LOG_IF_FAILED(engine->UpdateViewport(srNewViewport));
-        LOG_IF_FAILED(engine->InvalidateScroll(&coordDelta));
-    }
+    _Invalidate({ PendingInvalidation::Kind::Viewport, til::rect{ srNewViewport } });
+    _Invalidate({ PendingInvalidation::Kind::Scroll, {}, coordDelta });
 
     _ScrollPreviousSelection(coordDelta);
     return true;
@@ -444,10 +666,7 @@ void Renderer::TriggerScroll()
 // - <none>
 void Renderer::TriggerScroll(const til::point* const pcoordDelta)
 {
-    FOREACH_ENGINE(pEngine)
-    {
-        LOG_IF_FAILED(pEngine->InvalidateScroll(pcoordDelta));
-    }
+    _Invalidate({ PendingInvalidation::Kind::Scroll, {}, *pcoordDelta });
 
     _ScrollPreviousSelection(*pcoordDelta);
 
@@ -468,10 +687,17 @@ void Renderer::TriggerFlush(const bool circling)
     FOREACH_ENGINE(pEngine)
     {
         auto fEngineRequestsRepaint = false;
-        auto hr = pEngine->InvalidateFlush(circling, &fEngineRequestsRepaint);
-        LOG_IF_FAILED(hr);
+        auto hr = S_OK;
+        {
+            // This must be released before painting, which acquires the lock itself.
+            const auto engineLock = _engineLock.lock_exclusive();
+            _ApplyPendingInvalidations();
+
+            hr = pEngine->InvalidateFlush(circling, &fEngineRequestsRepaint);
+            LOG_IF_FAILED(hr);
 
-        LOG_IF_FAILED(pEngine->InvalidateSelection(rects));
+            LOG_IF_FAILED(pEngine->InvalidateSelection(rects));
+        }
 
         if (SUCCEEDED(hr) && fEngineRequestsRepaint)
         {
@@ -490,18 +716,36 @@ void Renderer::TriggerFlush(const bool circling)
 void Renderer::TriggerTitleChange()
 {
     const auto newTitle = _pData->GetConsoleTitle();
-    FOREACH_ENGINE(pEngine)
+    if (const auto engineLock = _engineLock.try_lock_exclusive())
     {
-        LOG_IF_FAILED(pEngine->InvalidateTitle(newTitle));
+        _ApplyPendingInvalidations();
+        FOREACH_ENGINE(pEngine)
+        {
+            LOG_IF_FAILED(pEngine->InvalidateTitle(newTitle));
+        }
+    }
+    else
+    {
+        const auto pendingLock = _pendingLock.lock_exclusive();
+        _pendingTitle.emplace(newTitle);
     }
     NotifyPaintFrame();
 }
 
 void Renderer::TriggerNewTextNotification(const std::wstring_view newText)
 {
-    FOREACH_ENGINE(pEngine)
+    if (const auto engineLock = _engineLock.try_lock_exclusive())
     {
-        LOG_IF_FAILED(pEngine->NotifyNewText(newText));
+        _ApplyPendingInvalidations();
+        FOREACH_ENGINE(pEngine)
+        {
+            LOG_IF_FAILED(pEngine->NotifyNewText(newText));
+        }
+    }
+    else
+    {
+        const auto pendingLock = _pendingLock.lock_exclusive();
+        _pendingNewText.append(newText);
     }
 }
 
@@ -513,8 +757,7 @@ void Renderer::TriggerNewTextNotification(const std::wstring_view newText)
 // - the HRESULT of the underlying engine's UpdateTitle call.
 HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine)
 {
-    const auto newTitle = _pData->GetConsoleTitle();
-    return pEngine->UpdateTitle(newTitle);
+    return pEngine->UpdateTitle(_frame.title);
 }
 
 // Routine Description:
@@ -527,6 +770,7 @@ HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine)
 // - <none>
 void Renderer::TriggerFontChange(const int iDpi, const FontInfoDesired& FontInfoDesired, _Out_ FontInfo& FontInfo)
 {
+    const auto engineLock = _engineLock.lock_exclusive();
     FOREACH_ENGINE(pEngine)
     {
         LOG_IF_FAILED(pEngine->UpdateDpi(iDpi));
@@ -553,9 +797,12 @@ void Renderer::UpdateSoftFont(const std::span<const uint16_t> bitPattern, const
     const auto softFontCharCount = cellSize.height ? bitPattern.size() / cellSize.height : 0;
     _lastSoftFontChar = _firstSoftFontChar + softFontCharCount - 1;
 
-    FOREACH_ENGINE(pEngine)
     {
-        LOG_IF_FAILED(pEngine->UpdateSoftFont(bitPattern, cellSize, centeringHint));
+        const auto engineLock = _engineLock.lock_exclusive();
+        FOREACH_ENGINE(pEngine)
+        {
+            LOG_IF_FAILED(pEngine->UpdateSoftFont(bitPattern, cellSize, centeringHint));
+        }
     }
     TriggerRedrawAll();
 }
@@ -583,6 +830,7 @@ bool Renderer::s_IsSoftFontChar(const std::wstring_view& v, const size_t firstSo
     //      renderer. We won't know which is which, so iterate over them.
     //      Only return the result of the successful one if it's not S_FALSE (which is the VT renderer)
     // TODO: 14560740 - The Window might be able to get at this info in a more sane manner
+    const auto engineLock = _engineLock.lock_exclusive();
     FOREACH_ENGINE(pEngine)
     {
         const auto hr = LOG_IF_FAILED(pEngine->GetProposedFont(FontInfoDesired, FontInfo, iDpi));
@@ -614,6 +862,7 @@ bool Renderer::IsGlyphWideByFont(const std::wstring_view glyph)
     //      renderer. We won't know which is which, so iterate over them.
     //      Only return the result of the successful one if it's not S_FALSE (which is the VT renderer)
     // TODO: 14560740 - The Window might be able to get at this info in a more sane manner
+    const auto engineLock = _engineLock.lock_exclusive();
     FOREACH_ENGINE(pEngine)
     {
         const auto hr = LOG_IF_FAILED(pEngine->IsGlyphWideByFont(glyph, &fIsFullWidth));
@@ -671,85 +920,213 @@ void Renderer::WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs)
 }
 
 // Routine Description:
-// - Paint helper to copy the primary console buffer text onto the screen.
-// - This portion primarily handles figuring the current viewport, comparing it/trimming it versus the invalid portion of the frame, and queuing up, row by row, which pieces of text need to be further processed.
-// - See also: Helper functions that separate out each complexity of text rendering.
+// - Copies everything that's needed to paint the engines' invalid areas into the frame snapshot.
+// - Must be called with the console lock held, after the engines started painting,
+//   because the snapshot only contains what the engines report as dirty.
 // Arguments:
-// - <none>
+// - engines - The engines that are about to paint the frame.
 // Return Value:
 // - <none>
-void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
+void Renderer::_CaptureFrame(const std::span<IRenderEngine* const> engines)
 {
+    _frame.Reset(_renderSettings);
+
     // This is the subsection of the entire screen buffer that is currently being presented.
-    // It can move left/right or top/bottom depending on how the viewport is scrolled
-    // relative to the entire buffer.
     const auto view = _pData->GetViewport();
 
-    // This is effectively the number of cells on the visible screen that need to be redrawn.
-    // The origin is always 0, 0 because it represents the screen itself, not the underlying buffer.
-    std::span<const til::rect> dirtyAreas;
-    LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
+    _CollectDirtyRows(engines, view.Dimensions());
+    _CaptureBufferOutput(view);
 
-    // This is to make sure any transforms are reset when this paint is finished.
-    auto resetLineTransform = wil::scope_exit([&]() {
-        LOG_IF_FAILED(pEngine->ResetLineTransform());
-    });
+    try
+    {
+        const auto overlays = _pData->GetOverlays();
+
+        for (const auto& overlay : overlays)
+        {
+            _CaptureOverlay(overlay);
+        }
+    }
+    CATCH_LOG();
+
+    try
+    {
+        const auto rectangles = _GetSelectionRects();
+        _frame.selectionRects.assign(rectangles.begin(), rectangles.end());
+    }
+    CATCH_LOG();
 
-    for (const auto& dirtyRect : dirtyAreas)
+    _frame.cursor = _GetCursorInfo();
+    _frame.title = _pData->GetConsoleTitle();
+    _frame.viewportLeft = view.Left();
+    _frame.gridLinesAllowed = _pData->IsGridLineDrawingAllowed();
+    _frame.hyperlinkHoveredId = _hyperlinkHoveredId;
+    _frame.hoveredInterval = _hoveredInterval;
+
+    // The engines get the colors from the snapshot's copy of the render settings,
+    // so we need to tell the original ones that blinking cells are on the screen.
+    if (_frame.IsBlinking())
     {
-        if (!dirtyRect)
+        _renderSettings.MarkBlinkInUse();
+    }
+}
+
+// Routine Description:
+// - Computes the union of the engines' dirty areas as a span of columns per row.
+// - Engines usually invalidate the same regions, so this lets us capture each row once,
+//   no matter how many engines are attached. Each engine later paints just its own subset.
+// Arguments:
+// - engines - The engines that are about to paint the frame.
+// - size - The size of the viewport.
+// Return Value:
+// - <none>
+void Renderer::_CollectDirtyRows(const std::span<IRenderEngine* const> engines, const til::size size)
+{
+    _dirtyRows.assign(gsl::narrow_cast<size_t>(std::max(0, size.height)), {});
+
+    const til::rect bounds{ size };
+
+    for (const auto pEngine : engines)
+    {
+        // This is effectively the number of cells on the visible screen that need to be redrawn.
+        // The origin is always 0, 0 because it represents the screen itself, not the underlying buffer.
+        std::span<const til::rect> dirtyAreas;
+        LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
+
+        for (const auto& dirtyRect : dirtyAreas)
+        {
+            const auto dirty = dirtyRect & bounds;
+
+            for (auto y = dirty.top; y < dirty.bottom; ++y)
+            {
+                auto& [left, right] = til::at(_dirtyRows, y);
+                if (left >= right)
+                {
+                    left = dirty.left;
+                    right = dirty.right;
+                }
+                else
+                {
+                    left = std::min(left, dirty.left);
+                    right = std::max(right, dirty.right);
+                }
+            }
+        }
+    }
+}
+
+// Routine Description:
+// - Capture helper to copy the dirty parts of the primary console buffer into the frame snapshot.
+// - This portion primarily handles figuring the current viewport, comparing it/trimming it versus the invalid portion of the frame, and queuing up, row by row, which pieces of text need to be further processed.
+// Arguments:
+// - view - The viewport that is currently presented.
+// Return Value:
+// - <none>
+void Renderer::_CaptureBufferOutput(const Viewport& view)
+{
+    // Retrieve the text buffer so we can read information out of it.
+    const auto& buffer = _pData->GetTextBuffer();
+
+    // Now walk through each row of text that we need to redraw.
+    for (til::CoordType y = 0; y < gsl::narrow_cast<til::CoordType>(_dirtyRows.size()); ++y)
+    {
+        const auto [left, right] = til::at(_dirtyRows, y);
+        if (left >= right)
         {
             continue;
         }
 
-        auto dirty = Viewport::FromExclusive(dirtyRect);
+        // Calculate the boundaries of a single line in buffer coordinates.
+        // This is from the left to right edge of the dirty area in width and exactly 1 tall.
+        const auto row = y + view.Top();
+        const auto screenLine = til::inclusive_rect{ left + view.Left(), row, right - 1 + view.Left(), row };
+
+        // Convert the screen coordinates of the line to an equivalent
+        // range of buffer cells, taking line rendition into account.
+        const auto lineRendition = buffer.GetLineRendition(row);
+        const auto bufferLine = Viewport::FromInclusive(ScreenToBufferLine(screenLine, lineRendition));
+
+        // Retrieve the span iterator limited to just this line we want to redraw.
+        const auto it = buffer.GetRowSpansAt(bufferLine.Origin(), bufferLine);
+
+        FrameSnapshot::Line line;
+        // Find where on the screen we should place this line information. This requires us to re-map
+        // the buffer-based origin of the line back onto the screen-based origin of the line.
+        // For example, the screen might say we need to paint line 1 because it is dirty but the viewport
+        // is actually looking at line 26 relative to the buffer. This means that we need line 27 out
+        // of the backing buffer to fill in line 1 of the screen.
+        line.target = bufferLine.Origin() - til::point{ 0, view.Top() };
+        line.screen = til::rect{ left, y, right, y + 1 };
+        line.lineRendition = lineRendition;
+        // Calculate if two things are true:
+        // 1. this row wrapped
+        // 2. We're painting the last col of the row.
+        // In that case, set lineWrapped=true for the PaintBufferLine calls.
+        line.lineWrapped = (buffer.GetRowByOffset(bufferLine.Origin().y).WasWrapForced()) &&
+                           (bufferLine.RightExclusive() == buffer.GetSize().Width());
+
+        _frame.AppendLine(_frame.lines, it, *_pData, line);
+    }
+}
+
+// Routine Description:
+// - Capture helper to copy the dirty parts of an overlay into the frame snapshot.
+// - This supports IME composition.
+// Arguments:
+// - overlay - The overlay to capture.
+// Return Value:
+// - <none>
+void Renderer::_CaptureOverlay(const RenderOverlay& overlay)
+{
+    // Now get the overlay's viewport and adjust it to where it is supposed to be relative to the window.
+    auto srCaView = overlay.region.ToExclusive();
+    srCaView.top += overlay.origin.y;
+    srCaView.bottom += overlay.origin.y;
+    srCaView.left += overlay.origin.x;
+    srCaView.right += overlay.origin.x;
 
-        // Shift the origin of the dirty region to match the underlying buffer so we can
-        // compare the two regions directly for intersection.
-        dirty = Viewport::Offset(dirty, view.Origin());
+    const auto top = std::max(srCaView.top, 0);
+    const auto bottom = std::min(srCaView.bottom, gsl::narrow_cast<til::CoordType>(_dirtyRows.size()));
 
-        // The intersection between what is dirty on the screen (in need of repaint)
-        // and what is supposed to be visible on the screen (the viewport) is what
-        // we need to walk through line-by-line and repaint onto the screen.
-        const auto redraw = Viewport::Intersect(dirty, view);
+    for (auto iRow = top; iRow < bottom; iRow++)
+    {
+        const auto [dirtyLeft, dirtyRight] = til::at(_dirtyRows, iRow);
+        const auto left = std::max(dirtyLeft, srCaView.left);
+        const auto right = std::min(dirtyRight, srCaView.right);
+        if (left >= right)
+        {
+            continue;
+        }
 
-        // Retrieve the text buffer so we can read information out of it.
-        const auto& buffer = _pData->GetTextBuffer();
+        const til::point target{ left, iRow };
+        const auto source = target - overlay.origin;
+        const auto limit = Viewport::FromExclusive({ source.x, source.y, source.x + right - left, source.y + 1 });
 
-        // Now walk through each row of text that we need to redraw.
-        for (auto row = redraw.Top(); row < redraw.BottomExclusive(); row++)
+        const auto it = overlay.buffer.GetRowSpansAt(source, limit);
+
+        FrameSnapshot::Line line;
+        line.target = target;
+        line.screen = til::rect{ left, iRow, right, iRow + 1 };
+
+        _frame.AppendLine(_frame.overlayLines, it, *_pData, line);
+    }
+}
+
+// Routine Description:
+// - Segments all captured lines into runs, which are then replayed to every engine.
+// - This doesn't access the console data and is called after the console lock was released.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_BuildFrameRuns()
+{
+    for (auto lines : { &_frame.lines, &_frame.overlayLines })
+    {
+        for (auto& line : *lines)
         {
-            // Calculate the boundaries of a single line. This is from the left to right edge of the dirty
-            // area in width and exactly 1 tall.
-            const auto screenLine = til::inclusive_rect{ redraw.Left(), row, redraw.RightInclusive(), row };
-
-            // Convert the screen coordinates of the line to an equivalent
-            // range of buffer cells, taking line rendition into account.
-            const auto lineRendition = buffer.GetLineRendition(row);
-            const auto bufferLine = Viewport::FromInclusive(ScreenToBufferLine(screenLine, lineRendition));
-
-            // Find where on the screen we should place this line information. This requires us to re-map
-            // the buffer-based origin of the line back onto the screen-based origin of the line.
-            // For example, the screen might say we need to paint line 1 because it is dirty but the viewport
-            // is actually looking at line 26 relative to the buffer. This means that we need line 27 out
-            // of the backing buffer to fill in line 1 of the screen.
-            const auto screenPosition = bufferLine.Origin() - til::point{ 0, view.Top() };
-
-            // Retrieve the cell information iterator limited to just this line we want to redraw.
-            auto it = buffer.GetCellDataAt(bufferLine.Origin(), bufferLine);
-
-            // Calculate if two things are true:
-            // 1. this row wrapped
-            // 2. We're painting the last col of the row.
-            // In that case, set lineWrapped=true for the _PaintBufferOutputHelper call.
-            const auto lineWrapped = (buffer.GetRowByOffset(bufferLine.Origin().y).WasWrapForced()) &&
-                                     (bufferLine.RightExclusive() == buffer.GetSize().Width());
-
-            // Prepare the appropriate line transform for the current row and viewport offset.
-            LOG_IF_FAILED(pEngine->PrepareLineTransform(lineRendition, screenPosition.y, view.Left()));
-
-            // Ask the helper to paint through this specific line.
-            _PaintBufferOutputHelper(pEngine, it, screenPosition, lineWrapped);
+            line.runOffset = gsl::narrow<uint32_t>(_frame.runs.size());
+            _BuildRuns(_frame.GetCells(line), line.target, _frame.runs, _frame.clusters);
+            line.runCount = gsl::narrow<uint32_t>(_frame.runs.size() - line.runOffset);
         }
     }
 }
@@ -757,157 +1134,245 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
 static bool _IsAllSpaces(const std::wstring_view v)
 {
     // first non-space char is not found (is npos)
-    return v.find_first_not_of(L' ') == decltype(v)::npos;
+    return til::scan::find_first_not_of(v, L' ') == til::scan::npos;
 }
 
-void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                        TextBufferCellIterator it,
-                                        const til::point target,
-                                        const bool lineWrapped)
+// Routine Description:
+// - Segments a line of cells into runs of clusters with the same color, pattern and font,
+//   each of which is painted with a single call to PaintBufferLine().
+// Arguments:
+// - cells - The cells of (a part of) a line.
+// - target - The screen position of the first cell.
+// - runs - Receives the runs. Their clusterOffset indexes into clusters.
+// - clusters - Receives the clusters.
+// Return Value:
+// - <none>
+void Renderer::_BuildRuns(const std::span<const FrameSnapshot::Cell> cells,
+                          const til::point target,
+                          std::vector<FrameSnapshot::Run>& runs,
+                          std::vector<Cluster>& clusters) const
 {
-    auto globalInvert{ _renderSettings.GetRenderMode(RenderSettings::Mode::ScreenReversed) };
+    const auto globalInvert{ _frame.settings.GetRenderMode(RenderSettings::Mode::ScreenReversed) };
+    const auto count = cells.size();
 
     // If we have valid data, let's figure out how to draw it.
-    if (it)
-    {
-        // TODO: MSFT: 20961091 -  This is a perf issue. Instead of rebuilding this and allocing memory to hold the reinterpretation,
-        // we should have an iterator/view adapter for the rendering.
-        // That would probably also eliminate the RenderData needing to give us the entire TextBuffer as well...
-        // Retrieve the iterator for one line of information.
-        til::CoordType cols = 0;
-
-        // Retrieve the first color.
-        auto color = it->TextAttr();
-        // Retrieve the first pattern id
-        auto patternIds = _pData->GetPatternId(target);
-        // Determine whether we're using a soft font.
-        auto usingSoftFont = s_IsSoftFontChar(it->Chars(), _firstSoftFontChar, _lastSoftFontChar);
-
-        // And hold the point where we should start drawing.
-        auto screenPoint = target;
-
-        // This outer loop will continue until we reach the end of the text we are trying to draw.
-        while (it)
+    if (!count)
+    {
+        return;
+    }
+
+    size_t i = 0;
+    til::CoordType cols = 0;
+
+    // Retrieve the first color.
+    auto color = cells[0].attr;
+    // Retrieve the first pattern set
+    auto patternIds = cells[0].patterns;
+    // Determine whether we're using a soft font.
+    auto usingSoftFont = s_IsSoftFontChar(_frame.GetText(cells[0]), _firstSoftFontChar, _lastSoftFontChar);
+
+    // And hold the point where we should start drawing.
+    auto screenPoint = target;
+
+    // This outer loop will continue until we reach the end of the text we are trying to draw.
+    while (i < count)
+    {
+        // Hold onto the current run color, pattern set and font usage right here for the length of the outer loop.
+        // We'll be changing the persistent ones as we run through the inner loop to detect when a run changes.
+        auto& run = runs.emplace_back();
+        run.attr = color;
+        run.patterns = patternIds;
+        run.usingSoftFont = usingSoftFont;
+
+        // Advance the point by however many columns we've just outputted and reset the accumulator.
+        screenPoint.x += cols;
+        cols = 0;
+
+        // Hold onto the start of this run in case we need to do some special work to paint the line drawing characters.
+        run.cellOffset = gsl::narrow_cast<uint32_t>(i);
+        run.clusterOffset = gsl::narrow<uint32_t>(clusters.size());
+
+        // This inner loop will accumulate clusters until the color changes.
+        // When the color changes, it will save the new color off and break.
+        // We also accumulate clusters according to regex patterns
+        do
         {
-            // Hold onto the current run color right here for the length of the outer loop.
-            // We'll be changing the persistent one as we run through the inner loops to detect
-            // when a run changes, but we will still need to know this color at the bottom
-            // when we go to draw gridlines for the length of the run.
-            const auto currentRunColor = color;
+            const auto& cell = til::at(cells, i);
+            const auto chars = _frame.GetText(cell);
+            const auto thisUsingSoftFont = s_IsSoftFontChar(chars, _firstSoftFontChar, _lastSoftFontChar);
+            const auto changedPatternOrFont = patternIds != cell.patterns || usingSoftFont != thisUsingSoftFont;
+            if (color != cell.attr || changedPatternOrFont)
+            {
+                // foreground doesn't matter for runs of spaces (!)
+                // if we trick it . . . we call Paint far fewer times for cmatrix
+                if (!_IsAllSpaces(chars) || !cell.attr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || changedPatternOrFont)
+                {
+                    color = cell.attr;
+                    patternIds = cell.patterns;
+                    usingSoftFont = thisUsingSoftFont;
+                    break; // vend this run
+                }
+            }
 
-            // Hold onto the current pattern id as well
-            const auto currentPatternId = patternIds;
+            // Walk through the text data and turn it into rendering clusters.
+            // Keep the columnCount as we go to improve performance over digging it out of the vector at the end.
+            til::CoordType columnCount = cell.columns;
 
-            // Update the drawing brushes with our color and font usage.
-            THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, currentRunColor, usingSoftFont, false));
+            // If we're on the first cluster to be added and it's marked as "trailing"
+            // (a.k.a. the right half of a two column character), then we need some special handling.
+            if (clusters.size() == run.clusterOffset && cell.dbcs == DbcsAttribute::Trailing)
+            {
+                // Move left to the one so the whole character can be struck correctly.
+                --screenPoint.x;
+                // And tell the engine to trim off the left half of it.
+                run.trimLeft = true;
+                // And add one to the number of columns we expect it to take as we insert it.
+                ++columnCount;
+            }
 
-            // Advance the point by however many columns we've just outputted and reset the accumulator.
-            screenPoint.x += cols;
-            cols = 0;
+            if (columnCount > 1)
+            {
+                run.containsWideCharacter = true;
+            }
 
-            // Hold onto the start of this run iterator and the target location where we started
-            // in case we need to do some special work to paint the line drawing characters.
-            const auto currentRunItStart = it;
-            const auto currentRunTargetStart = screenPoint;
+            // Advance the cluster and column counts.
+            clusters.emplace_back(chars, columnCount);
+            i += std::max<size_t>(cell.columns, 1); // prevent infinite loop for no visible columns
+            cols += columnCount;
 
-            // Ensure that our cluster vector is clear.
-            _clusterBuffer.clear();
+        } while (i < count);
 
-            // Reset our flag to know when we're in the special circumstance
-            // of attempting to draw only the right-half of a two-column character
-            // as the first item in our run.
-            auto trimLeft = false;
+        run.target = screenPoint;
+        run.columns = cols;
+        run.cellCount = gsl::narrow_cast<uint32_t>(std::min(i, count) - run.cellOffset);
+        run.clusterCount = gsl::narrow<uint32_t>(clusters.size() - run.clusterOffset);
+    }
+}
 
-            // Run contains wide character (>1 columns)
-            auto containsWideCharacter = false;
+// Routine Description:
+// - Paint helper to copy the primary console buffer text onto the screen.
+// - See also: Helper functions that separate out each complexity of text rendering.
+// Arguments:
+// - pEngine - The engine to paint with.
+// Return Value:
+// - <none>
+void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
+{
+    // This is to make sure any transforms are reset when this paint is finished.
+    auto resetLineTransform = wil::scope_exit([&]() {
+        LOG_IF_FAILED(pEngine->ResetLineTransform());
+    });
 
-            // This inner loop will accumulate clusters until the color changes.
-            // When the color changes, it will save the new color off and break.
-            // We also accumulate clusters according to regex patterns
-            do
+    _PaintLines(pEngine, _frame.lines, true);
+}
+
+// Routine Description:
+// - Paints the parts of the captured lines that intersect with the engine's dirty area.
+// - Lines that are entirely dirty are painted by replaying their prebuilt runs. For the
+//   others the runs are rebuilt for the dirty subset of their cells.
+// Arguments:
+// - pEngine - The engine to paint with.
+// - lines - The lines to paint.
+// - transform - Whether to prepare the line transform (line rendition and viewport offset).
+// Return Value:
+// - <none>
+void Renderer::_PaintLines(_In_ IRenderEngine* const pEngine, const std::vector<FrameSnapshot::Line>& lines, const bool transform)
+{
+    std::span<const til::rect> dirtyAreas;
+    LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
+
+    const auto originX = transform ? _frame.viewportLeft : 0;
+
+    for (const auto& line : lines)
+    {
+        const auto cells = _frame.GetCells(line);
+
+        for (const auto& dirtyRect : dirtyAreas)
+        {
+            const auto dirty = dirtyRect & line.screen;
+            if (!dirty)
             {
-                til::point thisPoint{ screenPoint.x + cols, screenPoint.y };
-                const auto thisPointPatterns = _pData->GetPatternId(thisPoint);
-                const auto thisUsingSoftFont = s_IsSoftFontChar(it->Chars(), _firstSoftFontChar, _lastSoftFontChar);
-                const auto changedPatternOrFont = patternIds != thisPointPatterns || usingSoftFont != thisUsingSoftFont;
-                if (color != it->TextAttr() || changedPatternOrFont)
-                {
-                    auto newAttr{ it->TextAttr() };
-                    // foreground doesn't matter for runs of spaces (!)
-                    // if we trick it . . . we call Paint far fewer times for cmatrix
-                    if (!_IsAllSpaces(it->Chars()) || !newAttr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || changedPatternOrFont)
-                    {
-                        color = newAttr;
-                        patternIds = thisPointPatterns;
-                        usingSoftFont = thisUsingSoftFont;
-                        break; // vend this run
-                    }
-                }
+                continue;
+            }
 
-                // Walk through the text data and turn it into rendering clusters.
-                // Keep the columnCount as we go to improve performance over digging it out of the vector at the end.
-                auto columnCount = it->Columns();
+            if (transform)
+            {
+                // Prepare the appropriate line transform for the current row and viewport offset.
+                LOG_IF_FAILED(pEngine->PrepareLineTransform(line.lineRendition, line.target.y, _frame.viewportLeft));
+            }
 
-                // If we're on the first cluster to be added and it's marked as "trailing"
-                // (a.k.a. the right half of a two column character), then we need some special handling.
-                if (_clusterBuffer.empty() && it->DbcsAttr() == DbcsAttribute::Trailing)
-                {
-                    // Move left to the one so the whole character can be struck correctly.
-                    --screenPoint.x;
-                    // And tell the next function to trim off the left half of it.
-                    trimLeft = true;
-                    // And add one to the number of columns we expect it to take as we insert it.
-                    ++columnCount;
-                }
+            if (dirty == line.screen)
+            {
+                _PaintRuns(pEngine, cells, _frame.GetRuns(line), _frame.clusters, line.lineWrapped);
+                continue;
+            }
 
-                if (columnCount > 1)
-                {
-                    containsWideCharacter = true;
-                }
+            // Convert the dirty part of the line to the equivalent range of cells, taking line rendition into account.
+            const auto bufferLine = ScreenToBufferLine(til::inclusive_rect{ dirty.left + originX, line.target.y, dirty.right - 1 + originX, line.target.y }, line.lineRendition);
+            const auto beg = gsl::narrow_cast<size_t>(std::clamp<til::CoordType>(bufferLine.left - line.target.x, 0, gsl::narrow_cast<til::CoordType>(cells.size())));
+            const auto end = gsl::narrow_cast<size_t>(std::clamp<til::CoordType>(bufferLine.right + 1 - line.target.x, gsl::narrow_cast<til::CoordType>(beg), gsl::narrow_cast<til::CoordType>(cells.size())));
+            const auto subset = cells.subspan(beg, end - beg);
 
-                // Advance the cluster and column counts.
-                _clusterBuffer.emplace_back(it->Chars(), columnCount);
-                it += std::max(it->Columns(), 1); // prevent infinite loop for no visible columns
-                cols += columnCount;
+            _runBuffer.clear();
+            _clusterBuffer.clear();
+            _BuildRuns(subset, { line.target.x + gsl::narrow_cast<til::CoordType>(beg), line.target.y }, _runBuffer, _clusterBuffer);
+            _PaintRuns(pEngine, subset, _runBuffer, _clusterBuffer, line.lineWrapped && end == cells.size());
+        }
+    }
+}
 
-            } while (it);
+// Routine Description:
+// - Paints prebuilt runs of clusters and their gridlines.
+// Arguments:
+// - pEngine - The engine to paint with.
+// - cells - The cells the runs were built from.
+// - runs - The runs to paint.
+// - clusters - The clusters the runs refer to.
+// - lineWrapped - Whether the line wrapped and ends at the right edge of the buffer.
+// Return Value:
+// - <none>
+void Renderer::_PaintRuns(_In_ IRenderEngine* const pEngine,
+                          const std::span<const FrameSnapshot::Cell> cells,
+                          const std::span<const FrameSnapshot::Run> runs,
+                          const std::span<const Cluster> clusters,
+                          const bool lineWrapped)
+{
+    for (const auto& run : runs)
+    {
+        // Update the drawing brushes with our color and font usage.
+        THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, run.attr, run.usingSoftFont, false));
 
-            // Do the painting.
-            THROW_IF_FAILED(pEngine->PaintBufferLine({ _clusterBuffer.data(), _clusterBuffer.size() }, screenPoint, trimLeft, lineWrapped));
+        // Do the painting.
+        THROW_IF_FAILED(pEngine->PaintBufferLine(clusters.subspan(run.clusterOffset, run.clusterCount), run.target, run.trimLeft, lineWrapped));
 
-            // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
-            // We're only allowed to draw the grid lines under certain circumstances.
-            if (_pData->IsGridLineDrawingAllowed())
+        // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
+        // We're only allowed to draw the grid lines under certain circumstances.
+        if (_frame.gridLinesAllowed)
+        {
+            // See GH: 803
+            // If we found a wide character while we built the run, it's possible we skipped over the right half
+            // attribute that could have contained different line information than the left half.
+            if (run.containsWideCharacter)
             {
-                // See GH: 803
-                // If we found a wide character while we looped above, it's possible we skipped over the right half
-                // attribute that could have contained different line information than the left half.
-                if (containsWideCharacter)
-                {
-                    // Start from the original position in this run.
-                    auto lineIt = currentRunItStart;
-                    // Start from the original target in this run.
-                    auto lineTarget = currentRunTargetStart;
-
-                    // We need to go through the iterators again to ensure we get the lines associated with each
-                    // exact column. The code above will condense two-column characters into one, but it is possible
-                    // (like with the IME) that the line drawing characters will vary from the left to right half
-                    // of a wider character.
-                    // We could theoretically pre-pass for this in the loop above to be more efficient about walking
-                    // the iterator, but I fear it would make the code even more confusing than it already is.
-                    // Do that in the future if some WPR trace points you to this spot as super bad.
-                    for (til::CoordType colsPainted = 0; colsPainted < cols; ++colsPainted, ++lineIt, ++lineTarget.x)
-                    {
-                        auto lines = lineIt->TextAttr();
-                        _PaintBufferOutputGridLineHelper(pEngine, lines, 1, lineTarget);
-                    }
-                }
-                else
+                // Start from the original target in this run, which is one column to the
+                // right of where we started painting if we trimmed off a leading half.
+                til::point lineTarget{ run.target.x + (run.trimLeft ? 1 : 0), run.target.y };
+
+                // We need to go through the cells again to ensure we get the lines associated with each
+                // exact column. The runs condense two-column characters into one, but it is possible
+                // (like with the IME) that the line drawing characters will vary from the left to right half
+                // of a wider character. The snapshot stores each column as a separate cell for this reason.
+                for (const auto& cell : cells.subspan(run.cellOffset, run.cellCount))
                 {
-                    // If nothing exciting is going on, draw the lines in bulk.
-                    _PaintBufferOutputGridLineHelper(pEngine, currentRunColor, cols, screenPoint);
+                    _PaintBufferOutputGridLineHelper(pEngine, cell.attr, _frame.HasPatterns(cell), 1, lineTarget);
+                    ++lineTarget.x;
                 }
             }
+            else
+            {
+                // If nothing exciting is going on, draw the lines in bulk.
+                _PaintBufferOutputGridLineHelper(pEngine, run.attr, run.patterns != 0, run.columns, run.target);
+            }
         }
     }
 }
@@ -972,12 +1437,14 @@ GridLineSet Renderer::s_GetGridlines(const TextAttribute& textAttribute) noexcep
 // - See also: All related helpers and buffer output functions.
 // Arguments:
 // - textAttribute - The line/box drawing attributes to use for this particular run.
+// - hasPatterns - Whether the run is part of a pattern (like a detected URL).
 // - cchLine - The length of both pwsLine and pbKAttrsLine.
 // - coordTarget - The X/Y coordinate position in the buffer which we're attempting to start rendering from.
 // Return Value:
 // - <none>
 void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngine,
                                                 const TextAttribute textAttribute,
+                                                const bool hasPatterns,
                                                 const size_t cchLine,
                                                 const til::point coordTarget)
 {
@@ -985,7 +1452,7 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
     auto lines = Renderer::s_GetGridlines(textAttribute);
 
     // For now, we dash underline patterns and switch to regular underline on hover
-    if (_isHoveredHyperlink(textAttribute) || _isInHoveredInterval(coordTarget))
+    if (_isHoveredHyperlink(textAttribute) || _isInHoveredInterval(coordTarget, hasPatterns))
     {
         lines.reset(GridLines::HyperlinkUnderline);
         lines.set(GridLines::Underline);
@@ -995,7 +1462,7 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
     if (lines.any())
     {
         // Get the current foreground color to render the lines.
-        const auto rgb = _renderSettings.GetAttributeColors(textAttribute).first;
+        const auto rgb = _frame.settings.GetAttributeColors(textAttribute).first;
         // Draw the lines
         LOG_IF_FAILED(pEngine->PaintBufferGridLines(lines, rgb, cchLine, coordTarget));
     }
@@ -1003,14 +1470,14 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
 
 bool Renderer::_isHoveredHyperlink(const TextAttribute& textAttribute) const noexcept
 {
-    return _hyperlinkHoveredId && _hyperlinkHoveredId == textAttribute.GetHyperlinkId();
+    return _frame.hyperlinkHoveredId && _frame.hyperlinkHoveredId == textAttribute.GetHyperlinkId();
 }
 
-bool Renderer::_isInHoveredInterval(const til::point coordTarget) const noexcept
+bool Renderer::_isInHoveredInterval(const til::point coordTarget, const bool hasPatterns) const noexcept
 {
-    return _hoveredInterval &&
-           _hoveredInterval->start <= coordTarget && coordTarget <= _hoveredInterval->stop &&
-           _pData->GetPatternId(coordTarget).size() > 0;
+    return _frame.hoveredInterval &&
+           _frame.hoveredInterval->start <= coordTarget && coordTarget <= _frame.hoveredInterval->stop &&
+           hasPatterns;
 }
 
 // Routine Description:
@@ -1085,10 +1552,9 @@ bool Renderer::_isInHoveredInterval(const til::point coordTarget) const noexcept
 // - <none>
 void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine)
 {
-    const auto cursorInfo = _GetCursorInfo();
-    if (cursorInfo.has_value())
+    if (_frame.cursor.has_value())
     {
-        LOG_IF_FAILED(pEngine->PaintCursor(cursorInfo.value()));
+        LOG_IF_FAILED(pEngine->PaintCursor(_frame.cursor.value()));
     }
 }
 
@@ -1106,52 +1572,10 @@ void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine)
 [[nodiscard]] HRESULT Renderer::_PrepareRenderInfo(_In_ IRenderEngine* const pEngine)
 {
     RenderFrameInfo info;
-    info.cursorInfo = _GetCursorInfo();
+    info.cursorInfo = _frame.cursor;
     return pEngine->PrepareRenderInfo(info);
 }
 
-// Routine Description:
-// - Paint helper to draw text that overlays the main buffer to provide user interactivity regions
-// - This supports IME composition.
-// Arguments:
-// - engine - The render engine that we're targeting.
-// - overlay - The overlay to draw.
-// Return Value:
-// - <none>
-void Renderer::_PaintOverlay(IRenderEngine& engine,
-                             const RenderOverlay& overlay)
-{
-    try
-    {
-        // Now get the overlay's viewport and adjust it to where it is supposed to be relative to the window.
-        auto srCaView = overlay.region.ToExclusive();
-        srCaView.top += overlay.origin.y;
-        srCaView.bottom += overlay.origin.y;
-        srCaView.left += overlay.origin.x;
-        srCaView.right += overlay.origin.x;
-
-        std::span<const til::rect> dirtyAreas;
-        LOG_IF_FAILED(engine.GetDirtyArea(dirtyAreas));
-
-        for (const auto& rect : dirtyAreas)
-        {
-            if (const auto viewDirty = rect & srCaView)
-            {
-                for (auto iRow = viewDirty.top; iRow < viewDirty.bottom; iRow++)
-                {
-                    const til::point target{ viewDirty.left, iRow };
-                    const auto source = target - overlay.origin;
-
-                    auto it = overlay.buffer.GetCellLineDataAt(source);
-
-                    _PaintBufferOutputHelper(&engine, it, target, false);
-                }
-            }
-        }
-    }
-    CATCH_LOG();
-}
-
 // Routine Description:
 // - Paint helper to draw the composition string portion of the IME.
 // - This specifically is the string that appears at the cursor on the input line showing what the user is currently typing.
@@ -1164,12 +1588,7 @@ void Renderer::_PaintOverlays(_In_ IRenderEngine* const pEngine)
 {
     try
     {
-        const auto overlays = _pData->GetOverlays();
-
-        for (const auto& overlay : overlays)
-        {
-            _PaintOverlay(*pEngine, overlay);
-        }
+        _PaintLines(pEngine, _frame.overlayLines, false);
     }
     CATCH_LOG();
 }
@@ -1187,9 +1606,7 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
         std::span<const til::rect> dirtyAreas;
         LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
 
-        // Get selection rectangles
-        const auto rectangles = _GetSelectionRects();
-        for (const auto& rect : rectangles)
+        for (const auto& rect : _frame.selectionRects)
         {
             for (auto& dirtyRect : dirtyAreas)
             {
@@ -1222,7 +1639,7 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
 {
     // The last color needs to be each engine's responsibility. If it's local to this function,
     //      then on the next engine we might not update the color.
-    return pEngine->UpdateDrawingBrushes(textAttributes, _renderSettings, _pData, usingSoftFont, isSettingDefaultBrushes);
+    return pEngine->UpdateDrawingBrushes(textAttributes, _frame.settings, _pData, usingSoftFont, isSettingDefaultBrushes);
 }
 
 // Routine Description:
@@ -1367,7 +1784,15 @@ void Renderer::ResetErrorStateAndResume()
 
 void Renderer::UpdateHyperlinkHoveredId(uint16_t id) noexcept
 {
+    // _CaptureFrame() copies the ID into the frame under the console lock.
+    // The console lock is recursive, so this is fine for callers that already hold it.
+    _pData->LockConsole();
+    const auto unlock = wil::scope_exit([&]() {
+        _pData->UnlockConsole();
+    });
+
     _hyperlinkHoveredId = id;
+    const auto engineLock = _engineLock.lock_exclusive();
     FOREACH_ENGINE(pEngine)
     {
         pEngine->UpdateHyperlinkHoveredId(id);
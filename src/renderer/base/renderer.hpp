@@ -20,6 +20,7 @@ Author(s):
 #include "../inc/RenderSettings.hpp"
 
 #include "thread.hpp"
+#include "FrameSnapshot.hpp"
 
 #include "../../buffer/out/textBuffer.hpp"
 
@@ -52,6 +53,7 @@ namespace Microsoft::Console::Render
         void TriggerRedraw(const til::point* const pcoord);
         void TriggerRedrawCursor(const til::point* const pcoord);
         void TriggerRedrawAll(const bool backgroundChanged = false, const bool frameChanged = false);
+        void TriggerRedrawBlinkingCells();
         void TriggerTeardown() noexcept;
 
         void TriggerSelection();
@@ -89,35 +91,68 @@ namespace Microsoft::Console::Render
         void SetRendererEnteredErrorStateCallback(std::function<void()> pfn);
         void ResetErrorStateAndResume();
 
+        size_t GetBlinkRedrawCellCount() const noexcept;
+
         void UpdateHyperlinkHoveredId(uint16_t id) noexcept;
         void UpdateLastHoveredInterval(const std::optional<interval_tree::IntervalTree<til::point, size_t>::interval>& newInterval);
 
     private:
+        // An invalidation that arrived while the engines were busy painting a frame.
+        struct PendingInvalidation
+        {
+            enum class Kind : uint8_t
+            {
+                Region,
+                Cursor,
+                System,
+                Selection,
+                Scroll,
+                All,
+                Viewport,
+            };
+
+            Kind kind;
+            til::rect rect;
+            til::point delta;
+        };
+
         static GridLineSet s_GetGridlines(const TextAttribute& textAttribute) noexcept;
         static bool s_IsSoftFontChar(const std::wstring_view& v, const size_t firstSoftFontChar, const size_t lastSoftFontChar);
 
         [[nodiscard]] HRESULT _PaintFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept;
+        [[nodiscard]] HRESULT _PaintFrameForEngines(const std::span<IRenderEngine* const> engines) noexcept;
+        [[nodiscard]] HRESULT _PaintFrameFromSnapshot(_In_ IRenderEngine* const pEngine);
+        std::span<IRenderEngine* const> _ActiveEngines() const noexcept;
         bool _CheckViewportAndScroll();
+        void _Invalidate(const PendingInvalidation& invalidation);
+        void _ApplyInvalidation(const PendingInvalidation& invalidation);
+        void _ApplyPendingInvalidations();
+        void _CaptureFrame(const std::span<IRenderEngine* const> engines);
+        void _CollectDirtyRows(const std::span<IRenderEngine* const> engines, const til::size size);
+        void _CaptureBufferOutput(const Microsoft::Console::Types::Viewport& view);
+        void _CaptureOverlay(const RenderOverlay& overlay);
+        void _BuildRuns(const std::span<const FrameSnapshot::Cell> cells, const til::point target, std::vector<FrameSnapshot::Run>& runs, std::vector<Cluster>& clusters) const;
+        void _BuildFrameRuns();
         [[nodiscard]] HRESULT _PaintBackground(_In_ IRenderEngine* const pEngine);
         void _PaintBufferOutput(_In_ IRenderEngine* const pEngine);
-        void _PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine, TextBufferCellIterator it, const til::point target, const bool lineWrapped);
-        void _PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngine, const TextAttribute textAttribute, const size_t cchLine, const til::point coordTarget);
+        void _PaintLines(_In_ IRenderEngine* const pEngine, const std::vector<FrameSnapshot::Line>& lines, const bool transform);
+        void _PaintRuns(_In_ IRenderEngine* const pEngine, const std::span<const FrameSnapshot::Cell> cells, const std::span<const FrameSnapshot::Run> runs, const std::span<const Cluster> clusters, const bool lineWrapped);
+        void _PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngine, const TextAttribute textAttribute, const bool hasPatterns, const size_t cchLine, const til::point coordTarget);
         bool _isHoveredHyperlink(const TextAttribute& textAttribute) const noexcept;
         void _PaintSelection(_In_ IRenderEngine* const pEngine);
         void _PaintCursor(_In_ IRenderEngine* const pEngine);
         void _PaintOverlays(_In_ IRenderEngine* const pEngine);
-        void _PaintOverlay(IRenderEngine& engine, const RenderOverlay& overlay);
         [[nodiscard]] HRESULT _UpdateDrawingBrushes(_In_ IRenderEngine* const pEngine, const TextAttribute attr, const bool usingSoftFont, const bool isSettingDefaultBrushes);
         [[nodiscard]] HRESULT _PerformScrolling(_In_ IRenderEngine* const pEngine);
         std::vector<til::rect> _GetSelectionRects() const;
         void _ScrollPreviousSelection(const til::point delta);
         [[nodiscard]] HRESULT _PaintTitle(IRenderEngine* const pEngine);
-        bool _isInHoveredInterval(til::point coordTarget) const noexcept;
+        bool _isInHoveredInterval(til::point coordTarget, const bool hasPatterns) const noexcept;
         [[nodiscard]] std::optional<CursorOptions> _GetCursorInfo();
         [[nodiscard]] HRESULT _PrepareRenderInfo(_In_ IRenderEngine* const pEngine);
 
         const RenderSettings& _renderSettings;
-        std::array<IRenderEngine*, 2> _engines{};
+        std::array<IRenderEngine*, 4> _engines{};
         IRenderData* _pData = nullptr; // Non-ownership pointer
         std::unique_ptr<RenderThread> _pThread;
         static constexpr size_t _firstSoftFontChar = 0xEF20;
@@ -126,7 +161,23 @@ namespace Microsoft::Console::Render
         std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> _hoveredInterval;
         Microsoft::Console::Types::Viewport _viewport;
         std::vector<Cluster> _clusterBuffer;
+        std::vector<FrameSnapshot::Run> _runBuffer;
+        // The union of all engines' dirty areas as a [left, right) span per row.
+        std::vector<std::pair<til::CoordType, til::CoordType>> _dirtyRows;
         std::vector<til::rect> _previousSelection;
+        // The number of cells TriggerRedrawBlinkingCells invalidated the last time it was called.
+        size_t _blinkRedrawCellCount = 0;
+        // Everything the current frame is painted from. See FrameSnapshot.hpp.
+        FrameSnapshot _frame;
+        // Held while calling into the engines, which aren't thread-safe. Painting a frame holds it
+        // after releasing the console lock, so the console lock must never be acquired while holding it.
+        wil::srwlock _engineLock;
+        // Protects the invalidations queued up while the engines were busy.
+        wil::srwlock _pendingLock;
+        std::vector<PendingInvalidation> _pendingInvalidations;
+        std::optional<std::wstring> _pendingTitle;
+        std::wstring _pendingNewText;
+        std::vector<til::rect> _selectionScratch;
         std::function<void()> _pfnBackgroundColorChanged;
         std::function<void()> _pfnFrameColorChanged;
         std::function<void()> _pfnRendererEnteredErrorState;
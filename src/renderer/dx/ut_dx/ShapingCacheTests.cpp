@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../../inc/ShapingCache.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console::Render;
+
+// The cache doesn't care what a font face is. Plain integers stand in for IDWriteFontFace here.
+using TestCache = ShapingCache<int>;
+
+static std::vector<uint16_t> narrowColumns(const std::wstring_view text, const uint16_t start = 0)
+{
+    std::vector<uint16_t> columns(text.size() + 1);
+    std::iota(columns.begin(), columns.end(), start);
+    return columns;
+}
+
+static TestCache::Entry makeEntry(const std::wstring_view text, const int face)
+{
+    TestCache::Entry entry;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        entry.Append(face, i, i + 1);
+    }
+    return entry;
+}
+
+class ShapingCacheTests
+{
+    TEST_CLASS(ShapingCacheTests);
+
+    TEST_METHOD(HitAndMiss)
+    {
+        TestCache cache;
+        static constexpr std::wstring_view text{ L"hello" };
+        const auto columns = narrowColumns(text);
+
+        VERIFY_IS_NULL(cache.Lookup(text, columns, 0));
+        cache.Insert(text, columns, 0, makeEntry(text, 1));
+
+        const auto entry = cache.Lookup(text, columns, 0);
+        VERIFY_IS_NOT_NULL(entry);
+        VERIFY_ARE_EQUAL(5u, entry->segments.size());
+        VERIFY_ARE_EQUAL(1u, entry->faces.size());
+        VERIFY_ARE_EQUAL(4u, entry->segments[4].beg);
+        VERIFY_ARE_EQUAL(5u, entry->segments[4].end);
+
+        // The state (bold/italic) and the column layout are part of the key.
+        VERIFY_IS_NULL(cache.Lookup(text, columns, 1));
+        VERIFY_IS_NULL(cache.Lookup(text, narrowColumns(text, 3), 0));
+        VERIFY_IS_NULL(cache.Lookup(L"hellO", columns, 0));
+
+        const auto& stats = cache.GetStats();
+        VERIFY_ARE_EQUAL(1u, stats.hits);
+        VERIFY_ARE_EQUAL(4u, stats.misses);
+
+        cache.Clear();
+        VERIFY_IS_NULL(cache.Lookup(text, columns, 0));
+        VERIFY_ARE_EQUAL(0u, cache.GetBytes());
+    }
+
+    TEST_METHOD(EntryDeduplicatesFaces)
+    {
+        TestCache::Entry entry;
+        entry.Append(1, 0, 1);
+        entry.Append(2, 1, 2);
+        entry.Append(1, 2, 3);
+        entry.Append(1, 3, 4);
+
+        VERIFY_ARE_EQUAL(2u, entry.faces.size());
+        VERIFY_ARE_EQUAL(4u, entry.segments.size());
+        VERIFY_ARE_EQUAL(entry.faces[entry.segments[0].face], 1);
+        VERIFY_ARE_EQUAL(entry.faces[entry.segments[1].face], 2);
+        VERIFY_ARE_EQUAL(entry.faces[entry.segments[2].face], 1);
+    }
+
+    TEST_METHOD(EvictsOldestOverBudget)
+    {
+        TestCache cache;
+
+        std::vector<std::wstring> lines;
+        for (auto i = 0; i < 8; ++i)
+        {
+            lines.emplace_back(fmt::format(FMT_COMPILE(L"line {:02}"), i));
+        }
+
+        const auto columns = narrowColumns(lines[0]);
+        for (const auto& line : lines)
+        {
+            cache.Insert(line, columns, 0, makeEntry(line, 0));
+        }
+
+        // Shrinking the budget to fit exactly 4 lines evicts the 4 oldest ones.
+        cache.SetBudget(cache.GetBytes() / 2);
+        VERIFY_ARE_EQUAL(4u, cache.GetEntryCount());
+        VERIFY_ARE_EQUAL(4u, cache.GetStats().evictions);
+        VERIFY_IS_NULL(cache.Lookup(lines[3], columns, 0));
+        VERIFY_IS_NOT_NULL(cache.Lookup(lines[4], columns, 0));
+
+        // lines[4] is the newest entry now, so the next insertion evicts lines[5].
+        cache.Insert(lines[0], columns, 0, makeEntry(lines[0], 0));
+        VERIFY_IS_NOT_NULL(cache.Lookup(lines[4], columns, 0));
+        VERIFY_IS_NULL(cache.Lookup(lines[5], columns, 0));
+        VERIFY_IS_NOT_NULL(cache.Lookup(lines[6], columns, 0));
+        VERIFY_IS_TRUE(cache.GetBytes() <= cache.GetBudget());
+
+        // Entries larger than the entire budget aren't cached at all.
+        cache.SetBudget(16);
+        VERIFY_ARE_EQUAL(0u, cache.GetEntryCount());
+        cache.Insert(lines[0], columns, 0, makeEntry(lines[0], 0));
+        VERIFY_ARE_EQUAL(0u, cache.GetEntryCount());
+    }
+
+    // Simulates scrolling through a log: every frame repaints the viewport, which
+    // mostly consists of the lines that were already visible in the previous frame.
+    TEST_METHOD(ScrollingHitRate)
+    {
+        TestCache cache;
+        static constexpr auto viewportHeight = 30;
+        static constexpr auto lineCount = 1000;
+
+        std::vector<std::wstring> lines;
+        for (auto i = 0; i < lineCount; ++i)
+        {
+            lines.emplace_back(fmt::format(FMT_COMPILE(L"{:5}: [info] processed request {} in {} ms"), i, i * 7919 % 10007, i % 97));
+        }
+
+        for (auto top = 0; top + viewportHeight <= lineCount; ++top)
+        {
+            for (auto y = top; y < top + viewportHeight; ++y)
+            {
+                const auto& line = lines[y];
+                const auto columns = narrowColumns(line);
+                if (!cache.Lookup(line, columns, 0))
+                {
+                    cache.Insert(line, columns, 0, makeEntry(line, 0));
+                }
+            }
+        }
+
+        // Each line is shaped exactly once.
+        const auto& stats = cache.GetStats();
+        VERIFY_ARE_EQUAL(static_cast<size_t>(lineCount), stats.misses);
+        VERIFY_ARE_EQUAL(static_cast<size_t>((lineCount - viewportHeight + 1) * viewportHeight - lineCount), stats.hits);
+    }
+};
@@ -21,6 +21,9 @@ class Cursor;
 
 namespace Microsoft::Console::Render
 {
+    // A pattern match in viewport coordinates. The stop is exclusive and the value is the pattern's ID.
+    using PatternInterval = interval_tree::Interval<til::point, size_t>;
+
     struct RenderOverlay final
     {
         // This is where the data is stored
@@ -63,7 +66,9 @@ namespace Microsoft::Console::Render
         virtual const std::wstring_view GetConsoleTitle() const noexcept = 0;
         virtual const std::wstring GetHyperlinkUri(uint16_t id) const = 0;
         virtual const std::wstring GetHyperlinkCustomId(uint16_t id) const = 0;
-        virtual const std::vector<size_t> GetPatternId(const til::point location) const = 0;
+        // Appends the patterns overlapping the cells [begin.x, endX) of row begin.y (in viewport coordinates) to
+        // patterns. The renderer calls this once per line and reuses the vector, so this shouldn't allocate.
+        virtual void GetPatternsInRow(const til::point begin, const til::CoordType endX, std::vector<PatternInterval>& patterns) const = 0;
 
         // This block used to be IUiaData.
         virtual std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept = 0;
@@ -87,6 +87,10 @@ namespace Microsoft::Console::Render
         [[nodiscard]] virtual HRESULT IsGlyphWideByFont(std::wstring_view glyph, _Out_ bool* pResult) noexcept = 0;
         [[nodiscard]] virtual HRESULT UpdateTitle(std::wstring_view newTitle) noexcept = 0;
 
+        // The renderer releases the console lock once it captured a frame and paints it without holding it.
+        // Engines that call back into IRenderData while painting must return true here.
+        [[nodiscard]] virtual bool RequiresRenderDataWhilePainting() const noexcept { return false; }
+
         // The following functions used to be specific to the DxRenderer and they should
         // be abstracted away and integrated into the above or simply get removed.
 
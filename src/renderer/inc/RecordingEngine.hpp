@@ -0,0 +1,176 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- RecordingEngine.hpp
+
+Abstract:
+- A render engine that doesn't draw anything. It counts every call the Renderer makes
+  and optionally records them, which allows us to measure the overhead of
+  Renderer::PaintFrame without a window, a GPU, GDI or a pipe (see src/tools/renderbench).
+- Records are appended to arenas that are allocated upfront. Once they're full, further
+  records are dropped (and counted as such), so that recording never allocates while painting.
+- In the Count mode nothing but the number of calls is tracked.
+--*/
+
+#pragma once
+
+#include "RenderEngineBase.hpp"
+
+namespace Microsoft::Console::Render
+{
+    class RecordingEngine final : public RenderEngineBase
+    {
+    public:
+        enum class Mode
+        {
+            Count,
+            Record
+        };
+
+        enum class Call : uint8_t
+        {
+            StartPaint,
+            EndPaint,
+            RequiresContinuousRedraw,
+            WaitUntilCanRender,
+            Present,
+            PrepareForTeardown,
+            ScrollFrame,
+            Invalidate,
+            InvalidateCursor,
+            InvalidateSystem,
+            InvalidateSelection,
+            InvalidateScroll,
+            InvalidateAll,
+            InvalidateFlush,
+            InvalidateTitle,
+            NotifyNewText,
+            PrepareRenderInfo,
+            ResetLineTransform,
+            PrepareLineTransform,
+            PaintBackground,
+            PaintBufferLine,
+            PaintBufferGridLines,
+            PaintSelection,
+            PaintCursor,
+            UpdateDrawingBrushes,
+            UpdateFont,
+            UpdateSoftFont,
+            UpdateDpi,
+            UpdateViewport,
+            GetProposedFont,
+            GetDirtyArea,
+            GetFontSize,
+            IsGlyphWideByFont,
+            UpdateTitle,
+            Count
+        };
+        static constexpr size_t CallCount = static_cast<size_t>(Call::Count);
+
+        // Flags stored in Record::flags. Their meaning depends on the call.
+        static constexpr uint8_t FlagTrimLeft = 0x01; // PaintBufferLine
+        static constexpr uint8_t FlagLineWrapped = 0x02; // PaintBufferLine
+        static constexpr uint8_t FlagUsingSoftFont = 0x01; // UpdateDrawingBrushes
+        static constexpr uint8_t FlagDefaultBrushes = 0x02; // UpdateDrawingBrushes
+        static constexpr uint8_t FlagCursorOn = 0x01; // PaintCursor
+        static constexpr uint8_t FlagCursorDoubleWidth = 0x02; // PaintCursor
+
+        struct Record
+        {
+            Call call;
+            uint8_t flags;
+            // PaintBufferGridLines: the GridLineSet. PaintCursor: the CursorType.
+            // PrepareLineTransform: the LineRendition.
+            uint16_t detail;
+            // PaintBufferGridLines: the color. PaintCursor: the color, if the cursor has one.
+            // InvalidateSelection: the number of rectangles.
+            uint32_t value;
+            // The cells that are painted or invalidated. For InvalidateScroll
+            // and ScrollFrame the left and top are the scroll delta instead.
+            til::rect rect;
+            // PaintBufferLine: the text of the clusters, see GetText().
+            uint32_t textOffset;
+            uint32_t textLength;
+        };
+
+        static constexpr size_t DefaultRecordCapacity = 64 * 1024;
+        static constexpr size_t DefaultTextCapacity = 1024 * 1024;
+
+        RecordingEngine(Mode mode = Mode::Count,
+                        size_t recordCapacity = DefaultRecordCapacity,
+                        size_t textCapacity = DefaultTextCapacity);
+
+        // IRenderEngine Members
+        [[nodiscard]] HRESULT StartPaint() noexcept override;
+        [[nodiscard]] HRESULT EndPaint() noexcept override;
+        [[nodiscard]] bool RequiresContinuousRedraw() noexcept override;
+        void WaitUntilCanRender() noexcept override;
+        [[nodiscard]] HRESULT Present() noexcept override;
+        [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept override;
+        [[nodiscard]] HRESULT ScrollFrame() noexcept override;
+        [[nodiscard]] HRESULT Invalidate(const til::rect* const psrRegion) noexcept override;
+        [[nodiscard]] HRESULT InvalidateCursor(const til::rect* const psrRegion) noexcept override;
+        [[nodiscard]] HRESULT InvalidateSystem(const til::rect* const prcDirtyClient) noexcept override;
+        [[nodiscard]] HRESULT InvalidateSelection(const std::vector<til::rect>& rectangles) noexcept override;
+        [[nodiscard]] HRESULT InvalidateScroll(const til::point* const pcoordDelta) noexcept override;
+        [[nodiscard]] HRESULT InvalidateAll() noexcept override;
+        [[nodiscard]] HRESULT InvalidateFlush(_In_ const bool circled, _Out_ bool* const pForcePaint) noexcept override;
+        [[nodiscard]] HRESULT InvalidateTitle(const std::wstring_view proposedTitle) noexcept override;
+        [[nodiscard]] HRESULT NotifyNewText(const std::wstring_view newText) noexcept override;
+        [[nodiscard]] HRESULT PrepareRenderInfo(const RenderFrameInfo& info) noexcept override;
+        [[nodiscard]] HRESULT ResetLineTransform() noexcept override;
+        [[nodiscard]] HRESULT PrepareLineTransform(const LineRendition lineRendition, const til::CoordType targetRow, const til::CoordType viewportLeft) noexcept override;
+        [[nodiscard]] HRESULT PaintBackground() noexcept override;
+        [[nodiscard]] HRESULT PaintBufferLine(const std::span<const Cluster> clusters, const til::point coord, const bool fTrimLeft, const bool lineWrapped) noexcept override;
+        [[nodiscard]] HRESULT PaintBufferGridLines(const GridLineSet lines, const COLORREF color, const size_t cchLine, const til::point coordTarget) noexcept override;
+        [[nodiscard]] HRESULT PaintSelection(const til::rect& rect) noexcept override;
+        [[nodiscard]] HRESULT PaintCursor(const CursorOptions& options) noexcept override;
+        [[nodiscard]] HRESULT UpdateDrawingBrushes(const TextAttribute& textAttributes, const RenderSettings& renderSettings, const gsl::not_null<IRenderData*> pData, const bool usingSoftFont, const bool isSettingDefaultBrushes) noexcept override;
+        [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& FontInfoDesired, _Out_ FontInfo& FontInfo) noexcept override;
+        [[nodiscard]] HRESULT UpdateSoftFont(const std::span<const uint16_t> bitPattern, const til::size cellSize, const size_t centeringHint) noexcept override;
+        [[nodiscard]] HRESULT UpdateDpi(const int iDpi) noexcept override;
+        [[nodiscard]] HRESULT UpdateViewport(const til::inclusive_rect& srNewViewport) noexcept override;
+        [[nodiscard]] HRESULT GetProposedFont(const FontInfoDesired& FontInfoDesired, _Out_ FontInfo& FontInfo, const int iDpi) noexcept override;
+        [[nodiscard]] HRESULT GetDirtyArea(std::span<const til::rect>& area) noexcept override;
+        [[nodiscard]] HRESULT GetFontSize(_Out_ til::size* const pFontSize) noexcept override;
+        [[nodiscard]] HRESULT IsGlyphWideByFont(const std::wstring_view glyph, _Out_ bool* const pResult) noexcept override;
+        [[nodiscard]] HRESULT UpdateTitle(const std::wstring_view newTitle) noexcept override;
+
+        static std::string_view GetCallName(const Call call) noexcept;
+
+        Mode GetMode() const noexcept;
+        uint64_t GetCallCount(const Call call) const noexcept;
+        uint64_t GetTotalCallCount() const noexcept;
+        // The number of frames that were painted, i.e. StartPaint() calls that didn't return S_FALSE.
+        uint64_t GetFrameCount() const noexcept;
+
+        std::span<const Record> GetRecords() const noexcept;
+        std::wstring_view GetText(const Record& record) const noexcept;
+        // The number of records that didn't fit into the arena.
+        uint64_t GetDroppedRecordCount() const noexcept;
+
+        // Forgets all counts and records, but keeps the arenas and the invalidated area.
+        void Reset() noexcept;
+
+    protected:
+        [[nodiscard]] HRESULT _DoUpdateTitle(const std::wstring_view newTitle) noexcept override;
+
+    private:
+        Record* _count(const Call call) noexcept;
+        void _appendText(Record& record, const std::span<const Cluster> clusters) noexcept;
+
+        Mode _mode;
+        std::array<uint64_t, CallCount> _counts{};
+        uint64_t _frames = 0;
+
+        // Both are reserved in the constructor and never grow beyond that.
+        std::vector<Record> _records;
+        std::vector<wchar_t> _text;
+        uint64_t _droppedRecords = 0;
+
+        til::bitmap _invalidMap;
+        til::point _scrollDelta;
+    };
+}
@@ -42,6 +42,7 @@ namespace Microsoft::Console::Render
         size_t GetColorAliasIndex(const ColorAlias alias) const noexcept;
         std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept;
         std::pair<COLORREF, COLORREF> GetAttributeColorsWithAlpha(const TextAttribute& attr) const noexcept;
+        void MarkBlinkInUse() const noexcept;
         void ToggleBlinkRendition(class Renderer& renderer) noexcept;
 
     private:
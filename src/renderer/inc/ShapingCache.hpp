@@ -0,0 +1,211 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ShapingCache.hpp
+
+Abstract:
+- Caches the result of segmenting and shaping a line of text, so that renderers
+  don't need to run font fallback and text analysis again when the same line is
+  painted again, for instance when it was just scrolled to a different row.
+- Lines are keyed by their text, the column each character starts at and an
+  opaque state value (bold/italic, etc.). The font itself isn't part of the key:
+  renderers must call Clear() whenever they change fonts.
+- Entries are evicted in least-recently-used order once the byte budget is exceeded.
+- The FontFace type is opaque to the cache, which allows testing it without DirectWrite.
+--*/
+
+#pragma once
+
+#include <til/hash.h>
+#include <til/lru_hash_map.h>
+
+namespace Microsoft::Console::Render
+{
+    template<typename FontFace>
+    class ShapingCache
+    {
+    public:
+        static constexpr size_t DefaultBudget = 4 * 1024 * 1024;
+
+        // A cluster of text as [beg,end) offsets into the line and the index of its font face in Entry::faces.
+        struct Segment
+        {
+            uint32_t face;
+            uint32_t beg;
+            uint32_t end;
+        };
+
+        struct Entry
+        {
+            void Append(const FontFace& face, const size_t beg, const size_t end)
+            {
+                uint32_t index = 0;
+                const auto count = faces.size();
+                // Consecutive clusters almost always share their font face.
+                if (count && faces.back() == face)
+                {
+                    index = gsl::narrow_cast<uint32_t>(count - 1);
+                }
+                else
+                {
+                    for (; index < count && !(faces[index] == face); ++index)
+                    {
+                    }
+                    if (index == count)
+                    {
+                        faces.emplace_back(face);
+                    }
+                }
+                segments.emplace_back(Segment{ index, gsl::narrow<uint32_t>(beg), gsl::narrow<uint32_t>(end) });
+            }
+
+            void Clear() noexcept
+            {
+                faces.clear();
+                segments.clear();
+            }
+
+            std::vector<FontFace> faces;
+            std::vector<Segment> segments;
+        };
+
+        struct Stats
+        {
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t evictions = 0;
+        };
+
+        explicit ShapingCache(const size_t budget = DefaultBudget) noexcept :
+            _budget{ budget }
+        {
+        }
+
+        // Returns the cached entry for the given line or nullptr if there's none.
+        // columns must contain the starting column of each character in text.
+        const Entry* Lookup(const std::wstring_view text, const std::span<const uint16_t> columns, const uint32_t state)
+        {
+            _buildKey(_key, text, columns, state);
+
+            const auto it = _map.find(_key);
+            if (it == _map.end())
+            {
+                _stats.misses++;
+                return nullptr;
+            }
+
+            _stats.hits++;
+            return &it->second.entry;
+        }
+
+        // Stores a copy of the entry for the given line, which must not be cached yet (i.e. Lookup() returned nullptr).
+        void Insert(const std::wstring_view text, const std::span<const uint16_t> columns, const uint32_t state, const Entry& entry)
+        {
+            _buildKey(_key, text, columns, state);
+
+            const auto bytes = _entryBytes(_key, entry);
+            if (bytes > _budget)
+            {
+                return;
+            }
+
+            _evict(_budget - bytes);
+            _map.insert(_key, Value{ entry, bytes });
+            _bytes += bytes;
+        }
+
+        void Clear() noexcept
+        {
+            _map.clear();
+            _bytes = 0;
+        }
+
+        void SetBudget(const size_t budget) noexcept
+        {
+            _budget = budget;
+            _evict(budget);
+        }
+
+        size_t GetBudget() const noexcept
+        {
+            return _budget;
+        }
+
+        // The approximate amount of memory used by all entries.
+        size_t GetBytes() const noexcept
+        {
+            return _bytes;
+        }
+
+        size_t GetEntryCount() const noexcept
+        {
+            return _map.size();
+        }
+
+        const Stats& GetStats() const noexcept
+        {
+            return _stats;
+        }
+
+        void ResetStats() noexcept
+        {
+            _stats = {};
+        }
+
+    private:
+        struct Value
+        {
+            Entry entry;
+            size_t bytes;
+        };
+
+        struct KeyHasher
+        {
+            size_t operator()(const std::wstring& key) const noexcept
+            {
+                return til::hash(key.data(), key.size() * sizeof(wchar_t));
+            }
+        };
+
+        // The key is a single string consisting of the state, the text and the columns.
+        // This makes hashing and comparing it as cheap as it gets.
+        static void _buildKey(std::wstring& key, const std::wstring_view text, const std::span<const uint16_t> columns, const uint32_t state)
+        {
+            static_assert(sizeof(wchar_t) == sizeof(uint16_t));
+
+            key.clear();
+            key.reserve(2 + text.size() + columns.size());
+            key.push_back(static_cast<wchar_t>(state & 0xffff));
+            key.push_back(static_cast<wchar_t>(state >> 16));
+            key.append(text);
+            for (const auto c : columns)
+            {
+                key.push_back(static_cast<wchar_t>(c));
+            }
+        }
+
+        static size_t _entryBytes(const std::wstring& key, const Entry& entry) noexcept
+        {
+            // The constant accounts for the hash map node and the allocator overhead of the 3 allocations.
+            return 128 + key.size() * sizeof(wchar_t) + entry.faces.size() * sizeof(FontFace) + entry.segments.size() * sizeof(Segment);
+        }
+
+        void _evict(const size_t target) noexcept
+        {
+            while (_bytes > target && !_map.empty())
+            {
+                _bytes -= _map.oldest()->second.bytes;
+                _map.pop_oldest();
+                _stats.evictions++;
+            }
+        }
+
+        til::lru_hash_map<std::wstring, Value, KeyHasher> _map;
+        std::wstring _key;
+        size_t _budget;
+        size_t _bytes = 0;
+        Stats _stats;
+    };
+}
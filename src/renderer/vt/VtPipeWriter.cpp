@@ -0,0 +1,178 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "VtPipeWriter.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+
+// Routine Description:
+// - Takes ownership of the pipe and starts the writer thread.
+// - NOTE: Will throw if the thread can't be created. Caller must catch.
+// Arguments:
+// - pipe - The pipe to write the output into.
+// - highWaterMark - The number of queued bytes after which Write() blocks.
+VtPipeWriter::VtPipeWriter(wil::unique_hfile pipe, const size_t highWaterMark) :
+    _pipe{ std::move(pipe) },
+    _highWaterMark{ highWaterMark }
+{
+    _thread.reset(CreateThread(nullptr, 0, s_WriterThread, this, 0, nullptr));
+    THROW_LAST_ERROR_IF(!_thread);
+}
+
+// Routine Description:
+// - Stops the writer thread. Output that wasn't written yet is discarded,
+//   which is why callers that care about it must call Drain() first.
+VtPipeWriter::~VtPipeWriter()
+{
+    {
+        const std::lock_guard lock{ _mutex };
+        _shutdown = true;
+    }
+    _pending.notify_one();
+
+    // The writer thread may be stuck in WriteFile() if nobody is reading from the pipe.
+    // Loop around CancelSynchronousIo() in case we called it while it wasn't blocked yet.
+    for (;;)
+    {
+        CancelSynchronousIo(_thread.get());
+        if (WaitForSingleObject(_thread.get(), 1000) == WAIT_OBJECT_0)
+        {
+            break;
+        }
+    }
+}
+
+// Routine Description:
+// - Hands the contents of the buffer to the writer thread and returns without waiting
+//   for them to be written, unless the high-water mark was exceeded.
+// - The buffer is left empty, but may have its capacity swapped with one of our own.
+// Arguments:
+// - buffer - The output to write.
+// Return Value:
+// - S_OK, or the error with which a previous write into the pipe failed.
+[[nodiscard]] HRESULT VtPipeWriter::Write(std::string& buffer) noexcept
+try
+{
+    std::unique_lock lock{ _mutex };
+
+    if (_queued.size() >= _highWaterMark && SUCCEEDED(_error))
+    {
+        const auto start = std::chrono::steady_clock::now();
+        _written.wait(lock, [&]() noexcept { return _queued.size() < _highWaterMark || FAILED(_error); });
+        _stats.stalls++;
+        _stats.stallTime += std::chrono::steady_clock::now() - start;
+    }
+
+    if (FAILED(_error))
+    {
+        buffer.clear();
+        return _error;
+    }
+
+    if (_queued.empty())
+    {
+        _queued.swap(buffer);
+    }
+    else
+    {
+        _queued.append(buffer);
+    }
+    buffer.clear();
+
+    _stats.bytesQueued = _queued.size() + _inFlight;
+    _stats.peakBytesQueued = std::max(_stats.peakBytesQueued, _stats.bytesQueued);
+
+    lock.unlock();
+    _pending.notify_one();
+    return S_OK;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Blocks until all output handed to Write() was written into the pipe.
+// Return Value:
+// - S_OK, or the error with which writing into the pipe failed.
+[[nodiscard]] HRESULT VtPipeWriter::Drain() noexcept
+try
+{
+    std::unique_lock lock{ _mutex };
+    _written.wait(lock, [&]() noexcept { return (_queued.empty() && !_inFlight) || FAILED(_error); });
+    return _error;
+}
+CATCH_RETURN()
+
+void VtPipeWriter::SetHighWaterMark(const size_t highWaterMark) noexcept
+{
+    {
+        const std::lock_guard lock{ _mutex };
+        _highWaterMark = highWaterMark;
+    }
+    // A raised high-water mark may unblock a waiting Write().
+    _written.notify_all();
+}
+
+VtPipeWriter::Stats VtPipeWriter::GetStats() const noexcept
+{
+    const std::lock_guard lock{ _mutex };
+    return _stats;
+}
+
+DWORD WINAPI VtPipeWriter::s_WriterThread(LPVOID parameter) noexcept
+{
+    static_cast<VtPipeWriter*>(parameter)->_WriterThread();
+    return 0;
+}
+
+void VtPipeWriter::_WriterThread() noexcept
+{
+    std::unique_lock lock{ _mutex };
+
+    for (;;)
+    {
+        _pending.wait(lock, [&]() noexcept { return !_queued.empty() || _shutdown; });
+        if (_shutdown)
+        {
+            break;
+        }
+
+        // Swap the buffers, so that Write() can continue to append to the (now empty) queue while we write.
+        _writing.swap(_queued);
+        _inFlight = _writing.size();
+        lock.unlock();
+
+        auto hr = S_OK;
+        std::string_view remaining{ _writing };
+        while (!remaining.empty())
+        {
+            DWORD written = 0;
+            const auto chunk = gsl::narrow_cast<DWORD>(std::min<size_t>(remaining.size(), MAXDWORD));
+            if (!WriteFile(_pipe.get(), remaining.data(), chunk, &written, nullptr))
+            {
+                hr = HRESULT_FROM_WIN32(GetLastError());
+                break;
+            }
+            remaining = remaining.substr(written);
+        }
+
+        lock.lock();
+        _stats.bytesWritten += _writing.size() - remaining.size();
+        _inFlight = 0;
+        _stats.bytesQueued = _queued.size();
+        _writing.clear();
+
+        if (FAILED(hr))
+        {
+            // There's no point in writing anything else. Write() and Drain() return the error from now on.
+            _error = hr;
+            _queued.clear();
+            _stats.bytesQueued = 0;
+            _written.notify_all();
+            break;
+        }
+
+        _written.notify_all();
+    }
+}
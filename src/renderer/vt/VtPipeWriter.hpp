@@ -0,0 +1,79 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- VtPipeWriter.hpp
+
+Abstract:
+- Writes the output of the VtEngine into its pipe on a dedicated thread, so that
+  the render thread (and with it the console lock) doesn't block on pipe I/O when
+  the terminal on the other end is slow to read.
+- The output is double buffered: while the writer thread is busy writing one buffer,
+  the next frames are appended to another one. Buffers are swapped and not copied,
+  which means that once they've grown large enough, queueing output doesn't allocate.
+- Once more than the high-water mark of bytes is queued, Write() blocks until the
+  writer thread has caught up. This applies backpressure to the producer and bounds
+  the memory usage. The time spent waiting is reported in the stats.
+--*/
+
+#pragma once
+
+#include <condition_variable>
+
+namespace Microsoft::Console::Render
+{
+    class VtPipeWriter
+    {
+    public:
+        static constexpr size_t DefaultHighWaterMark = 4 * 1024 * 1024;
+
+        struct Stats
+        {
+            // The number of bytes written into the pipe so far.
+            uint64_t bytesWritten = 0;
+            // The number of bytes that were handed to Write() but haven't been written yet.
+            uint64_t bytesQueued = 0;
+            uint64_t peakBytesQueued = 0;
+            // How often and how long Write() waited, because the high-water mark was exceeded.
+            uint64_t stalls = 0;
+            std::chrono::nanoseconds stallTime{};
+        };
+
+        VtPipeWriter(wil::unique_hfile pipe, size_t highWaterMark = DefaultHighWaterMark);
+        ~VtPipeWriter();
+
+        VtPipeWriter(const VtPipeWriter&) = delete;
+        VtPipeWriter& operator=(const VtPipeWriter&) = delete;
+
+        [[nodiscard]] HRESULT Write(std::string& buffer) noexcept;
+        [[nodiscard]] HRESULT Drain() noexcept;
+
+        void SetHighWaterMark(size_t highWaterMark) noexcept;
+        Stats GetStats() const noexcept;
+
+    private:
+        static DWORD WINAPI s_WriterThread(LPVOID parameter) noexcept;
+        void _WriterThread() noexcept;
+
+        wil::unique_hfile _pipe;
+        wil::unique_handle _thread;
+
+        mutable std::mutex _mutex;
+        // Signaled by Write() when _queued isn't empty anymore and by the destructor.
+        std::condition_variable _pending;
+        // Signaled by the writer thread whenever it finished writing a buffer.
+        std::condition_variable _written;
+
+        // Protected by _mutex.
+        std::string _queued;
+        size_t _inFlight = 0;
+        size_t _highWaterMark;
+        HRESULT _error = S_OK;
+        bool _shutdown = false;
+        Stats _stats;
+
+        // Only accessed by the writer thread.
+        std::string _writing;
+    };
+}
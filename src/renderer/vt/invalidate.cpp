@@ -135,6 +135,24 @@ CATCH_RETURN();
 // - S_OK
 [[nodiscard]] HRESULT VtEngine::PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept
 {
+    // The process may exit right after the final frame, so it needs to be written synchronously,
+    // as well as any output that's still queued, in case the final frame turns out to be empty.
+    _tearingDown = true;
+    if (_pipeWriter)
+    {
+        LOG_IF_FAILED(_pipeWriter->Drain());
+    }
     *pForcePaint = true;
     return S_OK;
 }
+
+// Method Description:
+// - The VT renderer resolves hyperlinks through IRenderData while painting and
+//   its output must not interleave with the output thread's passthrough, so
+//   it keeps holding the console lock until the frame has been written.
+// Return Value:
+// - true
+[[nodiscard]] bool VtEngine::RequiresRenderDataWhilePainting() const noexcept
+{
+    return true;
+}
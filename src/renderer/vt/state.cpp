@@ -28,7 +28,7 @@ constexpr til::point VtEngine::INVALID_COORDS = { -1, -1 };
 VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
                    const Viewport initialViewport) :
     RenderEngineBase(),
-    _hFile(std::move(pipe)),
+    _pipeWriter(pipe ? std::make_unique<VtPipeWriter>(std::move(pipe)) : nullptr),
     _usingLineRenditions(false),
     _stopUsingLineRenditions(false),
     _usingSoftFont(false),
@@ -60,7 +60,7 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
 {
 #ifndef UNIT_TESTING
     // When unit testing, we can instantiate a VtEngine without a pipe.
-    THROW_HR_IF(E_HANDLE, !_hFile);
+    THROW_HR_IF(E_HANDLE, !_pipeWriter);
 #else
     // member is only defined when UNIT_TESTING is.
     _usingTestCallback = false;
@@ -136,16 +136,26 @@ CATCH_RETURN();
     CATCH_RETURN();
 }
 
+// Method Description:
+// - Hands the buffered output to the pipe writer, which writes it into the pipe
+//   on its own thread. This only blocks if the terminal is so far behind that
+//   the pipe writer's high-water mark was exceeded, or during teardown, where
+//   the final frame must be written before the process exits.
+// Return Value:
+// - S_OK, or the error with which writing into the pipe failed.
 [[nodiscard]] HRESULT VtEngine::_Flush() noexcept
 {
-    if (_hFile)
+    if (_pipeWriter)
     {
-        auto fSuccess = !!WriteFile(_hFile.get(), _buffer.data(), gsl::narrow_cast<DWORD>(_buffer.size()), nullptr, nullptr);
-        _buffer.clear();
-        if (!fSuccess)
+        auto hr = _pipeWriter->Write(_buffer);
+        if (SUCCEEDED(hr) && _tearingDown)
         {
-            _exitResult = HRESULT_FROM_WIN32(GetLastError());
-            _hFile.reset();
+            hr = _pipeWriter->Drain();
+        }
+        if (FAILED(hr))
+        {
+            _exitResult = hr;
+            _pipeWriter.reset();
             if (_terminalOwner)
             {
                 _terminalOwner->CloseOutput();
@@ -553,3 +563,28 @@ HRESULT VtEngine::SwitchScreenBuffer(const bool useAltBuffer) noexcept
     RETURN_IF_FAILED(_Flush());
     return S_OK;
 }
+
+// Method Description:
+// - Sets the number of bytes that may be queued for the pipe, before flushing
+//   the output blocks until the terminal has caught up reading it.
+// Arguments:
+// - highWaterMark - The new limit in bytes.
+// Return Value:
+// - <none>
+void VtEngine::SetOutputHighWaterMark(const size_t highWaterMark) noexcept
+{
+    if (_pipeWriter)
+    {
+        _pipeWriter->SetHighWaterMark(highWaterMark);
+    }
+}
+
+// Method Description:
+// - Returns the number of bytes written and queued for the pipe, as well as how
+//   often and how long flushing the output was stalled by a slow terminal.
+// Return Value:
+// - The pipe writer's stats, or all zeros if there's no pipe.
+VtPipeWriter::Stats VtEngine::GetOutputStats() const noexcept
+{
+    return _pipeWriter ? _pipeWriter->GetStats() : VtPipeWriter::Stats{};
+}
@@ -18,6 +18,7 @@ Author(s):
 #include "../inc/RenderEngineBase.hpp"
 #include "../../types/inc/Viewport.hpp"
 #include "tracing.hpp"
+#include "VtPipeWriter.hpp"
 #include <string>
 #include <functional>
 
@@ -52,6 +53,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT EndPaint() noexcept override;
         [[nodiscard]] HRESULT Present() noexcept override;
         [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* pForcePaint) noexcept override;
+        [[nodiscard]] bool RequiresRenderDataWhilePainting() const noexcept override;
         [[nodiscard]] HRESULT Invalidate(const til::rect* psrRegion) noexcept override;
         [[nodiscard]] HRESULT InvalidateCursor(const til::rect* psrRegion) noexcept override;
         [[nodiscard]] HRESULT InvalidateSystem(const til::rect* prcDirtyClient) noexcept override;
@@ -90,9 +92,11 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT RequestWin32Input() noexcept;
         [[nodiscard]] virtual HRESULT SetWindowVisibility(const bool showOrHide) noexcept = 0;
         [[nodiscard]] HRESULT SwitchScreenBuffer(const bool useAltBuffer) noexcept;
+        void SetOutputHighWaterMark(const size_t highWaterMark) noexcept;
+        VtPipeWriter::Stats GetOutputStats() const noexcept;
 
     protected:
-        wil::unique_hfile _hFile;
+        std::unique_ptr<VtPipeWriter> _pipeWriter;
         std::string _buffer;
 
         std::string _formatBuffer;
@@ -132,6 +136,7 @@ namespace Microsoft::Console::Render
 
         Microsoft::Console::VirtualTerminal::RenderTracing _trace;
         bool _inResizeRequest{ false };
+        bool _tearingDown{ false };
 
         std::optional<til::CoordType> _wrappedRow{ std::nullopt };
 
@@ -177,21 +177,37 @@ bool FontBuffer::SetStartChar(const VTParameter startChar,
 
 void FontBuffer::AddSixelData(const wchar_t ch)
 {
-    if (!_charsetIdInitialized)
-    {
-        _buildCharsetId(ch);
-    }
-    else if (ch >= L'?' && ch <= L'~')
-    {
-        _addSixelValue(ch - L'?');
-    }
-    else if (ch == L'/')
+    AddSixelData({ &ch, 1 });
+}
+
+void FontBuffer::AddSixelData(const std::wstring_view data)
+{
+    auto it = data.begin();
+    const auto end = data.end();
+
+    // The charset ID comes first, and is typically just a single character.
+    for (; it != end && !_charsetIdInitialized; ++it)
     {
-        _endOfSixelLine();
+        _buildCharsetId(*it);
     }
-    else if (ch == L';')
+
+    // Everything after that is sixel data, which makes up the bulk of the
+    // string, so we don't want to be rechecking the ID state for every value.
+    for (; it != end; ++it)
     {
-        _endOfCharacter();
+        const auto ch = *it;
+        if (ch >= L'?' && ch <= L'~')
+        {
+            _addSixelValue(ch - L'?');
+        }
+        else if (ch == L'/')
+        {
+            _endOfSixelLine();
+        }
+        else if (ch == L';')
+        {
+            _endOfCharacter();
+        }
     }
 }
 
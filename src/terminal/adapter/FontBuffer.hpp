@@ -28,6 +28,7 @@ namespace Microsoft::Console::VirtualTerminal
         bool SetStartChar(const VTParameter startChar,
                           const DispatchTypes::DrcsCharsetSize charsetSize) noexcept;
         void AddSixelData(const wchar_t ch);
+        void AddSixelData(const std::wstring_view data);
         bool FinalizeSixelData();
 
         std::span<const uint16_t> GetBitPattern() const noexcept;
@@ -24,6 +24,8 @@ class Microsoft::Console::VirtualTerminal::ITermDispatch
 {
 public:
     using StringHandler = std::function<bool(const wchar_t)>;
+    // Used for data strings that can get large. See IStateMachineEngine::StringHandler.
+    using StringChunkHandler = std::function<bool(const std::wstring_view)>;
 
 #pragma warning(push)
 #pragma warning(disable : 26432) // suppress rule of 5 violation on interface because tampering with this is fraught with peril
@@ -31,6 +33,10 @@ public:
 
     virtual void Print(const wchar_t wchPrintable) = 0;
     virtual void PrintString(const std::wstring_view string) = 0;
+    // Line feeds may defer notifying the host and the renderer about scrolling.
+    // This is called at the end of each string and before any sequence that
+    // needs to see the result, so that the pending scroll can be performed.
+    virtual void FlushPendingScroll() = 0;
 
     virtual bool CursorUp(const VTInt distance) = 0; // CUU
     virtual bool CursorDown(const VTInt distance) = 0; // CUD
@@ -132,18 +138,18 @@ public:
 
     virtual bool DoFinalTermAction(const std::wstring_view string) = 0;
 
-    virtual StringHandler DownloadDRCS(const VTInt fontNumber,
-                                       const VTParameter startChar,
-                                       const DispatchTypes::DrcsEraseControl eraseControl,
-                                       const DispatchTypes::DrcsCellMatrix cellMatrix,
-                                       const DispatchTypes::DrcsFontSet fontSet,
-                                       const DispatchTypes::DrcsFontUsage fontUsage,
-                                       const VTParameter cellHeight,
-                                       const DispatchTypes::DrcsCharsetSize charsetSize) = 0; // DECDLD
-
-    virtual StringHandler DefineMacro(const VTInt macroId,
-                                      const DispatchTypes::MacroDeleteControl deleteControl,
-                                      const DispatchTypes::MacroEncoding encoding) = 0; // DECDMAC
+    virtual StringChunkHandler DownloadDRCS(const VTInt fontNumber,
+                                            const VTParameter startChar,
+                                            const DispatchTypes::DrcsEraseControl eraseControl,
+                                            const DispatchTypes::DrcsCellMatrix cellMatrix,
+                                            const DispatchTypes::DrcsFontSet fontSet,
+                                            const DispatchTypes::DrcsFontUsage fontUsage,
+                                            const VTParameter cellHeight,
+                                            const DispatchTypes::DrcsCharsetSize charsetSize) = 0; // DECDLD
+
+    virtual StringChunkHandler DefineMacro(const VTInt macroId,
+                                           const DispatchTypes::MacroDeleteControl deleteControl,
+                                           const DispatchTypes::MacroEncoding encoding) = 0; // DECDMAC
     virtual bool InvokeMacro(const VTInt macroId) = 0; // DECINVM
 
     virtual StringHandler RestoreTerminalState(const DispatchTypes::ReportFormat format) = 0; // DECRSTS
@@ -201,6 +201,32 @@ bool MacroBuffer::ParseDefinition(const wchar_t ch)
     return success;
 }
 
+bool MacroBuffer::ParseDefinition(const std::wstring_view data)
+{
+    auto it = data.begin();
+    const auto end = data.end();
+    while (it != end)
+    {
+        // Text encoded macros don't need any decoding, so we can append
+        // everything up to the next control character in one go.
+        if (_parseState == State::ExpectingText && *it >= L' ')
+        {
+            const auto textEnd = std::find_if(it, end, [](const auto ch) { return ch < L' '; });
+            if (!_appendToActiveMacro({ it, textEnd }))
+            {
+                _deleteMacro(_activeMacro());
+                return false;
+            }
+            it = textEnd;
+        }
+        else if (!ParseDefinition(*it++))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool MacroBuffer::_decodeHexDigit(const wchar_t ch) noexcept
 {
     _decodedChar <<= 4;
@@ -233,6 +259,17 @@ bool MacroBuffer::_appendToActiveMacro(const wchar_t ch)
     return false;
 }
 
+bool MacroBuffer::_appendToActiveMacro(const std::wstring_view text)
+{
+    if (GetSpaceAvailable() >= text.length())
+    {
+        _activeMacro().append(text);
+        _spaceUsed += text.length();
+        return true;
+    }
+    return false;
+}
+
 std::wstring& MacroBuffer::_activeMacro()
 {
     return _macros.at(_activeMacroId);
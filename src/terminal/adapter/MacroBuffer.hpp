@@ -45,10 +45,12 @@ namespace Microsoft::Console::VirtualTerminal
         void ClearMacrosIfInUse();
         bool InitParser(const size_t macroId, const DispatchTypes::MacroDeleteControl deleteControl, const DispatchTypes::MacroEncoding encoding);
         bool ParseDefinition(const wchar_t ch);
+        bool ParseDefinition(const std::wstring_view data);
 
     private:
         bool _decodeHexDigit(const wchar_t ch) noexcept;
         bool _appendToActiveMacro(const wchar_t ch);
+        bool _appendToActiveMacro(const std::wstring_view text);
         std::wstring& _activeMacro();
         void _deleteMacro(std::wstring& macro) noexcept;
         bool _applyPendingRepeat();
@@ -2141,6 +2141,21 @@ void AdaptDispatch::_DoLineFeed(TextBuffer& textBuffer, const bool withReturn, c
             textBuffer.GetRowByOffset(newPosition.y).Reset(eraseAttributes);
         }
     }
+    else if (bottomMargin == viewport.bottom - 1 && !_api.IsConsolePty())
+    {
+        // This is the same as the case below, but for the most common case of output
+        // scrolling the entire viewport. Output like that of `cat` consists of long runs
+        // of line feeds, so we only cycle the rows here and leave it to FlushPendingScroll
+        // to notify the host and the renderer about all of them at once. ConPTY needs
+        // to see every single rotation, because the VT renderer paints the rows before
+        // they're recycled.
+        if (_pendingScrollRows == 0)
+        {
+            cursor.SetIsOn(false);
+        }
+        textBuffer.IncrementCircularBufferWithoutFlush(true);
+        _pendingScrollRows++;
+    }
     else
     {
         // If the viewport has reached the end of the buffer, we can't pan down,
@@ -2170,6 +2185,37 @@ void AdaptDispatch::_DoLineFeed(TextBuffer& textBuffer, const bool withReturn, c
     _ApplyCursorMovementFlags(cursor);
 }
 
+// Routine Description:
+// - Notifies the host and the renderer about the rows _DoLineFeed cycled the
+//   buffer by since the last call, with a single rotation and a single scroll.
+//   The state machine engine calls this at the end of each string and before
+//   it dispatches anything that might depend on the buffer's position.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void AdaptDispatch::FlushPendingScroll()
+{
+    if (_pendingScrollRows == 0)
+    {
+        return;
+    }
+
+    const auto delta = std::exchange(_pendingScrollRows, 0);
+    auto& textBuffer = _api.GetTextBuffer();
+
+    textBuffer.TriggerCircling();
+    _api.NotifyBufferRotation(delta);
+    textBuffer.TriggerScroll({ 0, -delta });
+
+    // The text that was written in between the line feeds was invalidated
+    // before the scroll, which moved those invalidations up along with it.
+    // The rows that received it are the ones at the bottom of the viewport.
+    const auto viewport = _api.GetViewport();
+    const auto top = std::max(viewport.top, viewport.bottom - delta - 1);
+    textBuffer.TriggerRedraw(Viewport::FromExclusive({ viewport.left, top, viewport.right, viewport.bottom }));
+}
+
 // Routine Description:
 // - IND/NEL - Performs a line feed, possibly preceded by carriage return.
 //    Moves the cursor down one line, and possibly also to the leftmost column.
@@ -3324,7 +3370,7 @@ bool AdaptDispatch::DoFinalTermAction(const std::wstring_view string)
 // Method Description:
 // - DECDLD - Downloads one or more characters of a dynamically redefinable
 //   character set (DRCS) with a specified pixel pattern. The pixel array is
-//   transmitted in sixel format via the returned StringHandler function.
+//   transmitted in sixel format via the returned StringChunkHandler function.
 // Arguments:
 // - fontNumber - The buffer number into which the font will be loaded.
 // - startChar - The first character in the set that will be replaced.
@@ -3336,14 +3382,14 @@ bool AdaptDispatch::DoFinalTermAction(const std::wstring_view string)
 // - charsetSize - Whether the character set is 94 or 96 characters.
 // Return Value:
 // - a function to receive the pixel data or nullptr if parameters are invalid
-ITermDispatch::StringHandler AdaptDispatch::DownloadDRCS(const VTInt fontNumber,
-                                                         const VTParameter startChar,
-                                                         const DispatchTypes::DrcsEraseControl eraseControl,
-                                                         const DispatchTypes::DrcsCellMatrix cellMatrix,
-                                                         const DispatchTypes::DrcsFontSet fontSet,
-                                                         const DispatchTypes::DrcsFontUsage fontUsage,
-                                                         const VTParameter cellHeight,
-                                                         const DispatchTypes::DrcsCharsetSize charsetSize)
+ITermDispatch::StringChunkHandler AdaptDispatch::DownloadDRCS(const VTInt fontNumber,
+                                                              const VTParameter startChar,
+                                                              const DispatchTypes::DrcsEraseControl eraseControl,
+                                                              const DispatchTypes::DrcsCellMatrix cellMatrix,
+                                                              const DispatchTypes::DrcsFontSet fontSet,
+                                                              const DispatchTypes::DrcsFontUsage fontUsage,
+                                                              const VTParameter cellHeight,
+                                                              const DispatchTypes::DrcsCharsetSize charsetSize)
 {
     // The font buffer is created on demand.
     if (!_fontBuffer)
@@ -3372,18 +3418,18 @@ ITermDispatch::StringHandler AdaptDispatch::DownloadDRCS(const VTInt fontNumber,
     // set translation is correctly handled on the host side.
     const auto conptyPassthrough = _api.IsConsolePty() ? _CreateDrcsPassthroughHandler(charsetSize) : nullptr;
 
-    return [=](const auto ch) {
+    return [=](const std::wstring_view string) {
         if (conptyPassthrough)
         {
-            conptyPassthrough(ch);
+            conptyPassthrough(string);
         }
         // We pass the data string straight through to the font buffer class
         // until we receive an ESC, indicating the end of the string. At that
         // point we can finalize the buffer, and if valid, update the renderer
         // with the constructed bit pattern.
-        if (ch != AsciiChars::ESC)
+        if (string.back() != AsciiChars::ESC)
         {
-            _fontBuffer->AddSixelData(ch);
+            _fontBuffer->AddSixelData(string);
         }
         else if (_fontBuffer->FinalizeSixelData())
         {
@@ -3415,26 +3461,31 @@ ITermDispatch::StringHandler AdaptDispatch::DownloadDRCS(const VTInt fontNumber,
 // - <none>
 // Return value:
 // - a function to receive the data or nullptr if the initial flush fails
-ITermDispatch::StringHandler AdaptDispatch::_CreateDrcsPassthroughHandler(const DispatchTypes::DrcsCharsetSize charsetSize)
+ITermDispatch::StringChunkHandler AdaptDispatch::_CreateDrcsPassthroughHandler(const DispatchTypes::DrcsCharsetSize charsetSize)
 {
     const auto defaultPassthrough = _CreatePassthroughHandler();
     if (defaultPassthrough)
     {
         auto& engine = _api.GetStateMachine().Engine();
-        return [=, &engine, gotId = false](const auto ch) mutable {
+        return [=, &engine, gotId = false](std::wstring_view string) mutable {
             // The character set ID is contained in the first characters of the
             // sequence, so we just ignore that initial content until we receive
             // a "final" character (i.e. in range 30 to 7E). At that point we
             // pass through a hard-coded ID of "@".
             if (!gotId)
             {
-                if (ch >= 0x30 && ch <= 0x7E)
+                const auto idEnd = std::find_if(string.begin(), string.end(), [](const auto ch) {
+                    return ch >= 0x30 && ch <= 0x7E;
+                });
+                if (idEnd == string.end())
                 {
-                    gotId = true;
-                    defaultPassthrough('@');
+                    return true;
                 }
+                gotId = true;
+                defaultPassthrough(L"@");
+                string = { idEnd + 1, string.end() };
             }
-            else if (!defaultPassthrough(ch))
+            if (!string.empty() && !defaultPassthrough(string))
             {
                 // Once the DECDLD sequence is finished, we also output an SCS
                 // sequence to map the character set into the G1 table.
@@ -3456,9 +3507,9 @@ ITermDispatch::StringHandler AdaptDispatch::_CreateDrcsPassthroughHandler(const
 // - encoding - whether the data is encoded as plain text or hex digits.
 // Return Value:
 // - a function to receive the macro data or nullptr if parameters are invalid.
-ITermDispatch::StringHandler AdaptDispatch::DefineMacro(const VTInt macroId,
-                                                        const DispatchTypes::MacroDeleteControl deleteControl,
-                                                        const DispatchTypes::MacroEncoding encoding)
+ITermDispatch::StringChunkHandler AdaptDispatch::DefineMacro(const VTInt macroId,
+                                                             const DispatchTypes::MacroDeleteControl deleteControl,
+                                                             const DispatchTypes::MacroEncoding encoding)
 {
     if (!_macroBuffer)
     {
@@ -3467,8 +3518,8 @@ ITermDispatch::StringHandler AdaptDispatch::DefineMacro(const VTInt macroId,
 
     if (_macroBuffer->InitParser(macroId, deleteControl, encoding))
     {
-        return [&](const auto ch) {
-            return _macroBuffer->ParseDefinition(ch);
+        return [&](const std::wstring_view string) {
+            return _macroBuffer->ParseDefinition(string);
         };
     }
 
@@ -3536,7 +3587,13 @@ ITermDispatch::StringHandler AdaptDispatch::_RestoreColorTable()
     // color report to the connected terminal.
     if (_api.IsConsolePty())
     {
-        return _CreatePassthroughHandler();
+        if (const auto passthrough = _CreatePassthroughHandler())
+        {
+            return [=](const auto ch) {
+                return passthrough({ &ch, 1 });
+            };
+        }
+        return nullptr;
     }
 
     return [this, parameter = VTInt{}, parameters = std::vector<VTParameter>{}](const auto ch) mutable {
@@ -4210,7 +4267,7 @@ bool AdaptDispatch::PlaySounds(const VTParameters parameters)
 // - <none>
 // Return value:
 // - a function to receive the data or nullptr if the initial flush fails
-ITermDispatch::StringHandler AdaptDispatch::_CreatePassthroughHandler()
+ITermDispatch::StringChunkHandler AdaptDispatch::_CreatePassthroughHandler()
 {
     // Before we pass through any more data, we need to flush the current frame
     // first, otherwise it can end up arriving out of sync.
@@ -4220,16 +4277,16 @@ ITermDispatch::StringHandler AdaptDispatch::_CreatePassthroughHandler()
     auto& stateMachine = _api.GetStateMachine();
     if (stateMachine.FlushToTerminal())
     {
-        // And finally we create a StringHandler to receive the rest of the
+        // And finally we create a StringChunkHandler to receive the rest of the
         // sequence data, and pass it through to the connected terminal.
         auto& engine = stateMachine.Engine();
-        return [&, buffer = std::wstring{}](const auto ch) mutable {
+        return [&, buffer = std::wstring{}](const std::wstring_view string) mutable {
             // To make things more efficient, we buffer the string data before
             // passing it through, only flushing if the buffer gets too large,
             // or we're dealing with the last character in the current output
             // fragment, or we've reached the end of the string.
-            const auto endOfString = ch == AsciiChars::ESC;
-            buffer += ch;
+            const auto endOfString = string.back() == AsciiChars::ESC;
+            buffer += string;
             if (buffer.length() >= 4096 || stateMachine.IsProcessingLastCharacter() || endOfString)
             {
                 // The end of the string is signaled with an escape, but for it
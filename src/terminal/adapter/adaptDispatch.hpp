@@ -39,6 +39,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         void Print(const wchar_t wchPrintable) override;
         void PrintString(const std::wstring_view string) override;
+        void FlushPendingScroll() override;
 
         bool CursorUp(const VTInt distance) override; // CUU
         bool CursorDown(const VTInt distance) override; // CUD
@@ -133,18 +134,18 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool DoFinalTermAction(const std::wstring_view string) override;
 
-        StringHandler DownloadDRCS(const VTInt fontNumber,
-                                   const VTParameter startChar,
-                                   const DispatchTypes::DrcsEraseControl eraseControl,
-                                   const DispatchTypes::DrcsCellMatrix cellMatrix,
-                                   const DispatchTypes::DrcsFontSet fontSet,
-                                   const DispatchTypes::DrcsFontUsage fontUsage,
-                                   const VTParameter cellHeight,
-                                   const DispatchTypes::DrcsCharsetSize charsetSize) override; // DECDLD
-
-        StringHandler DefineMacro(const VTInt macroId,
-                                  const DispatchTypes::MacroDeleteControl deleteControl,
-                                  const DispatchTypes::MacroEncoding encoding) override; // DECDMAC
+        StringChunkHandler DownloadDRCS(const VTInt fontNumber,
+                                        const VTParameter startChar,
+                                        const DispatchTypes::DrcsEraseControl eraseControl,
+                                        const DispatchTypes::DrcsCellMatrix cellMatrix,
+                                        const DispatchTypes::DrcsFontSet fontSet,
+                                        const DispatchTypes::DrcsFontUsage fontUsage,
+                                        const VTParameter cellHeight,
+                                        const DispatchTypes::DrcsCharsetSize charsetSize) override; // DECDLD
+
+        StringChunkHandler DefineMacro(const VTInt macroId,
+                                       const DispatchTypes::MacroDeleteControl deleteControl,
+                                       const DispatchTypes::MacroEncoding encoding) override; // DECDMAC
         bool InvokeMacro(const VTInt macroId) override; // DECINVM
 
         StringHandler RestoreTerminalState(const DispatchTypes::ReportFormat format) override; // DECRSTS
@@ -248,8 +249,8 @@ namespace Microsoft::Console::VirtualTerminal
         void _ReportTabStops();
         StringHandler _RestoreTabStops();
 
-        StringHandler _CreateDrcsPassthroughHandler(const DispatchTypes::DrcsCharsetSize charsetSize);
-        StringHandler _CreatePassthroughHandler();
+        StringChunkHandler _CreateDrcsPassthroughHandler(const DispatchTypes::DrcsCharsetSize charsetSize);
+        StringChunkHandler _CreatePassthroughHandler();
 
         std::vector<bool> _tabStopColumns;
         bool _initDefaultTabStops = true;
@@ -273,6 +274,9 @@ namespace Microsoft::Console::VirtualTerminal
 
         til::inclusive_rect _scrollMargins;
 
+        // The number of rows _DoLineFeed rotated the buffer by, without notifying anyone yet.
+        til::CoordType _pendingScrollRows = 0;
+
         til::enumset<Mode> _modes;
 
         SgrStack _sgrStack;
@@ -24,6 +24,7 @@ class Microsoft::Console::VirtualTerminal::TermDispatch : public Microsoft::Cons
 public:
     void Print(const wchar_t wchPrintable) override = 0;
     void PrintString(const std::wstring_view string) override = 0;
+    void FlushPendingScroll() override {}
 
     bool CursorUp(const VTInt /*distance*/) override { return false; } // CUU
     bool CursorDown(const VTInt /*distance*/) override { return false; } // CUD
@@ -125,18 +126,18 @@ public:
 
     bool DoFinalTermAction(const std::wstring_view /*string*/) override { return false; }
 
-    StringHandler DownloadDRCS(const VTInt /*fontNumber*/,
-                               const VTParameter /*startChar*/,
-                               const DispatchTypes::DrcsEraseControl /*eraseControl*/,
-                               const DispatchTypes::DrcsCellMatrix /*cellMatrix*/,
-                               const DispatchTypes::DrcsFontSet /*fontSet*/,
-                               const DispatchTypes::DrcsFontUsage /*fontUsage*/,
-                               const VTParameter /*cellHeight*/,
-                               const DispatchTypes::DrcsCharsetSize /*charsetSize*/) override { return nullptr; } // DECDLD
-
-    StringHandler DefineMacro(const VTInt /*macroId*/,
-                              const DispatchTypes::MacroDeleteControl /*deleteControl*/,
-                              const DispatchTypes::MacroEncoding /*encoding*/) override { return nullptr; } // DECDMAC
+    StringChunkHandler DownloadDRCS(const VTInt /*fontNumber*/,
+                                    const VTParameter /*startChar*/,
+                                    const DispatchTypes::DrcsEraseControl /*eraseControl*/,
+                                    const DispatchTypes::DrcsCellMatrix /*cellMatrix*/,
+                                    const DispatchTypes::DrcsFontSet /*fontSet*/,
+                                    const DispatchTypes::DrcsFontUsage /*fontUsage*/,
+                                    const VTParameter /*cellHeight*/,
+                                    const DispatchTypes::DrcsCharsetSize /*charsetSize*/) override { return nullptr; } // DECDLD
+
+    StringChunkHandler DefineMacro(const VTInt /*macroId*/,
+                                   const DispatchTypes::MacroDeleteControl /*deleteControl*/,
+                                   const DispatchTypes::MacroEncoding /*encoding*/) override { return nullptr; } // DECDMAC
     bool InvokeMacro(const VTInt /*macroId*/) override { return false; } // DECINVM
 
     StringHandler RestoreTerminalState(const DispatchTypes::ReportFormat /*format*/) override { return nullptr; }; // DECRSTS
@@ -2677,6 +2677,64 @@ public:
         VERIFY_IS_TRUE(decdld(CellMatrix::Default, 0, FontSet::Size132x24, FontUsage::FullCell, bitmapOf6x18));
     }
 
+    // Builds a DECDLD sequence for a complete 94 character set of 10x20 glyphs.
+    static std::wstring _makeFullSoftFontDownload()
+    {
+        std::wstring sequence = L"\033P1;1;1;10;0;2;20;0{ @";
+        for (auto i = 0; i < 94; i++)
+        {
+            if (i > 0)
+            {
+                sequence += L';';
+            }
+            for (auto row = 0; row < 4; row++)
+            {
+                if (row > 0)
+                {
+                    sequence += L'/';
+                }
+                for (auto column = 0; column < 10; column++)
+                {
+                    sequence += static_cast<wchar_t>(L'?' + (i + row * 10 + column) % 64);
+                }
+            }
+        }
+        sequence += L"\033\\";
+        return sequence;
+    }
+
+    TEST_METHOD(SoftFontDownloadChunking)
+    {
+        const auto sequence = _makeFullSoftFontDownload();
+        const auto getBitPattern = [&]() {
+            const auto bitPattern = _pDispatch->_fontBuffer->GetBitPattern();
+            return std::vector<uint16_t>{ bitPattern.begin(), bitPattern.end() };
+        };
+
+        Log::Comment(L"Downloading the font in a single write");
+        _stateMachine->ProcessString(sequence);
+        const auto expected = getBitPattern();
+        VERIFY_IS_TRUE(std::any_of(expected.begin(), expected.end(), [](const auto bits) { return bits != 0; }));
+
+        Log::Comment(L"Downloading the font one character at a time");
+        _pDispatch->_fontBuffer = nullptr;
+        for (const auto& ch : sequence)
+        {
+            _stateMachine->ProcessString({ &ch, 1 });
+        }
+        VERIFY_IS_TRUE(expected == getBitPattern());
+
+        Log::Comment(L"Downloading the font with writes split at odd offsets");
+        _pDispatch->_fontBuffer = nullptr;
+        for (size_t offset = 0; offset < sequence.size(); offset += 37)
+        {
+            _stateMachine->ProcessString(std::wstring_view{ sequence }.substr(offset, 37));
+        }
+        VERIFY_IS_TRUE(expected == getBitPattern());
+
+        _pDispatch->_fontBuffer = nullptr;
+    }
+
     TEST_METHOD(TogglingC1ParserMode)
     {
         _stateMachine->SetParserMode(StateMachine::Mode::AcceptC1, false);
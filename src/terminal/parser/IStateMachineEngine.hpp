@@ -20,7 +20,10 @@ namespace Microsoft::Console::VirtualTerminal
     class IStateMachineEngine
     {
     public:
-        using StringHandler = std::function<bool(const wchar_t)>;
+        // Receives the data string of a DCS sequence in one or more chunks.
+        // The end of the string is signaled with a chunk containing just an ESC.
+        // Returning false causes the remainder of the string to be ignored.
+        using StringHandler = std::function<bool(const std::wstring_view)>;
 
         virtual ~IStateMachineEngine() = 0;
         IStateMachineEngine(const IStateMachineEngine&) = default;
@@ -44,12 +47,22 @@ namespace Microsoft::Console::VirtualTerminal
 
         virtual bool ActionIgnore() = 0;
 
+        // Called once the parameter of an OSC sequence is known. The engine
+        // may return a handler to receive the string incrementally, in which
+        // case ActionOscDispatch isn't called for this sequence. If the string
+        // is cancelled before it's terminated (by CAN, SUB or a stray ESC),
+        // the handler receives an empty chunk instead of the final ESC.
+        virtual StringHandler ActionOscStringStart(const size_t parameter) = 0;
         virtual bool ActionOscDispatch(const wchar_t wch,
                                        const size_t parameter,
                                        const std::wstring_view string) = 0;
 
         virtual bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) = 0;
 
+        // Called once a string passed to StateMachine::ProcessString has been
+        // processed, allowing the engine to flush state it collects per write.
+        virtual void ActionEndOfString() noexcept = 0;
+
     protected:
         IStateMachineEngine() = default;
     };
@@ -501,6 +501,16 @@ bool InputStateMachineEngine::ActionSs3Dispatch(const wchar_t wch, const VTParam
     return success;
 }
 
+// Method Description:
+// - Called once the current string has been processed.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void InputStateMachineEngine::ActionEndOfString() noexcept
+{
+}
+
 // Method Description:
 // - Triggers the Clear action to indicate that the state machine should erase
 //      all internal state.
@@ -525,6 +535,18 @@ bool InputStateMachineEngine::ActionIgnore() noexcept
     return true;
 }
 
+// Method Description:
+// - Called once the parameter of an OSC sequence is known, allowing us to
+//   consume its string incrementally.
+// Arguments:
+// - parameter - identifier of the OSC action to perform
+// Return Value:
+// - nullptr, since we don't need to stream any OSC strings.
+IStateMachineEngine::StringHandler InputStateMachineEngine::ActionOscStringStart(const size_t /*parameter*/) noexcept
+{
+    return nullptr;
+}
+
 // Method Description:
 // - Triggers the OscDispatch action to indicate that the listener should handle a control sequence.
 //   These sequences perform various API-type commands that can include many parameters.
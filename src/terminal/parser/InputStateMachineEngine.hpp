@@ -156,12 +156,15 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionIgnore() noexcept override;
 
+        StringHandler ActionOscStringStart(const size_t parameter) noexcept override;
         bool ActionOscDispatch(const wchar_t wch,
                                const size_t parameter,
                                const std::wstring_view string) noexcept override;
 
         bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) override;
 
+        void ActionEndOfString() noexcept override;
+
         void SetFlushToInputQueueCallback(std::function<bool()> pfnFlushToInputQueue);
 
     private:
@@ -23,6 +23,11 @@ OutputStateMachineEngine::OutputStateMachineEngine(std::unique_ptr<ITermDispatch
     THROW_HR_IF_NULL(E_INVALIDARG, _dispatch.get());
 }
 
+OutputStateMachineEngine::~OutputStateMachineEngine()
+{
+    _telemetry.Flush();
+}
+
 const ITermDispatch& OutputStateMachineEngine::Dispatch() const noexcept
 {
     return *_dispatch;
@@ -50,6 +55,7 @@ bool OutputStateMachineEngine::ActionExecute(const wchar_t wch)
         // with a user-defined reply, but until then we just ignore it.
         break;
     case AsciiChars::BEL:
+        _dispatch->FlushPendingScroll();
         _dispatch->WarningBell();
         // microsoft/terminal#2952
         // If we're attached to a terminal, let's also pass the BEL through.
@@ -179,6 +185,8 @@ bool OutputStateMachineEngine::ActionPrintString(const std::wstring_view string)
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionPassThroughString(const std::wstring_view string)
 {
+    _dispatch->FlushPendingScroll();
+
     auto success = true;
     if (_pTtyConnection != nullptr)
     {
@@ -201,6 +209,12 @@ bool OutputStateMachineEngine::ActionPassThroughString(const std::wstring_view s
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
 {
+    // Runs of IND and NEL may be coalesced into a single scroll, just like line feeds.
+    if (id != EscActionCodes::IND_Index && id != EscActionCodes::NEL_NextLine)
+    {
+        _dispatch->FlushPendingScroll();
+    }
+
     auto success = false;
 
     switch (id)
@@ -211,95 +225,95 @@ bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
         break;
     case EscActionCodes::DECSC_CursorSave:
         success = _dispatch->CursorSaveState();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSC);
+        _telemetry.Log(TermTelemetry::Codes::DECSC);
         break;
     case EscActionCodes::DECRC_CursorRestore:
         success = _dispatch->CursorRestoreState();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRC);
+        _telemetry.Log(TermTelemetry::Codes::DECRC);
         break;
     case EscActionCodes::DECKPAM_KeypadApplicationMode:
         success = _dispatch->SetKeypadMode(true);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECKPAM);
+        _telemetry.Log(TermTelemetry::Codes::DECKPAM);
         break;
     case EscActionCodes::DECKPNM_KeypadNumericMode:
         success = _dispatch->SetKeypadMode(false);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECKPNM);
+        _telemetry.Log(TermTelemetry::Codes::DECKPNM);
         break;
     case EscActionCodes::NEL_NextLine:
         success = _dispatch->LineFeed(DispatchTypes::LineFeedType::WithReturn);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::NEL);
+        _telemetry.Log(TermTelemetry::Codes::NEL);
         break;
     case EscActionCodes::IND_Index:
         success = _dispatch->LineFeed(DispatchTypes::LineFeedType::WithoutReturn);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::IND);
+        _telemetry.Log(TermTelemetry::Codes::IND);
         break;
     case EscActionCodes::RI_ReverseLineFeed:
         success = _dispatch->ReverseLineFeed();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::RI);
+        _telemetry.Log(TermTelemetry::Codes::RI);
         break;
     case EscActionCodes::HTS_HorizontalTabSet:
         success = _dispatch->HorizontalTabSet();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::HTS);
+        _telemetry.Log(TermTelemetry::Codes::HTS);
         break;
     case EscActionCodes::DECID_IdentifyDevice:
         success = _dispatch->DeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA);
+        _telemetry.Log(TermTelemetry::Codes::DA);
         break;
     case EscActionCodes::RIS_ResetToInitialState:
         success = _dispatch->HardReset();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::RIS);
+        _telemetry.Log(TermTelemetry::Codes::RIS);
         break;
     case EscActionCodes::SS2_SingleShift:
         success = _dispatch->SingleShift(2);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SS2);
+        _telemetry.Log(TermTelemetry::Codes::SS2);
         break;
     case EscActionCodes::SS3_SingleShift:
         success = _dispatch->SingleShift(3);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SS3);
+        _telemetry.Log(TermTelemetry::Codes::SS3);
         break;
     case EscActionCodes::LS2_LockingShift:
         success = _dispatch->LockingShift(2);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::LS2);
+        _telemetry.Log(TermTelemetry::Codes::LS2);
         break;
     case EscActionCodes::LS3_LockingShift:
         success = _dispatch->LockingShift(3);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::LS3);
+        _telemetry.Log(TermTelemetry::Codes::LS3);
         break;
     case EscActionCodes::LS1R_LockingShift:
         success = _dispatch->LockingShiftRight(1);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::LS1R);
+        _telemetry.Log(TermTelemetry::Codes::LS1R);
         break;
     case EscActionCodes::LS2R_LockingShift:
         success = _dispatch->LockingShiftRight(2);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::LS2R);
+        _telemetry.Log(TermTelemetry::Codes::LS2R);
         break;
     case EscActionCodes::LS3R_LockingShift:
         success = _dispatch->LockingShiftRight(3);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::LS3R);
+        _telemetry.Log(TermTelemetry::Codes::LS3R);
         break;
     case EscActionCodes::DECAC1_AcceptC1Controls:
         success = _dispatch->AcceptC1Controls(true);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECAC1);
+        _telemetry.Log(TermTelemetry::Codes::DECAC1);
         break;
     case EscActionCodes::DECDHL_DoubleHeightLineTop:
         success = _dispatch->SetLineRendition(LineRendition::DoubleHeightTop);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECDHL);
+        _telemetry.Log(TermTelemetry::Codes::DECDHL);
         break;
     case EscActionCodes::DECDHL_DoubleHeightLineBottom:
         success = _dispatch->SetLineRendition(LineRendition::DoubleHeightBottom);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECDHL);
+        _telemetry.Log(TermTelemetry::Codes::DECDHL);
         break;
     case EscActionCodes::DECSWL_SingleWidthLine:
         success = _dispatch->SetLineRendition(LineRendition::SingleWidth);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSWL);
+        _telemetry.Log(TermTelemetry::Codes::DECSWL);
         break;
     case EscActionCodes::DECDWL_DoubleWidthLine:
         success = _dispatch->SetLineRendition(LineRendition::DoubleWidth);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECDWL);
+        _telemetry.Log(TermTelemetry::Codes::DECDWL);
         break;
     case EscActionCodes::DECALN_ScreenAlignmentPattern:
         success = _dispatch->ScreenAlignmentPattern();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECALN);
+        _telemetry.Log(TermTelemetry::Codes::DECALN);
         break;
     default:
         const auto commandChar = id[0];
@@ -308,35 +322,35 @@ bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
         {
         case '%':
             success = _dispatch->DesignateCodingSystem(commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DOCS);
+            _telemetry.Log(TermTelemetry::Codes::DOCS);
             break;
         case '(':
             success = _dispatch->Designate94Charset(0, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG0);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG0);
             break;
         case ')':
             success = _dispatch->Designate94Charset(1, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG1);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG1);
             break;
         case '*':
             success = _dispatch->Designate94Charset(2, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG2);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG2);
             break;
         case '+':
             success = _dispatch->Designate94Charset(3, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG3);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG3);
             break;
         case '-':
             success = _dispatch->Designate96Charset(1, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG1);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG1);
             break;
         case '.':
             success = _dispatch->Designate96Charset(2, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG2);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG2);
             break;
         case '/':
             success = _dispatch->Designate96Charset(3, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG3);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG3);
             break;
         default:
             // If no functions to call, overall dispatch was a failure.
@@ -368,6 +382,8 @@ bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const VTParameters parameters)
 {
+    _dispatch->FlushPendingScroll();
+
     auto success = false;
 
     switch (id)
@@ -441,190 +457,197 @@ bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const VTPara
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
 {
+    // SGR only changes the attributes of the text that follows, which is
+    // common in colored log output, so it doesn't need to end a run of line feeds.
+    if (id != CsiActionCodes::SGR_SetGraphicsRendition)
+    {
+        _dispatch->FlushPendingScroll();
+    }
+
     auto success = false;
 
     switch (id)
     {
     case CsiActionCodes::CUU_CursorUp:
         success = _dispatch->CursorUp(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CUU);
+        _telemetry.Log(TermTelemetry::Codes::CUU);
         break;
     case CsiActionCodes::CUD_CursorDown:
         success = _dispatch->CursorDown(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CUD);
+        _telemetry.Log(TermTelemetry::Codes::CUD);
         break;
     case CsiActionCodes::CUF_CursorForward:
         success = _dispatch->CursorForward(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CUF);
+        _telemetry.Log(TermTelemetry::Codes::CUF);
         break;
     case CsiActionCodes::CUB_CursorBackward:
         success = _dispatch->CursorBackward(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CUB);
+        _telemetry.Log(TermTelemetry::Codes::CUB);
         break;
     case CsiActionCodes::CNL_CursorNextLine:
         success = _dispatch->CursorNextLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CNL);
+        _telemetry.Log(TermTelemetry::Codes::CNL);
         break;
     case CsiActionCodes::CPL_CursorPrevLine:
         success = _dispatch->CursorPrevLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CPL);
+        _telemetry.Log(TermTelemetry::Codes::CPL);
         break;
     case CsiActionCodes::CHA_CursorHorizontalAbsolute:
     case CsiActionCodes::HPA_HorizontalPositionAbsolute:
         success = _dispatch->CursorHorizontalPositionAbsolute(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CHA);
+        _telemetry.Log(TermTelemetry::Codes::CHA);
         break;
     case CsiActionCodes::VPA_VerticalLinePositionAbsolute:
         success = _dispatch->VerticalLinePositionAbsolute(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::VPA);
+        _telemetry.Log(TermTelemetry::Codes::VPA);
         break;
     case CsiActionCodes::HPR_HorizontalPositionRelative:
         success = _dispatch->HorizontalPositionRelative(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::HPR);
+        _telemetry.Log(TermTelemetry::Codes::HPR);
         break;
     case CsiActionCodes::VPR_VerticalPositionRelative:
         success = _dispatch->VerticalPositionRelative(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::VPR);
+        _telemetry.Log(TermTelemetry::Codes::VPR);
         break;
     case CsiActionCodes::CUP_CursorPosition:
     case CsiActionCodes::HVP_HorizontalVerticalPosition:
         success = _dispatch->CursorPosition(parameters.at(0), parameters.at(1));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CUP);
+        _telemetry.Log(TermTelemetry::Codes::CUP);
         break;
     case CsiActionCodes::DECSTBM_SetScrollingRegion:
         success = _dispatch->SetTopBottomScrollingMargins(parameters.at(0).value_or(0), parameters.at(1).value_or(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSTBM);
+        _telemetry.Log(TermTelemetry::Codes::DECSTBM);
         break;
     case CsiActionCodes::ICH_InsertCharacter:
         success = _dispatch->InsertCharacter(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ICH);
+        _telemetry.Log(TermTelemetry::Codes::ICH);
         break;
     case CsiActionCodes::DCH_DeleteCharacter:
         success = _dispatch->DeleteCharacter(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DCH);
+        _telemetry.Log(TermTelemetry::Codes::DCH);
         break;
     case CsiActionCodes::ED_EraseDisplay:
         success = parameters.for_each([&](const auto eraseType) {
             return _dispatch->EraseInDisplay(eraseType);
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ED);
+        _telemetry.Log(TermTelemetry::Codes::ED);
         break;
     case CsiActionCodes::DECSED_SelectiveEraseDisplay:
         success = parameters.for_each([&](const auto eraseType) {
             return _dispatch->SelectiveEraseInDisplay(eraseType);
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSED);
+        _telemetry.Log(TermTelemetry::Codes::DECSED);
         break;
     case CsiActionCodes::EL_EraseLine:
         success = parameters.for_each([&](const auto eraseType) {
             return _dispatch->EraseInLine(eraseType);
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::EL);
+        _telemetry.Log(TermTelemetry::Codes::EL);
         break;
     case CsiActionCodes::DECSEL_SelectiveEraseLine:
         success = parameters.for_each([&](const auto eraseType) {
             return _dispatch->SelectiveEraseInLine(eraseType);
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSEL);
+        _telemetry.Log(TermTelemetry::Codes::DECSEL);
         break;
     case CsiActionCodes::SM_SetMode:
         success = parameters.for_each([&](const auto mode) {
             return _dispatch->SetMode(DispatchTypes::ANSIStandardMode(mode));
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SM);
+        _telemetry.Log(TermTelemetry::Codes::SM);
         break;
     case CsiActionCodes::DECSET_PrivateModeSet:
         success = parameters.for_each([&](const auto mode) {
             return _dispatch->SetMode(DispatchTypes::DECPrivateMode(mode));
         });
         //TODO: MSFT:6367459 Add specific logging for each of the DECSET/DECRST codes
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSET);
+        _telemetry.Log(TermTelemetry::Codes::DECSET);
         break;
     case CsiActionCodes::RM_ResetMode:
         success = parameters.for_each([&](const auto mode) {
             return _dispatch->ResetMode(DispatchTypes::ANSIStandardMode(mode));
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::RM);
+        _telemetry.Log(TermTelemetry::Codes::RM);
         break;
     case CsiActionCodes::DECRST_PrivateModeReset:
         success = parameters.for_each([&](const auto mode) {
             return _dispatch->ResetMode(DispatchTypes::DECPrivateMode(mode));
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRST);
+        _telemetry.Log(TermTelemetry::Codes::DECRST);
         break;
     case CsiActionCodes::SGR_SetGraphicsRendition:
         success = _dispatch->SetGraphicsRendition(parameters);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SGR);
+        _telemetry.Log(TermTelemetry::Codes::SGR);
         break;
     case CsiActionCodes::DSR_DeviceStatusReport:
         success = _dispatch->DeviceStatusReport(DispatchTypes::ANSIStandardStatus(parameters.at(0)), parameters.at(1));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DSR);
+        _telemetry.Log(TermTelemetry::Codes::DSR);
         break;
     case CsiActionCodes::DSR_PrivateDeviceStatusReport:
         success = _dispatch->DeviceStatusReport(DispatchTypes::DECPrivateStatus(parameters.at(0)), parameters.at(1));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DSR);
+        _telemetry.Log(TermTelemetry::Codes::DSR);
         break;
     case CsiActionCodes::DA_DeviceAttributes:
         success = parameters.at(0).value_or(0) == 0 && _dispatch->DeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA);
+        _telemetry.Log(TermTelemetry::Codes::DA);
         break;
     case CsiActionCodes::DA2_SecondaryDeviceAttributes:
         success = parameters.at(0).value_or(0) == 0 && _dispatch->SecondaryDeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA2);
+        _telemetry.Log(TermTelemetry::Codes::DA2);
         break;
     case CsiActionCodes::DA3_TertiaryDeviceAttributes:
         success = parameters.at(0).value_or(0) == 0 && _dispatch->TertiaryDeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA3);
+        _telemetry.Log(TermTelemetry::Codes::DA3);
         break;
     case CsiActionCodes::DECREQTPARM_RequestTerminalParameters:
         success = _dispatch->RequestTerminalParameters(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECREQTPARM);
+        _telemetry.Log(TermTelemetry::Codes::DECREQTPARM);
         break;
     case CsiActionCodes::SU_ScrollUp:
         success = _dispatch->ScrollUp(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SU);
+        _telemetry.Log(TermTelemetry::Codes::SU);
         break;
     case CsiActionCodes::SD_ScrollDown:
         success = _dispatch->ScrollDown(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SD);
+        _telemetry.Log(TermTelemetry::Codes::SD);
         break;
     case CsiActionCodes::ANSISYSSC_CursorSave:
         success = parameters.empty() && _dispatch->CursorSaveState();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ANSISYSSC);
+        _telemetry.Log(TermTelemetry::Codes::ANSISYSSC);
         break;
     case CsiActionCodes::ANSISYSRC_CursorRestore:
         success = parameters.empty() && _dispatch->CursorRestoreState();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ANSISYSRC);
+        _telemetry.Log(TermTelemetry::Codes::ANSISYSRC);
         break;
     case CsiActionCodes::IL_InsertLine:
         success = _dispatch->InsertLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::IL);
+        _telemetry.Log(TermTelemetry::Codes::IL);
         break;
     case CsiActionCodes::DL_DeleteLine:
         success = _dispatch->DeleteLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DL);
+        _telemetry.Log(TermTelemetry::Codes::DL);
         break;
     case CsiActionCodes::CHT_CursorForwardTab:
         success = _dispatch->ForwardTab(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CHT);
+        _telemetry.Log(TermTelemetry::Codes::CHT);
         break;
     case CsiActionCodes::CBT_CursorBackTab:
         success = _dispatch->BackwardsTab(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CBT);
+        _telemetry.Log(TermTelemetry::Codes::CBT);
         break;
     case CsiActionCodes::TBC_TabClear:
         success = parameters.for_each([&](const auto clearType) {
             return _dispatch->TabClear(clearType);
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::TBC);
+        _telemetry.Log(TermTelemetry::Codes::TBC);
         break;
     case CsiActionCodes::ECH_EraseCharacters:
         success = _dispatch->EraseCharacters(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ECH);
+        _telemetry.Log(TermTelemetry::Codes::ECH);
         break;
     case CsiActionCodes::DTTERM_WindowManipulation:
         success = _dispatch->WindowManipulation(parameters.at(0), parameters.at(1), parameters.at(2));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DTTERM_WM);
+        _telemetry.Log(TermTelemetry::Codes::DTTERM_WM);
         break;
     case CsiActionCodes::REP_RepeatCharacter:
         // Handled w/o the dispatch. This function is unique in that way
@@ -639,85 +662,85 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParamete
             _dispatch->PrintString(wstr);
         }
         success = true;
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::REP);
+        _telemetry.Log(TermTelemetry::Codes::REP);
         break;
     case CsiActionCodes::DECSCUSR_SetCursorStyle:
         success = _dispatch->SetCursorStyle(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSCUSR);
+        _telemetry.Log(TermTelemetry::Codes::DECSCUSR);
         break;
     case CsiActionCodes::DECSTR_SoftReset:
         success = _dispatch->SoftReset();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSTR);
+        _telemetry.Log(TermTelemetry::Codes::DECSTR);
         break;
     case CsiActionCodes::DECSCA_SetCharacterProtectionAttribute:
         success = _dispatch->SetCharacterProtectionAttribute(parameters);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSCA);
+        _telemetry.Log(TermTelemetry::Codes::DECSCA);
         break;
     case CsiActionCodes::XT_PushSgr:
     case CsiActionCodes::XT_PushSgrAlias:
         success = _dispatch->PushGraphicsRendition(parameters);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::XTPUSHSGR);
+        _telemetry.Log(TermTelemetry::Codes::XTPUSHSGR);
         break;
     case CsiActionCodes::XT_PopSgr:
     case CsiActionCodes::XT_PopSgrAlias:
         success = _dispatch->PopGraphicsRendition();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::XTPOPSGR);
+        _telemetry.Log(TermTelemetry::Codes::XTPOPSGR);
         break;
     case CsiActionCodes::DECRQM_RequestMode:
         success = _dispatch->RequestMode(DispatchTypes::ANSIStandardMode(parameters.at(0)));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRQM);
+        _telemetry.Log(TermTelemetry::Codes::DECRQM);
         break;
     case CsiActionCodes::DECRQM_PrivateRequestMode:
         success = _dispatch->RequestMode(DispatchTypes::DECPrivateMode(parameters.at(0)));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRQM);
+        _telemetry.Log(TermTelemetry::Codes::DECRQM);
         break;
     case CsiActionCodes::DECCARA_ChangeAttributesRectangularArea:
         success = _dispatch->ChangeAttributesRectangularArea(parameters.at(0), parameters.at(1), parameters.at(2).value_or(0), parameters.at(3).value_or(0), parameters.subspan(4));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECCARA);
+        _telemetry.Log(TermTelemetry::Codes::DECCARA);
         break;
     case CsiActionCodes::DECRARA_ReverseAttributesRectangularArea:
         success = _dispatch->ReverseAttributesRectangularArea(parameters.at(0), parameters.at(1), parameters.at(2).value_or(0), parameters.at(3).value_or(0), parameters.subspan(4));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRARA);
+        _telemetry.Log(TermTelemetry::Codes::DECRARA);
         break;
     case CsiActionCodes::DECCRA_CopyRectangularArea:
         success = _dispatch->CopyRectangularArea(parameters.at(0), parameters.at(1), parameters.at(2).value_or(0), parameters.at(3).value_or(0), parameters.at(4), parameters.at(5), parameters.at(6), parameters.at(7));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECCRA);
+        _telemetry.Log(TermTelemetry::Codes::DECCRA);
         break;
     case CsiActionCodes::DECRQPSR_RequestPresentationStateReport:
         success = _dispatch->RequestPresentationStateReport(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRQPSR);
+        _telemetry.Log(TermTelemetry::Codes::DECRQPSR);
         break;
     case CsiActionCodes::DECFRA_FillRectangularArea:
         success = _dispatch->FillRectangularArea(parameters.at(0), parameters.at(1), parameters.at(2), parameters.at(3).value_or(0), parameters.at(4).value_or(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECFRA);
+        _telemetry.Log(TermTelemetry::Codes::DECFRA);
         break;
     case CsiActionCodes::DECERA_EraseRectangularArea:
         success = _dispatch->EraseRectangularArea(parameters.at(0), parameters.at(1), parameters.at(2).value_or(0), parameters.at(3).value_or(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECERA);
+        _telemetry.Log(TermTelemetry::Codes::DECERA);
         break;
     case CsiActionCodes::DECSERA_SelectiveEraseRectangularArea:
         success = _dispatch->SelectiveEraseRectangularArea(parameters.at(0), parameters.at(1), parameters.at(2).value_or(0), parameters.at(3).value_or(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSERA);
+        _telemetry.Log(TermTelemetry::Codes::DECSERA);
         break;
     case CsiActionCodes::DECSACE_SelectAttributeChangeExtent:
         success = _dispatch->SelectAttributeChangeExtent(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSACE);
+        _telemetry.Log(TermTelemetry::Codes::DECSACE);
         break;
     case CsiActionCodes::DECRQCRA_RequestChecksumRectangularArea:
         success = _dispatch->RequestChecksumRectangularArea(parameters.at(0).value_or(0), parameters.at(1).value_or(0), parameters.at(2), parameters.at(3), parameters.at(4).value_or(0), parameters.at(5).value_or(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRQCRA);
+        _telemetry.Log(TermTelemetry::Codes::DECRQCRA);
         break;
     case CsiActionCodes::DECINVM_InvokeMacro:
         success = _dispatch->InvokeMacro(parameters.at(0).value_or(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECINVM);
+        _telemetry.Log(TermTelemetry::Codes::DECINVM);
         break;
     case CsiActionCodes::DECAC_AssignColor:
         success = _dispatch->AssignColor(parameters.at(0), parameters.at(1).value_or(0), parameters.at(2).value_or(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECAC);
+        _telemetry.Log(TermTelemetry::Codes::DECAC);
         break;
     case CsiActionCodes::DECPS_PlaySound:
         success = _dispatch->PlaySounds(parameters);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECPS);
+        _telemetry.Log(TermTelemetry::Codes::DECPS);
         break;
     default:
         // If no functions to call, overall dispatch was a failure.
@@ -737,6 +760,31 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParamete
     return success;
 }
 
+// Routine Description:
+// - Adapts a dispatch handler that consumes the data string one character at
+//   a time to the chunked StringHandler interface of the state machine.
+// Arguments:
+// - handler - the per-character handler, or nullptr
+// Return Value:
+// - the wrapped handler or nullptr
+static IStateMachineEngine::StringHandler _forEachCharacter(ITermDispatch::StringHandler handler)
+{
+    if (!handler)
+    {
+        return nullptr;
+    }
+    return [handler = std::move(handler)](const std::wstring_view string) {
+        for (const auto ch : string)
+        {
+            if (!handler(ch))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+}
+
 // Routine Description:
 // - Triggers the DcsDispatch action to indicate that the listener should handle
 //      a control sequence. Returns the handler function that is to be used to
@@ -748,6 +796,8 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParamete
 // - the data string handler function or nullptr if the sequence is not supported
 IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionDcsDispatch(const VTID id, const VTParameters parameters)
 {
+    _dispatch->FlushPendingScroll();
+
     StringHandler handler = nullptr;
 
     switch (id)
@@ -766,13 +816,13 @@ IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionDcsDispatch(c
         handler = _dispatch->DefineMacro(parameters.at(0).value_or(0), parameters.at(1), parameters.at(2));
         break;
     case DcsActionCodes::DECRSTS_RestoreTerminalState:
-        handler = _dispatch->RestoreTerminalState(parameters.at(0));
+        handler = _forEachCharacter(_dispatch->RestoreTerminalState(parameters.at(0)));
         break;
     case DcsActionCodes::DECRQSS_RequestSetting:
-        handler = _dispatch->RequestSetting();
+        handler = _forEachCharacter(_dispatch->RequestSetting());
         break;
     case DcsActionCodes::DECRSPS_RestorePresentationState:
-        handler = _dispatch->RestorePresentationState(parameters.at(0));
+        handler = _forEachCharacter(_dispatch->RestorePresentationState(parameters.at(0)));
         break;
     default:
         handler = nullptr;
@@ -810,6 +860,80 @@ bool OutputStateMachineEngine::ActionIgnore() noexcept
     return true;
 }
 
+// Routine Description:
+// - Called once the parameter of an OSC sequence is known. We use this to
+//   decode OSC 52 clipboard writes as they arrive, since their base64 payload
+//   can be several megabytes large, and accumulating it would needlessly keep
+//   both the encoded and the decoded string in memory.
+// Arguments:
+// - parameter - identifier of the OSC action to perform
+// Return Value:
+// - a handler to receive the OSC string, or nullptr to have it accumulated
+//   and passed to ActionOscDispatch as usual.
+IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionOscStringStart(const size_t parameter)
+{
+    _dispatch->FlushPendingScroll();
+
+    // If there's a TTY attached to us, we may have to pass the sequence
+    // through as a whole, which requires the state machine to collect it.
+    if (parameter != OscActionCodes::SetClipboard || _pfnFlushToTerminal != nullptr)
+    {
+        return nullptr;
+    }
+
+    // This follows the same rules as _GetOscSetClipboard: the `Pc` parameter
+    // is ignored, and `Pd` has to be either valid base64 or a `?`.
+    return [this, gotSelection = false, dataLength = size_t{}, firstChar = wchar_t{}, decoder = Base64Decoder{}](std::wstring_view string) mutable {
+        // The sequence was cancelled. The clipboard stays as it is.
+        if (string.empty())
+        {
+            return false;
+        }
+
+        if (string.back() == AsciiChars::ESC)
+        {
+            auto success = false;
+            if (gotSelection)
+            {
+                if (dataLength == 1 && firstChar == L'?')
+                {
+                    success = true;
+                }
+                else
+                {
+                    std::wstring content;
+                    success = SUCCEEDED_LOG(decoder.Finish(content)) && _dispatch->SetClipboard(content);
+                }
+            }
+            _telemetry.Log(TermTelemetry::Codes::OSCSCB);
+            _ClearLastChar();
+            return success;
+        }
+
+        if (!gotSelection)
+        {
+            const auto pos = string.find(L';');
+            if (pos == std::wstring_view::npos)
+            {
+                return true;
+            }
+            gotSelection = true;
+            string = string.substr(pos + 1);
+        }
+
+        if (!string.empty())
+        {
+            if (dataLength == 0)
+            {
+                firstChar = string.front();
+            }
+            dataLength += string.size();
+            decoder.Write(string);
+        }
+        return true;
+    };
+}
+
 // Routine Description:
 // - Triggers the OscDispatch action to indicate that the listener should handle a control sequence.
 //   These sequences perform various API-type commands that can include many parameters.
@@ -823,6 +947,8 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
                                                  const size_t parameter,
                                                  const std::wstring_view string)
 {
+    _dispatch->FlushPendingScroll();
+
     auto success = false;
 
     switch (parameter)
@@ -834,7 +960,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
         std::wstring title;
         success = _GetOscTitle(string, title);
         success = success && _dispatch->SetWindowTitle(title);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCWT);
+        _telemetry.Log(TermTelemetry::Codes::OSCWT);
         break;
     }
     case OscActionCodes::SetColor:
@@ -848,7 +974,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
             const auto rgb = til::at(colors, i);
             success = success && _dispatch->SetColorTableEntry(tableIndex, rgb);
         }
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCCT);
+        _telemetry.Log(TermTelemetry::Codes::OSCCT);
         break;
     }
     case OscActionCodes::SetForegroundColor:
@@ -869,7 +995,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
                 {
                     success = success && _dispatch->SetDefaultForeground(color);
                 }
-                TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCFG);
+                _telemetry.Log(TermTelemetry::Codes::OSCFG);
                 commandIndex++;
                 colorIndex++;
             }
@@ -881,7 +1007,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
                 {
                     success = success && _dispatch->SetDefaultBackground(color);
                 }
-                TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCBG);
+                _telemetry.Log(TermTelemetry::Codes::OSCBG);
                 commandIndex++;
                 colorIndex++;
             }
@@ -893,7 +1019,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
                 {
                     success = success && _dispatch->SetCursorColor(color);
                 }
-                TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCSCC);
+                _telemetry.Log(TermTelemetry::Codes::OSCSCC);
                 commandIndex++;
                 colorIndex++;
             }
@@ -909,13 +1035,13 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
         {
             success = _dispatch->SetClipboard(setClipboardContent);
         }
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCSCB);
+        _telemetry.Log(TermTelemetry::Codes::OSCSCB);
         break;
     }
     case OscActionCodes::ResetCursorColor:
     {
         success = _dispatch->SetCursorColor(INVALID_COLOR);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCRCC);
+        _telemetry.Log(TermTelemetry::Codes::OSCRCC);
         break;
     }
     case OscActionCodes::Hyperlink:
@@ -982,6 +1108,27 @@ bool OutputStateMachineEngine::ActionSs3Dispatch(const wchar_t /*wch*/, const VT
     return false;
 }
 
+// Routine Description:
+// - Called once the current string has been processed. The usage counts of
+//   the sequences we dispatched are collected locally and only merged into
+//   the global telemetry here, once per write, instead of once per sequence.
+// - Line feeds that were coalesced by the dispatch are flushed here as well,
+//   so that the host and the renderer see the buffer as it is after the write.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void OutputStateMachineEngine::ActionEndOfString() noexcept
+{
+    _telemetry.Flush();
+
+    try
+    {
+        _dispatch->FlushPendingScroll();
+    }
+    CATCH_LOG();
+}
+
 // Routine Description:
 // - Null terminates, then returns, the string that we've collected as part of the OSC string.
 // Arguments:
@@ -29,6 +29,7 @@ namespace Microsoft::Console::VirtualTerminal
         static constexpr size_t MAX_URL_LENGTH = 2 * 1048576; // 2MB, like iTerm2
 
         OutputStateMachineEngine(std::unique_ptr<ITermDispatch> pDispatch);
+        ~OutputStateMachineEngine() override;
 
         bool ActionExecute(const wchar_t wch) override;
         bool ActionExecuteFromEscape(const wchar_t wch) override;
@@ -51,12 +52,15 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionIgnore() noexcept override;
 
+        StringHandler ActionOscStringStart(const size_t parameter) override;
         bool ActionOscDispatch(const wchar_t wch,
                                const size_t parameter,
                                const std::wstring_view string) override;
 
         bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) noexcept override;
 
+        void ActionEndOfString() noexcept override;
+
         void SetTerminalConnection(Microsoft::Console::Render::VtEngine* const pTtyConnection,
                                    std::function<bool()> pfnFlushToTerminal);
 
@@ -68,6 +72,7 @@ namespace Microsoft::Console::VirtualTerminal
         Microsoft::Console::Render::VtEngine* _pTtyConnection;
         std::function<bool()> _pfnFlushToTerminal;
         wchar_t _lastPrintedChar;
+        TermTelemetry::Counters _telemetry;
 
         enum EscActionCodes : uint64_t
         {
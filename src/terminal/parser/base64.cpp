@@ -26,6 +26,335 @@ static constexpr uint8_t decodeTable[128] = {
 };
 // clang-format on
 
+static constexpr char encodeTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Capturing r/error by reference produces less optimal assembly.
+static constexpr auto accumulate = [](auto& r, auto& error, auto ch) {
+    // n will be in the range [0, 0x3f] for valid ch
+    // and exactly 0xff for invalid ch.
+    const auto n = decodeTable[ch & 0x7f];
+    // Both ch > 0x7f, as well as n > 0x7f are invalid values and count as an error.
+    // We can add the error state by checking if any bits ~0x7f are set (which is 0xff80).
+    error |= (ch | n) & 0xff80;
+    r = r << 6 | n;
+};
+
+static uint32_t load24(const char* in) noexcept
+{
+    return static_cast<uint32_t>(static_cast<uint8_t>(in[0])) << 16 |
+           static_cast<uint32_t>(static_cast<uint8_t>(in[1])) << 8 |
+           static_cast<uint32_t>(static_cast<uint8_t>(in[2]));
+}
+
+static void store24(char*& out, const uint32_t r) noexcept
+{
+    *out++ = gsl::narrow_cast<char>(r >> 16);
+    *out++ = gsl::narrow_cast<char>(r >> 8);
+    *out++ = gsl::narrow_cast<char>(r >> 0);
+}
+
+// The vectorized loops below work on 12 bytes <> 16 characters at a time and only deal with the
+// happy path: As soon as they encounter anything other than the 64 characters of the alphabet
+// (padding, invalid input, etc.) they stop and leave the rest to the scalar code, which knows
+// how to handle it. Since the input is UTF-16, the 16 characters fit into two registers and
+// every character already has its own 16-bit lane, which saves us from widening/narrowing.
+//
+// Decoding translates each character into its 6-bit value using range checks, then merges pairs
+// of adjacent lanes twice: 6+6 bits into 12 bits and 12+12 bits into the final 24 bits.
+// Encoding does the opposite. Both avoid SSSE3's pshufb, since we only require SSE2 on x86.
+#if defined(_M_X64) || defined(_M_IX86)
+
+// Returns false if any of the 8 characters isn't part of the alphabet.
+static bool decodeValues(const __m128i ch, __m128i& values) noexcept
+{
+    // Chars >= 0x8000 are negative for these signed comparisons, which conveniently makes them invalid.
+    const auto inRange = [&](const short lo, const short hi) noexcept {
+        return _mm_and_si128(_mm_cmpgt_epi16(ch, _mm_set1_epi16(lo - 1)), _mm_cmplt_epi16(ch, _mm_set1_epi16(hi + 1)));
+    };
+    const auto equals = [&](const short c) noexcept {
+        return _mm_cmpeq_epi16(ch, _mm_set1_epi16(c));
+    };
+
+    const auto upper = inRange('A', 'Z');
+    const auto lower = inRange('a', 'z');
+    const auto digit = inRange('0', '9');
+    const auto plus = _mm_or_si128(equals('+'), equals('-'));
+    const auto slash = equals('/');
+    const auto underscore = equals('_');
+
+    // The masks are mutually exclusive, so we can just OR together the offsets they select.
+    auto offset = _mm_and_si128(upper, _mm_set1_epi16(-'A'));
+    offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi16(26 - 'a')));
+    offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi16(52 - '0')));
+    offset = _mm_or_si128(offset, _mm_and_si128(plus, _mm_set1_epi16(62)));
+    offset = _mm_or_si128(offset, _mm_and_si128(slash, _mm_set1_epi16(63 - '/')));
+    offset = _mm_or_si128(offset, _mm_and_si128(underscore, _mm_set1_epi16(63 - '_')));
+
+    // "+" and "-" both map to 62, so we zero them out first (the offset for them is 62 itself).
+    values = _mm_add_epi16(_mm_andnot_si128(plus, ch), offset);
+
+    const auto valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), _mm_or_si128(slash, underscore));
+    return _mm_movemask_epi8(valid) == 0xffff;
+}
+
+// Merges each pair of adjacent 16-bit lanes into a 32-bit lane: (even << shift) | odd.
+static __m128i mergePairs(const __m128i v, const int shift) noexcept
+{
+    const auto even = _mm_and_si128(v, _mm_set1_epi32(0xffff));
+    const auto odd = _mm_srli_epi32(v, 16);
+    return _mm_or_si128(_mm_sll_epi32(even, _mm_cvtsi32_si128(shift)), odd);
+}
+
+static void decodeVectorized(const wchar_t*& in, const wchar_t* inEnd, char*& out) noexcept
+{
+    while (inEnd - in >= 16)
+    {
+        __m128i v0;
+        __m128i v1;
+        const auto ok0 = decodeValues(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), v0);
+        const auto ok1 = decodeValues(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8)), v1);
+        if (!ok0 || !ok1)
+        {
+            break;
+        }
+
+        const auto packed12 = _mm_packs_epi32(mergePairs(v0, 6), mergePairs(v1, 6));
+        const auto packed24 = mergePairs(packed12, 12);
+
+        store24(out, gsl::narrow_cast<uint32_t>(_mm_cvtsi128_si32(packed24)));
+        store24(out, gsl::narrow_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(packed24, 4))));
+        store24(out, gsl::narrow_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(packed24, 8))));
+        store24(out, gsl::narrow_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(packed24, 12))));
+        in += 16;
+    }
+}
+
+// Translates 8 6-bit values into their characters.
+static __m128i encodeValues(const __m128i v) noexcept
+{
+    const auto above = [&](const short n, const int add) noexcept {
+        return _mm_and_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16(n)), _mm_set1_epi16(gsl::narrow_cast<short>(add)));
+    };
+    // Each range of values builds on the offset of the range below it.
+    auto offset = _mm_set1_epi16('A');
+    offset = _mm_add_epi16(offset, above(25, ('a' - 26) - 'A'));
+    offset = _mm_add_epi16(offset, above(51, ('0' - 52) - ('a' - 26)));
+    offset = _mm_add_epi16(offset, above(61, ('+' - 62) - ('0' - 52)));
+    offset = _mm_add_epi16(offset, above(62, ('/' - 63) - ('+' - 62)));
+    return _mm_add_epi16(v, offset);
+}
+
+static void encodeVectorized(const char*& in, const char* inEnd, wchar_t*& out) noexcept
+{
+    const auto mask = _mm_set1_epi32(63);
+
+    while (inEnd - in >= 12)
+    {
+        const auto x = _mm_setr_epi32(load24(in), load24(in + 3), load24(in + 6), load24(in + 9));
+        // a holds the 1st and 2nd, b the 3rd and 4th 6-bit value of each group, each in a 16-bit lane.
+        const auto a = _mm_or_si128(_mm_srli_epi32(x, 18), _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(x, 12), mask), 16));
+        const auto b = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(x, 6), mask), _mm_slli_epi32(_mm_and_si128(x, mask), 16));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encodeValues(_mm_unpacklo_epi32(a, b)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), encodeValues(_mm_unpackhi_epi32(a, b)));
+        in += 12;
+        out += 16;
+    }
+}
+
+#elif defined(_M_ARM64)
+
+// Returns false if any of the 8 characters isn't part of the alphabet.
+static bool decodeValues(const uint16x8_t ch, uint16x8_t& values) noexcept
+{
+    const auto inRange = [&](const uint16_t lo, const uint16_t hi) noexcept {
+        return vandq_u16(vcgeq_u16(ch, vdupq_n_u16(lo)), vcleq_u16(ch, vdupq_n_u16(hi)));
+    };
+    const auto equals = [&](const uint16_t c) noexcept {
+        return vceqq_u16(ch, vdupq_n_u16(c));
+    };
+
+    const auto upper = inRange('A', 'Z');
+    const auto lower = inRange('a', 'z');
+    const auto digit = inRange('0', '9');
+    const auto plus = vorrq_u16(equals('+'), equals('-'));
+    const auto slash = equals('/');
+    const auto underscore = equals('_');
+
+    // The masks are mutually exclusive, so we can just OR together the offsets they select.
+    // The offsets rely on unsigned wrap-around.
+    auto offset = vandq_u16(upper, vdupq_n_u16(gsl::narrow_cast<uint16_t>(-'A')));
+    offset = vorrq_u16(offset, vandq_u16(lower, vdupq_n_u16(gsl::narrow_cast<uint16_t>(26 - 'a'))));
+    offset = vorrq_u16(offset, vandq_u16(digit, vdupq_n_u16(gsl::narrow_cast<uint16_t>(52 - '0'))));
+    offset = vorrq_u16(offset, vandq_u16(plus, vdupq_n_u16(62)));
+    offset = vorrq_u16(offset, vandq_u16(slash, vdupq_n_u16(gsl::narrow_cast<uint16_t>(63 - '/'))));
+    offset = vorrq_u16(offset, vandq_u16(underscore, vdupq_n_u16(gsl::narrow_cast<uint16_t>(63 - '_'))));
+
+    // "+" and "-" both map to 62, so we zero them out first (the offset for them is 62 itself).
+    values = vaddq_u16(vbicq_u16(ch, plus), offset);
+
+    const auto valid = vorrq_u16(vorrq_u16(vorrq_u16(upper, lower), vorrq_u16(digit, plus)), vorrq_u16(slash, underscore));
+    return vminvq_u16(valid) == 0xffff;
+}
+
+// Merges each pair of adjacent 16-bit lanes into a 32-bit lane: (even << shift) | odd.
+template<int Shift>
+static uint32x4_t mergePairs(const uint16x8_t v) noexcept
+{
+    const auto w = vreinterpretq_u32_u16(v);
+    return vorrq_u32(vshlq_n_u32(vandq_u32(w, vdupq_n_u32(0xffff)), Shift), vshrq_n_u32(w, 16));
+}
+
+static void decodeVectorized(const wchar_t*& in, const wchar_t* inEnd, char*& out) noexcept
+{
+    while (inEnd - in >= 16)
+    {
+        uint16x8_t v0;
+        uint16x8_t v1;
+        const auto ok0 = decodeValues(vld1q_u16(reinterpret_cast<const uint16_t*>(in)), v0);
+        const auto ok1 = decodeValues(vld1q_u16(reinterpret_cast<const uint16_t*>(in + 8)), v1);
+        if (!ok0 || !ok1)
+        {
+            break;
+        }
+
+        const auto packed12 = vcombine_u16(vmovn_u32(mergePairs<6>(v0)), vmovn_u32(mergePairs<6>(v1)));
+        const auto packed24 = mergePairs<12>(packed12);
+
+        store24(out, vgetq_lane_u32(packed24, 0));
+        store24(out, vgetq_lane_u32(packed24, 1));
+        store24(out, vgetq_lane_u32(packed24, 2));
+        store24(out, vgetq_lane_u32(packed24, 3));
+        in += 16;
+    }
+}
+
+// Translates 8 6-bit values into their characters.
+static uint16x8_t encodeValues(const uint16x8_t v) noexcept
+{
+    const auto above = [&](const uint16_t n, const int add) noexcept {
+        return vandq_u16(vcgtq_u16(v, vdupq_n_u16(n)), vdupq_n_u16(gsl::narrow_cast<uint16_t>(add)));
+    };
+    // Each range of values builds on the offset of the range below it.
+    auto offset = vdupq_n_u16('A');
+    offset = vaddq_u16(offset, above(25, ('a' - 26) - 'A'));
+    offset = vaddq_u16(offset, above(51, ('0' - 52) - ('a' - 26)));
+    offset = vaddq_u16(offset, above(61, ('+' - 62) - ('0' - 52)));
+    offset = vaddq_u16(offset, above(62, ('/' - 63) - ('+' - 62)));
+    return vaddq_u16(v, offset);
+}
+
+static void encodeVectorized(const char*& in, const char* inEnd, wchar_t*& out) noexcept
+{
+    const auto mask = vdupq_n_u32(63);
+
+    while (inEnd - in >= 12)
+    {
+        const uint32_t groups[4]{ load24(in), load24(in + 3), load24(in + 6), load24(in + 9) };
+        const auto x = vld1q_u32(&groups[0]);
+        // a holds the 1st and 2nd, b the 3rd and 4th 6-bit value of each group, each in a 16-bit lane.
+        const auto a = vorrq_u32(vshrq_n_u32(x, 18), vshlq_n_u32(vandq_u32(vshrq_n_u32(x, 12), mask), 16));
+        const auto b = vorrq_u32(vandq_u32(vshrq_n_u32(x, 6), mask), vshlq_n_u32(vandq_u32(x, mask), 16));
+
+        vst1q_u16(reinterpret_cast<uint16_t*>(out), encodeValues(vreinterpretq_u16_u32(vzip1q_u32(a, b))));
+        vst1q_u16(reinterpret_cast<uint16_t*>(out + 8), encodeValues(vreinterpretq_u16_u32(vzip2q_u32(a, b))));
+        in += 12;
+        out += 16;
+    }
+}
+
+#else
+
+static void decodeVectorized(const wchar_t*&, const wchar_t*, char*&) noexcept
+{
+}
+
+static void encodeVectorized(const char*&, const char*, wchar_t*&) noexcept
+{
+}
+
+#endif
+
+// Encodes src with RFC 4648 (Base64), including padding, and writes it into dst,
+// which must be able to hold at least EncodedLength(src.size()) characters.
+// Returns the number of characters written, or 0 if dst is too small.
+size_t Base64::Encode(const std::string_view src, const std::span<wchar_t> dst) noexcept
+{
+    if (dst.size() < EncodedLength(src.size()))
+    {
+        return 0;
+    }
+
+    // in and out may be nullptr if src.empty(), in which case the loops below are skipped.
+#pragma warning(suppress : 26429) // Symbol 'in' is never tested for nullness, it can be marked as not_null (f.23).
+    auto in = src.data();
+    const auto inEnd = in + src.size();
+    const auto outBeg = dst.data();
+#pragma warning(suppress : 26429) // Symbol 'out' is never tested for nullness, it can be marked as not_null (f.23).
+    auto out = outBeg;
+
+    encodeVectorized(in, inEnd, out);
+
+    for (; inEnd - in >= 3; in += 3)
+    {
+        const auto r = load24(in);
+        *out++ = encodeTable[(r >> 18) & 63];
+        *out++ = encodeTable[(r >> 12) & 63];
+        *out++ = encodeTable[(r >> 6) & 63];
+        *out++ = encodeTable[r & 63];
+    }
+
+    switch (inEnd - in)
+    {
+    case 1:
+    {
+        const auto r = static_cast<uint32_t>(static_cast<uint8_t>(in[0])) << 16;
+        *out++ = encodeTable[(r >> 18) & 63];
+        *out++ = encodeTable[(r >> 12) & 63];
+        *out++ = L'=';
+        *out++ = L'=';
+        break;
+    }
+    case 2:
+    {
+        const auto r = static_cast<uint32_t>(static_cast<uint8_t>(in[0])) << 16 | static_cast<uint32_t>(static_cast<uint8_t>(in[1])) << 8;
+        *out++ = encodeTable[(r >> 18) & 63];
+        *out++ = encodeTable[(r >> 12) & 63];
+        *out++ = encodeTable[(r >> 6) & 63];
+        *out++ = L'=';
+        break;
+    }
+    default:
+        break;
+    }
+
+    return gsl::narrow_cast<size_t>(out - outBeg);
+}
+
+// Decodes a string encoded with RFC 4648 (Base64) into dst, which must be able to hold at
+// least DecodedLengthMax(src.size()) bytes. The input is validated in the same pass.
+// On success, written is set to the number of bytes written.
+HRESULT Base64::Decode(const std::wstring_view& src, const std::span<char> dst, size_t& written) noexcept
+{
+    written = 0;
+    if (dst.size() < DecodedLengthMax(src.size()))
+    {
+        return E_NOT_SUFFICIENT_BUFFER;
+    }
+
+    Base64Decoder decoder;
+    auto out = decoder._write(src, dst.data());
+    out = decoder._finish(out);
+
+    if (decoder._error)
+    {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+
+    written = gsl::narrow_cast<size_t>(out - dst.data());
+    return S_OK;
+}
+
 // Decodes an UTF8 string encoded with RFC 4648 (Base64) and returns it as UTF16 in dst.
 // It supports both variants of the RFC (base64 and base64url), but
 // throws an error for non-alphabet characters, including newlines.
@@ -33,59 +362,73 @@ static constexpr uint8_t decodeTable[128] = {
 // * Doesn't support whitespace and will throw an exception for such strings.
 // * Doesn't validate the number of trailing "=". Those are basically ignored.
 //   Strings like "YQ===" will be accepted as valid input and simply result in "a".
+//   Any data following a "=" is invalid however.
 HRESULT Base64::Decode(const std::wstring_view& src, std::wstring& dst) noexcept
 {
-    std::string result;
-    result.resize(((src.size() + 3) / 4) * 3);
+    Base64Decoder decoder;
+    decoder.Write(src);
+    return decoder.Finish(dst);
+}
+
+// Decodes the next piece of the input. Pieces may be split anywhere,
+// including in the middle of a group of 4 base64 characters.
+// Errors are accumulated and reported by Finish().
+void Base64Decoder::Write(const std::wstring_view src) noexcept
+{
+    // Every 4 input characters (including the up to 3 that are still pending in _r) produce 3 bytes.
+    const auto offset = _bytes.size();
+    _bytes.resize(offset + ((_ri + src.size()) / 4) * 3);
+
+    const auto outBeg = _bytes.data();
+    const auto out = _write(src, outBeg + offset);
+    _bytes.resize(out - outBeg);
+}
+
+// Flushes the last, incomplete group of base64 characters and returns the decoded
+// string as UTF16 in dst. Fails if any of the input so far was invalid.
+HRESULT Base64Decoder::Finish(std::wstring& dst) noexcept
+{
+    const auto offset = _bytes.size();
+    _bytes.resize(offset + 2);
+
+    const auto outBeg = _bytes.data();
+    const auto out = _finish(outBeg + offset);
+    _bytes.resize(out - outBeg);
+
+    if (_error)
+    {
+        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
 
+    return til::u8u16(_bytes, dst);
+}
+
+// Decodes src into out, which must have room for ((_ri + src.size()) / 4) * 3 bytes.
+// Returns the new end of the output.
+char* Base64Decoder::_write(const std::wstring_view src, char* out) noexcept
+{
     // in and inEnd may be nullptr if src.empty().
     // The remaining code in this function ensures not to read from in if src.empty().
 #pragma warning(suppress : 26429) // Symbol 'in' is never tested for nullness, it can be marked as not_null (f.23).
     auto in = src.data();
     const auto inEnd = in + src.size();
-    // Sometimes in programming you have to ask yourself what the right offset for a pointer is.
-    // Is 4 enough? Certainly not. 6 on the other hand is just way too much. Clearly 5 is just right.
-    //
-    // In all seriousness however the offset is 5, because the batched loop reads 4 characters at a time,
-    // a base64 string can end with two "=" and the batched loop doesn't handle any such "=".
-    // Additionally the while() condition of the batched loop would make a lot more sense if it were using <=,
-    // but for reasons outlined below it needs to use < so we need to add 1 back again.
-    // We thus get -4-2+1 which is -5.
-    //
-    // There's a special reason we need to use < and not <= for the loop:
-    // In C++ it's undefined behavior to perform any pointer arithmetic that leads to unallocated memory,
-    // which is why we can't just write `inEnd - 6` as that might be UB if `src.size()` is less than 6.
-    // We thus would need write `inEnd - min(6, src.size())` in combination with `<=` for the batched loop.
-    // But if `src.size()` is actually less than 6 then `inEnd` is equal to the initial `in`, aka: an empty range.
-    // In such cases we'd enter the batched loop and read from `in` despite us not wanting to enter the loop.
-    // We can fix the issue by using < instead and adding +1 to the offset.
-    //
-    // Yes this works.
-    const auto inEndBatched = inEnd - std::min<size_t>(5, src.size());
-
-    // outBeg and out may be nullptr if src.empty().
-    // The remaining code in this function ensures not to write to out if src.empty().
-    const auto outBeg = result.data();
-#pragma warning(suppress : 26429) // Symbol 'out' is never tested for nullness, it can be marked as not_null (f.23).
-    auto out = outBeg;
 
-    // r is just a generic "remainder" we use to accumulate 4 base64 chars into 3 output bytes.
-    uint_fast32_t r = 0;
-    // error is treated as a boolean. If it's not 0 we had an invalid input character.
-    uint_fast16_t error = 0;
-
-    // Capturing r/error by reference produces less optimal assembly.
-    static constexpr auto accumulate = [](auto& r, auto& error, auto ch) {
-        // n will be in the range [0, 0x3f] for valid ch
-        // and exactly 0xff for invalid ch.
-        const auto n = decodeTable[ch & 0x7f];
-        // Both ch > 0x7f, as well as n > 0x7f are invalid values and count as an error.
-        // We can add the error state by checking if any bits ~0x7f are set (which is 0xff80).
-        error |= (ch | n) & 0xff80;
-        r = r << 6 | n;
-    };
+    // If the previous piece ended in the middle of a group, we complete that group first.
+    while (_ri != 0 && in < inEnd)
+    {
+        _accumulateOne(*in++, out);
+    }
+
+    // The batched loops below don't handle any "=", so they stop short of the
+    // first one. Everything from there on is handled one character at a time.
+    const auto padding = _padding ? in : std::find(in, inEnd, L'=');
+    const auto inEndBatched = in + ((padding - in) & ~3);
+
+    decodeVectorized(in, inEndBatched, out);
+
+    auto r = _r;
+    auto error = _error;
 
-    // If src.empty() then `in == inEndBatched == nullptr` and this is skipped.
     while (in < inEndBatched)
     {
         const auto ch0 = *in++;
@@ -110,49 +453,57 @@ HRESULT Base64::Decode(const std::wstring_view& src, std::wstring& dst) noexcept
         accumulate(r, error, ch2);
         accumulate(r, error, ch3);
 
-        *out++ = gsl::narrow_cast<char>(r >> 16);
-        *out++ = gsl::narrow_cast<char>(r >> 8);
-        *out++ = gsl::narrow_cast<char>(r >> 0);
+        store24(out, gsl::narrow_cast<uint32_t>(r));
     }
 
+    _r = r;
+    _error = error;
+
+    while (in < inEnd)
     {
-        uint_fast8_t ri = 0;
+        _accumulateOne(*in++, out);
+    }
 
-        // If src.empty() then `in == inEnd == nullptr` and this is skipped.
-        for (; in < inEnd; ++in)
-        {
-            if (const auto ch = *in; ch != '=')
-            {
-                accumulate(r, error, ch);
-                ri++;
-            }
-        }
+    return out;
+}
 
-        switch (ri)
-        {
-        case 2:
-            *out++ = gsl::narrow_cast<char>(r >> 4);
-            break;
-        case 3:
-            *out++ = gsl::narrow_cast<char>(r >> 10);
-            *out++ = gsl::narrow_cast<char>(r >> 2);
-            break;
-        case 4:
-            *out++ = gsl::narrow_cast<char>(r >> 16);
-            *out++ = gsl::narrow_cast<char>(r >> 8);
-            *out++ = gsl::narrow_cast<char>(r >> 0);
-            break;
-        default:
-            error |= ri;
-            break;
-        }
+// Writes out the last, incomplete group of base64 characters (up to 2 bytes).
+char* Base64Decoder::_finish(char* out) noexcept
+{
+    switch (_ri)
+    {
+    case 0:
+        break;
+    case 2:
+        *out++ = gsl::narrow_cast<char>(_r >> 4);
+        break;
+    case 3:
+        *out++ = gsl::narrow_cast<char>(_r >> 10);
+        *out++ = gsl::narrow_cast<char>(_r >> 2);
+        break;
+    default:
+        _error |= _ri;
+        break;
     }
+    _ri = 0;
+    return out;
+}
 
-    if (error)
+void Base64Decoder::_accumulateOne(const wchar_t ch, char*& out) noexcept
+{
+    if (ch == L'=')
     {
-        return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        _padding = true;
+        return;
     }
 
-    result.resize(out - outBeg);
-    return til::u8u16(result, dst);
+    // Padding may only appear at the end.
+    _error |= _padding;
+    accumulate(_r, _error, ch);
+
+    if (++_ri == 4)
+    {
+        store24(out, gsl::narrow_cast<uint32_t>(_r));
+        _ri = 0;
+    }
 }
@@ -7,6 +7,8 @@ Module Name:
 
 Abstract:
 - This declares standard base64 encoding and decoding, with paddings when needed.
+- The bulk of the work is vectorized (SSE2 and NEON) and operates directly
+  on UTF-16, since that's what the VT parser hands us.
 */
 
 #pragma once
@@ -16,6 +18,44 @@ namespace Microsoft::Console::VirtualTerminal
     class Base64
     {
     public:
+        static constexpr size_t EncodedLength(const size_t size) noexcept
+        {
+            return (size + 2) / 3 * 4;
+        }
+
+        static constexpr size_t DecodedLengthMax(const size_t size) noexcept
+        {
+            return (size + 3) / 4 * 3;
+        }
+
+        static size_t Encode(const std::string_view src, const std::span<wchar_t> dst) noexcept;
+        static HRESULT Decode(const std::wstring_view& src, const std::span<char> dst, size_t& written) noexcept;
         static HRESULT Decode(const std::wstring_view& src, std::wstring& dst) noexcept;
     };
+
+    // Decodes base64 that arrives in arbitrarily sized pieces, like an OSC 52
+    // payload that's split across several writes. Only the decoded bytes are
+    // retained, which are a fraction of the size of the UTF-16 input.
+    class Base64Decoder
+    {
+    public:
+        void Write(const std::wstring_view src) noexcept;
+        HRESULT Finish(std::wstring& dst) noexcept;
+
+    private:
+        friend class Base64;
+
+        char* _write(const std::wstring_view src, char* out) noexcept;
+        char* _finish(char* out) noexcept;
+        void _accumulateOne(const wchar_t ch, char*& out) noexcept;
+
+        std::string _bytes;
+        // r is just a generic "remainder" we use to accumulate 4 base64 chars into 3 output bytes.
+        // ri is the number of chars accumulated in r so far.
+        uint_fast32_t _r = 0;
+        uint_fast8_t _ri = 0;
+        // error is treated as a boolean. If it's not 0 we had an invalid input character.
+        uint_fast16_t _error = 0;
+        bool _padding = false;
+    };
 }
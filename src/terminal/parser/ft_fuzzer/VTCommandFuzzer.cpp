@@ -41,6 +41,7 @@ static std::string GenerateOscColorTableToken();
 static std::string GenerateVt52Token();
 static std::string GenerateVt52CursorAddressToken();
 static std::string GenerateOscHyperlinkToken();
+static std::string GenerateOscClipboardToken();
 
 const fuzz::_fuzz_type_entry<BYTE> g_repeatMap[] = {
     { 4, [](BYTE) { return CFuzzChance::GetRandom<BYTE>(2, 0xF); } },
@@ -64,7 +65,8 @@ const std::function<std::string()> g_tokenGenerators[] = {
     GenerateOscColorTableToken,
     GenerateVt52Token,
     GenerateVt52CursorAddressToken,
-    GenerateOscHyperlinkToken
+    GenerateOscHyperlinkToken,
+    GenerateOscClipboardToken
 };
 
 std::string GenerateTokenLowProbability()
@@ -602,6 +604,52 @@ std::string GenerateOscHyperlinkToken()
     return GenerateFuzzedOscToken(FUZZ_MAP(map), tokens, ARRAYSIZE(tokens));
 }
 
+// Osc Clipboard String. An Osc followed by 52, followed by a ";", followed by a selection,
+// followed by a ";", followed by a (mostly valid) base64 payload, and BEL terminated.
+std::string GenerateOscClipboardToken()
+{
+    const LPCSTR tokens[] = { "\x7", "\x1b\\" };
+    const _fuzz_type_entry<std::string> map[] = {
+        { 100,
+          [](std::string) {
+              static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/-_";
+              const LPCSTR selections[] = { "c", "p", "s0", "" };
+
+              std::string s;
+              AppendFormat(s, "%d", 52);
+              s.append(";");
+              s.append(CFuzzChance::SelectOne(selections, ARRAYSIZE(selections)));
+              s.append(";");
+
+              // Long payloads exercise the vectorized decoder, short ones the scalar remainder.
+              auto limit = CFuzzChance::GetRandom<SHORT>();
+              for (SHORT i = 0; i < limit; i++)
+              {
+                  s.push_back(alphabet[CFuzzChance::GetRandom<BYTE>(0, ARRAYSIZE(alphabet) - 2)]);
+              }
+
+              // Sometimes pad the payload and sometimes corrupt it.
+              switch (CFuzzChance::GetRandom<BYTE>(0, 5))
+              {
+              case 0:
+                  s.append("=");
+                  break;
+              case 1:
+                  s.append("==");
+                  break;
+              case 2:
+                  s[CFuzzChance::GetRandom<size_t>(s.size())] = static_cast<char>(CFuzzChance::GetRandom<BYTE>());
+                  break;
+              default:
+                  break;
+              }
+              return s;
+          } }
+    };
+
+    return GenerateFuzzedOscToken(FUZZ_MAP(map), tokens, ARRAYSIZE(tokens));
+}
+
 int __cdecl wmain(int argc, WCHAR* argv[])
 {
     if (argc != 3)
@@ -7,6 +7,8 @@
 
 #include "ascii.hpp"
 
+#include <til/scan.h>
+
 using namespace Microsoft::Console::VirtualTerminal;
 
 //Takes ownership of the pEngine.
@@ -329,6 +331,41 @@ static constexpr bool _isDcsPassThroughValid(const wchar_t wch) noexcept
     return wch >= AsciiChars::SPC && wch < AsciiChars::DEL;
 }
 
+// Routine Description:
+// - Finds the end of the run of characters, starting at the given offset, that
+//   can be handed to a DCS data string handler without further interpretation.
+//   That's everything _EventDcsPassThrough would pass through, which excludes
+//   the CAN, SUB and ESC terminators, as well as DEL and all C1 controls.
+// Arguments:
+// - string - The string being processed.
+// - offset - The offset at which the run starts.
+// Return Value:
+// - The offset one past the end of the run.
+static size_t _findDcsPassThroughRunEnd(const std::wstring_view string, size_t offset) noexcept
+{
+    while (offset < string.size() && (_isC0Code(til::at(string, offset)) || _isDcsPassThroughValid(til::at(string, offset))))
+    {
+        ++offset;
+    }
+    return offset;
+}
+
+// Routine Description:
+// - Finds the end of the run of characters, starting at the given offset, that
+//   _EventOscString would add to the OSC string. That's everything except for
+//   C0 controls (which includes the BEL and ESC terminators) and C1 controls.
+// Arguments:
+// - string - The string being processed.
+// - offset - The offset at which the run starts.
+// Return Value:
+// - The offset one past the end of the run.
+static size_t _findOscStringRunEnd(const std::wstring_view string, size_t offset) noexcept
+{
+    static constexpr til::scan::char_class oscStringEnd{ { L'\x00', L'\x1f' }, { L'\x80', L'\x9f' } };
+    const auto end = til::scan::find_first_of(string.substr(offset), oscStringEnd);
+    return end == til::scan::npos ? string.size() : offset + end;
+}
+
 // Routine Description:
 // - Determines if a character is "start of string" beginning
 //      indicator.
@@ -377,6 +414,9 @@ static constexpr bool _isActionableFromGround(const wchar_t wch) noexcept
     return (wch <= AsciiChars::US) || _isC1ControlCharacter(wch) || _isDelete(wch);
 }
 
+// The same set of characters as _isActionableFromGround, for use with til::scan.
+static constexpr til::scan::char_class _actionableFromGround{ { L'\x00', L'\x1f' }, { L'\x7f', L'\x9f' } };
+
 #pragma warning(pop)
 
 // Routine Description:
@@ -563,6 +603,9 @@ void StateMachine::_ActionClear()
 
     _oscString.clear();
     _oscParameter = 0;
+    _ActionOscStringAbort();
+    _oscStringSize = 0;
+    _oscStringIgnored = false;
 
     _dcsStringHandler = nullptr;
 
@@ -594,9 +637,16 @@ void StateMachine::_ActionInterrupt()
     if (_state == VTStates::DcsPassThrough)
     {
         // The ESC signals the end of the data string.
-        _dcsStringHandler(AsciiChars::ESC);
+        static constexpr wchar_t esc = AsciiChars::ESC;
+        _dcsStringHandler({ &esc, 1 });
         _dcsStringHandler = nullptr;
     }
+    // An OSC string that's cut short is never dispatched. If the engine was
+    // consuming it incrementally, it has to discard what it got so far.
+    else if (_state == VTStates::OscString || _state == VTStates::OscTermination)
+    {
+        _ActionOscStringAbort();
+    }
 }
 
 // Routine Description:
@@ -619,10 +669,82 @@ void StateMachine::_ActionOscParam(const wchar_t wch) noexcept
 // Return Value:
 // - <none>
 void StateMachine::_ActionOscPut(const wchar_t wch)
+{
+    _ActionOscPutString({ &wch, 1 });
+}
+
+// Routine Description:
+// - Stores a run of characters as part of the OSC string, or hands them to
+//   the engine if it asked to receive the string incrementally. Once the
+//   string exceeds OscStringLimit, the whole sequence is ignored.
+// Arguments:
+// - string - Characters to store.
+// Return Value:
+// - <none>
+void StateMachine::_ActionOscPutString(const std::wstring_view string)
 {
     _trace.TraceOnAction(L"OscPut");
 
-    _oscString.push_back(wch);
+    if (_oscStringIgnored)
+    {
+        return;
+    }
+
+    _oscStringSize += string.size();
+    if (_oscStringSize > OscStringLimit)
+    {
+        // Release the memory right away, since the string may be huge.
+        std::wstring{}.swap(_oscString);
+        _ActionOscStringAbort();
+        _oscStringIgnored = true;
+        return;
+    }
+
+    if (_oscStringHandler)
+    {
+        if (!_oscStringHandler(string))
+        {
+            _oscStringHandler = nullptr;
+            _oscStringIgnored = true;
+        }
+    }
+    else
+    {
+        _oscString.append(string);
+    }
+}
+
+// Routine Description:
+// - Gives the engine a chance to consume the string of the current OSC
+//   sequence incrementally, once the OSC parameter has been parsed.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void StateMachine::_ActionOscStringStart()
+{
+    _SafeExecute([=]() {
+        _oscStringHandler = _engine->ActionOscStringStart(_oscParameter);
+        return true;
+    });
+}
+
+// Routine Description:
+// - Tells the engine's OSC string handler, if there is one, that the string
+//   won't be terminated and releases it, along with whatever it has buffered.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void StateMachine::_ActionOscStringAbort()
+{
+    if (_oscStringHandler)
+    {
+        _SafeExecute([=]() {
+            return _oscStringHandler({});
+        });
+        _oscStringHandler = nullptr;
+    }
 }
 
 // Routine Description:
@@ -634,10 +756,25 @@ void StateMachine::_ActionOscPut(const wchar_t wch)
 // - <none>
 void StateMachine::_ActionOscDispatch(const wchar_t wch)
 {
+    if (_oscStringIgnored)
+    {
+        _ActionIgnore();
+        return;
+    }
+
     _trace.TraceOnAction(L"OscDispatch");
     _trace.DispatchSequenceTrace(_SafeExecuteWithLog(wch, [=]() {
+        if (_oscStringHandler)
+        {
+            // The ESC signals the end of the string, just like for DCS strings.
+            static constexpr wchar_t esc = AsciiChars::ESC;
+            return _oscStringHandler({ &esc, 1 });
+        }
         return _engine->ActionOscDispatch(wch, _oscParameter, _oscString);
     }));
+
+    // The handler is done. Don't keep it (and its buffers) around until the next sequence.
+    _oscStringHandler = nullptr;
 }
 
 // Routine Description:
@@ -1310,7 +1447,7 @@ void StateMachine::_EventCsiParam(const wchar_t wch)
 // - wch - Character that triggered the event
 // Return Value:
 // - <none>
-void StateMachine::_EventOscParam(const wchar_t wch) noexcept
+void StateMachine::_EventOscParam(const wchar_t wch)
 {
     _trace.TraceOnEvent(L"OscParam");
     if (_isOscTerminator(wch))
@@ -1323,6 +1460,7 @@ void StateMachine::_EventOscParam(const wchar_t wch) noexcept
     }
     else if (_isOscDelimiter(wch))
     {
+        _ActionOscStringStart();
         _EnterOscString();
     }
     else
@@ -1385,6 +1523,8 @@ void StateMachine::_EventOscTermination(const wchar_t wch)
     }
     else
     {
+        // The ESC didn't terminate the string after all. It starts a new sequence instead.
+        _ActionOscStringAbort();
         _EnterEscape();
         _EventEscape(wch);
     }
@@ -1663,10 +1803,7 @@ void StateMachine::_EventDcsPassThrough(const wchar_t wch)
     _trace.TraceOnEvent(L"DcsPassThrough");
     if (_isC0Code(wch) || _isDcsPassThroughValid(wch))
     {
-        if (!_dcsStringHandler(wch))
-        {
-            _EnterDcsIgnore();
-        }
+        _ActionDcsPassThroughString({ &wch, 1 });
     }
     else
     {
@@ -1674,6 +1811,102 @@ void StateMachine::_EventDcsPassThrough(const wchar_t wch)
     }
 }
 
+// Routine Description:
+// - Hands a run of data string characters to the DCS string handler. If the
+//   handler isn't interested in the rest of the string, we'll ignore it.
+// Arguments:
+// - string - The characters to pass through. Only contains characters that
+//   satisfy _isC0Code or _isDcsPassThroughValid.
+// Return Value:
+// - <none>
+void StateMachine::_ActionDcsPassThroughString(const std::wstring_view string)
+{
+    if (!_dcsStringHandler(string))
+    {
+        _EnterDcsIgnore();
+    }
+}
+
+// Routine Description:
+// - Attempts to dispatch the CSI sequence that starts at the given offset
+//   without running it through the state machine one character at a time.
+//   Colored output and full-screen applications consist mostly of SGR, CUP,
+//   EL and ED sequences, all of which have nothing but numeric parameters.
+//   As such, only complete sequences made up of digits and parameter
+//   delimiters qualify. Anything else (intermediates, private markers,
+//   embedded controls, more than MAX_PARAMETER_COUNT parameters or a sequence
+//   that's split across writes) is left for the regular state machine.
+// Arguments:
+// - string - The string that's currently being processed.
+// - offset - The offset of the ESC that introduces the sequence.
+// Return Value:
+// - The offset one past the end of the sequence if it was dispatched.
+//   Otherwise offset, in which case nothing was done.
+size_t StateMachine::_ActionCsiDispatchFast(const std::wstring_view string, const size_t offset)
+{
+    // We need at least the ESC, the "[" and the final character.
+    if (string.size() - offset < 3 || !_isCsiIndicator(til::at(string, offset + 1)))
+    {
+        return offset;
+    }
+
+    std::array<VTParameter, MAX_PARAMETER_COUNT> parameters;
+    size_t parameterCount = 0;
+    auto end = offset + 2;
+
+    for (; end < string.size(); ++end)
+    {
+        const auto wch = til::at(string, end);
+        if (_isNumericParamValue(wch))
+        {
+            parameterCount = std::max<size_t>(parameterCount, 1);
+            auto& parameter = til::at(parameters, parameterCount - 1);
+            auto value = parameter.value_or(0);
+            _AccumulateTo(wch, value);
+            parameter = value;
+        }
+        else if (_isParameterDelimiter(wch))
+        {
+            // "Empty" parameters count as well, just like in _ActionParam.
+            parameterCount = std::max<size_t>(parameterCount, 1);
+            if (parameterCount >= MAX_PARAMETER_COUNT)
+            {
+                return offset;
+            }
+            ++parameterCount;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    // The sequence must be complete and end in a final character (0x40 - 0x7E).
+    if (end >= string.size() || til::at(string, end) < L'@' || til::at(string, end) > L'~')
+    {
+        return offset;
+    }
+
+    const auto finalChar = til::at(string, end);
+    ++end;
+
+    // The run is what FlushToTerminal would pass through if the engine asks for it.
+    _runOffset = offset;
+    _runSize = end - offset;
+    _processingLastCharacter = end >= string.size();
+
+    _engine->ActionClear();
+    _trace.ClearSequenceTrace();
+    _trace.AddSequenceTrace(string.substr(offset, end - offset));
+    _trace.TraceOnAction(L"CsiDispatch");
+    _trace.DispatchSequenceTrace(_SafeExecuteWithLog(finalChar, [&]() {
+        return _engine->ActionCsiDispatch(VTID{ finalChar }, { parameters.data(), parameterCount });
+    }));
+    _ExecuteCsiCompleteCallback();
+
+    return end;
+}
+
 // Routine Description:
 // - Handle SOS/PM/APC string.
 //   In this state the entire string is ignored.
@@ -1847,6 +2080,54 @@ void StateMachine::ProcessString(const std::wstring_view string)
         _runOffset = start;
         _runSize = current - start + 1;
 
+        if (_processingIndividually && _state == VTStates::DcsPassThrough)
+        {
+            // DCS data strings can be quite large (e.g. DECDLD soft fonts), so
+            // instead of feeding them through the state machine one character
+            // at a time, we hand the longest run of data characters over to the
+            // string handler in one go. The terminators and anything else that
+            // needs special treatment still take the regular path below.
+            const auto end = _findDcsPassThroughRunEnd(string, current);
+            if (end > current)
+            {
+                _trace.TraceOnEvent(L"DcsPassThrough");
+                _processingLastCharacter = end >= string.size();
+                _ActionDcsPassThroughString(string.substr(current, end - current));
+                current = end;
+                continue;
+            }
+        }
+        else if (_processingIndividually && _state == VTStates::OscString)
+        {
+            // The same applies to OSC strings (e.g. OSC 52 clipboard writes).
+            const auto end = _findOscStringRunEnd(string, current);
+            if (end > current)
+            {
+                _trace.TraceOnEvent(L"OscString");
+                _processingLastCharacter = end >= string.size();
+                _ActionOscPutString(string.substr(current, end - current));
+                current = end;
+                continue;
+            }
+        }
+        else if (_processingIndividually && _state == VTStates::Ground && !_isEngineForInput &&
+                 _isEscape(til::at(string, current)) && _parserMode.test(Mode::Ansi))
+        {
+            // Most escape sequences in the output of typical applications are
+            // simple CSI sequences. Those we can dispatch in one go as well.
+            const auto end = _ActionCsiDispatchFast(string, current);
+            if (end > current)
+            {
+                current = end;
+                if (_state == VTStates::Ground)
+                {
+                    _processingIndividually = false;
+                    start = current;
+                }
+                continue;
+            }
+        }
+
         if (_processingIndividually)
         {
             // Note whether we're dealing with the last character in the buffer.
@@ -1879,7 +2160,9 @@ void StateMachine::ProcessString(const std::wstring_view string)
             }
             else
             {
-                ++current; // Otherwise, add this char to the current run to be printed.
+                // Otherwise, add this char and all following printable ones to the current run to be printed.
+                const auto end = til::scan::find_first_of(string.substr(current + 1), _actionableFromGround);
+                current = end == til::scan::npos ? string.size() : current + 1 + end;
             }
         }
     }
@@ -1968,7 +2251,7 @@ void StateMachine::ProcessString(const std::wstring_view string)
             // after dispatching the characters
             _EnterGround();
         }
-        else if (_state != VTStates::SosPmApcString && _state != VTStates::DcsPassThrough && _state != VTStates::DcsIgnore)
+        else if (_state != VTStates::SosPmApcString && _state != VTStates::DcsPassThrough && _state != VTStates::DcsIgnore && !_oscStringHandler)
         {
             // If the engine doesn't require flushing at the end of the string, we
             // want to cache the partial sequence in case we have to flush the whole
@@ -1984,6 +2267,8 @@ void StateMachine::ProcessString(const std::wstring_view string)
             cachedSequence.append(run);
         }
     }
+
+    _engine->ActionEndOfString();
 }
 
 // Routine Description:
@@ -61,6 +61,13 @@ namespace Microsoft::Console::VirtualTerminal
         void ProcessString(const std::wstring_view string);
         bool IsProcessingLastCharacter() const noexcept;
 
+        // The maximum number of characters in an OSC string. Longer OSC sequences are ignored
+        // in their entirety, and their string is discarded as soon as the limit is exceeded,
+        // so that a misbehaving application can't exhaust our memory.
+        // OSC 52 clipboard writes of several megabytes are legitimate (e.g.
+        // yanking a large buffer in a remote editor), so this is fairly generous.
+        static constexpr size_t OscStringLimit = 32 * 1024 * 1024;
+
         void OnCsiComplete(const std::function<void()> callback);
 
         void ResetState() noexcept;
@@ -89,6 +96,9 @@ namespace Microsoft::Console::VirtualTerminal
         void _ActionCsiDispatch(const wchar_t wch);
         void _ActionOscParam(const wchar_t wch) noexcept;
         void _ActionOscPut(const wchar_t wch);
+        void _ActionOscPutString(const std::wstring_view string);
+        void _ActionOscStringStart();
+        void _ActionOscStringAbort();
         void _ActionOscDispatch(const wchar_t wch);
         void _ActionSs3Dispatch(const wchar_t wch);
         void _ActionDcsDispatch(const wchar_t wch);
@@ -96,6 +106,8 @@ namespace Microsoft::Console::VirtualTerminal
         void _ActionClear();
         void _ActionIgnore() noexcept;
         void _ActionInterrupt();
+        void _ActionDcsPassThroughString(const std::wstring_view string);
+        size_t _ActionCsiDispatchFast(const std::wstring_view string, const size_t offset);
 
         void _EnterGround() noexcept;
         void _EnterEscape();
@@ -124,7 +136,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _EventCsiIntermediate(const wchar_t wch);
         void _EventCsiIgnore(const wchar_t wch);
         void _EventCsiParam(const wchar_t wch);
-        void _EventOscParam(const wchar_t wch) noexcept;
+        void _EventOscParam(const wchar_t wch);
         void _EventOscString(const wchar_t wch);
         void _EventOscTermination(const wchar_t wch);
         void _EventSs3Entry(const wchar_t wch);
@@ -197,6 +209,9 @@ namespace Microsoft::Console::VirtualTerminal
 
         std::wstring _oscString;
         VTInt _oscParameter;
+        IStateMachineEngine::StringHandler _oscStringHandler;
+        size_t _oscStringSize;
+        bool _oscStringIgnored;
 
         IStateMachineEngine::StringHandler _dcsStringHandler;
 
@@ -67,6 +67,39 @@ void TermTelemetry::Log(const Codes code) noexcept
     _uiTimesUsedCurrent++;
 }
 
+// Routine Description:
+// - Logs the usage of all the VT100 codes collected in the given counters.
+//
+// Arguments:
+// - counters - The usage counts to add.
+// Return Value:
+// - <none>
+void TermTelemetry::Log(const Counters& counters) noexcept
+{
+    for (size_t i = 0; i < NUMBER_OF_CODES; ++i)
+    {
+        _uiTimesUsed[i] += til::at(counters._timesUsed, i);
+    }
+    _uiTimesUsedCurrent += counters._total;
+}
+
+// Routine Description:
+// - Merges the collected usage counts into the shared TermTelemetry instance and resets them.
+//
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void TermTelemetry::Counters::Flush() noexcept
+{
+    if (_total)
+    {
+        Instance().Log(*this);
+        _timesUsed = {};
+        _total = 0;
+    }
+}
+
 // Routine Description:
 // - Logs a particular VT100 escape code failed or was unsupported.
 //
@@ -128,7 +128,30 @@ namespace Microsoft::Console::VirtualTerminal
             // Only use this last enum as a count of the number of codes.
             NUMBER_OF_CODES
         };
+
+        // Collects usage counts locally (e.g. per parser), so that logging a
+        // sequence is nothing but an increment. The counts are merged into
+        // the shared instance with Flush(), for instance once per write.
+        class Counters
+        {
+        public:
+            void Log(const Codes code) noexcept
+            {
+                til::at(_timesUsed, code)++;
+                _total++;
+            }
+
+            void Flush() noexcept;
+
+        private:
+            friend class TermTelemetry;
+
+            std::array<unsigned int, NUMBER_OF_CODES> _timesUsed{};
+            unsigned int _total = 0;
+        };
+
         void Log(const Codes code) noexcept;
+        void Log(const Counters& counters) noexcept;
         void LogFailed(const wchar_t wch) noexcept;
         void SetShouldWriteFinalLog(const bool writeLog) noexcept;
         void SetActivityId(const GUID* activityId) noexcept;
@@ -6,6 +6,8 @@
 
 using namespace Microsoft::Console::VirtualTerminal;
 
+#if TIL_FEATURE_VTPARSERTRACING_ENABLED
+
 #pragma warning(push)
 #pragma warning(disable : 26447) // The function is declared 'noexcept' but calls function '_tlgWrapBinary<wchar_t>()' which may throw exceptions
 #pragma warning(disable : 26477) // Use 'nullptr' rather than 0 or NULL
@@ -80,6 +82,15 @@ void ParserTracing::AddSequenceTrace(const wchar_t wch)
     }
 }
 
+void ParserTracing::AddSequenceTrace(const std::wstring_view string)
+{
+    // Don't waste time storing this if no one is listening.
+    if (TraceLoggingProviderEnabled(g_hConsoleVirtTermParserEventTraceProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE))
+    {
+        _sequenceTrace.append(string);
+    }
+}
+
 void ParserTracing::DispatchSequenceTrace(const bool fSuccess) noexcept
 {
     if (fSuccess)
@@ -135,3 +146,5 @@ void ParserTracing::DispatchPrintRunTrace(const std::wstring_view& string) const
 }
 
 #pragma warning(pop)
+
+#endif
@@ -8,6 +8,8 @@ Module Name:
 Abstract:
 - This module is used for recording tracing/debugging information to the telemetry ETW channel
 - The data is not automatically broadcast to telemetry backends.
+- The tracing is only compiled in if Feature_VtParserTracing is enabled. Otherwise all
+  methods are empty inline functions, which removes them from the parser's hot path.
 - NOTE: Many functions in this file appear to be copy/pastes. This is because the TraceLog documentation warns
         to not be "cute" in trying to reduce its macro usages with variables as it can cause unexpected behavior.
 */
@@ -34,6 +36,7 @@ namespace Microsoft::Console::VirtualTerminal
         // C-strings is more ergonomic instead and fits the need for
         // high performance in this particular code.
 
+#if TIL_FEATURE_VTPARSERTRACING_ENABLED
         void TraceStateChange(_In_z_ const wchar_t* name) const noexcept;
         void TraceOnAction(_In_z_ const wchar_t* name) const noexcept;
         void TraceOnExecute(const wchar_t wch) const noexcept;
@@ -42,11 +45,26 @@ namespace Microsoft::Console::VirtualTerminal
         void TraceCharInput(const wchar_t wch);
 
         void AddSequenceTrace(const wchar_t wch);
+        void AddSequenceTrace(const std::wstring_view string);
         void DispatchSequenceTrace(const bool fSuccess) noexcept;
         void ClearSequenceTrace() noexcept;
         void DispatchPrintRunTrace(const std::wstring_view& string) const;
 
     private:
         std::wstring _sequenceTrace;
+#else
+        void TraceStateChange(_In_z_ const wchar_t* /*name*/) const noexcept {}
+        void TraceOnAction(_In_z_ const wchar_t* /*name*/) const noexcept {}
+        void TraceOnExecute(const wchar_t /*wch*/) const noexcept {}
+        void TraceOnExecuteFromEscape(const wchar_t /*wch*/) const noexcept {}
+        void TraceOnEvent(_In_z_ const wchar_t* /*name*/) const noexcept {}
+        void TraceCharInput(const wchar_t /*wch*/) noexcept {}
+
+        void AddSequenceTrace(const wchar_t /*wch*/) noexcept {}
+        void AddSequenceTrace(const std::wstring_view /*string*/) noexcept {}
+        void DispatchSequenceTrace(const bool /*fSuccess*/) noexcept {}
+        void ClearSequenceTrace() noexcept {}
+        void DispatchPrintRunTrace(const std::wstring_view& /*string*/) const noexcept {}
+#endif
     };
 }
@@ -103,6 +103,132 @@ class Microsoft::Console::VirtualTerminal::Base64Test
         }
     }
 
+    TEST_METHOD(DecodeStreaming)
+    {
+        // "The quick brown fox jumps over the lazy dog"
+        static constexpr std::wstring_view encoded = L"VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZw==";
+        static constexpr std::wstring_view expected = L"The quick brown fox jumps over the lazy dog";
+
+        for (size_t chunkSize = 1; chunkSize <= encoded.size(); chunkSize++)
+        {
+            Base64Decoder decoder;
+            for (size_t offset = 0; offset < encoded.size(); offset += chunkSize)
+            {
+                decoder.Write(encoded.substr(offset, chunkSize));
+            }
+
+            std::wstring decoded;
+            VERIFY_SUCCEEDED(decoder.Finish(decoded));
+            VERIFY_ARE_EQUAL(expected, decoded);
+        }
+    }
+
+    TEST_METHOD(DecodeInvalid)
+    {
+        std::wstring result;
+
+        VERIFY_FAILED(Base64::Decode(L"Zm9v\nYmFy", result));
+        VERIFY_FAILED(Base64::Decode(L"Z", result));
+        VERIFY_FAILED(Base64::Decode(L"Zm9vY", result));
+        VERIFY_FAILED(Base64::Decode(L"Zg==Zg==", result));
+
+        // Trailing "=" aren't validated.
+        VERIFY_SUCCEEDED(Base64::Decode(L"YQ===", result));
+        VERIFY_ARE_EQUAL(L"a", result);
+    }
+
+    TEST_METHOD(EncodeFuzz)
+    {
+        static constexpr auto testRounds = 8;
+        pcg_engines::oneseq_dxsm_64_32 rng{ til::gen_random<uint64_t>() };
+
+        uint8_t referenceData[256];
+        for (auto& b : referenceData)
+        {
+            b = static_cast<uint8_t>(rng());
+        }
+
+        std::wstring expected;
+        std::wstring encoded;
+
+        for (auto i = 0; i < testRounds; ++i)
+        {
+            const auto referenceLength = rng(static_cast<uint32_t>(std::size(referenceData)));
+            const std::string_view reference{ reinterpret_cast<const char*>(&referenceData[0]), referenceLength };
+
+            expected.clear();
+            if (referenceLength)
+            {
+                DWORD encodedLen;
+                THROW_IF_WIN32_BOOL_FALSE(CryptBinaryToStringW(&referenceData[0], referenceLength, CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF, nullptr, &encodedLen));
+                expected.resize(encodedLen - 1);
+                THROW_IF_WIN32_BOOL_FALSE(CryptBinaryToStringW(&referenceData[0], referenceLength, CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF, expected.data(), &encodedLen));
+            }
+
+            encoded.resize(Base64::EncodedLength(reference.size()));
+            encoded.resize(Base64::Encode(reference, encoded));
+            VERIFY_ARE_EQUAL(expected, encoded);
+        }
+    }
+
+    TEST_METHOD(EncodeBufferTooSmall)
+    {
+        wchar_t buffer[8];
+        VERIFY_ARE_EQUAL(8u, Base64::Encode("foobar", buffer));
+        VERIFY_ARE_EQUAL(0u, Base64::Encode("foobarb", buffer));
+        VERIFY_ARE_EQUAL(0u, Base64::Encode("foo", std::span{ buffer, 3 }));
+    }
+
+    TEST_METHOD(RoundTripVectorBoundaries)
+    {
+        // The vectorized loops process 16 characters at a time and leave the rest to the scalar code.
+        // This tests all lengths around those boundaries, as well as invalid characters at every position.
+        std::string data;
+        std::wstring encoded;
+        std::string decoded;
+
+        for (size_t length = 0; length <= 64; ++length)
+        {
+            data.resize(length);
+            for (size_t i = 0; i < length; ++i)
+            {
+                data[i] = static_cast<char>(i * 37 + length);
+            }
+
+            encoded.resize(Base64::EncodedLength(length));
+            VERIFY_ARE_EQUAL(encoded.size(), Base64::Encode(data, encoded));
+
+            size_t written = 0;
+            decoded.resize(Base64::DecodedLengthMax(encoded.size()));
+            VERIFY_SUCCEEDED(Base64::Decode(encoded, decoded, written));
+            decoded.resize(written);
+            VERIFY_ARE_EQUAL(data, decoded);
+
+            const auto unpadded = encoded.find(L'=');
+            const auto validLength = unpadded == std::wstring::npos ? encoded.size() : unpadded;
+            for (size_t i = 0; i < validLength; ++i)
+            {
+                for (const auto ch : { L'!', L'\u0141', L'\xff2b' })
+                {
+                    auto invalid = encoded;
+                    invalid[i] = ch;
+                    decoded.resize(Base64::DecodedLengthMax(invalid.size()));
+                    VERIFY_FAILED(Base64::Decode(invalid, decoded, written));
+                }
+            }
+        }
+    }
+
+    TEST_METHOD(DecodeBufferTooSmall)
+    {
+        char buffer[5];
+        size_t written = 0;
+        VERIFY_ARE_EQUAL(E_NOT_SUFFICIENT_BUFFER, Base64::Decode(L"Zm9vYmFy", buffer, written));
+        VERIFY_ARE_EQUAL(0u, written);
+        VERIFY_SUCCEEDED(Base64::Decode(L"Zm9v", buffer, written));
+        VERIFY_ARE_EQUAL(3u, written);
+    }
+
     TEST_METHOD(DecodeUTF8)
     {
         std::wstring result;
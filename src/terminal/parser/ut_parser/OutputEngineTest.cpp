@@ -3014,6 +3014,130 @@ class StateMachineExternalTest final
         pDispatch->ClearState();
     }
 
+    TEST_METHOD(TestTelemetryFlushedPerWrite)
+    {
+        auto dispatch = std::make_unique<StatefulDispatch>();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        TermTelemetry::Instance().GetAndResetTimesUsedCurrent();
+
+        // The usage counts are collected by the engine and merged into
+        // the global telemetry once the whole string has been processed.
+        mach.ProcessString(L"\x1b[1m\x1b[2;3Htext\x1b[K\x1b[2J");
+        VERIFY_ARE_EQUAL(4u, TermTelemetry::Instance().GetAndResetTimesUsedCurrent());
+
+        // Sequences split across writes are counted once they're complete.
+        mach.ProcessString(L"\x1b[3");
+        VERIFY_ARE_EQUAL(0u, TermTelemetry::Instance().GetAndResetTimesUsedCurrent());
+        mach.ProcessString(L"1m");
+        VERIFY_ARE_EQUAL(1u, TermTelemetry::Instance().GetAndResetTimesUsedCurrent());
+    }
+
+    TEST_METHOD(TestSetClipboardAcrossWrites)
+    {
+        auto dispatch = std::make_unique<StatefulDispatch>();
+        auto pDispatch = dispatch.get();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        // "The quick brown fox jumps over the lazy dog"
+        const std::wstring_view sequence = L"\x1b]52;c;VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZw==\x1b\\";
+
+        // The payload is decoded as it arrives, so the base64 groups, the `Pc`
+        // parameter and the terminator can all be split across writes.
+        for (size_t chunkSize = 1; chunkSize <= 8; chunkSize++)
+        {
+            Log::Comment(NoThrowString().Format(L"Writing %zu characters at a time", chunkSize));
+            for (size_t offset = 0; offset < sequence.size(); offset += chunkSize)
+            {
+                mach.ProcessString(sequence.substr(offset, chunkSize));
+            }
+            VERIFY_ARE_EQUAL(L"The quick brown fox jumps over the lazy dog", pDispatch->_copyContent);
+            pDispatch->ClearState();
+        }
+
+        pDispatch->_copyContent = L"UNCHANGED";
+        // An interrupted sequence doesn't change the content.
+        mach.ProcessString(L"\x1b]52;;Zm9v");
+        mach.ProcessString(L"\x1b[m");
+        VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+
+        // The handler (and its decoder) is released as soon as the sequence ends,
+        // however it ends, so that it doesn't linger until the next sequence.
+        for (const auto interrupt : { L"\x18", L"\x1a", L"\x1b[m" })
+        {
+            pDispatch->_copyContent = L"UNCHANGED";
+            mach.ProcessString(L"\x1b]52;;Zm9v");
+            VERIFY_IS_TRUE(static_cast<bool>(mach._oscStringHandler));
+            mach.ProcessString(interrupt);
+            VERIFY_IS_FALSE(static_cast<bool>(mach._oscStringHandler));
+            VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+        }
+
+        mach.ProcessString(L"\x1b]52;;Zm9v\x07");
+        VERIFY_IS_FALSE(static_cast<bool>(mach._oscStringHandler));
+        VERIFY_ARE_EQUAL(L"foo", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+
+        pDispatch->_copyContent = L"UNCHANGED";
+        // Data after the padding is illegal, won't change the content.
+        mach.ProcessString(L"\x1b]52;;Zg==Zm9v\x07");
+        VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+    }
+
+    TEST_METHOD(TestOscStringLimit)
+    {
+        auto dispatch = std::make_unique<StatefulDispatch>();
+        auto pDispatch = dispatch.get();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        // Writes count repetitions of pattern in chunks, like a large OSC sequence arriving over a pipe.
+        const auto writeRepeated = [&](const std::wstring_view pattern, const size_t count) {
+            std::wstring chunk;
+            for (size_t i = 0; i < 16 * 1024; ++i)
+            {
+                chunk.append(pattern);
+            }
+            for (auto remaining = count * pattern.size(); remaining != 0;)
+            {
+                const auto length = std::min(remaining, chunk.size());
+                mach.ProcessString({ chunk.data(), length });
+                remaining -= length;
+            }
+        };
+
+        Log::Comment(L"Strings up to the limit are kept, longer strings are ignored, even when split across writes");
+        // The OSC 8 string includes the empty `params`, hence the leading semicolon.
+        mach.ProcessString(L"\x1b]8;;");
+        writeRepeated(L"a", StateMachine::OscStringLimit - 1);
+        VERIFY_ARE_EQUAL(StateMachine::OscStringLimit, mach._oscString.size());
+        mach.ProcessString(L"a");
+        VERIFY_IS_TRUE(mach._oscString.empty());
+        mach.ProcessString(L"\x1b\\");
+        VERIFY_IS_FALSE(pDispatch->_hyperlinkMode);
+        VERIFY_ARE_EQUAL(StateMachine::VTStates::Ground, mach._state);
+
+        Log::Comment(L"Streamed strings are subject to the limit as well");
+        pDispatch->_copyContent = L"UNCHANGED";
+        mach.ProcessString(L"\x1b]52;;");
+        writeRepeated(L"Zm9v", StateMachine::OscStringLimit / 4 + 1);
+        mach.ProcessString(L"\x07");
+        VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+
+        Log::Comment(L"The limit doesn't leak into the next sequence");
+        mach.ProcessString(L"\x1b]52;;Zm9v\x07");
+        VERIFY_ARE_EQUAL(L"foo", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+    }
+
     TEST_METHOD(TestAddHyperlink)
     {
         auto dispatch = std::make_unique<StatefulDispatch>();
@@ -38,11 +38,13 @@ public:
         dcsId = 0;
         dcsParams.clear();
         dcsDataString.clear();
+        log.clear();
     }
 
     bool ActionExecute(const wchar_t wch) override
     {
         executed += wch;
+        log += wch;
         return true;
     };
 
@@ -51,6 +53,7 @@ public:
     bool ActionPrintString(const std::wstring_view string) override
     {
         printed += string;
+        log += string;
         return true;
     };
 
@@ -68,6 +71,8 @@ public:
 
     bool ActionIgnore() override { return true; };
 
+    IStateMachineEngine::StringHandler ActionOscStringStart(const size_t /* parameter */) override { return nullptr; };
+
     bool ActionOscDispatch(const wchar_t /* wch */,
                            const size_t /* parameter */,
                            const std::wstring_view /* string */) override
@@ -82,6 +87,8 @@ public:
 
     bool ActionSs3Dispatch(const wchar_t /* wch */, const VTParameters /* parameters */) override { return true; };
 
+    void ActionEndOfString() noexcept override {}
+
     // ActionCsiDispatch is the only method that's actually implemented.
     bool ActionCsiDispatch(const VTID id, const VTParameters parameters) override
     {
@@ -94,10 +101,15 @@ public:
         else
         {
             csiId = id;
+            log += L"{CSI ";
+            log += std::to_wstring(csiId);
             for (size_t i = 0; i < parameters.size(); i++)
             {
                 csiParams.push_back(parameters.at(i).value_or(0));
+                log += L' ';
+                log += std::to_wstring(parameters.at(i).value_or(-1));
             }
+            log += L'}';
             return true;
         }
     }
@@ -133,6 +145,9 @@ public:
     uint64_t dcsId = 0;
     std::vector<size_t> dcsParams;
     std::wstring dcsDataString;
+
+    // Everything that was printed, executed and dispatched (CSI only), in order.
+    std::wstring log;
 };
 
 class Microsoft::Console::VirtualTerminal::StateMachineTest
@@ -157,6 +172,8 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
 
     TEST_METHOD(DcsDataStringsReceivedByHandler);
+
+    TEST_METHOD(CsiFastPathMatchesStateMachine);
 };
 
 void StateMachineTest::TwoStateMachinesDoNotInterfereWithEachOther()
@@ -337,3 +354,80 @@ void StateMachineTest::DcsDataStringsReceivedByHandler()
     // Verify the control characters were executed (if expected).
     VERIFY_ARE_EQUAL(expectedExecuted, engine.executed);
 }
+
+void StateMachineTest::CsiFastPathMatchesStateMachine()
+{
+    // Complete CSI sequences are dispatched without going through the individual
+    // state transitions, unless they're split across writes. Feeding the same input
+    // once as a whole and once one character at a time compares the two paths.
+    std::wstring tooManyParameters = L"\x1b[";
+    for (auto i = 0; i < 40; ++i)
+    {
+        tooManyParameters += std::to_wstring(i) + L";";
+    }
+    tooManyParameters += L"m";
+
+    const std::wstring_view inputs[] = {
+        L"\x1b[m",
+        L"\x1b[0m",
+        L"\x1b[1;31m",
+        L"\x1b[38;2;255;128;0m",
+        L"\x1b[48;5;123m",
+        L"\x1b[;m",
+        L"\x1b[;;1;;m",
+        L"\x1b[H",
+        L"\x1b[12;34H",
+        L"\x1b[;5f",
+        L"\x1b[K",
+        L"\x1b[2K",
+        L"\x1b[J",
+        L"\x1b[3J",
+        L"\x1b[99999999999;1H",
+        L"\x1b[0001;0002H",
+        L"\x1b[?25h",
+        L"\x1b[>c",
+        L"\x1b[1:2m",
+        L"\x1b[1 q",
+        L"\x1b[1\nm",
+        L"\x1b[1\x7fm",
+        L"\x1b[1\x1b[2m",
+        L"\x1b[1\x80m",
+        L"\x1bM",
+        L"\x1b",
+        L"\x1b[",
+        L"\x1b[1;2",
+        tooManyParameters,
+    };
+
+    const auto compare = [](const std::wstring_view input) {
+        auto wholeEnginePtr{ std::make_unique<TestStateMachineEngine>() };
+        const auto& wholeEngine{ *wholeEnginePtr.get() };
+        StateMachine wholeMachine{ std::move(wholeEnginePtr) };
+
+        auto splitEnginePtr{ std::make_unique<TestStateMachineEngine>() };
+        const auto& splitEngine{ *splitEnginePtr.get() };
+        StateMachine splitMachine{ std::move(splitEnginePtr) };
+
+        wholeMachine.ProcessString(input);
+        for (const auto& ch : input)
+        {
+            splitMachine.ProcessString({ &ch, 1 });
+        }
+
+        VERIFY_ARE_EQUAL(splitEngine.log, wholeEngine.log);
+    };
+
+    std::wstring all;
+    for (size_t i = 0; i < std::size(inputs); ++i)
+    {
+        const auto input = til::at(inputs, i);
+        Log::Comment(NoThrowString().Format(L"Input #%zu", i));
+        compare(input);
+
+        all += L"text";
+        all += input;
+    }
+
+    Log::Comment(L"All inputs at once");
+    compare(all);
+}
@@ -1099,4 +1099,92 @@ class BitmapTests
         }
         VERIFY_ARE_EQUAL(expected, actual);
     }
+
+    TEST_METHOD(RunsWithFragmentedRows)
+    {
+        // Rows that were filled with disjoint spans can't be summarized as a
+        // single run and have to fall back to scanning the underlying bits.
+        til::bitmap map{ til::size{ 8, 2 } };
+
+        // 1 0 1 1 0 0 0 1
+        // 0 0 0 0 0 0 0 0
+        map.set(til::point{ 0, 0 });
+        map.set(til::rect{ 2, 0, 4, 1 });
+        map.set(til::point{ 7, 0 });
+
+        til::some<til::rect, 3> expected;
+        expected.push_back(til::rect{ 0, 0, 1, 1 });
+        expected.push_back(til::rect{ 2, 0, 4, 1 });
+        expected.push_back(til::rect{ 7, 0, 8, 1 });
+
+        til::some<til::rect, 3> actual;
+        for (auto run : map.runs())
+        {
+            actual.push_back(run);
+        }
+        VERIFY_ARE_EQUAL(expected, actual);
+
+        Log::Comment(L"Filling the gaps one by one must still be detected as all().");
+        VERIFY_IS_FALSE(map.all());
+        map.set(til::rect{ 0, 1, 8, 2 });
+        VERIFY_IS_FALSE(map.all());
+        map.set(til::point{ 1, 0 });
+        map.set(til::rect{ 4, 0, 7, 1 });
+        VERIFY_IS_TRUE(map.all());
+
+        expected.clear();
+        expected.push_back(til::rect{ 0, 0, 8, 1 });
+        expected.push_back(til::rect{ 0, 1, 8, 2 });
+
+        actual.clear();
+        for (auto run : map.runs())
+        {
+            actual.push_back(run);
+        }
+        VERIFY_ARE_EQUAL(expected, actual);
+
+        Log::Comment(L"Covering a fragmented row with a single span makes it contiguous again.");
+        map.reset_all();
+        map.set(til::point{ 1, 0 });
+        map.set(til::point{ 5, 0 });
+        map.set(til::rect{ 0, 0, 8, 1 });
+        VERIFY_ARE_EQUAL(1u, map.runs().size());
+        VERIFY_ARE_EQUAL((til::rect{ 0, 0, 8, 1 }), map.runs().front());
+    }
+
+    TEST_METHOD(RunsMatchIterator)
+    {
+        // runs() is built from the row summaries, whereas the iterator
+        // walks the bits. Both must agree for random sets of rectangles.
+        til::bitmap map{ til::size{ 37, 11 } };
+        uint32_t seed = 0x1234;
+        const auto next = [&](til::CoordType max) {
+            seed = seed * 1664525 + 1013904223;
+            return static_cast<til::CoordType>((seed >> 8) % static_cast<uint32_t>(max));
+        };
+
+        for (auto i = 0; i < 200; ++i)
+        {
+            const auto left = next(37);
+            const auto top = next(11);
+            const auto right = left + 1 + next(37 - left);
+            const auto bottom = top + 1 + next(11 - top);
+            map.set(til::rect{ left, top, right, bottom });
+
+            if (i % 3 == 0)
+            {
+                map.translate(til::point{ 0, next(5) - 2 }, i % 2 == 0);
+            }
+            if (i % 17 == 0)
+            {
+                map.reset_all();
+            }
+
+            const std::vector<til::rect> expected{ map.begin(), map.end() };
+            const auto actual = map.runs();
+            VERIFY_ARE_EQUAL(expected.size(), actual.size());
+            VERIFY_IS_TRUE(std::equal(expected.begin(), expected.end(), actual.begin(), actual.end()));
+            VERIFY_ARE_EQUAL(map._bits.all(), map.all());
+        }
+    }
 };
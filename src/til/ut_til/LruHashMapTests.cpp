@@ -0,0 +1,299 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include <til/lru_hash_map.h>
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+// Maps all keys onto just a few hashes, to exercise the collision handling and backward shift deletion.
+struct CollidingHash
+{
+    size_t operator()(int key) const noexcept
+    {
+        return static_cast<size_t>(key % 7);
+    }
+};
+
+// The std::list + std::unordered_map combination that lru_hash_map replaces.
+// It serves as the reference for the randomized tests. VtBench's glyph-cache kernel uses it as its baseline.
+template<typename K, typename V>
+struct ReferenceLru
+{
+    using list_type = std::list<std::pair<K, V>>;
+
+    typename list_type::iterator find(const K& key)
+    {
+        const auto it = map.find(key);
+        if (it == map.end())
+        {
+            return list.end();
+        }
+        list.splice(list.begin(), list, it->second);
+        return it->second;
+    }
+
+    void insert(const K& key, V value)
+    {
+        list.emplace_front(key, std::move(value));
+        map.emplace(key, list.begin());
+    }
+
+    void pop_oldest()
+    {
+        map.erase(list.back().first);
+        list.pop_back();
+    }
+
+    list_type list;
+    std::unordered_map<K, typename list_type::iterator> map;
+};
+
+// Generates the clusters of text a terminal would ask a glyph cache for.
+// The distributions are skewed, because real text reuses a few glyphs (letters, common ideographs) a lot.
+static std::vector<std::wstring> generateGlyphTrace(std::wstring_view kind, size_t count)
+{
+    std::mt19937 rng{ 0 };
+    std::exponential_distribution<double> skew{ 0.05 };
+    const auto pick = [&](uint32_t range) {
+        return static_cast<uint32_t>(skew(rng)) % range;
+    };
+    const auto appendCodepoint = [](std::wstring& str, uint32_t cp) {
+        if (cp >= 0x10000)
+        {
+            cp -= 0x10000;
+            str.push_back(static_cast<wchar_t>(0xD800 + (cp >> 10)));
+            str.push_back(static_cast<wchar_t>(0xDC00 + (cp & 0x3FF)));
+        }
+        else
+        {
+            str.push_back(static_cast<wchar_t>(cp));
+        }
+    };
+
+    std::vector<std::wstring> trace;
+    trace.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::wstring cluster;
+        const auto roll = rng() % 100;
+
+        if (kind == L"ascii" || (kind == L"mixed" && roll < 70))
+        {
+            appendCodepoint(cluster, 0x20 + pick(95));
+        }
+        else if (kind == L"cjk" || (kind == L"mixed" && roll < 90))
+        {
+            appendCodepoint(cluster, 0x4E00 + pick(20992));
+        }
+        else
+        {
+            // Emoji, some with skin tone modifiers and some as ZWJ sequences.
+            appendCodepoint(cluster, 0x1F600 + pick(80));
+            if (roll % 4 == 0)
+            {
+                appendCodepoint(cluster, 0x1F3FB + pick(5));
+            }
+            if (roll % 8 == 1)
+            {
+                appendCodepoint(cluster, 0x200D);
+                appendCodepoint(cluster, 0x1F468 + pick(4));
+            }
+        }
+
+        trace.emplace_back(std::move(cluster));
+    }
+
+    return trace;
+}
+
+class LruHashMapTests
+{
+    TEST_CLASS(LruHashMapTests);
+
+    TEST_METHOD(Basic)
+    {
+        til::lru_hash_map<int, int> map;
+        VERIFY_IS_TRUE(map.empty());
+        VERIFY_IS_TRUE(map.find(1) == map.end());
+        VERIFY_IS_TRUE(map.oldest() == map.end());
+
+        const auto it1 = map.insert(1, 10);
+        const auto it2 = map.insert(2, 20);
+        const auto it3 = map.insert(3, 30);
+        VERIFY_ARE_EQUAL(3u, map.size());
+        VERIFY_ARE_EQUAL(20, it2->second);
+
+        // Insertion order determines the initial LRU order...
+        VERIFY_IS_TRUE(map.oldest() == it1);
+        // ...and find() marks entries as the newest one.
+        VERIFY_IS_TRUE(map.find(1) == it1);
+        VERIFY_IS_TRUE(map.oldest() == it2);
+        map.make_newest(it2);
+        VERIFY_IS_TRUE(map.oldest() == it3);
+
+        map.pop_oldest();
+        VERIFY_ARE_EQUAL(2u, map.size());
+        VERIFY_IS_TRUE(map.find(3) == map.end());
+        VERIFY_IS_TRUE(map.oldest() == it1);
+
+        map.erase(it1);
+        map.erase(it2);
+        VERIFY_IS_TRUE(map.empty());
+        VERIFY_IS_TRUE(map.oldest() == map.end());
+    }
+
+    TEST_METHOD(IteratorsSurviveGrowth)
+    {
+        til::lru_hash_map<int, std::wstring> map;
+        std::vector<decltype(map)::iterator> iterators;
+
+        for (auto i = 0; i < 10000; ++i)
+        {
+            iterators.emplace_back(map.insert(i, std::to_wstring(i)));
+        }
+
+        for (auto i = 0; i < 10000; ++i)
+        {
+            VERIFY_ARE_EQUAL(i, iterators[i]->first);
+            VERIFY_ARE_EQUAL(std::to_wstring(i), iterators[i]->second);
+            VERIFY_IS_TRUE(map.find(i) == iterators[i]);
+        }
+    }
+
+    TEST_METHOD(Clear)
+    {
+        til::lru_hash_map<int, std::wstring> map;
+
+        for (auto i = 0; i < 100; ++i)
+        {
+            map.insert(i, std::to_wstring(i));
+        }
+
+        map.clear();
+        VERIFY_IS_TRUE(map.empty());
+        VERIFY_IS_TRUE(map.find(0) == map.end());
+
+        // The recycled nodes must be usable again.
+        for (auto i = 0; i < 200; ++i)
+        {
+            map.insert(i, std::to_wstring(i));
+        }
+        VERIFY_ARE_EQUAL(200u, map.size());
+        VERIFY_ARE_EQUAL(L"123", map.find(123)->second);
+    }
+
+    TEST_METHOD(Move)
+    {
+        til::lru_hash_map<int, std::wstring> a;
+        const auto it = a.insert(1, L"foo");
+
+        auto b = std::move(a);
+        VERIFY_IS_TRUE(a.empty());
+        VERIFY_IS_TRUE(b.find(1) == it);
+
+        a = std::move(b);
+        VERIFY_IS_TRUE(b.empty());
+        VERIFY_ARE_EQUAL(L"foo", a.find(1)->second);
+
+        // The moved-from map must still be usable.
+        b.insert(2, L"bar");
+        VERIFY_ARE_EQUAL(L"bar", b.find(2)->second);
+    }
+
+    TEST_METHOD(MatchesReferenceImplementation)
+    {
+        std::mt19937 rng{ 0 };
+        til::lru_hash_map<int, int, CollidingHash> map;
+        ReferenceLru<int, int> reference;
+
+        for (auto step = 0; step < 100000; ++step)
+        {
+            const auto key = static_cast<int>(rng() % 300);
+
+            if (rng() % 3)
+            {
+                const auto it = map.find(key);
+                const auto ref = reference.find(key);
+
+                if (ref == reference.list.end())
+                {
+                    VERIFY_IS_TRUE(it == map.end());
+                    map.insert(key, key * 2);
+                    reference.insert(key, key * 2);
+                }
+                else
+                {
+                    VERIFY_IS_TRUE(it != map.end());
+                    VERIFY_ARE_EQUAL(ref->second, it->second);
+                }
+            }
+            else if (!reference.list.empty())
+            {
+                VERIFY_ARE_EQUAL(reference.list.back().first, map.oldest()->first);
+                map.pop_oldest();
+                reference.pop_oldest();
+            }
+
+            VERIFY_ARE_EQUAL(reference.list.size(), map.size());
+        }
+    }
+
+    // Replays glyph traces through a glyph cache of limited size, like AtlasEngine's TileHashMap.
+    // Both implement the same eviction policy and must thus produce the same hits.
+    TEST_METHOD(GlyphTracesMatchReference)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"Data:trace", L"{ascii, cjk, mixed}")
+        END_TEST_METHOD_PROPERTIES()
+
+        String trace;
+        VERIFY_SUCCEEDED_RETURN(TestData::TryGetValue(L"trace", trace));
+
+        static constexpr size_t lookups = 100000;
+        static constexpr size_t cacheSize = 2048;
+        const auto keys = generateGlyphTrace(std::wstring_view{ trace }, lookups);
+
+        size_t hits = 0;
+        size_t referenceHits = 0;
+
+        {
+            til::lru_hash_map<std::wstring, size_t> map;
+            for (const auto& key : keys)
+            {
+                if (map.find(key) != map.end())
+                {
+                    hits++;
+                    continue;
+                }
+                if (map.size() >= cacheSize)
+                {
+                    map.pop_oldest();
+                }
+                map.insert(key, key.size());
+            }
+        }
+        {
+            ReferenceLru<std::wstring, size_t> map;
+            for (const auto& key : keys)
+            {
+                if (map.find(key) != map.list.end())
+                {
+                    referenceHits++;
+                    continue;
+                }
+                if (map.list.size() >= cacheSize)
+                {
+                    map.pop_oldest();
+                }
+                map.insert(key, key.size());
+            }
+        }
+
+        VERIFY_ARE_EQUAL(referenceHits, hits);
+    }
+};
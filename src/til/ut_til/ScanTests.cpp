@@ -0,0 +1,270 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include <til/scan.h>
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+// The lengths cover the scalar-only case (< 8), the SSE2/NEON-only case (8-15) and all
+// combinations of AVX2 blocks with SSE2 blocks and scalar remainders after them.
+static constexpr size_t maxLength = 80;
+
+// Offsets at which single code units are placed when testing all 65536 of them.
+// They're at the start, in the middle and at the end of blocks of each size.
+static constexpr std::array<size_t, 8> probeOffsets{ 0, 3, 7, 8, 15, 16, 31, 40 };
+static constexpr size_t probeLength = 48;
+
+// C0, DEL and C1 controls, like StateMachine uses it.
+static constexpr til::scan::char_class controls{ { L'\0', L'\x1f' }, { L'\x7f', L'\x9f' } };
+
+static bool referenceIsControl(const wchar_t ch) noexcept
+{
+    return ch <= 0x1f || (ch >= 0x7f && ch <= 0x9f);
+}
+
+static bool referenceEqualsIgnoreCase(const std::wstring_view a, const std::wstring_view b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (::towlower(a[i]) != ::towlower(b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+class ScanTests
+{
+    TEST_CLASS(ScanTests);
+
+    TEST_METHOD(CharClassContains)
+    {
+        static constexpr til::scan::char_class single{ { L'a', L'z' } };
+        static constexpr til::scan::char_class everything{ { L'\0', L'\xffff' } };
+
+        for (uint32_t i = 0; i <= 0xffff; ++i)
+        {
+            const auto ch = static_cast<wchar_t>(i);
+            VERIFY_ARE_EQUAL(referenceIsControl(ch), controls.contains(ch));
+            VERIFY_ARE_EQUAL(ch >= L'a' && ch <= L'z', single.contains(ch));
+            VERIFY_IS_TRUE(everything.contains(ch));
+        }
+    }
+
+    TEST_METHOD(FindFirstOfAllCodeUnits)
+    {
+        std::wstring text(probeLength, L'a');
+
+        for (uint32_t i = 0; i <= 0xffff; ++i)
+        {
+            const auto ch = static_cast<wchar_t>(i);
+            const auto isControl = referenceIsControl(ch);
+
+            for (const auto offset : probeOffsets)
+            {
+                text[offset] = ch;
+                const auto actual = til::scan::find_first_of(text, controls);
+                text[offset] = L'a';
+
+                if (actual != (isControl ? offset : til::scan::npos))
+                {
+                    VERIFY_FAIL(NoThrowString().Format(L"U+%04X at offset %zu: got %zu", i, offset, actual));
+                }
+            }
+        }
+    }
+
+    TEST_METHOD(FindFirstOfAllOffsets)
+    {
+        for (size_t length = 0; length <= maxLength; ++length)
+        {
+            std::wstring text(length, L'x');
+            VERIFY_ARE_EQUAL(til::scan::npos, til::scan::find_first_of(text, controls));
+
+            for (size_t offset = 0; offset < length; ++offset)
+            {
+                // A second match after the first one must not affect the result.
+                text[offset] = L'\x1b';
+                text[length - 1] = L'\x9b';
+                VERIFY_ARE_EQUAL(offset, til::scan::find_first_of(text, controls));
+                text[offset] = L'x';
+                text[length - 1] = L'x';
+            }
+        }
+    }
+
+    TEST_METHOD(FindNotOfAllOffsets)
+    {
+        for (size_t length = 0; length <= maxLength; ++length)
+        {
+            std::wstring text(length, L' ');
+            VERIFY_ARE_EQUAL(til::scan::npos, til::scan::find_first_not_of(text, L' '));
+            VERIFY_ARE_EQUAL(til::scan::npos, til::scan::find_last_not_of(text, L' '));
+
+            for (size_t beg = 0; beg < length; ++beg)
+            {
+                for (auto end = beg; end < length; ++end)
+                {
+                    text[beg] = L'a';
+                    text[end] = L'b';
+                    VERIFY_ARE_EQUAL(beg, til::scan::find_first_not_of(text, L' '));
+                    VERIFY_ARE_EQUAL(end, til::scan::find_last_not_of(text, L' '));
+                    text[beg] = L' ';
+                    text[end] = L' ';
+                }
+            }
+        }
+    }
+
+    TEST_METHOD(FindNotOfAllCodeUnits)
+    {
+        std::wstring text(probeLength, L' ');
+
+        for (uint32_t i = 0; i <= 0xffff; ++i)
+        {
+            const auto ch = static_cast<wchar_t>(i);
+
+            for (const auto offset : probeOffsets)
+            {
+                text[offset] = ch;
+                const auto first = til::scan::find_first_not_of(text, L' ');
+                const auto last = til::scan::find_last_not_of(text, L' ');
+                const auto expected = std::wstring_view{ text }.find_first_not_of(L' ');
+                text[offset] = L' ';
+
+                if (first != expected || last != expected)
+                {
+                    VERIFY_FAIL(NoThrowString().Format(L"U+%04X at offset %zu: got %zu and %zu", i, offset, first, last));
+                }
+            }
+        }
+    }
+
+    TEST_METHOD(IsAscii)
+    {
+        for (size_t length = 0; length <= maxLength; ++length)
+        {
+            std::wstring text(length, L'\x7f');
+            VERIFY_IS_TRUE(til::scan::is_ascii(text));
+
+            for (size_t offset = 0; offset < length; ++offset)
+            {
+                text[offset] = L'\x80';
+                VERIFY_IS_FALSE(til::scan::is_ascii(text));
+                text[offset] = L'\x7f';
+            }
+        }
+
+        std::wstring text(probeLength, L'a');
+        for (uint32_t i = 0; i <= 0xffff; ++i)
+        {
+            for (const auto offset : probeOffsets)
+            {
+                text[offset] = static_cast<wchar_t>(i);
+                const auto actual = til::scan::is_ascii(text);
+                text[offset] = L'a';
+
+                if (actual != (i < 0x80))
+                {
+                    VERIFY_FAIL(NoThrowString().Format(L"U+%04X at offset %zu", i, offset));
+                }
+            }
+        }
+    }
+
+    TEST_METHOD(Count)
+    {
+        std::mt19937 rng{ 0 };
+
+        for (size_t length = 0; length <= maxLength; ++length)
+        {
+            for (auto iteration = 0; iteration < 100; ++iteration)
+            {
+                std::wstring text(length, L'a');
+                for (auto& ch : text)
+                {
+                    // Mix in code units whose lower or upper byte matches a line feed.
+                    static constexpr std::array<wchar_t, 4> alphabet{ L'\n', L'a', L'\x0a0a', L'\x010a' };
+                    ch = til::at(alphabet, rng() % alphabet.size());
+                }
+
+                const auto expected = static_cast<size_t>(std::count(text.begin(), text.end(), L'\n'));
+                VERIFY_ARE_EQUAL(expected, til::scan::count(text, L'\n'));
+            }
+        }
+    }
+
+    TEST_METHOD(EqualsIgnoreCaseAllCodeUnits)
+    {
+        std::wstring a(probeLength, L'q');
+        std::wstring b(probeLength, L'Q');
+
+        for (uint32_t i = 0; i <= 0xffff; ++i)
+        {
+            const auto ch = static_cast<wchar_t>(i);
+
+            // Each code unit is compared against its upper and lower case variant as well as its neighbor.
+            for (const auto other : { static_cast<wchar_t>(::towupper(ch)), static_cast<wchar_t>(::towlower(ch)), static_cast<wchar_t>(ch ^ 0x20) })
+            {
+                for (const auto offset : probeOffsets)
+                {
+                    a[offset] = ch;
+                    b[offset] = other;
+                    const auto expected = referenceEqualsIgnoreCase(a, b);
+                    const auto actual = til::scan::equals_ignore_case(a, b);
+                    a[offset] = L'q';
+                    b[offset] = L'Q';
+
+                    if (actual != expected)
+                    {
+                        VERIFY_FAIL(NoThrowString().Format(L"U+%04X vs. U+%04X at offset %zu", i, other, offset));
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_METHOD(EqualsIgnoreCaseRandomized)
+    {
+        std::mt19937 rng{ 0 };
+        static constexpr std::array<wchar_t, 12> alphabet{ L'A', L'Z', L'a', L'z', L'@', L'[', L'`', L'{', L'\x00c4', L'\x00e4', L'\x0130', L'\x212a' };
+
+        for (size_t length = 0; length <= maxLength; ++length)
+        {
+            for (auto iteration = 0; iteration < 100; ++iteration)
+            {
+                std::wstring a(length, L'a');
+                for (auto& ch : a)
+                {
+                    ch = til::at(alphabet, rng() % alphabet.size());
+                }
+
+                auto b = a;
+                for (auto& ch : b)
+                {
+                    if (rng() % 2)
+                    {
+                        ch = static_cast<wchar_t>(::towupper(ch));
+                    }
+                }
+                if (length && rng() % 2)
+                {
+                    b[rng() % length] = til::at(alphabet, rng() % alphabet.size());
+                }
+
+                VERIFY_ARE_EQUAL(referenceEqualsIgnoreCase(a, b), til::scan::equals_ignore_case(a, b));
+            }
+        }
+
+        VERIFY_IS_FALSE(til::scan::equals_ignore_case(L"abc", L"ab"));
+    }
+};
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "HeadlessRenderData.hpp"
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Types;
+
+HeadlessRenderData::HeadlessRenderData(HeadlessTerminal& terminal, const RenderSettings& renderSettings) :
+    _terminal{ terminal },
+    _renderSettings{ renderSettings },
+    _fontInfo{ L"Consolas", 0, 0, { 8, 16 }, CP_UTF8 }
+{
+}
+
+Viewport HeadlessRenderData::GetViewport() noexcept
+{
+    return Viewport::FromExclusive(_terminal.GetViewport());
+}
+
+til::point HeadlessRenderData::GetTextBufferEndPosition() const noexcept
+{
+    const auto viewport = _terminal.GetViewport();
+    return { viewport.right - 1, viewport.bottom - 1 };
+}
+
+const TextBuffer& HeadlessRenderData::GetTextBuffer() const noexcept
+{
+    return _terminal.GetTextBuffer();
+}
+
+const FontInfo& HeadlessRenderData::GetFontInfo() const noexcept
+{
+    return _fontInfo;
+}
+
+std::vector<Viewport> HeadlessRenderData::GetSelectionRects() noexcept
+try
+{
+    std::vector<Viewport> result;
+    if (_selection)
+    {
+        const auto [anchor, end] = *_selection;
+        const auto left = std::min(anchor.x, end.x);
+        const auto right = std::max(anchor.x, end.x);
+        for (auto y = std::min(anchor.y, end.y); y <= std::max(anchor.y, end.y); ++y)
+        {
+            result.emplace_back(Viewport::FromInclusive({ left, y, right, y }));
+        }
+    }
+    return result;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return {};
+}
+
+void HeadlessRenderData::LockConsole() noexcept
+{
+}
+
+void HeadlessRenderData::UnlockConsole() noexcept
+{
+}
+
+til::point HeadlessRenderData::GetCursorPosition() const noexcept
+{
+    return GetTextBuffer().GetCursor().GetPosition();
+}
+
+bool HeadlessRenderData::IsCursorVisible() const noexcept
+{
+    return GetTextBuffer().GetCursor().IsVisible();
+}
+
+bool HeadlessRenderData::IsCursorOn() const noexcept
+{
+    return GetTextBuffer().GetCursor().IsOn();
+}
+
+ULONG HeadlessRenderData::GetCursorHeight() const noexcept
+{
+    return GetTextBuffer().GetCursor().GetSize();
+}
+
+CursorType HeadlessRenderData::GetCursorStyle() const noexcept
+{
+    return GetTextBuffer().GetCursor().GetType();
+}
+
+ULONG HeadlessRenderData::GetCursorPixelWidth() const noexcept
+{
+    return 1;
+}
+
+bool HeadlessRenderData::IsCursorDoubleWidth() const noexcept
+{
+    const auto& buffer = GetTextBuffer();
+    const auto position = buffer.GetCursor().GetPosition();
+    return buffer.GetRowByOffset(position.y).DbcsAttrAt(position.x) != DbcsAttribute::Single;
+}
+
+const std::vector<RenderOverlay> HeadlessRenderData::GetOverlays() const noexcept
+{
+    return {};
+}
+
+const bool HeadlessRenderData::IsGridLineDrawingAllowed() noexcept
+{
+    return true;
+}
+
+const std::wstring_view HeadlessRenderData::GetConsoleTitle() const noexcept
+{
+    return L"RenderBench";
+}
+
+const std::wstring HeadlessRenderData::GetHyperlinkUri(uint16_t id) const
+{
+    return GetTextBuffer().GetHyperlinkUriFromId(id);
+}
+
+const std::wstring HeadlessRenderData::GetHyperlinkCustomId(uint16_t id) const
+{
+    return GetTextBuffer().GetCustomIdFromId(id);
+}
+
+void HeadlessRenderData::GetPatternsInRow(const til::point begin, const til::CoordType endX, std::vector<PatternInterval>& patterns) const
+{
+    // The same query as Terminal::GetPatternsInRow(). The stop of a match is exclusive.
+    _patterns.visit_overlapping({ begin.x + 1, begin.y }, { endX - 1, begin.y }, [&](const auto& interval) {
+        patterns.emplace_back(interval);
+    });
+}
+
+std::pair<COLORREF, COLORREF> HeadlessRenderData::GetAttributeColors(const TextAttribute& attr) const noexcept
+{
+    return _renderSettings.GetAttributeColors(attr);
+}
+
+const bool HeadlessRenderData::IsSelectionActive() const
+{
+    return _selection.has_value();
+}
+
+const bool HeadlessRenderData::IsBlockSelection() const
+{
+    return true;
+}
+
+void HeadlessRenderData::ClearSelection()
+{
+    _selection.reset();
+}
+
+void HeadlessRenderData::SelectNewRegion(const til::point coordStart, const til::point coordEnd)
+{
+    _selection.emplace(coordStart, coordEnd);
+}
+
+const til::point HeadlessRenderData::GetSelectionAnchor() const noexcept
+{
+    return _selection ? _selection->first : til::point{};
+}
+
+const til::point HeadlessRenderData::GetSelectionEnd() const noexcept
+{
+    return _selection ? _selection->second : til::point{};
+}
+
+void HeadlessRenderData::ColorSelection(const til::point /*coordSelectionStart*/, const til::point /*coordSelectionEnd*/, const TextAttribute /*attr*/)
+{
+}
+
+const bool HeadlessRenderData::IsUiaDataInitialized() const noexcept
+{
+    return true;
+}
+
+void HeadlessRenderData::SetPatterns(interval_tree::IntervalTree<til::point, size_t> patterns)
+{
+    _patterns = std::move(patterns);
+}
@@ -0,0 +1,71 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- HeadlessRenderData.hpp
+
+Abstract:
+- A minimal IRenderData implementation on top of VtBench's HeadlessTerminal,
+  so that the Renderer can paint its buffer without a console or a window.
+- It only supports what RenderBench needs: a block selection, pattern matches and a fixed title.
+  There's no locking, because the benchmark is single-threaded.
+--*/
+
+#pragma once
+
+#include "../vtbench/HeadlessTerminal.hpp"
+
+class HeadlessRenderData final : public Microsoft::Console::Render::IRenderData
+{
+public:
+    using Viewport = Microsoft::Console::Types::Viewport;
+
+    HeadlessRenderData(HeadlessTerminal& terminal, const Microsoft::Console::Render::RenderSettings& renderSettings);
+
+#pragma region IRenderData
+    Viewport GetViewport() noexcept override;
+    til::point GetTextBufferEndPosition() const noexcept override;
+    const TextBuffer& GetTextBuffer() const noexcept override;
+    const FontInfo& GetFontInfo() const noexcept override;
+    std::vector<Viewport> GetSelectionRects() noexcept override;
+    void LockConsole() noexcept override;
+    void UnlockConsole() noexcept override;
+
+    til::point GetCursorPosition() const noexcept override;
+    bool IsCursorVisible() const noexcept override;
+    bool IsCursorOn() const noexcept override;
+    ULONG GetCursorHeight() const noexcept override;
+    CursorType GetCursorStyle() const noexcept override;
+    ULONG GetCursorPixelWidth() const noexcept override;
+    bool IsCursorDoubleWidth() const noexcept override;
+    const std::vector<Microsoft::Console::Render::RenderOverlay> GetOverlays() const noexcept override;
+    const bool IsGridLineDrawingAllowed() noexcept override;
+    const std::wstring_view GetConsoleTitle() const noexcept override;
+    const std::wstring GetHyperlinkUri(uint16_t id) const override;
+    const std::wstring GetHyperlinkCustomId(uint16_t id) const override;
+    void GetPatternsInRow(const til::point begin, const til::CoordType endX, std::vector<Microsoft::Console::Render::PatternInterval>& patterns) const override;
+
+    std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept override;
+    const bool IsSelectionActive() const override;
+    const bool IsBlockSelection() const override;
+    void ClearSelection() override;
+    void SelectNewRegion(const til::point coordStart, const til::point coordEnd) override;
+    const til::point GetSelectionAnchor() const noexcept override;
+    const til::point GetSelectionEnd() const noexcept override;
+    void ColorSelection(const til::point coordSelectionStart, const til::point coordSelectionEnd, const TextAttribute attr) override;
+    const bool IsUiaDataInitialized() const noexcept override;
+#pragma endregion
+
+    // Sets the matches that GetPatternsInRow() returns, in viewport coordinates, like Terminal::UpdatePatternsUnderLock().
+    void SetPatterns(interval_tree::IntervalTree<til::point, size_t> patterns);
+
+private:
+    HeadlessTerminal& _terminal;
+    const Microsoft::Console::Render::RenderSettings& _renderSettings;
+    FontInfo _fontInfo;
+
+    // In buffer coordinates. The selection is a block from the anchor to the end (inclusive).
+    std::optional<std::pair<til::point, til::point>> _selection;
+    interval_tree::IntervalTree<til::point, size_t> _patterns;
+};
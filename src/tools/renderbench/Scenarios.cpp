@@ -0,0 +1,245 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "Scenarios.hpp"
+
+using namespace Microsoft::Console::Types;
+
+// The fixed seed keeps the screens identical across runs.
+static constexpr uint32_t seed = 0x5eed;
+
+static constexpr std::wstring_view words[]{
+    L"build", L"warning", L"src", L"terminal", L"parser", L"adapter", L"buffer", L"render",
+    L"0x7ffe", L"[INFO]", L"compile", L"link", L"done", L"ms", L"ok", L"test", L"passed",
+};
+
+// Writes every row of the viewport with the given generator. Every row is cursor addressed,
+// so that the screen doesn't scroll, and the cursor ends up at the start of the last row.
+template<typename Generator>
+static void fillScreen(HeadlessTerminal& terminal, Generator&& generator)
+{
+    const auto viewport = terminal.GetViewport();
+    std::minstd_rand rng{ seed };
+    std::wstring text;
+
+    for (til::CoordType y = 0; y < viewport.height(); ++y)
+    {
+        fmt::format_to(std::back_inserter(text), FMT_COMPILE(L"\x1b[{};1H"), y + 1);
+        generator(text, rng, viewport.width());
+        text.append(L"\x1b[m");
+    }
+
+    fmt::format_to(std::back_inserter(text), FMT_COMPILE(L"\x1b[{};1H"), viewport.height());
+    terminal.Write(text);
+}
+
+// Plain log output: words separated by spaces.
+static void appendAscii(std::wstring& out, std::minstd_rand& rng, const til::CoordType width)
+{
+    til::CoordType column = 0;
+    for (;;)
+    {
+        const auto& word = words[rng() % std::size(words)];
+        const auto length = gsl::narrow_cast<til::CoordType>(word.size());
+        if (column + length + 1 > width)
+        {
+            break;
+        }
+        out.append(word);
+        out.push_back(L' ');
+        column += length + 1;
+    }
+}
+
+static void setupAscii(ScenarioContext& context)
+{
+    fillScreen(context.terminal, appendAscii);
+}
+
+// A 24-bit color for every single cell, which means that the renderer can't merge any cells into runs.
+static void setupSgr(ScenarioContext& context)
+{
+    fillScreen(context.terminal, [](std::wstring& out, std::minstd_rand& rng, const til::CoordType width) {
+        for (til::CoordType column = 0; column < width; ++column)
+        {
+            fmt::format_to(std::back_inserter(out), FMT_COMPILE(L"\x1b[38;2;{};{};{}m{}"), rng() & 0xff, rng() & 0xff, rng() & 0xff, static_cast<wchar_t>(L'!' + rng() % 94));
+        }
+    });
+}
+
+// Wide CJK ideographs interspersed with some ASCII.
+static void setupCjk(ScenarioContext& context)
+{
+    fillScreen(context.terminal, [](std::wstring& out, std::minstd_rand& rng, const til::CoordType width) {
+        for (til::CoordType column = 0; column + 4 <= width;)
+        {
+            if (rng() % 8 == 0)
+            {
+                out.append(L"abc ");
+                column += 4;
+            }
+            else
+            {
+                out.push_back(static_cast<wchar_t>(0x4E00 + rng() % 0x5000));
+                column += 2;
+            }
+        }
+    });
+}
+
+// Underlined, double underlined and struck through words, as well as hyperlinks.
+// Every one of them is painted with PaintBufferGridLines on top of the text.
+static void setupGridLines(ScenarioContext& context)
+{
+    fillScreen(context.terminal, [](std::wstring& out, std::minstd_rand& rng, const til::CoordType width) {
+        static constexpr std::wstring_view styles[]{ L"\x1b[4m", L"\x1b[21m", L"\x1b[9m", L"\x1b[m" };
+
+        til::CoordType column = 0;
+        for (auto i = 0;; ++i)
+        {
+            const auto& word = words[rng() % std::size(words)];
+            const auto length = gsl::narrow_cast<til::CoordType>(word.size());
+            if (column + length + 1 > width)
+            {
+                break;
+            }
+            if (i % 5 == 4)
+            {
+                fmt::format_to(std::back_inserter(out), FMT_COMPILE(L"\x1b]8;;https://example.com/{}\x1b\\{}\x1b]8;;\x1b\\ "), rng() % 4096, word);
+            }
+            else
+            {
+                fmt::format_to(std::back_inserter(out), FMT_COMPILE(L"{}{}\x1b[m "), styles[i % std::size(styles)], word);
+            }
+            column += length + 1;
+        }
+    });
+}
+
+// Log output with a URL every few words, matched by a copy of Terminal's linkPattern.
+// The renderer looks up the matches of every line it captures.
+static void setupPatterns(ScenarioContext& context)
+{
+    static constexpr std::wstring_view linkPattern{ LR"(\b(https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])" };
+
+    fillScreen(context.terminal, [](std::wstring& out, std::minstd_rand& rng, const til::CoordType width) {
+        til::CoordType column = 0;
+        for (auto i = 0;; ++i)
+        {
+            const auto& word = words[rng() % std::size(words)];
+            const auto length = gsl::narrow_cast<til::CoordType>(word.size()) + (i % 4 == 3 ? 20 : 0);
+            if (column + length + 1 > width)
+            {
+                break;
+            }
+            if (i % 4 == 3)
+            {
+                fmt::format_to(std::back_inserter(out), FMT_COMPILE(L"https://example.com/{} "), word);
+            }
+            else
+            {
+                fmt::format_to(std::back_inserter(out), FMT_COMPILE(L"{} "), word);
+            }
+            column += length + 1;
+        }
+    });
+
+    auto& buffer = context.terminal.GetTextBuffer();
+    const auto viewport = context.terminal.GetViewport();
+    buffer.AddPatternRecognizer(linkPattern);
+    context.renderData.SetPatterns(buffer.GetPatterns(viewport.top, viewport.bottom - 1));
+}
+
+// Nothing changes on the screen, but the renderer is asked to paint all of it,
+// like after a resize or a change of the color scheme.
+static void stepRedrawAll(ScenarioContext& context, const size_t /*frame*/)
+{
+    context.renderer.TriggerRedrawAll();
+}
+
+// A block selection that grows and shrinks by one column every frame, like dragging the mouse.
+static void stepSelection(ScenarioContext& context, const size_t frame)
+{
+    const auto viewport = context.terminal.GetViewport();
+    const auto width = viewport.width();
+    const auto column = gsl::narrow_cast<til::CoordType>(frame % gsl::narrow_cast<size_t>(width));
+    context.renderData.SelectNewRegion({ 0, viewport.top + 1 }, { column, viewport.bottom - 2 });
+    context.renderer.TriggerSelection();
+}
+
+// One new line of output at the bottom of the screen per frame. The buffer is exactly as
+// large as the viewport, so it rotates and the renderer is asked to scroll, like in a terminal.
+static void stepScroll(ScenarioContext& context, const size_t frame)
+{
+    // Seeded by the frame, so that every iteration scrolls in the same lines.
+    std::minstd_rand rng{ seed + gsl::narrow_cast<uint32_t>(frame) };
+
+    const auto rotatedRows = context.terminal.GetCounters().rotatedRows;
+
+    std::wstring text{ L"\r\n" };
+    appendAscii(text, rng, context.terminal.GetViewport().width());
+    context.terminal.Write(text);
+
+    const auto delta = gsl::narrow_cast<til::CoordType>(context.terminal.GetCounters().rotatedRows - rotatedRows);
+    if (delta != 0)
+    {
+        const til::point scroll{ 0, -delta };
+        context.renderer.TriggerScroll(&scroll);
+    }
+
+    const auto viewport = context.terminal.GetViewport();
+    context.renderer.TriggerRedraw(Viewport::FromExclusive({ viewport.left, viewport.bottom - 1, viewport.right, viewport.bottom }));
+}
+
+// One character per frame, like someone typing at a shell prompt. Only the
+// changed cell and the cursor are invalidated. The line is cleared once it's full.
+static void stepTyping(ScenarioContext& context, const size_t frame)
+{
+    const auto& cursor = context.terminal.GetTextBuffer().GetCursor();
+    const auto width = gsl::narrow_cast<size_t>(context.terminal.GetViewport().width());
+
+    if (frame % width == 0)
+    {
+        context.terminal.Write(L"\r\x1b[K");
+        const auto row = cursor.GetPosition().y;
+        context.renderer.TriggerRedraw(Viewport::FromExclusive({ 0, row, gsl::narrow_cast<til::CoordType>(width), row + 1 }));
+    }
+
+    const auto before = cursor.GetPosition();
+    const wchar_t ch = static_cast<wchar_t>(L'a' + frame % 26);
+    context.terminal.Write({ &ch, 1 });
+    const auto after = cursor.GetPosition();
+
+    context.renderer.TriggerRedraw(&before);
+    context.renderer.TriggerRedrawCursor(&before);
+    context.renderer.TriggerRedrawCursor(&after);
+}
+
+static constexpr Scenario builtinScenarios[]{
+    { L"ascii", L"Full repaint of a screen of plain text", setupAscii, stepRedrawAll },
+    { L"sgr", L"Full repaint of a screen with a different color in every cell", setupSgr, stepRedrawAll },
+    { L"cjk", L"Full repaint of a screen of wide CJK ideographs", setupCjk, stepRedrawAll },
+    { L"gridlines", L"Full repaint of underlines, strikethroughs and hyperlinks", setupGridLines, stepRedrawAll },
+    { L"patterns", L"Full repaint of a screen with URLs that are matched as patterns", setupPatterns, stepRedrawAll },
+    { L"selection", L"A block selection that changes every frame", setupAscii, stepSelection },
+    { L"scroll", L"A new line of output at the bottom of the screen every frame", setupAscii, stepScroll },
+    { L"typing", L"A single new character and the cursor every frame", setupAscii, stepTyping },
+};
+
+std::span<const Scenario> Scenarios::Builtin() noexcept
+{
+    return builtinScenarios;
+}
+
+const Scenario* Scenarios::Find(const std::wstring_view name) noexcept
+{
+    for (const auto& scenario : builtinScenarios)
+    {
+        if (scenario.name == name)
+        {
+            return &scenario;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,43 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- Scenarios.hpp
+
+Abstract:
+- The canned buffer states RenderBench paints. Each one writes its initial screen
+  contents through the VT parser and then changes the screen between two frames,
+  telling the Renderer what changed, just like the buffer or the terminal would.
+- They're deterministic, so that results are comparable between machines and builds.
+--*/
+
+#pragma once
+
+#include "HeadlessRenderData.hpp"
+
+struct ScenarioContext
+{
+    HeadlessTerminal& terminal;
+    HeadlessRenderData& renderData;
+    Microsoft::Console::Render::Renderer& renderer;
+};
+
+struct Scenario
+{
+    std::wstring_view name;
+    std::wstring_view description;
+    // Writes the initial contents of the screen.
+    void (*setup)(ScenarioContext& context);
+    // Changes the screen for the given frame and invalidates what changed.
+    void (*step)(ScenarioContext& context, size_t frame);
+};
+
+namespace Scenarios
+{
+    // All scenarios, in the order they're run by default.
+    std::span<const Scenario> Builtin() noexcept;
+
+    // Returns nullptr if there's no scenario with that name.
+    const Scenario* Find(const std::wstring_view name) noexcept;
+}
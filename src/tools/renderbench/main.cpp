@@ -0,0 +1,246 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// RenderBench measures the overhead of Renderer::PaintFrame: capturing the frame from
+// the TextBuffer, segmenting it into runs and replaying it to an engine. The engine is a
+// RecordingEngine that doesn't draw anything, so this runs headless (no window, no GPU,
+// no console) and prints its results as JSON.
+
+#include "precomp.h"
+
+#include "Scenarios.hpp"
+
+#include "../vtbench/Timing.hpp"
+#include "../../renderer/inc/RecordingEngine.hpp"
+
+using namespace Microsoft::Console::Render;
+
+struct Options
+{
+    til::size viewport{ 120, 30 };
+    size_t frames = 1000;
+    int iterations = 5;
+    // Like a window with a VT engine and a UIA engine attached, each of them gets the same frame.
+    size_t engines = 1;
+    RecordingEngine::Mode mode = RecordingEngine::Mode::Count;
+    std::vector<std::wstring> scenarios;
+};
+
+struct Result
+{
+    std::wstring_view scenario;
+    // The time spent in PaintFrame() per iteration. Changing the screen between frames isn't included.
+    Timing paint;
+    uint64_t paintedFrames = 0;
+    std::array<uint64_t, RecordingEngine::CallCount> calls{};
+    size_t records = 0;
+    size_t textLength = 0;
+    uint64_t droppedRecords = 0;
+};
+
+static Result runScenario(const Options& options, const Scenario& scenario)
+{
+    Result result;
+    result.scenario = scenario.name;
+
+    HeadlessTerminal terminal{ options.viewport, 0 };
+    RenderSettings renderSettings;
+    HeadlessRenderData renderData{ terminal, renderSettings };
+    std::vector<std::unique_ptr<RecordingEngine>> recordingEngines;
+    std::vector<IRenderEngine*> engines;
+    for (size_t i = 0; i < options.engines; ++i)
+    {
+        engines.emplace_back(recordingEngines.emplace_back(std::make_unique<RecordingEngine>(options.mode)).get());
+    }
+    // The results are taken from the first engine. The others make the same calls.
+    auto& engine = *recordingEngines.front();
+    // There's no render thread. We call PaintFrame() ourselves.
+    Renderer renderer{ renderSettings, &renderData, engines.data(), engines.size(), nullptr };
+
+    ScenarioContext context{ terminal, renderData, renderer };
+    scenario.setup(context);
+
+    // The first frame picks up the viewport and paints the initial screen.
+    THROW_IF_FAILED(renderer.PaintFrame());
+
+    for (auto i = 0; i < options.iterations; ++i)
+    {
+        for (const auto& e : recordingEngines)
+        {
+            e->Reset();
+        }
+
+        Clock::duration elapsed{};
+        for (size_t frame = 0; frame < options.frames; ++frame)
+        {
+            scenario.step(context, frame);
+
+            const auto start = Clock::now();
+            THROW_IF_FAILED(renderer.PaintFrame());
+            elapsed += Clock::now() - start;
+        }
+        result.paint.Add(std::chrono::duration<double>(elapsed).count());
+    }
+
+    // The scenarios are deterministic, so every iteration makes the same calls.
+    result.paintedFrames = engine.GetFrameCount();
+    for (size_t call = 0; call < RecordingEngine::CallCount; ++call)
+    {
+        til::at(result.calls, call) = engine.GetCallCount(static_cast<RecordingEngine::Call>(call));
+    }
+    for (const auto& record : engine.GetRecords())
+    {
+        result.textLength += record.textLength;
+    }
+    result.records = engine.GetRecords().size();
+    result.droppedRecords = engine.GetDroppedRecordCount();
+
+    return result;
+}
+
+static void printResults(const Options& options, const std::vector<Result>& results)
+{
+    std::string out;
+    auto it = std::back_inserter(out);
+
+    fmt::format_to(it, FMT_COMPILE("{{\n  \"viewport\": {{ \"width\": {}, \"height\": {} }},\n  \"frames\": {},\n  \"iterations\": {},\n  \"engines\": {},\n  \"mode\": \"{}\",\n  \"results\": ["), options.viewport.width, options.viewport.height, options.frames, options.iterations, options.engines, options.mode == RecordingEngine::Mode::Record ? "record" : "count");
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& r = results[i];
+        const auto frames = static_cast<double>(options.frames);
+        const auto fps = [&](double seconds) { return seconds > 0 ? frames / seconds : 0.0; };
+        const auto painted = std::max<uint64_t>(1, r.paintedFrames);
+
+        fmt::format_to(it, FMT_COMPILE("{}\n    {{\n      \"scenario\": \"{}\",\n      \"paintedFrames\": {},\n"), i ? "," : "", til::u16u8(r.scenario), r.paintedFrames);
+        fmt::format_to(it, FMT_COMPILE("      \"fps\": {{ \"best\": {:.1f}, \"mean\": {:.1f} }},\n"), fps(r.paint.best), fps(r.paint.Mean()));
+        fmt::format_to(it, FMT_COMPILE("      \"frameMicroseconds\": {{ \"best\": {:.3f}, \"mean\": {:.3f} }},\n"), r.paint.best / frames * 1e6, r.paint.Mean() / frames * 1e6);
+
+        // Only the calls that were actually made, to keep the output readable.
+        out.append("      \"callsPerFrame\": {");
+        auto first = true;
+        for (size_t call = 0; call < RecordingEngine::CallCount; ++call)
+        {
+            if (const auto count = til::at(r.calls, call))
+            {
+                const auto name = RecordingEngine::GetCallName(static_cast<RecordingEngine::Call>(call));
+                fmt::format_to(it, FMT_COMPILE("{}\n        \"{}\": {:.2f}"), first ? "" : ",", name, static_cast<double>(count) / painted);
+                first = false;
+            }
+        }
+        out.append("\n      }");
+
+        if (options.mode == RecordingEngine::Mode::Record)
+        {
+            fmt::format_to(it, FMT_COMPILE(",\n      \"recording\": {{ \"records\": {}, \"textLength\": {}, \"droppedRecords\": {} }}"), r.records, r.textLength, r.droppedRecords);
+        }
+
+        out.append("\n    }");
+    }
+
+    out.append("\n  ]\n}\n");
+    fwrite(out.data(), 1, out.size(), stdout);
+}
+
+static void printUsage()
+{
+    fwprintf(stderr, L"Usage: RenderBench.exe [options]\r\n");
+    fwprintf(stderr, L"  --scenario <name>    Run only the given scenario. May be repeated.\r\n");
+    fwprintf(stderr, L"                       Built-in:");
+    for (const auto& scenario : Scenarios::Builtin())
+    {
+        fwprintf(stderr, L" %.*s", gsl::narrow_cast<int>(scenario.name.size()), scenario.name.data());
+    }
+    fwprintf(stderr, L"\r\n");
+    fwprintf(stderr, L"  --frames <n>         Number of frames per iteration. Default: 1000\r\n");
+    fwprintf(stderr, L"  --iterations <n>     Number of runs per scenario. Default: 5\r\n");
+    fwprintf(stderr, L"  --viewport <w>x<h>   Viewport size. Default: 120x30\r\n");
+    fwprintf(stderr, L"  --engines <n>        Number of engines that paint each frame. Default: 1\r\n");
+    fwprintf(stderr, L"  --record             Record every call instead of only counting them.\r\n");
+}
+
+static bool parseOptions(int argc, wchar_t* argv[], Options& options)
+{
+    for (auto i = 1; i < argc; ++i)
+    {
+        const std::wstring_view arg{ argv[i] };
+        const auto hasValue = i + 1 < argc;
+
+        if (arg == L"--scenario" && hasValue)
+        {
+            options.scenarios.emplace_back(argv[++i]);
+        }
+        else if (arg == L"--frames" && hasValue)
+        {
+            options.frames = static_cast<size_t>(std::max(1, _wtoi(argv[++i])));
+        }
+        else if (arg == L"--iterations" && hasValue)
+        {
+            options.iterations = std::max(1, _wtoi(argv[++i]));
+        }
+        else if (arg == L"--viewport" && hasValue)
+        {
+            if (swscanf_s(argv[++i], L"%dx%d", &options.viewport.width, &options.viewport.height) != 2 ||
+                options.viewport.width <= 0 || options.viewport.height <= 0)
+            {
+                return false;
+            }
+        }
+        else if (arg == L"--engines" && hasValue)
+        {
+            options.engines = static_cast<size_t>(std::clamp(_wtoi(argv[++i]), 1, 8));
+        }
+        else if (arg == L"--record")
+        {
+            options.mode = RecordingEngine::Mode::Record;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // Without any explicit selection we run all the built-in scenarios.
+    if (options.scenarios.empty())
+    {
+        for (const auto& scenario : Scenarios::Builtin())
+        {
+            options.scenarios.emplace_back(scenario.name);
+        }
+    }
+
+    return true;
+}
+
+int __cdecl wmain(int argc, wchar_t* argv[])
+try
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return E_INVALIDARG;
+    }
+
+    std::vector<Result> results;
+
+    for (const auto& name : options.scenarios)
+    {
+        const auto scenario = Scenarios::Find(name);
+        if (!scenario)
+        {
+            fwprintf(stderr, L"Unknown scenario '%s'\r\n", name.c_str());
+            return E_INVALIDARG;
+        }
+        fwprintf(stderr, L"Running '%s'...\r\n", name.c_str());
+        results.emplace_back(runScenario(options, *scenario));
+    }
+
+    printResults(options, results);
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return wil::ResultFromCaughtException();
+}
@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "Corpus.hpp"
+
+#include "../../types/inc/VtRecording.hpp"
+
+// All generators produce 120 column wide output, which is wider than the default
+// viewport, so that wrapping is exercised as well. The fixed seed keeps the
+// streams identical across runs.
+static constexpr int lineWidth = 120;
+static constexpr uint32_t seed = 0x5eed;
+
+static constexpr std::wstring_view builtinNames[]{
+    L"ascii",
+    L"cjk",
+    L"sgr",
+    L"tui",
+    L"hyperlink",
+    L"seq",
+};
+
+static constexpr std::wstring_view words[]{
+    L"build", L"warning", L"src", L"terminal", L"parser", L"adapter", L"buffer", L"render",
+    L"0x7ffe", L"[INFO]", L"compile", L"link", L"done", L"ms", L"ok", L"test", L"passed",
+};
+
+// Plain log output: words separated by spaces, wrapped at lineWidth.
+static void generateAscii(std::wstring& out, std::mt19937& rng, const size_t /*line*/)
+{
+    int column = 0;
+    while (column < lineWidth)
+    {
+        const auto& word = words[rng() % std::size(words)];
+        out.append(word);
+        out.push_back(L' ');
+        column += static_cast<int>(word.size()) + 1;
+    }
+    out.append(L"\r\n");
+}
+
+// Wide CJK ideographs interspersed with some ASCII.
+static void generateCjk(std::wstring& out, std::mt19937& rng, const size_t /*line*/)
+{
+    int column = 0;
+    while (column < lineWidth)
+    {
+        if (rng() % 8 == 0)
+        {
+            out.append(L"abc ");
+            column += 4;
+        }
+        else
+        {
+            out.push_back(static_cast<wchar_t>(0x4E00 + rng() % 0x5000));
+            column += 2;
+        }
+    }
+    out.append(L"\r\n");
+}
+
+// A 24-bit SGR sequence for every single cell, like colorized diffs or gradients.
+static void generateSgr(std::wstring& out, std::mt19937& rng, const size_t /*line*/)
+{
+    for (int column = 0; column < lineWidth; ++column)
+    {
+        fmt::format_to(std::back_inserter(out), FMT_COMPILE(L"\x1b[38;2;{};{};{}m{}"), rng() & 0xff, rng() & 0xff, rng() & 0xff, static_cast<wchar_t>(L'!' + rng() % 94));
+        if (column % 16 == 0)
+        {
+            out.append(L"\x1b[1;4m");
+        }
+    }
+    out.append(L"\x1b[m\r\n");
+}
+
+// Cursor addressed updates as produced by full-screen TUIs: CUP, short text,
+// EL and the occasional full repaint via ED.
+static void generateTui(std::wstring& out, std::mt19937& rng, const size_t /*line*/)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        const auto row = 1 + rng() % 30;
+        const auto col = 1 + rng() % 100;
+        fmt::format_to(std::back_inserter(out), FMT_COMPILE(L"\x1b[{};{}H\x1b[7m{}\x1b[27m {:>8}\x1b[K"), row, col, words[rng() % std::size(words)], rng() % 100000);
+    }
+    if (rng() % 64 == 0)
+    {
+        out.append(L"\x1b[H\x1b[2J");
+    }
+}
+
+// Output like that of `ls --hyperlink`, where every entry is an OSC 8 hyperlink.
+static void generateHyperlink(std::wstring& out, std::mt19937& rng, const size_t /*line*/)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto& word = words[rng() % std::size(words)];
+        fmt::format_to(std::back_inserter(out), FMT_COMPILE(L"\x1b]8;id={};file://host/home/user/{}/{}\x1b\\{}-{}\x1b]8;;\x1b\\  "), rng() % 4096, word, rng(), word, rng() % 1000);
+    }
+    out.append(L"\r\n");
+}
+
+// The output of `seq`: one short line after the other. Nothing but text and line feeds
+// at the bottom of the buffer, which makes it the worst case for scrolling.
+// With --size 8 that's a little over a million lines.
+static void generateSeq(std::wstring& out, std::mt19937& /*rng*/, const size_t line)
+{
+    fmt::format_to(std::back_inserter(out), FMT_COMPILE(L"{}\r\n"), line + 1);
+}
+
+std::span<const std::wstring_view> Corpora::BuiltinNames() noexcept
+{
+    return builtinNames;
+}
+
+std::optional<Corpus> Corpora::Generate(const std::wstring_view name, const size_t targetBytes)
+{
+    void (*generator)(std::wstring&, std::mt19937&, size_t) = nullptr;
+    if (name == L"ascii")
+    {
+        generator = generateAscii;
+    }
+    else if (name == L"cjk")
+    {
+        generator = generateCjk;
+    }
+    else if (name == L"sgr")
+    {
+        generator = generateSgr;
+    }
+    else if (name == L"tui")
+    {
+        generator = generateTui;
+    }
+    else if (name == L"hyperlink")
+    {
+        generator = generateHyperlink;
+    }
+    else if (name == L"seq")
+    {
+        generator = generateSeq;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+
+    std::mt19937 rng{ seed };
+    Corpus corpus;
+    corpus.name = name;
+
+    // Every non-ASCII character we generate is in the BMP and takes 3 bytes in UTF-8.
+    // Counting them as we go is a lot cheaper than converting the whole string.
+    size_t bytes = 0;
+    for (size_t line = 0; bytes < targetBytes; ++line)
+    {
+        const auto beg = corpus.text.size();
+        generator(corpus.text, rng, line);
+        for (auto it = corpus.text.begin() + beg; it != corpus.text.end(); ++it)
+        {
+            bytes += *it < 0x80 ? 1 : (*it < 0x800 ? 2 : 3);
+        }
+    }
+
+    corpus.bytes = bytes;
+    return corpus;
+}
+
+// A session recorded by ConptyConnection (see VtRecording.hpp). Only the output frames
+// are of interest here; they're concatenated, so the timing of the session is lost.
+static Corpus loadRecording(const std::filesystem::path& path)
+{
+    using namespace Microsoft::Console::Utils;
+
+    VtRecordingReader reader{ path };
+    std::string bytes;
+    while (const auto frame = reader.Next())
+    {
+        if (frame->type == VtRecordingFrameType::Output)
+        {
+            bytes.append(frame->payload);
+        }
+    }
+
+    Corpus corpus;
+    corpus.name = path.filename().wstring();
+    corpus.text = til::u8u16(bytes);
+    corpus.bytes = bytes.size();
+    return corpus;
+}
+
+Corpus Corpora::Load(const std::filesystem::path& path)
+{
+    if (path.extension() == L".vtrec")
+    {
+        return loadRecording(path);
+    }
+
+    std::ifstream file{ path, std::ios::binary };
+    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND), !file);
+
+    const std::string bytes{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+
+    Corpus corpus;
+    corpus.name = path.filename().wstring();
+    corpus.text = til::u8u16(bytes);
+    corpus.bytes = bytes.size();
+    return corpus;
+}
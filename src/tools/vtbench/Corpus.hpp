@@ -0,0 +1,36 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- Corpus.hpp
+
+Abstract:
+- The VT streams VtBench replays. The built-in ones are generated
+  deterministically, so that results are comparable between machines and
+  builds. Recorded streams can be loaded from disk as raw UTF-8.
+--*/
+
+#pragma once
+
+struct Corpus
+{
+    std::wstring name;
+    std::wstring text;
+    // The size of the stream as it would arrive on the wire (UTF-8).
+    size_t bytes = 0;
+};
+
+namespace Corpora
+{
+    // The names of the built-in corpora, in the order they're run by default.
+    std::span<const std::wstring_view> BuiltinNames() noexcept;
+
+    // Generates the built-in corpus with the given name, roughly targetBytes in size.
+    // Returns std::nullopt if there's no corpus with that name.
+    std::optional<Corpus> Generate(const std::wstring_view name, const size_t targetBytes);
+
+    // Loads a recorded stream of raw terminal output (UTF-8) from the given file.
+    // .vtrec session recordings are supported as well.
+    Corpus Load(const std::filesystem::path& path);
+}
@@ -0,0 +1,238 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "HeadlessTerminal.hpp"
+
+using namespace Microsoft::Console::VirtualTerminal;
+
+// The buffers are created as inactive buffers: an active TextBuffer forwards every change to the
+// Renderer, which in turn needs an IRenderData. We want to measure the parser, the adapter and
+// the buffer here, not the (engine-less) renderer bookkeeping.
+HeadlessTerminal::HeadlessTerminal(const til::size viewportSize, const til::CoordType scrollback) :
+    _viewportSize{ viewportSize },
+    _scrollback{ scrollback },
+    _terminalInput{ nullptr }
+{
+    Reset();
+}
+
+HeadlessTerminal::~HeadlessTerminal() = default;
+
+// Routine Description:
+// - Feeds the given text through the parser, just like Terminal::Write.
+void HeadlessTerminal::Write(const std::wstring_view text)
+{
+    _stateMachine->ProcessString(text);
+}
+
+// Routine Description:
+// - Recreates the buffers and the parser, so that every benchmark
+//   iteration starts from the exact same (empty) state.
+void HeadlessTerminal::Reset()
+{
+    _stateMachine.reset();
+    _altBuffer.reset();
+    _retainedAltBuffer.reset();
+
+    const til::size bufferSize{ _viewportSize.width, _viewportSize.height + _scrollback };
+    _mainBuffer = std::make_unique<TextBuffer>(bufferSize, TextAttribute{}, 0, false, _renderer);
+    _viewportOrigin = {};
+    _bracketedPasteMode = false;
+    _counters = {};
+
+    auto dispatch = std::make_unique<AdaptDispatch>(*this, _renderer, _renderer._renderSettings, _terminalInput);
+    auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+    _stateMachine = std::make_unique<StateMachine>(std::move(engine));
+}
+
+const HeadlessTerminal::Counters& HeadlessTerminal::GetCounters() const noexcept
+{
+    return _counters;
+}
+
+TextBuffer& HeadlessTerminal::_activeBuffer() const noexcept
+{
+    return _altBuffer ? *_altBuffer : *_mainBuffer;
+}
+
+void HeadlessTerminal::ReturnResponse(const std::wstring_view /*response*/)
+{
+    _counters.responses++;
+}
+
+StateMachine& HeadlessTerminal::GetStateMachine()
+{
+    return *_stateMachine;
+}
+
+TextBuffer& HeadlessTerminal::GetTextBuffer()
+{
+    return _activeBuffer();
+}
+
+til::rect HeadlessTerminal::GetViewport() const
+{
+    // The alt buffer is exactly the size of the viewport and it doesn't scroll.
+    const auto origin = _altBuffer ? til::point{} : _viewportOrigin;
+    return { origin, _viewportSize };
+}
+
+void HeadlessTerminal::SetViewportPosition(const til::point position)
+{
+    if (!_altBuffer)
+    {
+        _viewportOrigin = position;
+        _counters.viewportMoves++;
+    }
+}
+
+bool HeadlessTerminal::IsVtInputEnabled() const
+{
+    return false;
+}
+
+void HeadlessTerminal::SetTextAttributes(const TextAttribute& attrs)
+{
+    _activeBuffer().SetCurrentAttributes(attrs);
+}
+
+void HeadlessTerminal::SetAutoWrapMode(const bool /*wrapAtEOL*/)
+{
+}
+
+bool HeadlessTerminal::GetAutoWrapMode() const
+{
+    return true;
+}
+
+void HeadlessTerminal::WarningBell()
+{
+    _counters.bells++;
+}
+
+bool HeadlessTerminal::GetLineFeedMode() const
+{
+    return false;
+}
+
+void HeadlessTerminal::SetWindowTitle(const std::wstring_view /*title*/)
+{
+    _counters.titleChanges++;
+}
+
+void HeadlessTerminal::UseAlternateScreenBuffer()
+{
+    const auto& mainCursor = _mainBuffer->GetCursor();
+    if (_retainedAltBuffer)
+    {
+        // The viewport never changes size, so the last alt buffer always fits.
+        _altBuffer = std::move(_retainedAltBuffer);
+        _altBuffer->ResetToDefaults(TextAttribute{}, mainCursor.GetSize());
+    }
+    else
+    {
+        _altBuffer = std::make_unique<TextBuffer>(_viewportSize, TextAttribute{}, mainCursor.GetSize(), false, _renderer);
+    }
+
+    // The new position should match the viewport-relative position of the main buffer.
+    auto cursorPos = mainCursor.GetPosition();
+    cursorPos.y -= _viewportOrigin.y;
+    _altBuffer->GetCursor().SetPosition(cursorPos);
+}
+
+void HeadlessTerminal::UseMainScreenBuffer()
+{
+    if (!_altBuffer)
+    {
+        return;
+    }
+
+    // This is the equal and opposite effect of what we did in UseAlternateScreenBuffer.
+    auto cursorPos = _altBuffer->GetCursor().GetPosition();
+    cursorPos.y += _viewportOrigin.y;
+    _mainBuffer->GetCursor().SetPosition(cursorPos);
+
+    _retainedAltBuffer = std::move(_altBuffer);
+}
+
+CursorType HeadlessTerminal::GetUserDefaultCursorStyle() const
+{
+    return CursorType::Legacy;
+}
+
+void HeadlessTerminal::ShowWindow(bool /*showOrHide*/)
+{
+}
+
+void HeadlessTerminal::SetConsoleOutputCP(const unsigned int /*codepage*/)
+{
+}
+
+unsigned int HeadlessTerminal::GetConsoleOutputCP() const
+{
+    return CP_UTF8;
+}
+
+void HeadlessTerminal::SetBracketedPasteMode(const bool enabled)
+{
+    _bracketedPasteMode = enabled;
+}
+
+std::optional<bool> HeadlessTerminal::GetBracketedPasteMode() const
+{
+    return _bracketedPasteMode;
+}
+
+void HeadlessTerminal::CopyToClipboard(const std::wstring_view /*content*/)
+{
+    _counters.clipboardWrites++;
+}
+
+void HeadlessTerminal::SetTaskbarProgress(const DispatchTypes::TaskbarState /*state*/, const size_t /*progress*/)
+{
+}
+
+void HeadlessTerminal::SetWorkingDirectory(const std::wstring_view /*uri*/)
+{
+}
+
+void HeadlessTerminal::PlayMidiNote(const int /*noteNumber*/, const int /*velocity*/, const std::chrono::microseconds /*duration*/)
+{
+}
+
+bool HeadlessTerminal::ResizeWindow(const til::CoordType /*width*/, const til::CoordType /*height*/)
+{
+    return false;
+}
+
+bool HeadlessTerminal::IsConsolePty() const
+{
+    return false;
+}
+
+void HeadlessTerminal::NotifyAccessibilityChange(const til::rect& /*changedRect*/)
+{
+}
+
+void HeadlessTerminal::NotifyBufferRotation(const int delta)
+{
+    _counters.bufferRotations++;
+    _counters.rotatedRows += delta;
+}
+
+void HeadlessTerminal::MarkPrompt(const DispatchTypes::ScrollMark& /*mark*/)
+{
+}
+
+void HeadlessTerminal::MarkCommandStart()
+{
+}
+
+void HeadlessTerminal::MarkOutputStart()
+{
+}
+
+void HeadlessTerminal::MarkCommandFinish(std::optional<unsigned int> /*error*/)
+{
+}
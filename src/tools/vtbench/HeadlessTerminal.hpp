@@ -0,0 +1,112 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- HeadlessTerminal.hpp
+
+Abstract:
+- A minimal ITerminalApi implementation that wires the VT parser and
+  AdaptDispatch to a plain TextBuffer, without a window, a GPU or a console.
+- It's used by VtBench to measure the StateMachine -> AdaptDispatch -> TextBuffer
+  pipeline in isolation. Everything that would normally leave the terminal
+  (responses, titles, clipboard, ...) is counted and otherwise discarded.
+--*/
+
+#pragma once
+
+#include "../../terminal/adapter/adaptDispatch.hpp"
+#include "../../terminal/parser/OutputStateMachineEngine.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+class HeadlessTerminal final : public Microsoft::Console::VirtualTerminal::ITerminalApi
+{
+public:
+    using StateMachine = Microsoft::Console::VirtualTerminal::StateMachine;
+    using DispatchTypes = Microsoft::Console::VirtualTerminal::DispatchTypes;
+
+    // Counts of the side effects that would normally be forwarded to the host.
+    struct Counters
+    {
+        size_t responses = 0;
+        size_t titleChanges = 0;
+        size_t clipboardWrites = 0;
+        size_t bufferRotations = 0;
+        // The sum of all rotations. Runs of line feeds are reported as a single rotation.
+        size_t rotatedRows = 0;
+        size_t viewportMoves = 0;
+        size_t bells = 0;
+    };
+
+    HeadlessTerminal(const til::size viewportSize, const til::CoordType scrollback);
+    ~HeadlessTerminal() override;
+
+    void Write(const std::wstring_view text);
+    void Reset();
+
+    const Counters& GetCounters() const noexcept;
+
+#pragma region ITerminalApi
+    void ReturnResponse(const std::wstring_view response) override;
+
+    StateMachine& GetStateMachine() override;
+    TextBuffer& GetTextBuffer() override;
+    til::rect GetViewport() const override;
+    void SetViewportPosition(const til::point position) override;
+
+    bool IsVtInputEnabled() const override;
+
+    void SetTextAttributes(const TextAttribute& attrs) override;
+
+    void SetAutoWrapMode(const bool wrapAtEOL) override;
+    bool GetAutoWrapMode() const override;
+
+    void WarningBell() override;
+    bool GetLineFeedMode() const override;
+    void SetWindowTitle(const std::wstring_view title) override;
+    void UseAlternateScreenBuffer() override;
+    void UseMainScreenBuffer() override;
+
+    CursorType GetUserDefaultCursorStyle() const override;
+
+    void ShowWindow(bool showOrHide) override;
+
+    void SetConsoleOutputCP(const unsigned int codepage) override;
+    unsigned int GetConsoleOutputCP() const override;
+
+    void SetBracketedPasteMode(const bool enabled) override;
+    std::optional<bool> GetBracketedPasteMode() const override;
+    void CopyToClipboard(const std::wstring_view content) override;
+    void SetTaskbarProgress(const DispatchTypes::TaskbarState state, const size_t progress) override;
+    void SetWorkingDirectory(const std::wstring_view uri) override;
+    void PlayMidiNote(const int noteNumber, const int velocity, const std::chrono::microseconds duration) override;
+
+    bool ResizeWindow(const til::CoordType width, const til::CoordType height) override;
+    bool IsConsolePty() const override;
+
+    void NotifyAccessibilityChange(const til::rect& changedRect) override;
+    void NotifyBufferRotation(const int delta) override;
+
+    void MarkPrompt(const DispatchTypes::ScrollMark& mark) override;
+    void MarkCommandStart() override;
+    void MarkOutputStart() override;
+    void MarkCommandFinish(std::optional<unsigned int> error) override;
+#pragma endregion
+
+private:
+    TextBuffer& _activeBuffer() const noexcept;
+
+    til::size _viewportSize;
+    til::CoordType _scrollback;
+    til::point _viewportOrigin;
+    bool _bracketedPasteMode = false;
+    Counters _counters;
+
+    DummyRenderer _renderer;
+    Microsoft::Console::VirtualTerminal::TerminalInput _terminalInput;
+    std::unique_ptr<TextBuffer> _mainBuffer;
+    std::unique_ptr<TextBuffer> _altBuffer;
+    // The last alt buffer, reused by the next one like Terminal does.
+    std::unique_ptr<TextBuffer> _retainedAltBuffer;
+    std::unique_ptr<StateMachine> _stateMachine;
+};
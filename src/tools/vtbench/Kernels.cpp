@@ -0,0 +1,453 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "Kernels.hpp"
+
+#include "HeadlessTerminal.hpp"
+#include "../../buffer/out/Row.hpp"
+#include "../../buffer/out/textBuffer.hpp"
+#include "../../terminal/parser/base64.hpp"
+
+#include <til/lru_hash_map.h>
+
+// Compares til::bitmap::runs() with the bit-by-bit iterator it replaced,
+// for a fully dirty map and for a typical sparse frame.
+static void kernelBitmapRuns(KernelRun& run)
+{
+    static constexpr til::size size{ 240, 80 };
+    static constexpr size_t calls = 1000;
+
+    for (const auto full : { true, false })
+    {
+        til::bitmap map{ size };
+        const auto dirty = [&]() {
+            map.reset_all();
+            if (full)
+            {
+                map.set_all();
+            }
+            else
+            {
+                // A cursor and a few changed words.
+                map.set(til::point{ 10, 5 });
+                map.set(til::rect{ 0, 40, 30, 41 });
+                map.set(til::rect{ 100, 60, 108, 61 });
+                map.set(til::rect{ 120, 60, 130, 61 });
+            }
+        };
+
+        const std::string prefix{ full ? "full" : "sparse" };
+        run.Measure(prefix + "/iterator", calls, [&]() {
+            dirty();
+            const std::vector<til::rect> runs{ map.begin(), map.end() };
+            run.Consume(runs.size());
+        });
+        run.Measure(prefix + "/runs", calls, [&]() {
+            dirty();
+            run.Consume(map.runs().size());
+        });
+    }
+}
+
+// Compares ROW::ReplaceText() for pure ASCII lines with the same lines
+// with a leading non-ASCII character, which forces the regular code point loop.
+static void kernelRowReplaceText(KernelRun& run)
+{
+    static constexpr size_t calls = 10000;
+
+    for (const uint16_t columns : { 80, 200, 1000 })
+    {
+        std::wstring ascii;
+        for (uint16_t i = 0; i < columns; ++i)
+        {
+            ascii.push_back(static_cast<wchar_t>(L'!' + i % 94));
+        }
+        auto mixed = ascii;
+        mixed[0] = L'\u00e9';
+
+        // The storage TextBuffer would normally provide for the row.
+        std::vector<wchar_t> chars(columns);
+        std::vector<uint16_t> offsets(columns + 1u);
+        ROW row{ chars.data(), offsets.data(), columns, TextAttribute{} };
+
+        const auto write = [&](const std::wstring_view text) {
+            RowWriteState state{
+                .text = text,
+                .columnBegin = 0,
+                .columnLimit = row.size(),
+            };
+            row.ReplaceText(state);
+            run.Consume(gsl::narrow_cast<size_t>(state.columnEnd));
+        };
+
+        run.Measure(fmt::format(FMT_COMPILE("{}/ascii"), columns), calls, [&]() { write(ascii); });
+        run.Measure(fmt::format(FMT_COMPILE("{}/non-ascii"), columns), calls, [&]() { write(mixed); });
+    }
+}
+
+// Compares a DECDLD download of a complete 94 character set of 10x20 glyphs
+// in a single write, which lets the state machine hand the sixel data over to
+// the font buffer in chunks, with writes of one character at a time.
+static void kernelSoftFontDownload(KernelRun& run)
+{
+    static constexpr size_t calls = 100;
+
+    std::wstring sequence = L"\033P1;1;1;10;0;2;20;0{ @";
+    for (auto i = 0; i < 94; i++)
+    {
+        if (i > 0)
+        {
+            sequence += L';';
+        }
+        for (auto row = 0; row < 4; row++)
+        {
+            if (row > 0)
+            {
+                sequence += L'/';
+            }
+            for (auto column = 0; column < 10; column++)
+            {
+                sequence += static_cast<wchar_t>(L'?' + (i + row * 10 + column) % 64);
+            }
+        }
+    }
+    sequence += L"\033\\";
+
+    HeadlessTerminal terminal{ { 80, 24 }, 0 };
+    for (const size_t writeSize : { sequence.size(), size_t{ 37 }, size_t{ 1 } })
+    {
+        const auto label = writeSize == sequence.size() ? std::string{ "single-write" } : fmt::format(FMT_COMPILE("writes-of-{}"), writeSize);
+        run.Measure(label, calls, [&]() {
+            for (size_t offset = 0; offset < sequence.size(); offset += writeSize)
+            {
+                terminal.Write(std::wstring_view{ sequence }.substr(offset, writeSize));
+            }
+            run.Consume(terminal.GetCounters().responses);
+        });
+    }
+}
+
+// Encodes and decodes random data with the Base64 codec used by OSC 52,
+// once with a size that fits into the caches and once with one that doesn't.
+static void kernelBase64(KernelRun& run)
+{
+    using Microsoft::Console::VirtualTerminal::Base64;
+
+    std::mt19937 rng{ 0 };
+    for (const size_t megabytes : { 1, 64 })
+    {
+        // The same amount of data is processed for both sizes.
+        const auto calls = 64 / megabytes;
+
+        std::string data(megabytes * 1024 * 1024, '\0');
+        for (auto& ch : data)
+        {
+            ch = static_cast<char>(rng());
+        }
+
+        std::wstring encoded(Base64::EncodedLength(data.size()), L'\0');
+        std::string decoded(Base64::DecodedLengthMax(encoded.size()), '\0');
+
+        run.Measure(fmt::format(FMT_COMPILE("{}MB/encode"), megabytes), calls, [&]() {
+            run.Consume(Base64::Encode(data, encoded));
+        });
+        run.Measure(fmt::format(FMT_COMPILE("{}MB/decode"), megabytes), calls, [&]() {
+            size_t written = 0;
+            THROW_IF_FAILED(Base64::Decode(encoded, decoded, written));
+            run.Consume(written);
+        });
+    }
+}
+
+// Compares the cell and the span iterator of TextBuffer for the access patterns of their readers:
+// * text only (TextBuffer::GetText, ReadOutputStringW)
+// * attributes only (ReadOutputAttributes, UiaTextRangeBase::GetAttributeValue)
+// * text and attributes of every cell (the renderer, ReadConsoleOutputW, _CopyRectangle)
+static void kernelRowSpans(KernelRun& run)
+{
+    static constexpr size_t calls = 100;
+
+    DummyRenderer renderer;
+    for (const til::CoordType columns : { 80, 200 })
+    {
+        // Text with different attributes every few columns,
+        // which is a bit more colorful than the average shell prompt.
+        const til::size size{ columns, 50 };
+        TextBuffer buffer{ size, TextAttribute{ 0x7 }, 0, false, renderer };
+        for (til::CoordType y = 0; y < size.height; ++y)
+        {
+            auto& row = buffer.GetRowByOffset(y);
+            for (til::CoordType x = 0; x < size.width; ++x)
+            {
+                const auto ch = static_cast<wchar_t>(L'!' + (x + y) % 94);
+                row.ReplaceCharacters(x, 1, { &ch, 1 });
+            }
+            for (til::CoordType x = 0; x < size.width; x += 8)
+            {
+                row.ReplaceAttributes(x, std::min(x + 8, size.width), TextAttribute{ gsl::narrow_cast<WORD>(x / 8 % 16) });
+            }
+        }
+
+        const auto limits = buffer.GetSize();
+        std::wstring text;
+        text.reserve(size.area<size_t>());
+
+        run.Measure(fmt::format(FMT_COMPILE("{}/text/cells"), columns), calls, [&]() {
+            text.clear();
+            for (auto it = buffer.GetCellDataAt({}, limits); it; ++it)
+            {
+                if (it->DbcsAttr() != DbcsAttribute::Trailing)
+                {
+                    text.append(it->Chars());
+                }
+            }
+            run.Consume(text.size());
+        });
+        run.Measure(fmt::format(FMT_COMPILE("{}/text/spans"), columns), calls, [&]() {
+            text.clear();
+            for (auto it = buffer.GetRowSpansAt({}, limits); it; ++it)
+            {
+                text.append(it->Text());
+            }
+            run.Consume(text.size());
+        });
+
+        run.Measure(fmt::format(FMT_COMPILE("{}/attributes/cells"), columns), calls, [&]() {
+            for (auto it = buffer.GetCellDataAt({}, limits); it; ++it)
+            {
+                run.Consume(it->TextAttr().GetLegacyAttributes());
+            }
+        });
+        run.Measure(fmt::format(FMT_COMPILE("{}/attributes/spans"), columns), calls, [&]() {
+            for (auto it = buffer.GetRowSpansAt({}, limits); it; ++it)
+            {
+                run.Consume(it->attr.GetLegacyAttributes() * gsl::narrow_cast<size_t>(it->Columns()));
+            }
+        });
+
+        run.Measure(fmt::format(FMT_COMPILE("{}/text-and-attributes/cells"), columns), calls, [&]() {
+            for (auto it = buffer.GetCellDataAt({}, limits); it; ++it)
+            {
+                run.Consume(it->Chars().size() + WI_EnumValue(it->DbcsAttr()) + it->TextAttr().GetLegacyAttributes());
+            }
+        });
+        run.Measure(fmt::format(FMT_COMPILE("{}/text-and-attributes/spans"), columns), calls, [&]() {
+            for (auto it = buffer.GetRowSpansAt({}, limits); it; ++it)
+            {
+                const auto legacy = it->attr.GetLegacyAttributes();
+                for (auto col = it->columnBegin; col < it->columnEnd; ++col)
+                {
+                    run.Consume(it->row->GlyphAt(col).size() + WI_EnumValue(it->row->DbcsAttrAt(col)) + legacy);
+                }
+            }
+        });
+    }
+}
+
+// Compares toggling the alt buffer like pagers and editors do (DECSET 1049) with
+// constructing a TextBuffer of the same size, which is what every toggle used to cost.
+static void kernelAltBufferToggle(KernelRun& run)
+{
+    static constexpr size_t calls = 10000;
+
+    DummyRenderer renderer;
+    for (const til::size viewport : { til::size{ 120, 50 }, til::size{ 240, 80 } })
+    {
+        HeadlessTerminal terminal{ viewport, 1000 };
+        const auto prefix = fmt::format(FMT_COMPILE("{}x{}"), viewport.width, viewport.height);
+
+        run.Measure(prefix + "/toggle", calls, [&]() {
+            terminal.Write(L"\x1b[?1049h\x1b[Hpager\x1b[?1049l");
+            run.Consume(terminal.GetTextBuffer().GetCursor().GetPosition().x);
+        });
+        run.Measure(prefix + "/construct", calls, [&]() {
+            const TextBuffer buffer{ viewport, TextAttribute{}, 0, false, renderer };
+            run.Consume(gsl::narrow_cast<size_t>(buffer.GetSize().Height()));
+        });
+    }
+}
+
+// Generates the clusters of text a terminal would ask a glyph cache for. The distributions
+// are skewed, because real text reuses a few glyphs (letters, common ideographs) a lot.
+// This is the same generator LruHashMapTests uses.
+static std::vector<std::wstring> generateGlyphTrace(const std::string_view kind, const size_t count)
+{
+    std::mt19937 rng{ 0 };
+    std::exponential_distribution<double> skew{ 0.05 };
+    const auto pick = [&](uint32_t range) {
+        return static_cast<uint32_t>(skew(rng)) % range;
+    };
+    const auto appendCodepoint = [](std::wstring& str, uint32_t cp) {
+        if (cp >= 0x10000)
+        {
+            cp -= 0x10000;
+            str.push_back(static_cast<wchar_t>(0xD800 + (cp >> 10)));
+            str.push_back(static_cast<wchar_t>(0xDC00 + (cp & 0x3FF)));
+        }
+        else
+        {
+            str.push_back(static_cast<wchar_t>(cp));
+        }
+    };
+
+    std::vector<std::wstring> trace;
+    trace.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::wstring cluster;
+        const auto roll = rng() % 100;
+
+        if (kind == "ascii")
+        {
+            appendCodepoint(cluster, 0x20 + pick(95));
+        }
+        else if (kind == "cjk")
+        {
+            appendCodepoint(cluster, 0x4E00 + pick(20992));
+        }
+        else
+        {
+            // Emoji, some with skin tone modifiers and some as ZWJ sequences.
+            appendCodepoint(cluster, 0x1F600 + pick(80));
+            if (roll % 4 == 0)
+            {
+                appendCodepoint(cluster, 0x1F3FB + pick(5));
+            }
+            if (roll % 8 == 1)
+            {
+                appendCodepoint(cluster, 0x200D);
+                appendCodepoint(cluster, 0x1F468 + pick(4));
+            }
+        }
+
+        trace.emplace_back(std::move(cluster));
+    }
+
+    return trace;
+}
+
+// The std::list + std::unordered_map combination that til::lru_hash_map replaced.
+struct ListLru
+{
+    using list_type = std::list<std::pair<std::wstring, size_t>>;
+
+    bool find(const std::wstring& key)
+    {
+        const auto it = map.find(key);
+        if (it == map.end())
+        {
+            return false;
+        }
+        list.splice(list.begin(), list, it->second);
+        return true;
+    }
+
+    void insert(const std::wstring& key, const size_t value)
+    {
+        list.emplace_front(key, value);
+        map.emplace(key, list.begin());
+    }
+
+    void pop_oldest()
+    {
+        map.erase(list.back().first);
+        list.pop_back();
+    }
+
+    size_t size() const noexcept
+    {
+        return list.size();
+    }
+
+    list_type list;
+    std::unordered_map<std::wstring, list_type::iterator> map;
+};
+
+// Replays glyph traces through a glyph cache of limited size, like AtlasEngine's TileHashMap,
+// with til::lru_hash_map and with the std::list + std::unordered_map baseline.
+// The hit rate is the one of a cold cache. The times are those of a warm cache.
+static void kernelGlyphCache(KernelRun& run)
+{
+    static constexpr size_t lookups = 1000000;
+    static constexpr size_t cacheSize = 2048;
+
+    // Looks up a glyph and inserts it on a miss, evicting the oldest one if the cache is full.
+    const auto lookup = [](auto& map, const std::wstring& key) {
+        bool hit;
+        if constexpr (std::is_same_v<std::decay_t<decltype(map)>, ListLru>)
+        {
+            hit = map.find(key);
+        }
+        else
+        {
+            hit = map.find(key) != map.end();
+        }
+        if (!hit)
+        {
+            if (map.size() >= cacheSize)
+            {
+                map.pop_oldest();
+            }
+            map.insert(key, key.size());
+        }
+        return hit;
+    };
+
+    for (const std::string_view kind : { "ascii", "cjk", "emoji" })
+    {
+        const auto keys = generateGlyphTrace(kind, lookups);
+
+        const auto replay = [&](auto& map, const std::string_view name) {
+            size_t hits = 0;
+            for (const auto& key : keys)
+            {
+                hits += lookup(map, key);
+            }
+            run.Report(fmt::format(FMT_COMPILE("{}/{}/hitRate"), kind, name), static_cast<double>(hits) / static_cast<double>(lookups));
+
+            size_t next = 0;
+            run.Measure(fmt::format(FMT_COMPILE("{}/{}"), kind, name), lookups, [&]() {
+                run.Consume(lookup(map, keys[next]));
+                next = next + 1 == keys.size() ? 0 : next + 1;
+            });
+        };
+
+        {
+            til::lru_hash_map<std::wstring, size_t> map;
+            replay(map, "lru_hash_map");
+        }
+        {
+            ListLru map;
+            replay(map, "list");
+        }
+    }
+}
+
+static constexpr Kernel builtinKernels[]{
+    { L"bitmap-runs", L"til::bitmap::runs() versus iterating the bitmap", kernelBitmapRuns },
+    { L"row-replace-text", L"ROW::ReplaceText() with ASCII and non-ASCII lines", kernelRowReplaceText },
+    { L"softfont-download", L"DECDLD soft font downloads in one write and in many small writes", kernelSoftFontDownload },
+    { L"base64", L"Base64 encoding and decoding of 1 MB and 64 MB of random data", kernelBase64 },
+    { L"row-spans", L"TextBuffer::GetRowSpansAt() versus GetCellDataAt() for text and attribute readers", kernelRowSpans },
+    { L"alt-buffer-toggle", L"Entering and leaving the alt buffer versus constructing a TextBuffer", kernelAltBufferToggle },
+    { L"glyph-cache", L"til::lru_hash_map versus std::list + std::unordered_map as a glyph cache", kernelGlyphCache },
+};
+
+std::span<const Kernel> Kernels::Builtin() noexcept
+{
+    return builtinKernels;
+}
+
+const Kernel* Kernels::Find(const std::wstring_view name) noexcept
+{
+    for (const auto& kernel : builtinKernels)
+    {
+        if (kernel.name == name)
+        {
+            return &kernel;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,103 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- Kernels.hpp
+
+Abstract:
+- Micro benchmarks of individual building blocks of the output and render path,
+  like the bitmap of dirty cells, the Base64 codec or the glyph cache.
+  VtBench runs them with --kernel.
+- A kernel usually times a new implementation next to the one it replaced or
+  next to its slow path, so that both can be compared on the same machine.
+--*/
+
+#pragma once
+
+#include "Timing.hpp"
+
+// Collects the timings of one kernel.
+class KernelRun
+{
+public:
+    struct Sample
+    {
+        std::string label;
+        size_t calls = 0;
+        // The time it took to make all the calls, once per iteration.
+        Timing timing;
+    };
+
+    explicit KernelRun(const int iterations) noexcept :
+        _iterations{ iterations }
+    {
+    }
+
+    // Calls func() `calls` times in a row and records how long that took.
+    // This is repeated for every iteration, so that we get the best and mean time.
+    template<typename Func>
+    void Measure(std::string label, const size_t calls, Func&& func)
+    {
+        auto& sample = _samples.emplace_back(Sample{ std::move(label), calls });
+        for (auto i = 0; i < _iterations; ++i)
+        {
+            const auto start = Clock::now();
+            for (size_t call = 0; call < calls; ++call)
+            {
+                func();
+            }
+            sample.timing.Add(secondsSince(start));
+        }
+    }
+
+    // Kernels feed the results of their work into this, so that the compiler
+    // can't drop the work as unused. The sum is printed with the results.
+    void Consume(const size_t value) noexcept
+    {
+        _checksum += value;
+    }
+
+    // Records a result that isn't a time, like the hit rate of a cache.
+    void Report(std::string name, const double value)
+    {
+        _metrics.emplace_back(std::move(name), value);
+    }
+
+    std::span<const Sample> Samples() const noexcept
+    {
+        return _samples;
+    }
+
+    std::span<const std::pair<std::string, double>> Metrics() const noexcept
+    {
+        return _metrics;
+    }
+
+    size_t Checksum() const noexcept
+    {
+        return _checksum;
+    }
+
+private:
+    int _iterations;
+    std::vector<Sample> _samples;
+    std::vector<std::pair<std::string, double>> _metrics;
+    size_t _checksum = 0;
+};
+
+struct Kernel
+{
+    std::wstring_view name;
+    std::wstring_view description;
+    void (*run)(KernelRun& run);
+};
+
+namespace Kernels
+{
+    // All kernels, in the order they're run by `--kernel all`.
+    std::span<const Kernel> Builtin() noexcept;
+
+    // Returns nullptr if there's no kernel with that name.
+    const Kernel* Find(const std::wstring_view name) noexcept;
+}
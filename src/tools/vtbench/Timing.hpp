@@ -0,0 +1,39 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- Timing.hpp
+
+Abstract:
+- The clock and the best/mean statistics shared by VtBench and RenderBench.
+--*/
+
+#pragma once
+
+using Clock = std::chrono::steady_clock;
+
+inline double secondsSince(const Clock::time_point start) noexcept
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// The best and mean of several timed runs of the same code.
+struct Timing
+{
+    double best = std::numeric_limits<double>::infinity();
+    double total = 0;
+    int samples = 0;
+
+    void Add(const double seconds) noexcept
+    {
+        best = std::min(best, seconds);
+        total += seconds;
+        samples++;
+    }
+
+    double Mean() const noexcept
+    {
+        return samples ? total / samples : 0;
+    }
+};
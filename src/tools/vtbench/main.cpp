@@ -0,0 +1,439 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// VtBench measures the throughput of the core output path:
+//   StateMachine::ProcessString -> AdaptDispatch -> TextBuffer
+// It runs headless (no window, no GPU, no console) and prints its results as JSON.
+
+#include "precomp.h"
+
+#include "Corpus.hpp"
+#include "HeadlessTerminal.hpp"
+#include "Kernels.hpp"
+#include "Timing.hpp"
+
+#include "../../terminal/adapter/termDispatch.hpp"
+
+using namespace Microsoft::Console::VirtualTerminal;
+
+#pragma region Allocation counting
+
+// The benchmark is single-threaded, but the CRT might not be.
+static std::atomic<size_t> g_allocations{ 0 };
+static std::atomic<size_t> g_allocatedBytes{ 0 };
+
+void* __cdecl operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (const auto p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void* __cdecl operator new(size_t size, std::align_val_t alignment)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (const auto p = _aligned_malloc(size ? size : 1, static_cast<size_t>(alignment)))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void __cdecl operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void __cdecl operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void __cdecl operator delete(void* p, std::align_val_t) noexcept
+{
+    _aligned_free(p);
+}
+
+void __cdecl operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    _aligned_free(p);
+}
+
+struct AllocationSnapshot
+{
+    size_t count = 0;
+    size_t bytes = 0;
+
+    static AllocationSnapshot Now() noexcept
+    {
+        return { g_allocations.load(std::memory_order_relaxed), g_allocatedBytes.load(std::memory_order_relaxed) };
+    }
+
+    AllocationSnapshot operator-(const AllocationSnapshot& other) const noexcept
+    {
+        return { count - other.count, bytes - other.bytes };
+    }
+};
+
+#pragma endregion
+
+// The memory used by the process, to see how the size of the scrollback
+// (and whether it's spilled to disk) affects the footprint of a terminal.
+struct MemorySnapshot
+{
+    size_t workingSet = 0;
+    size_t privateBytes = 0;
+
+    static MemorySnapshot Now() noexcept
+    {
+        PROCESS_MEMORY_COUNTERS_EX counters{};
+        counters.cb = sizeof(counters);
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+        {
+            return {};
+        }
+        return { counters.WorkingSetSize, counters.PrivateUsage };
+    }
+};
+
+// A dispatch that does nothing, so that we can measure the parser on its own.
+class NullDispatch final : public TermDispatch
+{
+public:
+    void Print(const wchar_t /*wchPrintable*/) override {}
+    void PrintString(const std::wstring_view /*string*/) override {}
+};
+
+struct Options
+{
+    til::size viewport{ 120, 30 };
+    til::CoordType scrollback = 9001;
+    size_t targetBytes = 16 * 1024 * 1024;
+    size_t chunkSize = 4096;
+    int iterations = 5;
+    std::vector<std::wstring> corpora;
+    std::vector<std::filesystem::path> files;
+    std::vector<const Kernel*> kernels;
+};
+
+struct Result
+{
+    std::wstring corpus;
+    size_t bytes = 0;
+    size_t codeUnits = 0;
+    Timing parse;
+    Timing pipeline;
+    AllocationSnapshot allocations;
+    MemorySnapshot memory;
+    bool scrollbackSpilled = false;
+    HeadlessTerminal::Counters counters;
+};
+
+struct KernelResult
+{
+    std::wstring_view kernel;
+    KernelRun run;
+};
+
+// Feeds the text in chunks of the given size, similar to how ConptyConnection
+// hands over whatever a single ReadFile() on the output pipe returned.
+template<typename Sink>
+static void replay(const std::wstring_view text, const size_t chunkSize, Sink&& sink)
+{
+    for (size_t i = 0; i < text.size(); i += chunkSize)
+    {
+        sink(text.substr(i, chunkSize));
+    }
+}
+
+static Result runCorpus(const Options& options, const Corpus& corpus)
+{
+    Result result;
+    result.corpus = corpus.name;
+    result.bytes = corpus.bytes;
+    result.codeUnits = corpus.text.size();
+
+    // Stage 1: The parser on its own.
+    for (auto i = 0; i < options.iterations; ++i)
+    {
+        StateMachine stateMachine{ std::make_unique<OutputStateMachineEngine>(std::make_unique<NullDispatch>()) };
+
+        const auto start = Clock::now();
+        replay(corpus.text, options.chunkSize, [&](const std::wstring_view chunk) {
+            stateMachine.ProcessString(chunk);
+        });
+        result.parse.Add(secondsSince(start));
+    }
+
+    // Stage 2: The full pipeline. The difference to stage 1 is the time spent in AdaptDispatch and TextBuffer.
+    HeadlessTerminal terminal{ options.viewport, options.scrollback };
+    for (auto i = 0; i < options.iterations; ++i)
+    {
+        terminal.Reset();
+
+        const auto allocations = AllocationSnapshot::Now();
+        const auto start = Clock::now();
+        replay(corpus.text, options.chunkSize, [&](const std::wstring_view chunk) {
+            terminal.Write(chunk);
+        });
+        result.pipeline.Add(secondsSince(start));
+
+        // The corpora are deterministic, so every iteration allocates the same.
+        result.allocations = AllocationSnapshot::Now() - allocations;
+        result.counters = terminal.GetCounters();
+    }
+
+    // Measured while the terminal and its full scrollback are still alive.
+    result.memory = MemorySnapshot::Now();
+    result.scrollbackSpilled = terminal.GetTextBuffer().GetScrollbackSpill() != nullptr;
+
+    return result;
+}
+
+static std::string jsonString(const std::wstring_view str)
+{
+    std::string out{ '"' };
+    for (const auto ch : til::u16u8(str))
+    {
+        switch (ch)
+        {
+        case '"':
+            out.append("\\\"");
+            break;
+        case '\\':
+            out.append("\\\\");
+            break;
+        default:
+            if (static_cast<unsigned char>(ch) < 0x20)
+            {
+                fmt::format_to(std::back_inserter(out), FMT_COMPILE("\\u{:04x}"), static_cast<int>(ch));
+            }
+            else
+            {
+                out.push_back(ch);
+            }
+            break;
+        }
+    }
+    out.push_back('"');
+    return out;
+}
+
+static void printKernelResults(std::string& out, const std::vector<KernelResult>& results)
+{
+    auto it = std::back_inserter(out);
+
+    out.append(",\n  \"kernels\": [");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& r = results[i];
+        fmt::format_to(it, FMT_COMPILE("{}\n    {{\n      \"kernel\": {},\n      \"checksum\": {},\n      \"samples\": ["), i ? "," : "", jsonString(r.kernel), r.run.Checksum());
+
+        const auto samples = r.run.Samples();
+        for (size_t j = 0; j < samples.size(); ++j)
+        {
+            const auto& s = samples[j];
+            const auto perCall = [&](double seconds) { return seconds / static_cast<double>(s.calls) * 1e9; };
+            fmt::format_to(it, FMT_COMPILE("{}\n        {{ \"label\": \"{}\", \"calls\": {}, \"nanosecondsPerCall\": {{ \"best\": {:.1f}, \"mean\": {:.1f} }} }}"), j ? "," : "", s.label, s.calls, perCall(s.timing.best), perCall(s.timing.Mean()));
+        }
+        out.append("\n      ]");
+
+        // Only kernels that report anything besides times have this, to keep the output readable.
+        const auto metrics = r.run.Metrics();
+        if (!metrics.empty())
+        {
+            out.append(",\n      \"metrics\": {");
+            for (size_t j = 0; j < metrics.size(); ++j)
+            {
+                fmt::format_to(it, FMT_COMPILE("{}\n        \"{}\": {:.4f}"), j ? "," : "", metrics[j].first, metrics[j].second);
+            }
+            out.append("\n      }");
+        }
+
+        out.append("\n    }");
+    }
+    out.append("\n  ]");
+}
+
+static void printResults(const Options& options, const std::vector<Result>& results, const std::vector<KernelResult>& kernelResults)
+{
+    std::string out;
+    auto it = std::back_inserter(out);
+
+    fmt::format_to(it, FMT_COMPILE("{{\n  \"build\": {{ \"parserTracing\": {} }},\n"), Feature_VtParserTracing::IsEnabled());
+    fmt::format_to(it, FMT_COMPILE("  \"viewport\": {{ \"width\": {}, \"height\": {} }},\n  \"scrollback\": {},\n  \"chunkSize\": {},\n  \"iterations\": {},\n  \"results\": ["), options.viewport.width, options.viewport.height, options.scrollback, options.chunkSize, options.iterations);
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& r = results[i];
+        const auto mbps = [&](double seconds) { return seconds > 0 ? r.bytes / seconds / 1e6 : 0.0; };
+        const auto dispatchBest = std::max(0.0, r.pipeline.best - r.parse.best);
+        const auto dispatchMean = std::max(0.0, r.pipeline.Mean() - r.parse.Mean());
+
+        fmt::format_to(it, FMT_COMPILE("{}\n    {{\n      \"corpus\": {},\n      \"bytes\": {},\n      \"codeUnits\": {},\n      \"throughputMBps\": {:.2f},\n"), i ? "," : "", jsonString(r.corpus), r.bytes, r.codeUnits, mbps(r.pipeline.best));
+        fmt::format_to(it, FMT_COMPILE("      \"stages\": {{\n        \"parse\": {{ \"bestSeconds\": {:.6f}, \"meanSeconds\": {:.6f}, \"throughputMBps\": {:.2f} }},\n"), r.parse.best, r.parse.Mean(), mbps(r.parse.best));
+        fmt::format_to(it, FMT_COMPILE("        \"dispatch\": {{ \"bestSeconds\": {:.6f}, \"meanSeconds\": {:.6f} }},\n"), dispatchBest, dispatchMean);
+        fmt::format_to(it, FMT_COMPILE("        \"total\": {{ \"bestSeconds\": {:.6f}, \"meanSeconds\": {:.6f} }}\n      }},\n"), r.pipeline.best, r.pipeline.Mean());
+        fmt::format_to(it, FMT_COMPILE("      \"allocations\": {{ \"count\": {}, \"bytes\": {} }},\n"), r.allocations.count, r.allocations.bytes);
+        fmt::format_to(it, FMT_COMPILE("      \"memory\": {{ \"workingSetBytes\": {}, \"privateBytes\": {}, \"scrollbackSpilled\": {} }},\n"), r.memory.workingSet, r.memory.privateBytes, r.scrollbackSpilled);
+        fmt::format_to(it, FMT_COMPILE("      \"counters\": {{ \"responses\": {}, \"titleChanges\": {}, \"clipboardWrites\": {}, \"bufferRotations\": {}, \"rotatedRows\": {}, \"viewportMoves\": {}, \"bells\": {} }}\n    }}"), r.counters.responses, r.counters.titleChanges, r.counters.clipboardWrites, r.counters.bufferRotations, r.counters.rotatedRows, r.counters.viewportMoves, r.counters.bells);
+    }
+
+    out.append("\n  ]");
+
+    if (!kernelResults.empty())
+    {
+        printKernelResults(out, kernelResults);
+    }
+
+    out.append("\n}\n");
+    fwrite(out.data(), 1, out.size(), stdout);
+}
+
+static void printUsage()
+{
+    fwprintf(stderr, L"Usage: VtBench.exe [options] [recorded-stream.txt ...]\r\n");
+    fwprintf(stderr, L"  --corpus <name>      Run only the given built-in corpus. May be repeated.\r\n");
+    fwprintf(stderr, L"                       Built-in: ascii, cjk, sgr, tui, hyperlink\r\n");
+    fwprintf(stderr, L"  --size <MiB>         Size of each generated corpus. Default: 16\r\n");
+    fwprintf(stderr, L"  --chunk <units>      Number of UTF-16 code units per ProcessString() call. Default: 4096\r\n");
+    fwprintf(stderr, L"  --iterations <n>     Number of runs per corpus and stage. Default: 5\r\n");
+    fwprintf(stderr, L"  --viewport <w>x<h>   Viewport size. Default: 120x30\r\n");
+    fwprintf(stderr, L"  --scrollback <rows>  Number of scrollback rows. Default: 9001\r\n");
+    fwprintf(stderr, L"  --kernel <name>      Run the given micro benchmark. May be repeated. 'all' runs all of them.\r\n");
+    fwprintf(stderr, L"                       Built-in:");
+    for (const auto& kernel : Kernels::Builtin())
+    {
+        fwprintf(stderr, L" %.*s", gsl::narrow_cast<int>(kernel.name.size()), kernel.name.data());
+    }
+    fwprintf(stderr, L"\r\n");
+    fwprintf(stderr, L"Recorded streams are raw terminal output encoded as UTF-8.\r\n");
+}
+
+static bool parseOptions(int argc, wchar_t* argv[], Options& options)
+{
+    for (auto i = 1; i < argc; ++i)
+    {
+        const std::wstring_view arg{ argv[i] };
+        const auto hasValue = i + 1 < argc;
+
+        if (arg == L"--corpus" && hasValue)
+        {
+            options.corpora.emplace_back(argv[++i]);
+        }
+        else if (arg == L"--size" && hasValue)
+        {
+            options.targetBytes = static_cast<size_t>(_wtoi(argv[++i])) * 1024 * 1024;
+        }
+        else if (arg == L"--chunk" && hasValue)
+        {
+            options.chunkSize = static_cast<size_t>(std::max(1, _wtoi(argv[++i])));
+        }
+        else if (arg == L"--iterations" && hasValue)
+        {
+            options.iterations = std::max(1, _wtoi(argv[++i]));
+        }
+        else if (arg == L"--viewport" && hasValue)
+        {
+            if (swscanf_s(argv[++i], L"%dx%d", &options.viewport.width, &options.viewport.height) != 2 ||
+                options.viewport.width <= 0 || options.viewport.height <= 0)
+            {
+                return false;
+            }
+        }
+        else if (arg == L"--scrollback" && hasValue)
+        {
+            options.scrollback = std::max(0, _wtoi(argv[++i]));
+        }
+        else if (arg == L"--kernel" && hasValue)
+        {
+            const std::wstring_view name{ argv[++i] };
+            if (name == L"all")
+            {
+                for (const auto& kernel : Kernels::Builtin())
+                {
+                    options.kernels.emplace_back(&kernel);
+                }
+            }
+            else if (const auto kernel = Kernels::Find(name))
+            {
+                options.kernels.emplace_back(kernel);
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if (arg.starts_with(L"--"))
+        {
+            return false;
+        }
+        else
+        {
+            options.files.emplace_back(arg);
+        }
+    }
+
+    // Without any explicit selection we run all the built-in corpora.
+    if (options.corpora.empty() && options.files.empty() && options.kernels.empty())
+    {
+        const auto names = Corpora::BuiltinNames();
+        options.corpora.assign(names.begin(), names.end());
+    }
+
+    return true;
+}
+
+int __cdecl wmain(int argc, wchar_t* argv[])
+try
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return E_INVALIDARG;
+    }
+
+    std::vector<Result> results;
+
+    for (const auto& name : options.corpora)
+    {
+        const auto corpus = Corpora::Generate(name, options.targetBytes);
+        if (!corpus)
+        {
+            fwprintf(stderr, L"Unknown corpus '%s'\r\n", name.c_str());
+            return E_INVALIDARG;
+        }
+        fwprintf(stderr, L"Running '%s'...\r\n", name.c_str());
+        results.emplace_back(runCorpus(options, *corpus));
+    }
+
+    for (const auto& path : options.files)
+    {
+        const auto corpus = Corpora::Load(path);
+        fwprintf(stderr, L"Running '%s'...\r\n", path.c_str());
+        results.emplace_back(runCorpus(options, corpus));
+    }
+
+    std::vector<KernelResult> kernelResults;
+
+    for (const auto kernel : options.kernels)
+    {
+        fwprintf(stderr, L"Running kernel '%.*s'...\r\n", gsl::narrow_cast<int>(kernel->name.size()), kernel->name.data());
+        auto& result = kernelResults.emplace_back(KernelResult{ kernel->name, KernelRun{ options.iterations } });
+        kernel->run(result.run);
+    }
+
+    printResults(options, results, kernelResults);
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return wil::ResultFromCaughtException();
+}
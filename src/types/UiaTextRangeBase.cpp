@@ -290,8 +290,9 @@ void UiaTextRangeBase::_expandToEnclosingUnit(TextUnit unit)
     else if (unit <= TextUnit_Word)
     {
         // expand to word
-        _start = buffer.GetWordStart(_start, _wordDelimiters, true, documentEnd);
-        _end = buffer.GetWordEnd(_start, _wordDelimiters, true, documentEnd);
+        const DelimiterClassifier classifier{ _wordDelimiters };
+        _start = buffer.GetWordStart(_start, classifier, true, documentEnd);
+        _end = buffer.GetWordEnd(_start, classifier, true, documentEnd);
     }
     else if (unit <= TextUnit_Line)
     {
@@ -806,10 +807,17 @@ try
         const auto height{ std::abs(inclusiveEnd.y - _start.y + 1) };
         viewportRange = Viewport::FromDimensions({ originX, originY }, width, height);
     }
-    auto iter{ buffer.GetCellDataAt(_start, viewportRange) };
-    for (; iter && iter.Pos() != inclusiveEnd; ++iter)
+    // All cells of a span share their attributes, so we only need to verify them once per span.
+    for (auto it{ buffer.GetRowSpansAt(_start, viewportRange) }; it; ++it)
     {
-        if (!_verifyAttr(attributeId, *pRetVal, iter->TextAttr()).value())
+        // The cell at inclusiveEnd itself isn't checked.
+        const auto containsEnd{ it->y == inclusiveEnd.y && it->columnBegin <= inclusiveEnd.x && inclusiveEnd.x < it->columnEnd };
+        if (containsEnd && it->columnBegin == inclusiveEnd.x)
+        {
+            break;
+        }
+
+        if (!_verifyAttr(attributeId, *pRetVal, it->attr).value())
         {
             // The value of the specified attribute varies over the text range
             // return UiaGetReservedMixedAttributeValue.
@@ -818,6 +826,11 @@ try
             UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal, UiaTracing::AttributeType::Mixed);
             return UiaGetReservedMixedAttributeValue(&pRetVal->punkVal);
         }
+
+        if (containsEnd)
+        {
+            break;
+        }
     }
 
     UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal);
@@ -1472,6 +1485,8 @@ void UiaTextRangeBase::_moveEndpointByUnitWord(_In_ const int moveCount,
     const auto bufferSize = buffer.GetSize();
     const auto bufferOrigin = bufferSize.Origin();
     const auto documentEnd = _getDocumentEnd();
+    // Moving by many words classifies many cells. Build the lookup table for that only once.
+    const DelimiterClassifier classifier{ _wordDelimiters };
 
     auto resultPos = GetEndpoint(endpoint);
     auto nextPos = resultPos;
@@ -1488,7 +1503,7 @@ void UiaTextRangeBase::_moveEndpointByUnitWord(_In_ const int moveCount,
             {
                 success = false;
             }
-            else if (buffer.MoveToNextWord(nextPos, _wordDelimiters, documentEnd))
+            else if (buffer.MoveToNextWord(nextPos, classifier, documentEnd))
             {
                 resultPos = nextPos;
                 (*pAmountMoved)++;
@@ -1510,7 +1525,7 @@ void UiaTextRangeBase::_moveEndpointByUnitWord(_In_ const int moveCount,
             {
                 success = false;
             }
-            else if (allowBottomExclusive && _tryMoveToWordStart(buffer, documentEnd, resultPos))
+            else if (allowBottomExclusive && _tryMoveToWordStart(buffer, classifier, documentEnd, resultPos))
             {
                 // IMPORTANT: _tryMoveToWordStart modifies resultPos if successful
                 // Degenerate ranges first move to the beginning of the word,
@@ -1518,7 +1533,7 @@ void UiaTextRangeBase::_moveEndpointByUnitWord(_In_ const int moveCount,
                 // to the next branch and move to the previous word!
                 (*pAmountMoved)--;
             }
-            else if (buffer.MoveToPreviousWord(nextPos, _wordDelimiters))
+            else if (buffer.MoveToPreviousWord(nextPos, classifier))
             {
                 resultPos = nextPos;
                 (*pAmountMoved)--;
@@ -1541,14 +1556,15 @@ void UiaTextRangeBase::_moveEndpointByUnitWord(_In_ const int moveCount,
 // - tries to move resultingPos to the beginning of the word
 // Arguments:
 // - buffer - the text buffer we're operating on
+// - classifier - built from _wordDelimiters
 // - documentEnd - the document end of the buffer (see _getDocumentEnd())
 // - resultingPos - the position we're starting from and modifying
 // Return Value:
 // - true --> we were not at the beginning of the word, and we updated resultingPos to be so
 // - false --> otherwise (we're already at the beginning of the word)
-bool UiaTextRangeBase::_tryMoveToWordStart(const TextBuffer& buffer, const til::point documentEnd, til::point& resultingPos) const
+bool UiaTextRangeBase::_tryMoveToWordStart(const TextBuffer& buffer, const DelimiterClassifier& classifier, const til::point documentEnd, til::point& resultingPos) const
 {
-    const auto wordStart{ buffer.GetWordStart(resultingPos, _wordDelimiters, true, documentEnd) };
+    const auto wordStart{ buffer.GetWordStart(resultingPos, classifier, true, documentEnd) };
     if (resultingPos != wordStart)
     {
         resultingPos = wordStart;
@@ -182,7 +182,7 @@ namespace Microsoft::Console::Types
 
         std::optional<bool> _verifyAttr(TEXTATTRIBUTEID attributeId, VARIANT val, const TextAttribute& attr) const;
         bool _initializeAttrQuery(TEXTATTRIBUTEID attributeId, VARIANT* pRetVal, const TextAttribute& attr) const;
-        bool _tryMoveToWordStart(const TextBuffer& buffer, const til::point documentEnd, til::point& resultingPos) const;
+        bool _tryMoveToWordStart(const TextBuffer& buffer, const DelimiterClassifier& classifier, const til::point documentEnd, til::point& resultingPos) const;
 
         til::point _getInclusiveEnd() const noexcept;
 
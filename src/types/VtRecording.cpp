@@ -0,0 +1,149 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inc/VtRecording.hpp"
+
+using namespace Microsoft::Console::Utils;
+
+// Frames are collected in memory until this many bytes have accumulated.
+// This keeps the number of WriteFile() calls on the output thread low.
+static constexpr size_t flushThreshold = 64 * 1024;
+
+VtRecordingWriter::VtRecordingWriter(const std::filesystem::path& path) :
+    _file{ CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) },
+    _start{ std::chrono::steady_clock::now() }
+{
+    THROW_LAST_ERROR_IF(!_file);
+
+    _buffer.reserve(flushThreshold * 2);
+
+    const VtRecordingFileHeader header;
+    _buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+VtRecordingWriter::~VtRecordingWriter()
+{
+    try
+    {
+        Flush();
+    }
+    CATCH_LOG();
+}
+
+bool VtRecordingWriter::IsOpen() const noexcept
+{
+    return static_cast<bool>(_file);
+}
+
+void VtRecordingWriter::WriteOutput(const std::string_view bytes)
+{
+    _append(VtRecordingFrameType::Output, bytes.data(), bytes.size());
+}
+
+void VtRecordingWriter::WriteInput(const std::wstring_view text)
+{
+    const auto bytes = til::u16u8(text);
+    _append(VtRecordingFrameType::Input, bytes.data(), bytes.size());
+}
+
+void VtRecordingWriter::WriteResize(const uint32_t columns, const uint32_t rows)
+{
+    const VtRecordingResize resize{ columns, rows };
+    _append(VtRecordingFrameType::Resize, &resize, sizeof(resize));
+}
+
+void VtRecordingWriter::Flush()
+{
+    const auto guard = _lock.lock_exclusive();
+    _flushLocked();
+}
+
+void VtRecordingWriter::_append(VtRecordingFrameType type, const void* data, size_t size)
+{
+    if (!_file)
+    {
+        return;
+    }
+
+    const auto guard = _lock.lock_exclusive();
+
+    // Taken under the lock, so that the timestamps of the frames are in the order they're written,
+    // even if the input and the output thread append a frame at the same time.
+    const auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start);
+    const VtRecordingFrameHeader header{
+        .size = gsl::narrow<uint32_t>(size),
+        .type = type,
+        .reserved = 0,
+        .timestamp = gsl::narrow_cast<uint64_t>(timestamp.count()),
+    };
+
+    _buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    _buffer.append(static_cast<const char*>(data), size);
+
+    if (_buffer.size() >= flushThreshold)
+    {
+        _flushLocked();
+    }
+}
+
+void VtRecordingWriter::_flushLocked()
+{
+    if (!_file || _buffer.empty())
+    {
+        return;
+    }
+
+    DWORD written = 0;
+    THROW_IF_WIN32_BOOL_FALSE(WriteFile(_file.get(), _buffer.data(), gsl::narrow<DWORD>(_buffer.size()), &written, nullptr));
+    _buffer.clear();
+}
+
+VtRecordingReader::VtRecordingReader(const std::filesystem::path& path) :
+    _file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) }
+{
+    THROW_LAST_ERROR_IF(!_file);
+
+    LARGE_INTEGER size{};
+    THROW_IF_WIN32_BOOL_FALSE(GetFileSizeEx(_file.get(), &size));
+    _size = gsl::narrow<size_t>(size.QuadPart);
+
+    VtRecordingFileHeader header;
+    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_BAD_FORMAT), _size < sizeof(header));
+
+    _mapping.reset(CreateFileMappingW(_file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+    THROW_LAST_ERROR_IF(!_mapping);
+
+    _view.reset(static_cast<const char*>(MapViewOfFile(_mapping.get(), FILE_MAP_READ, 0, 0, 0)));
+    THROW_LAST_ERROR_IF(!_view);
+
+    memcpy(&header, _view.get(), sizeof(header));
+    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_BAD_FORMAT), header.magic != VtRecordingFileHeader::ExpectedMagic);
+    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_UNSUPPORTED_TYPE), header.version != VtRecordingFileHeader::CurrentVersion);
+
+    Rewind();
+}
+
+std::optional<VtRecordingFrame> VtRecordingReader::Next() noexcept
+{
+    VtRecordingFrameHeader header;
+    if (_size - _offset < sizeof(header))
+    {
+        return std::nullopt;
+    }
+
+    memcpy(&header, _view.get() + _offset, sizeof(header));
+    if (_size - _offset - sizeof(header) < header.size)
+    {
+        return std::nullopt;
+    }
+
+    const std::string_view payload{ _view.get() + _offset + sizeof(header), header.size };
+    _offset += sizeof(header) + header.size;
+    return VtRecordingFrame{ header.type, std::chrono::microseconds{ header.timestamp }, payload };
+}
+
+void VtRecordingReader::Rewind() noexcept
+{
+    _offset = sizeof(VtRecordingFileHeader);
+}
@@ -0,0 +1,120 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- VtRecording.hpp
+
+Abstract:
+- A compact binary log of a terminal session: the raw output bytes of the
+  connection, the input written to it and resize events, each with a timestamp.
+- Recordings allow us to replay the exact input that made a customer's
+  terminal slow, without needing access to the application that produced it.
+
+File layout (all integers are little endian):
+    VtRecordingFileHeader
+    { VtRecordingFrameHeader, payload[VtRecordingFrameHeader::size] }*
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Utils
+{
+    enum class VtRecordingFrameType : uint16_t
+    {
+        // Raw bytes as received from the connection. Usually UTF-8, and frames
+        // may split multi-byte sequences, exactly like ReadFile() does.
+        Output = 1,
+        // Input as written to the connection, encoded as UTF-8.
+        Input = 2,
+        // A VtRecordingResize struct.
+        Resize = 3,
+    };
+
+    struct VtRecordingFileHeader
+    {
+        static constexpr std::array<char, 8> ExpectedMagic{ 'W', 'T', 'V', 'T', 'R', 'E', 'C', '\0' };
+        static constexpr uint32_t CurrentVersion = 1;
+
+        std::array<char, 8> magic = ExpectedMagic;
+        uint32_t version = CurrentVersion;
+        uint32_t reserved = 0;
+    };
+
+    struct VtRecordingFrameHeader
+    {
+        uint32_t size;
+        VtRecordingFrameType type;
+        uint16_t reserved;
+        // Microseconds since the start of the recording.
+        uint64_t timestamp;
+    };
+
+    struct VtRecordingResize
+    {
+        uint32_t columns;
+        uint32_t rows;
+    };
+
+    static_assert(sizeof(VtRecordingFileHeader) == 16);
+    static_assert(sizeof(VtRecordingFrameHeader) == 16);
+    static_assert(sizeof(VtRecordingResize) == 8);
+
+    struct VtRecordingFrame
+    {
+        VtRecordingFrameType type;
+        std::chrono::microseconds timestamp;
+        std::string_view payload;
+    };
+
+    // Appends frames to a recording file. All methods may be called concurrently,
+    // since output, input and resizes usually arrive on different threads.
+    // Frames are buffered and written out in larger chunks to keep the overhead
+    // on the connection's output thread small.
+    class VtRecordingWriter
+    {
+    public:
+        VtRecordingWriter() = default;
+        explicit VtRecordingWriter(const std::filesystem::path& path);
+        ~VtRecordingWriter();
+
+        VtRecordingWriter(const VtRecordingWriter&) = delete;
+        VtRecordingWriter& operator=(const VtRecordingWriter&) = delete;
+
+        bool IsOpen() const noexcept;
+
+        void WriteOutput(const std::string_view bytes);
+        void WriteInput(const std::wstring_view text);
+        void WriteResize(const uint32_t columns, const uint32_t rows);
+        void Flush();
+
+    private:
+        void _append(VtRecordingFrameType type, const void* data, size_t size);
+        void _flushLocked();
+
+        wil::srwlock _lock;
+        wil::unique_hfile _file;
+        std::string _buffer;
+        std::chrono::steady_clock::time_point _start;
+    };
+
+    // Reads a recording by mapping it into memory. The returned frames
+    // point directly into the mapping and live as long as the reader.
+    class VtRecordingReader
+    {
+    public:
+        explicit VtRecordingReader(const std::filesystem::path& path);
+
+        // Returns the next frame or std::nullopt at the end of the recording.
+        // A truncated trailing frame (e.g. from a crash) is treated as the end.
+        std::optional<VtRecordingFrame> Next() noexcept;
+        void Rewind() noexcept;
+
+    private:
+        wil::unique_hfile _file;
+        wil::unique_handle _mapping;
+        wil::unique_mapview_ptr<const char> _view;
+        size_t _size = 0;
+        size_t _offset = 0;
+    };
+}
@@ -67,6 +67,21 @@ namespace Microsoft::Console::Utils
 
     std::wstring FilterStringForPaste(const std::wstring_view wstr, const FilterOption option);
 
+    // Does the same as FilterStringForPaste, but for text that arrives in chunks.
+    // This allows large pastes to be filtered piece by piece as they're written.
+    class PasteFilter
+    {
+    public:
+        explicit PasteFilter(const FilterOption option) noexcept;
+
+        void Filter(const std::wstring_view chunk, std::wstring& out);
+
+    private:
+        FilterOption _option;
+        // The last character of the previous chunk, because \r\n may be split across chunks.
+        wchar_t _previous = 0;
+    };
+
     constexpr uint16_t EndianSwap(uint16_t value)
     {
         return (value & 0xFF00) >> 8 |
@@ -23,6 +23,7 @@ class UtilsTests
     TEST_METHOD(TestGuidToString);
     TEST_METHOD(TestSplitString);
     TEST_METHOD(TestFilterStringForPaste);
+    TEST_METHOD(TestPasteFilterChunked);
     TEST_METHOD(TestStringToUint);
     TEST_METHOD(TestColorFromXTermColor);
 
@@ -191,6 +192,26 @@ void UtilsTests::TestFilterStringForPaste()
                      FilterStringForPaste(unicodeString, FilterOption::CarriageReturnNewline | FilterOption::ControlCodes));
 }
 
+void UtilsTests::TestPasteFilterChunked()
+{
+    const std::wstring text = L"line 1\r\nline 2\nline 3\r\r\n\x1b[201~\x01tab\there\x9c\r\n\n你好\r\n";
+    const auto option = FilterOption::CarriageReturnNewline | FilterOption::ControlCodes;
+    const auto expected = FilterStringForPaste(text, option);
+
+    // Splitting the text into chunks of any size, including ones that
+    // split up \r\n, must not change the result.
+    for (size_t chunkSize = 1; chunkSize <= text.size(); ++chunkSize)
+    {
+        PasteFilter filter{ option };
+        std::wstring actual;
+        for (size_t i = 0; i < text.size(); i += chunkSize)
+        {
+            filter.Filter(std::wstring_view{ text }.substr(i, chunkSize), actual);
+        }
+        VERIFY_ARE_EQUAL(expected, actual, NoThrowString().Format(L"chunk size %zu", chunkSize));
+    }
+}
+
 void UtilsTests::TestStringToUint()
 {
     auto success = false;
@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../inc/VtRecording.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console::Utils;
+
+class VtRecordingTests
+{
+    TEST_CLASS(VtRecordingTests);
+
+    std::filesystem::path _path;
+
+    TEST_METHOD_SETUP(MethodSetup)
+    {
+        wchar_t directory[MAX_PATH + 1]{};
+        VERIFY_ARE_NOT_EQUAL(0u, GetTempPathW(ARRAYSIZE(directory), &directory[0]));
+        _path = std::filesystem::path{ &directory[0] } / L"VtRecordingTests.vtrec";
+        return true;
+    }
+
+    TEST_METHOD_CLEANUP(MethodCleanup)
+    {
+        std::error_code ec;
+        std::filesystem::remove(_path, ec);
+        return true;
+    }
+
+    TEST_METHOD(RoundTrip)
+    {
+        {
+            VtRecordingWriter writer{ _path };
+            VERIFY_IS_TRUE(writer.IsOpen());
+            writer.WriteResize(120, 30);
+            writer.WriteOutput("\x1b[31mhello\xe2\x82");
+            writer.WriteInput(L"ls\r");
+            writer.WriteOutput("\xac");
+        }
+
+        VtRecordingReader reader{ _path };
+
+        auto frame = reader.Next();
+        VERIFY_IS_TRUE(frame.has_value());
+        VERIFY_IS_TRUE(frame->type == VtRecordingFrameType::Resize);
+        VERIFY_ARE_EQUAL(sizeof(VtRecordingResize), frame->payload.size());
+        VtRecordingResize resize{};
+        memcpy(&resize, frame->payload.data(), sizeof(resize));
+        VERIFY_ARE_EQUAL(120u, resize.columns);
+        VERIFY_ARE_EQUAL(30u, resize.rows);
+        auto previous = frame->timestamp;
+
+        frame = reader.Next();
+        VERIFY_IS_TRUE(frame.has_value());
+        VERIFY_IS_TRUE(frame->type == VtRecordingFrameType::Output);
+        VERIFY_ARE_EQUAL(std::string_view{ "\x1b[31mhello\xe2\x82" }, frame->payload);
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(frame->timestamp.count(), previous.count());
+        previous = frame->timestamp;
+
+        frame = reader.Next();
+        VERIFY_IS_TRUE(frame.has_value());
+        VERIFY_IS_TRUE(frame->type == VtRecordingFrameType::Input);
+        VERIFY_ARE_EQUAL(std::string_view{ "ls\r" }, frame->payload);
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(frame->timestamp.count(), previous.count());
+
+        frame = reader.Next();
+        VERIFY_IS_TRUE(frame.has_value());
+        VERIFY_IS_TRUE(frame->type == VtRecordingFrameType::Output);
+        VERIFY_ARE_EQUAL(std::string_view{ "\xac" }, frame->payload);
+
+        VERIFY_IS_FALSE(reader.Next().has_value());
+
+        reader.Rewind();
+        frame = reader.Next();
+        VERIFY_IS_TRUE(frame.has_value());
+        VERIFY_IS_TRUE(frame->type == VtRecordingFrameType::Resize);
+    }
+
+    TEST_METHOD(ConcurrentWritersKeepTimestampsInOrder)
+    {
+        static constexpr size_t framesPerThread = 10000;
+
+        {
+            // Like ConptyConnection, where the input and the output thread record at the same time.
+            VtRecordingWriter writer{ _path };
+            std::thread input{ [&]() {
+                for (size_t i = 0; i < framesPerThread; ++i)
+                {
+                    writer.WriteInput(L"a");
+                }
+            } };
+            for (size_t i = 0; i < framesPerThread; ++i)
+            {
+                writer.WriteOutput("b");
+            }
+            input.join();
+        }
+
+        VtRecordingReader reader{ _path };
+        size_t frames = 0;
+        std::chrono::microseconds previous{};
+        while (const auto frame = reader.Next())
+        {
+            if (frame->timestamp < previous)
+            {
+                VERIFY_FAIL(NoThrowString().Format(L"frame %zu is older than the one before it", frames));
+            }
+            previous = frame->timestamp;
+            ++frames;
+        }
+        VERIFY_ARE_EQUAL(2 * framesPerThread, frames);
+    }
+
+    TEST_METHOD(TruncatedFrameEndsRecording)
+    {
+        {
+            VtRecordingWriter writer{ _path };
+            writer.WriteOutput("complete");
+            writer.WriteOutput("truncated");
+        }
+
+        // Simulate a crash halfway through writing the last frame.
+        const auto size = std::filesystem::file_size(_path);
+        std::filesystem::resize_file(_path, size - 4);
+
+        VtRecordingReader reader{ _path };
+        const auto frame = reader.Next();
+        VERIFY_IS_TRUE(frame.has_value());
+        VERIFY_ARE_EQUAL(std::string_view{ "complete" }, frame->payload);
+        VERIFY_IS_FALSE(reader.Next().has_value());
+    }
+
+    TEST_METHOD(RejectsForeignFiles)
+    {
+        {
+            wil::unique_hfile file{ CreateFileW(_path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+            VERIFY_IS_TRUE(static_cast<bool>(file));
+            static constexpr char text[] = "this is not a recording at all";
+            VERIFY_WIN32_BOOL_SUCCEEDED(WriteFile(file.get(), &text[0], sizeof(text), nullptr, nullptr));
+        }
+
+        VERIFY_THROWS_SPECIFIC(VtRecordingReader{ _path },
+                               wil::ResultException,
+                               [](wil::ResultException& e) { return e.GetErrorCode() == HRESULT_FROM_WIN32(ERROR_BAD_FORMAT); });
+    }
+};
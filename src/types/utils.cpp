@@ -531,7 +531,28 @@ catch (...)
 std::wstring Utils::FilterStringForPaste(const std::wstring_view wstr, const FilterOption option)
 {
     std::wstring filtered;
-    filtered.reserve(wstr.length());
+    PasteFilter{ option }.Filter(wstr, filtered);
+    return filtered;
+}
+
+Utils::PasteFilter::PasteFilter(const FilterOption option) noexcept :
+    _option{ option }
+{
+}
+
+// Routine Description:
+// - Filters the next chunk of pasted text and appends the result to out.
+//   Calling this for each chunk of a string in turn produces the same result
+//   as calling FilterStringForPaste for the entire string.
+// Arguments:
+// - chunk - The next chunk of text to process.
+// - out - The string to append the filtered text to.
+void Utils::PasteFilter::Filter(const std::wstring_view chunk, std::wstring& out)
+{
+    if (out.empty())
+    {
+        out.reserve(chunk.size());
+    }
 
     const auto isControlCode = [](wchar_t c) {
         if (c >= L'\x20' && c < L'\x7f')
@@ -552,29 +573,30 @@ std::wstring Utils::FilterStringForPaste(const std::wstring_view wstr, const Fil
 
     std::wstring::size_type pos = 0;
     std::wstring::size_type begin = 0;
+    auto previous = _previous;
 
-    while (pos < wstr.size())
+    while (pos < chunk.size())
     {
-        const auto c = til::at(wstr, pos);
+        const auto c = til::at(chunk, pos);
 
-        if (WI_IsFlagSet(option, FilterOption::CarriageReturnNewline) && c == L'\n')
+        if (WI_IsFlagSet(_option, FilterOption::CarriageReturnNewline) && c == L'\n')
         {
             // copy up to but not including the \n
-            filtered.append(wstr.cbegin() + begin, wstr.cbegin() + pos);
-            if (!(pos > 0 && (til::at(wstr, pos - 1) == L'\r')))
+            out.append(chunk.cbegin() + begin, chunk.cbegin() + pos);
+            if (previous != L'\r')
             {
                 // there was no \r before the \n we did not copy,
                 // so append our own \r (this effectively replaces the \n
                 // with a \r)
-                filtered.push_back(L'\r');
+                out.push_back(L'\r');
             }
             ++pos;
             begin = pos;
         }
-        else if (WI_IsFlagSet(option, FilterOption::ControlCodes) && isControlCode(c))
+        else if (WI_IsFlagSet(_option, FilterOption::ControlCodes) && isControlCode(c))
         {
             // copy up to but not including the control code
-            filtered.append(wstr.cbegin() + begin, wstr.cbegin() + pos);
+            out.append(chunk.cbegin() + begin, chunk.cbegin() + pos);
             ++pos;
             begin = pos;
         }
@@ -582,24 +604,12 @@ std::wstring Utils::FilterStringForPaste(const std::wstring_view wstr, const Fil
         {
             ++pos;
         }
-    }
 
-    // If we entered the while loop even once, begin would be non-zero
-    // (because we set begin = pos right after incrementing pos)
-    // So, if begin is still zero at this point it means we never found a newline
-    // and we can just write the original string
-    if (begin == 0)
-    {
-        return std::wstring{ wstr };
-    }
-    else
-    {
-        filtered.append(wstr.cbegin() + begin, wstr.cend());
-        // we may have removed some characters, so we may not need as much space
-        // as we reserved earlier
-        filtered.shrink_to_fit();
-        return filtered;
+        previous = c;
     }
+
+    out.append(chunk.cbegin() + begin, chunk.cend());
+    _previous = previous;
 }
 
 // Routine Description: